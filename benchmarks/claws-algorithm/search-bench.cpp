@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/algorithm/search.hpp>
+
+namespace
+{
+  // The needle only appears in the last element, so `find` scans the whole range
+  template<class T>
+  std::vector<T> make_input(std::size_t size)
+  {
+    std::vector<T> result(size, T(1));
+
+    result.back() = T(2);
+    return result;
+  }
+
+  template<class T>
+  void std_find(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(std::find(data.begin(), data.end(), T(2)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void claws_find(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::find(data.begin(), data.end(), T(2)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void std_find_first_of(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+    T const needles[] = {T(2), T(3), T(4), T(5)};
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(std::find_first_of(data.begin(), data.end(), std::begin(needles), std::end(needles)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void claws_find_if_eq_any(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+    T const needles[] = {T(2), T(3), T(4), T(5)};
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::find_if_eq_any(data.begin(), data.end(), std::begin(needles), std::end(needles)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void std_count(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(std::count(data.begin(), data.end(), T(1)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void claws_count(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::count(data.begin(), data.end(), T(1)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void std_minmax_element(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(std::minmax_element(data.begin(), data.end()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void claws_minmax_element(benchmark::State &state)
+  {
+    auto const data = make_input<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::minmax_element(data.begin(), data.end()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void std_mismatch(benchmark::State &state)
+  {
+    auto const lh = make_input<T>(static_cast<std::size_t>(state.range(0)));
+    auto const rh = std::vector<T>(lh.size(), T(1));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(std::mismatch(lh.begin(), lh.end(), rh.begin()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T>
+  void claws_mismatch(benchmark::State &state)
+  {
+    auto const lh = make_input<T>(static_cast<std::size_t>(state.range(0)));
+    auto const rh = std::vector<T>(lh.size(), T(1));
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::mismatch(lh.begin(), lh.end(), rh.begin()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+#define CLAWS_SEARCH_BENCH(NAME, TYPE)                                                     \
+  BENCHMARK_TEMPLATE(std_##NAME, TYPE)->RangeMultiplier(16)->Range(1 << 6, 1 << 18); \
+  BENCHMARK_TEMPLATE(claws_##NAME, TYPE)->RangeMultiplier(16)->Range(1 << 6, 1 << 18)
+
+CLAWS_SEARCH_BENCH(find, std::uint8_t);
+CLAWS_SEARCH_BENCH(find, std::uint32_t);
+CLAWS_SEARCH_BENCH(find, double);
+CLAWS_SEARCH_BENCH(count, std::uint8_t);
+CLAWS_SEARCH_BENCH(count, std::uint32_t);
+CLAWS_SEARCH_BENCH(minmax_element, std::int32_t);
+CLAWS_SEARCH_BENCH(minmax_element, std::uint64_t);
+CLAWS_SEARCH_BENCH(mismatch, std::uint16_t);
+CLAWS_SEARCH_BENCH(mismatch, std::uint64_t);
+BENCHMARK_TEMPLATE(std_find_first_of, std::uint8_t)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+BENCHMARK_TEMPLATE(claws_find_if_eq_any, std::uint8_t)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+
+#undef CLAWS_SEARCH_BENCH
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/algorithm/radix_sort.hpp>
+#include <claws/algorithm/sort.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace
+{
+  enum class input_pattern
+  {
+    random,
+    sorted,
+    reversed,
+    few_unique
+  };
+
+  template<class T>
+  std::vector<T> make_input(std::size_t size, input_pattern pattern)
+  {
+    std::mt19937_64 engine(size);
+    std::vector<T> result(size);
+
+    for (std::size_t i(0u); i != size; ++i)
+      switch (pattern)
+        {
+        case input_pattern::random:
+          result[i] = static_cast<T>(engine());
+          break;
+        case input_pattern::sorted:
+          result[i] = static_cast<T>(i);
+          break;
+        case input_pattern::reversed:
+          result[i] = static_cast<T>(size - i);
+          break;
+        case input_pattern::few_unique:
+          result[i] = static_cast<T>(engine() % 16u);
+          break;
+        }
+    return result;
+  }
+
+  struct std_sort
+  {
+    template<class it>
+    void operator()(it begin, it end) const
+    {
+      std::sort(begin, end);
+    }
+  };
+
+  struct claws_sort
+  {
+    template<class it>
+    void operator()(it begin, it end) const
+    {
+      claws::sort(begin, end);
+    }
+  };
+
+  struct claws_radix_sort
+  {
+    template<class it>
+    void operator()(it begin, it end) const
+    {
+      claws::radix_sort(begin, end);
+    }
+  };
+
+  // The copy of the input is part of the measured time, it is the same for every algorithm.
+  template<class T, class algorithm, input_pattern pattern>
+  void sort_bench(benchmark::State &state)
+  {
+    auto const input = make_input<T>(static_cast<std::size_t>(state.range(0)), pattern);
+    std::vector<T> data(input.size());
+
+    for (auto _ : state)
+      {
+        std::copy(input.begin(), input.end(), data.begin());
+        algorithm{}(data.begin(), data.end());
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  struct index_tag;
+  using index_type = claws::tagged_data<std::uint32_t, std::int32_t, index_tag>;
+
+  void radix_sort_tagged_payload(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const raw_keys = make_input<std::uint32_t>(size, input_pattern::random);
+    std::vector<index_type> input;
+    std::vector<index_type> keys(size);
+    std::vector<std::uint32_t> payload(size);
+
+    for (auto key : raw_keys)
+      input.emplace_back(key % static_cast<std::uint32_t>(size));
+    for (auto _ : state)
+      {
+        std::copy(input.begin(), input.end(), keys.begin());
+        for (std::size_t i(0u); i != size; ++i)
+          payload[i] = static_cast<std::uint32_t>(i);
+        claws::radix_sort(keys.begin(), keys.end(), payload.begin());
+        benchmark::DoNotOptimize(keys.data());
+        benchmark::DoNotOptimize(payload.data());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+#define CLAWS_SORT_BENCH(TYPE, PATTERN)                                                                              \
+  BENCHMARK_TEMPLATE(sort_bench, TYPE, std_sort, input_pattern::PATTERN)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);   \
+  BENCHMARK_TEMPLATE(sort_bench, TYPE, claws_sort, input_pattern::PATTERN)->RangeMultiplier(32)->Range(1 << 10, 1 << 20); \
+  BENCHMARK_TEMPLATE(sort_bench, TYPE, claws_radix_sort, input_pattern::PATTERN)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)
+
+CLAWS_SORT_BENCH(std::uint32_t, random);
+CLAWS_SORT_BENCH(std::uint32_t, sorted);
+CLAWS_SORT_BENCH(std::uint32_t, reversed);
+CLAWS_SORT_BENCH(std::uint32_t, few_unique);
+CLAWS_SORT_BENCH(std::uint64_t, random);
+CLAWS_SORT_BENCH(std::uint64_t, sorted);
+CLAWS_SORT_BENCH(std::uint64_t, reversed);
+CLAWS_SORT_BENCH(std::uint64_t, few_unique);
+CLAWS_SORT_BENCH(float, random);
+
+#undef CLAWS_SORT_BENCH
+
+BENCHMARK(radix_sort_tagged_payload)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
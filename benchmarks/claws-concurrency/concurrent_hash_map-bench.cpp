@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <mutex>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/concurrent_hash_map.hpp>
+
+namespace
+{
+  constexpr std::uint64_t key_count = 1u << 16u;
+
+  /// The baseline: one map behind one mutex, every access serialised
+  class locked_map
+  {
+    std::mutex mutex;
+    claws::flat_hash_map<std::uint64_t, std::uint64_t> map;
+
+  public:
+    void insert_or_assign(std::uint64_t key, std::uint64_t value)
+    {
+      std::lock_guard lock(mutex);
+
+      map.insert_or_assign(key, value);
+    }
+
+    bool contains(std::uint64_t key)
+    {
+      std::lock_guard lock(mutex);
+
+      return map.contains(key);
+    }
+  };
+
+  using sharded_map = claws::concurrent_hash_map<std::uint64_t, std::uint64_t>;
+  using sharded_mutex_map = claws::concurrent_hash_map<std::uint64_t, std::uint64_t, claws::mix_hash, std::equal_to<>, std::mutex>;
+
+  template<class map_type>
+  map_type &get_map()
+  {
+    static map_type *map = [] {
+      auto const result = new map_type;
+
+      for (std::uint64_t i(0u); i != key_count; ++i)
+        result->insert_or_assign(i, i);
+      return result;
+    }();
+
+    return *map;
+  }
+
+  // Every thread does `state.range(0)` writes out of 100 operations on random keys
+  template<class map_type>
+  void read_write_mix(benchmark::State &state)
+  {
+    auto &map = get_map<map_type>();
+    auto const write_percent = static_cast<std::uint64_t>(state.range(0));
+    std::uint64_t random(0x9E3779B97F4A7C15u * (static_cast<std::uint64_t>(state.thread_index()) + 1u));
+
+    for (auto _ : state)
+      {
+        random ^= random << 13u;
+        random ^= random >> 7u;
+        random ^= random << 17u;
+
+        auto const key = random % key_count;
+
+        if ((random >> 32u) % 100u < write_percent)
+          map.insert_or_assign(key, random);
+        else
+          benchmark::DoNotOptimize(map.contains(key));
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Lookups of 256 keys at once: each shard is locked once per batch
+  void find_many(benchmark::State &state)
+  {
+    auto &map = get_map<sharded_map>();
+    std::uint64_t keys[256];
+
+    for (std::uint64_t i(0u); i != 256u; ++i)
+      keys[i] = (i * 0x9E3779B97F4A7C15u) % key_count;
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+
+        map.find_many(keys, [&sum](std::size_t, std::uint64_t value) { sum += value; });
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * 256);
+  }
+
+  void find_each(benchmark::State &state)
+  {
+    auto &map = get_map<sharded_map>();
+    std::uint64_t keys[256];
+
+    for (std::uint64_t i(0u); i != 256u; ++i)
+      keys[i] = (i * 0x9E3779B97F4A7C15u) % key_count;
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+
+        for (auto const key : keys)
+          map.visit(key, [&sum](std::uint64_t value) { sum += value; });
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * 256);
+  }
+}
+
+BENCHMARK_TEMPLATE(read_write_mix, locked_map)->ArgName("write%")->Arg(0)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(read_write_mix, sharded_map)->ArgName("write%")->Arg(0)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(read_write_mix, sharded_mutex_map)->ArgName("write%")->Arg(0)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(find_many)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(find_each)->ThreadRange(1, 8)->UseRealTime();
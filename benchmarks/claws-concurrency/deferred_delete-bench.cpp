@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/deferred_delete.hpp>
+#include <claws/utils/handle_types.hpp>
+
+namespace
+{
+  // Large enough allocations that freeing them isn't free
+  constexpr std::size_t buffer_size = 4096;
+
+  struct buffer_deleter
+  {
+    void operator()(char *buffer) const noexcept
+    {
+      delete[] buffer;
+    }
+  };
+
+  claws::deletion_queue &get_bench_queue() noexcept
+  {
+    static claws::deletion_queue queue;
+
+    return queue;
+  }
+
+  using deferred_deleter = claws::deferred_delete<buffer_deleter, get_bench_queue>;
+  using sync_buffer = claws::handle<char *, buffer_deleter>;
+  using deferred_buffer = claws::handle<char *, deferred_deleter>;
+
+  // Releases a batch of handles, as a request handler dropping its resources would
+  template<class buffer_type>
+  void release_batch(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    std::vector<char *> buffers(count);
+
+    for (auto _ : state)
+      {
+        for (auto &buffer : buffers)
+          buffer = new char[buffer_size];
+        for (auto buffer : buffers)
+          buffer_type released(typename buffer_type::deleter_type{}, std::move(buffer));
+        // Deferred deletions are reclaimed at a safe point, and counted
+        get_bench_queue().drain();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // The reclaimer thread frees buffers, the releasing thread only pushes them
+  void release_batch_background(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    std::vector<char *> buffers(count);
+    claws::background_reclaimer reclaimer(get_bench_queue());
+
+    for (auto _ : state)
+      {
+        for (auto &buffer : buffers)
+          buffer = new char[buffer_size];
+        for (auto buffer : buffers)
+          deferred_buffer released(deferred_deleter{}, std::move(buffer));
+      }
+    get_bench_queue().flush();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK_TEMPLATE(release_batch, sync_buffer)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(release_batch, deferred_buffer)->Arg(64)->Arg(4096);
+BENCHMARK(release_batch_background)->Arg(64)->Arg(4096);
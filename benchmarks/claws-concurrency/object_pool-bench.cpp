@@ -0,0 +1,94 @@
+#include <list>
+#include <memory_resource>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/object_pool.hpp>
+
+namespace
+{
+  constexpr int max_threads = 8;
+
+  struct particle
+  {
+    float position[3];
+    float velocity[3];
+    int age;
+  };
+
+  claws::object_pool<particle> particle_pool;
+  std::pmr::synchronized_pool_resource synchronized_resource;
+
+  // Keeps `live` particles, replacing the oldest one each iteration, like a particle system
+  template<class create_type, class destroy_type>
+  void churn(benchmark::State &state, create_type create, destroy_type destroy)
+  {
+    std::vector<particle *> live(256u);
+
+    for (auto &value : live)
+      value = create();
+    std::size_t oldest(0u);
+    for (auto _ : state)
+      {
+        destroy(live[oldest]);
+        live[oldest] = create();
+        oldest = (oldest + 1u) % live.size();
+      }
+    for (auto value : live)
+      destroy(value);
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void new_delete_churn(benchmark::State &state)
+  {
+    churn(
+      state, [] { return new particle{}; }, [](particle *value) { delete value; });
+  }
+
+  void synchronized_pool_churn(benchmark::State &state)
+  {
+    churn(
+      state, [] { return new (synchronized_resource.allocate(sizeof(particle), alignof(particle))) particle{}; },
+      [](particle *value) { synchronized_resource.deallocate(value, sizeof(particle), alignof(particle)); });
+  }
+
+  void object_pool_churn(benchmark::State &state)
+  {
+    churn(
+      state, [] { return particle_pool.create(); }, [](particle *value) { particle_pool.destroy(value); });
+  }
+
+  void std_list(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        std::list<int> values;
+
+        for (int i(0); i != state.range(0); ++i)
+          values.push_back(i);
+        benchmark::DoNotOptimize(values.back());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void pool_allocator_list(benchmark::State &state)
+  {
+    // Fits a list node: two pointers and the value
+    claws::fixed_pool pool(3u * sizeof(void *), alignof(std::max_align_t));
+
+    for (auto _ : state)
+      {
+        std::list<int, claws::pool_allocator<int>> values{claws::pool_allocator<int>(pool)};
+
+        for (int i(0); i != state.range(0); ++i)
+          values.push_back(i);
+        benchmark::DoNotOptimize(values.back());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(new_delete_churn)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(synchronized_pool_churn)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(object_pool_churn)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(std_list)->Arg(1 << 10);
+BENCHMARK(pool_allocator_list)->Arg(1 << 10);
@@ -0,0 +1,86 @@
+#include <atomic>
+#include <memory>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/rcu_handle.hpp>
+
+namespace
+{
+  struct routing_table
+  {
+    int routes[16];
+  };
+
+  claws::rcu_handle<routing_table> &get_rcu_table()
+  {
+    static claws::rcu_handle<routing_table> table(new routing_table{});
+
+    return table;
+  }
+
+  std::shared_ptr<routing_table> shared_table = std::make_shared<routing_table>();
+
+  // Every thread reads the same table, the refcount's cache line bounces between them for shared_ptr
+  void rcu_handle_read(benchmark::State &state)
+  {
+    auto &table = get_rcu_table();
+
+    for (auto _ : state)
+      {
+        auto const reader = table.read();
+
+        benchmark::DoNotOptimize(reader->routes[3]);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // A copy, as readers must take one to keep the table alive while a writer replaces it
+  void shared_ptr_read(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        auto const reader = std::atomic_load(&shared_table);
+
+        benchmark::DoNotOptimize(reader->routes[3]);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Readers with a writer replacing the table every 256 reads of thread 0
+  void rcu_handle_read_write(benchmark::State &state)
+  {
+    auto &table = get_rcu_table();
+    unsigned reads(0u);
+
+    for (auto _ : state)
+      {
+        if (!state.thread_index() && !(++reads & 255u))
+          table.update(new routing_table{});
+
+        auto const reader = table.read();
+
+        benchmark::DoNotOptimize(reader->routes[3]);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void shared_ptr_read_write(benchmark::State &state)
+  {
+    unsigned reads(0u);
+
+    for (auto _ : state)
+      {
+        if (!state.thread_index() && !(++reads & 255u))
+          std::atomic_store(&shared_table, std::make_shared<routing_table>());
+
+        auto const reader = std::atomic_load(&shared_table);
+
+        benchmark::DoNotOptimize(reader->routes[3]);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+}
+
+BENCHMARK(rcu_handle_read)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(shared_ptr_read)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(rcu_handle_read_write)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(shared_ptr_read_write)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,64 @@
+#include <cstdint>
+#include <mutex>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/seqlock.hpp>
+#include <claws/container/vect.hpp>
+
+namespace
+{
+  using pose = claws::vect<double, 4u>;
+
+  /// The baseline: a pose behind a mutex
+  class locked_pose
+  {
+    mutable std::mutex mutex;
+    pose value{};
+
+  public:
+    void store(pose const &new_value)
+    {
+      std::lock_guard lock(mutex);
+
+      value = new_value;
+    }
+
+    pose load() const
+    {
+      std::lock_guard lock(mutex);
+
+      return value;
+    }
+  };
+
+  template<class cell_type>
+  cell_type &get_cell()
+  {
+    static cell_type cell;
+
+    return cell;
+  }
+
+  // Thread 0 publishes poses continuously, the others read them: latency of each operation, with writes in flight
+  template<class cell_type>
+  void publish_read(benchmark::State &state)
+  {
+    auto &cell = get_cell<cell_type>();
+    double i(0.0);
+
+    for (auto _ : state)
+      {
+        if (!state.thread_index())
+          {
+            i += 1.0;
+            cell.store(pose{{i, i, i, i}});
+          }
+        else
+          benchmark::DoNotOptimize(cell.load());
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+}
+
+BENCHMARK_TEMPLATE(publish_read, locked_pose)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(publish_read, claws::seqlock<pose>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(publish_read, claws::multi_seqlock<pose>)->ThreadRange(1, 8)->UseRealTime();
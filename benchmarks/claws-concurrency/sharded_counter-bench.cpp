@@ -0,0 +1,61 @@
+#include <atomic>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/sharded_counter.hpp>
+#include <claws/utils/padded.hpp>
+
+namespace
+{
+  constexpr int max_threads = 8;
+
+  std::atomic<std::uint64_t> single_counter{0u};
+  // One counter per thread, next to each other: distinct values, but 8 threads writing the same cache line
+  std::atomic<std::uint64_t> packed_counters[max_threads] = {};
+  claws::padded<std::atomic<std::uint64_t>> padded_counters[max_threads] = {};
+  claws::sharded_counter<> sharded(max_threads);
+
+  void single_atomic(benchmark::State &state)
+  {
+    for (auto _ : state)
+      single_counter.fetch_add(1u, std::memory_order_relaxed);
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void packed_atomics(benchmark::State &state)
+  {
+    auto &counter = packed_counters[state.thread_index()];
+
+    for (auto _ : state)
+      counter.fetch_add(1u, std::memory_order_relaxed);
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void padded_atomics(benchmark::State &state)
+  {
+    auto &counter = *padded_counters[state.thread_index()];
+
+    for (auto _ : state)
+      counter.fetch_add(1u, std::memory_order_relaxed);
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void sharded_counter(benchmark::State &state)
+  {
+    for (auto _ : state)
+      sharded.increment();
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Reading sums every slot
+  void sharded_counter_read(benchmark::State &state)
+  {
+    for (auto _ : state)
+      benchmark::DoNotOptimize(sharded.load());
+  }
+}
+
+BENCHMARK(single_atomic)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(packed_atomics)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(padded_atomics)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(sharded_counter)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK(sharded_counter_read);
@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/concurrency/string_interner.hpp>
+#include <claws/container/flat_hash_map.hpp>
+
+namespace
+{
+  constexpr std::size_t name_count = 1u << 16u;
+
+  std::vector<std::string> const &get_names()
+  {
+    static std::vector<std::string> const names = [] {
+      std::vector<std::string> result;
+
+      for (std::size_t i(0u); i != name_count; ++i)
+        result.push_back("service.requests.latency.p99.shard_" + std::to_string(i * 7919u % name_count));
+      return result;
+    }();
+
+    return names;
+  }
+
+  claws::string_interner &get_interner()
+  {
+    static claws::string_interner *interner = [] {
+      auto const result = new claws::string_interner(name_count);
+
+      for (auto const &name : get_names())
+        result->intern(name);
+      return result;
+    }();
+
+    return *interner;
+  }
+
+  /// The usual alternative: a map from strings to ids behind a mutex
+  struct locked_interner
+  {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::uint32_t> ids;
+
+    std::uint32_t intern(std::string const &name)
+    {
+      std::lock_guard lock(mutex);
+
+      return ids.try_emplace(name, static_cast<std::uint32_t>(ids.size())).first->second;
+    }
+  };
+
+  locked_interner &get_locked_interner()
+  {
+    static locked_interner *interner = [] {
+      auto const result = new locked_interner;
+
+      for (auto const &name : get_names())
+        result->intern(name);
+      return result;
+    }();
+
+    return *interner;
+  }
+
+  // Interning strings already interned, as when parsing incoming metrics
+  void intern_hit(benchmark::State &state)
+  {
+    auto &interner = get_interner();
+    auto const &names = get_names();
+    std::size_t i(static_cast<std::size_t>(state.thread_index()) * 4099u);
+
+    for (auto _ : state)
+      {
+        benchmark::DoNotOptimize(interner.intern(names[i]));
+        i = (i + 1u) % name_count;
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void locked_map_hit(benchmark::State &state)
+  {
+    auto &interner = get_locked_interner();
+    auto const &names = get_names();
+    std::size_t i(static_cast<std::size_t>(state.thread_index()) * 4099u);
+
+    for (auto _ : state)
+      {
+        benchmark::DoNotOptimize(interner.intern(names[i]));
+        i = (i + 1u) % name_count;
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Aggregating samples keyed by metric name: hashing and comparing whole strings at every sample
+  void aggregate_by_string(benchmark::State &state)
+  {
+    auto const &names = get_names();
+    claws::flat_hash_map<std::string, double> totals;
+
+    for (auto const &name : names)
+      totals[name] = 0.0;
+    for (auto _ : state)
+      for (std::size_t i(0u); i != name_count; ++i)
+        totals.find(names[i * 31u % name_count])->second += 1.0;
+    state.SetItemsProcessed(state.iterations() * name_count);
+  }
+
+  // Same with interned ids: one integer hashed and compared per sample
+  void aggregate_by_id(benchmark::State &state)
+  {
+    auto &interner = get_interner();
+    claws::flat_hash_map<claws::interned_id, double> totals;
+    std::vector<claws::interned_id> ids;
+
+    interner.intern_many(get_names(), std::back_inserter(ids));
+    for (auto const id : ids)
+      totals[id] = 0.0;
+    for (auto _ : state)
+      for (std::size_t i(0u); i != name_count; ++i)
+        totals.find(ids[i * 31u % name_count])->second += 1.0;
+    state.SetItemsProcessed(state.iterations() * name_count);
+  }
+}
+
+BENCHMARK(intern_hit)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(locked_map_hit)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(aggregate_by_string);
+BENCHMARK(aggregate_by_id);
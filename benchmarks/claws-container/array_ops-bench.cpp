@@ -0,0 +1,125 @@
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/array_ops.hpp>
+
+namespace
+{
+  template<class T, std::size_t size>
+  std::vector<std::array<T, size>> make_input(std::size_t count)
+  {
+    std::vector<std::array<T, size>> result(count);
+
+    for (std::size_t i(0u); i != count; ++i)
+      for (std::size_t j(0u); j != size; ++j)
+        result[i][j] = static_cast<T>(i + j + 1);
+    return result;
+  }
+
+  template<class T, std::size_t size>
+  void array_ops_raw_add(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const lh = make_input<T, size>(count);
+    auto const rh = make_input<T, size>(count);
+    std::vector<std::array<T, size>> out(count);
+
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          for (std::size_t j(0u); j != size; ++j)
+            out[i][j] = lh[i][j] + rh[i][j];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void array_ops_add(benchmark::State &state)
+  {
+    using namespace claws::array_ops;
+
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const lh = make_input<T, size>(count);
+    auto const rh = make_input<T, size>(count);
+    std::vector<std::array<T, size>> out(count);
+
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          out[i] = lh[i] + rh[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void scalar_array_ops_multiply(benchmark::State &state)
+  {
+    using namespace claws::scalar_array_ops;
+
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto values = make_input<T, size>(count);
+
+    for (auto _ : state)
+      {
+        for (auto &value : values)
+          value *= T(1);
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void array_ops_negate(benchmark::State &state)
+  {
+    using namespace claws::array_ops;
+
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const values = make_input<T, size>(count);
+    std::vector<std::array<T, size>> out(count);
+
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          out[i] = -values[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void array_scalar_product(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const lh = make_input<T, size>(count);
+    auto const rh = make_input<T, size>(count);
+
+    for (auto _ : state)
+      {
+        T sum{};
+
+        for (std::size_t i(0u); i != count; ++i)
+          sum += claws::scalar(lh[i], rh[i]);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+#define CLAWS_ARRAY_OPS_BENCH(TYPE, SIZE)                                                                    \
+  BENCHMARK_TEMPLATE(array_ops_raw_add, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);         \
+  BENCHMARK_TEMPLATE(array_ops_add, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);             \
+  BENCHMARK_TEMPLATE(scalar_array_ops_multiply, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14); \
+  BENCHMARK_TEMPLATE(array_ops_negate, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);          \
+  BENCHMARK_TEMPLATE(array_scalar_product, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14)
+
+CLAWS_ARRAY_OPS_BENCH(float, 4);
+CLAWS_ARRAY_OPS_BENCH(int, 8);
+
+#undef CLAWS_ARRAY_OPS_BENCH
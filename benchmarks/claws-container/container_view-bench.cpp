@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/container_view.hpp>
+
+namespace
+{
+  std::vector<std::uint32_t> make_input(std::size_t size)
+  {
+    std::vector<std::uint32_t> result(size);
+
+    std::iota(result.begin(), result.end(), 0u);
+    return result;
+  }
+
+  constexpr auto transform = [](std::uint32_t value) noexcept { return value * 3u + 1u; };
+
+  void raw_transform_sum(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (auto value : input)
+          sum += transform(value);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void container_view_range_for(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (auto value : claws::container_view(input, transform))
+          sum += value;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void container_view_indexed(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+    auto const view = claws::container_view(input, transform);
+    auto const size = static_cast<std::size_t>(view.size());
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (std::size_t i(0u); i != size; ++i)
+          sum += view[i];
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(raw_transform_sum)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK(container_view_range_for)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK(container_view_indexed)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
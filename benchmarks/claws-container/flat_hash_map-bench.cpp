@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/flat_hash_map.hpp>
+#include <claws/container/flat_hash_set.hpp>
+
+namespace
+{
+  using flat_map = claws::flat_hash_map<std::uint64_t, std::uint64_t>;
+  using std_map = std::unordered_map<std::uint64_t, std::uint64_t>;
+  using position = claws::vect<int, 2u>;
+
+  /// Distinct random keys: the first `size` are inserted, the next `size` are missing from the map
+  std::vector<std::uint64_t> const &get_keys(std::size_t size)
+  {
+    static std::vector<std::uint64_t> keys;
+
+    if (keys.size() != size * 2u)
+      {
+        std::mt19937_64 generator(size);
+        claws::flat_hash_set<std::uint64_t> seen;
+
+        keys.clear();
+        while (keys.size() != size * 2u)
+          if (auto const key = generator(); seen.insert(key).second)
+            keys.push_back(key);
+      }
+    return keys;
+  }
+
+  template<class map_type>
+  map_type make_map(std::size_t size)
+  {
+    auto const &keys = get_keys(size);
+    map_type map;
+
+    for (std::size_t i(0u); i != size; ++i)
+      map.try_emplace(keys[i], i);
+    return map;
+  }
+
+  template<class map_type>
+  void insert(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const &keys = get_keys(size);
+
+    for (auto _ : state)
+      {
+        map_type map;
+
+        for (std::size_t i(0u); i != size; ++i)
+          map.try_emplace(keys[i], i);
+        benchmark::DoNotOptimize(map.size());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class map_type>
+  void lookup(benchmark::State &state, std::size_t first)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const &keys = get_keys(size);
+    auto const map = make_map<map_type>(size);
+
+    for (auto _ : state)
+      {
+        std::uint64_t found(0u);
+
+        for (std::size_t i(first); i != first + size; ++i)
+          found += map.find(keys[i]) != map.end();
+        benchmark::DoNotOptimize(found);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class map_type>
+  void lookup_hit(benchmark::State &state)
+  {
+    lookup<map_type>(state, 0u);
+  }
+
+  template<class map_type>
+  void lookup_miss(benchmark::State &state)
+  {
+    lookup<map_type>(state, static_cast<std::size_t>(state.range(0)));
+  }
+
+  // Sliding window of `size` keys: every insertion follows an erasure, like a cache or an in-flight request table
+  template<class map_type>
+  void erase_heavy(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const &keys = get_keys(size);
+
+    for (auto _ : state)
+      {
+        auto map = make_map<map_type>(size);
+
+        for (std::size_t i(size); i != size * 2u; ++i)
+          {
+            map.erase(keys[i - size]);
+            map.try_emplace(keys[i], i);
+          }
+        benchmark::DoNotOptimize(map.size());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // Grid coordinates: `std::hash` has no specialization for them, the usual workaround being to pack them in an integer
+  struct packed_position_hash
+  {
+    std::size_t operator()(position const &value) const noexcept
+    {
+      return std::hash<std::uint64_t>{}((std::uint64_t(std::uint32_t(value[0])) << 32u) | std::uint32_t(value[1]));
+    }
+  };
+
+  using std_grid = std::unordered_map<position, int, packed_position_hash>;
+  using flat_grid = claws::flat_hash_map<position, int>;
+
+  // Cells of a grid looked up in random order
+  template<class map_type>
+  void lookup_grid(benchmark::State &state)
+  {
+    auto const side = static_cast<int>(state.range(0));
+    std::vector<position> cells;
+    map_type map;
+
+    for (int x(0); x != side; ++x)
+      for (int y(0); y != side; ++y)
+        {
+          map.try_emplace(position{{x, y}}, x + y);
+          cells.push_back(position{{x, y}});
+        }
+    std::shuffle(cells.begin(), cells.end(), std::mt19937(42u));
+    for (auto _ : state)
+      {
+        std::int64_t sum(0);
+
+        for (auto const &cell : cells)
+          sum += map.find(cell)->second;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+  }
+}
+
+BENCHMARK_TEMPLATE(insert, std_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(insert, flat_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_hit, std_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_hit, flat_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_miss, std_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_miss, flat_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(erase_heavy, std_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(erase_heavy, flat_map)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_grid, std_grid)->Arg(1 << 9);
+BENCHMARK_TEMPLATE(lookup_grid, flat_grid)->Arg(1 << 9);
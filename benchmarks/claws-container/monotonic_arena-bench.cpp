@@ -0,0 +1,103 @@
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/monotonic_arena.hpp>
+
+namespace
+{
+  struct node
+  {
+    node *next;
+    int value;
+  };
+
+  // Builds a linked list of `count` nodes and throws it away, like per-request scratch data
+  template<class allocate_type, class release_type>
+  void build_lists(benchmark::State &state, allocate_type allocate, release_type release)
+  {
+    auto const count = static_cast<int>(state.range(0));
+
+    for (auto _ : state)
+      {
+        node *head = nullptr;
+
+        for (int i(0); i != count; ++i)
+          head = new (allocate()) node{head, i};
+        benchmark::DoNotOptimize(head);
+        release(head);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void new_delete_nodes(benchmark::State &state)
+  {
+    build_lists(
+      state, [] { return ::operator new(sizeof(node)); },
+      [](node *head) {
+        while (head)
+          ::operator delete(std::exchange(head, head->next));
+      });
+  }
+
+  void pmr_monotonic_nodes(benchmark::State &state)
+  {
+    std::pmr::monotonic_buffer_resource resource;
+
+    build_lists(
+      state, [&resource] { return resource.allocate(sizeof(node), alignof(node)); }, [&resource](node *) { resource.release(); });
+  }
+
+  void arena_nodes(benchmark::State &state)
+  {
+    claws::monotonic_arena arena;
+
+    build_lists(
+      state, [&arena] { return arena.allocate(sizeof(node), alignof(node)); }, [&arena](node *) { arena.reset(); });
+  }
+
+  void arena_huge_pages_nodes(benchmark::State &state)
+  {
+    claws::monotonic_arena arena(claws::monotonic_arena::huge_page_size, claws::arena_backing::huge_pages);
+
+    build_lists(
+      state, [&arena] { return arena.allocate(sizeof(node), alignof(node)); }, [&arena](node *) { arena.reset(); });
+  }
+
+  // Through the virtual `std::pmr::memory_resource` interface. Growing leaves the previous buffers behind, unused until the reset
+  void arena_pmr_vectors(benchmark::State &state)
+  {
+    claws::monotonic_arena arena;
+
+    for (auto _ : state)
+      {
+        std::pmr::vector<int> values(&arena);
+
+        for (int i(0); i != state.range(0); ++i)
+          values.push_back(i);
+        benchmark::DoNotOptimize(values.data());
+        arena.reset();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void std_vectors(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        std::vector<int> values;
+
+        for (int i(0); i != state.range(0); ++i)
+          values.push_back(i);
+        benchmark::DoNotOptimize(values.data());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(new_delete_nodes)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(pmr_monotonic_nodes)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(arena_nodes)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(arena_huge_pages_nodes)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(std_vectors)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(arena_pmr_vectors)->Arg(1 << 10)->Arg(1 << 16);
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <benchmark/benchmark.h>
+#include <claws/container/relocatable_hash_map.hpp>
+
+namespace
+{
+  using index_map = claws::relocatable_hash_map<std::uint64_t, std::uint64_t>;
+
+  constexpr std::size_t block_size = std::size_t(64u) << 20u;
+
+  /// A block holding an index of `size` entries, as a service would have saved it
+  std::byte *get_saved_block(std::size_t size)
+  {
+    static std::byte *block = nullptr;
+    static std::size_t block_entries = 0u;
+
+    if (block_entries != size)
+      {
+        std::free(block);
+        block = static_cast<std::byte *>(std::aligned_alloc(claws::relocatable_arena::max_alignment, block_size));
+
+        auto const arena = claws::relocatable_arena::create(block, block_size);
+        auto const map = arena->construct<index_map>(*arena);
+
+        map->reserve(size);
+        for (std::uint64_t i(0u); i != size; ++i)
+          map->insert(i * 7919u, i);
+        arena->set_root(map);
+        block_entries = size;
+      }
+    return block;
+  }
+
+  // Cold start: rebuilding the index from its entries
+  void restart_rebuild(benchmark::State &state)
+  {
+    auto const size = static_cast<std::uint64_t>(state.range(0));
+
+    for (auto _ : state)
+      {
+        std::unordered_map<std::uint64_t, std::uint64_t> map;
+
+        map.reserve(size);
+        for (std::uint64_t i(0u); i != size; ++i)
+          map.emplace(i * 7919u, i);
+        benchmark::DoNotOptimize(map.find(7919u));
+      }
+  }
+
+  // Warm start: the saved block is used where it is mapped, only the first lookup's pages are touched
+  void restart_attach(benchmark::State &state)
+  {
+    auto const block = get_saved_block(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        auto const arena = claws::relocatable_arena::attach(block, block_size);
+
+        benchmark::DoNotOptimize(arena->get_root<index_map>()->find(7919u));
+      }
+  }
+
+  void lookup_unordered_map(benchmark::State &state)
+  {
+    auto const size = static_cast<std::uint64_t>(state.range(0));
+    std::unordered_map<std::uint64_t, std::uint64_t> map;
+    std::uint64_t i(0u);
+
+    for (std::uint64_t j(0u); j != size; ++j)
+      map.emplace(j * 7919u, j);
+    for (auto _ : state)
+      {
+        benchmark::DoNotOptimize(map.find((i * 7919u) % (size * 7919u)));
+        i = (i + 12345u) % size;
+      }
+  }
+
+  void lookup_relocatable(benchmark::State &state)
+  {
+    auto const size = static_cast<std::uint64_t>(state.range(0));
+    auto const map = claws::relocatable_arena::attach(get_saved_block(size), block_size)->get_root<index_map>();
+    std::uint64_t i(0u);
+
+    for (auto _ : state)
+      {
+        benchmark::DoNotOptimize(map->find((i * 7919u) % (size * 7919u)));
+        i = (i + 12345u) % size;
+      }
+  }
+}
+
+BENCHMARK(restart_rebuild)->Arg(1 << 20);
+BENCHMARK(restart_attach)->Arg(1 << 20);
+BENCHMARK(lookup_unordered_map)->Arg(1 << 20);
+BENCHMARK(lookup_relocatable)->Arg(1 << 20);
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/slot_map.hpp>
+
+namespace
+{
+  struct entity_tag;
+
+  struct transform
+  {
+    float position[3];
+    float velocity[3];
+  };
+
+  using entity_map = claws::slot_map<transform, entity_tag>;
+  using entity = entity_map::key_type;
+
+  // Lookups go through the keys in random order, like systems touching entities referenced by other entities
+  template<class key_type>
+  std::vector<key_type> shuffled(std::vector<key_type> keys)
+  {
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    return keys;
+  }
+
+  void slot_map_lookup(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    entity_map map;
+    std::vector<entity> keys;
+
+    map.reserve(size);
+    for (std::size_t i(0u); i != size; ++i)
+      keys.push_back(map.insert({{float(i), 0.f, 0.f}, {1.f, 0.f, 0.f}}));
+    keys = shuffled(keys);
+    for (auto _ : state)
+      {
+        float sum = 0.f;
+
+        for (auto key : keys)
+          sum += map[key].position[0];
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void unordered_map_lookup(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    std::unordered_map<std::uint32_t, transform> map;
+    std::vector<std::uint32_t> keys;
+
+    map.reserve(size);
+    for (std::size_t i(0u); i != size; ++i)
+      {
+        map.emplace(static_cast<std::uint32_t>(i), transform{{float(i), 0.f, 0.f}, {1.f, 0.f, 0.f}});
+        keys.push_back(static_cast<std::uint32_t>(i));
+      }
+    keys = shuffled(keys);
+    for (auto _ : state)
+      {
+        float sum = 0.f;
+
+        for (auto key : keys)
+          sum += map.find(key)->second.position[0];
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void slot_map_iteration(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    entity_map map;
+
+    for (std::size_t i(0u); i != size; ++i)
+      map.insert({{float(i), 0.f, 0.f}, {1.f, 0.f, 0.f}});
+    for (auto _ : state)
+      {
+        for (auto &value : map)
+          for (int axis = 0; axis < 3; ++axis)
+            value.position[axis] += value.velocity[axis];
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void unordered_map_iteration(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    std::unordered_map<std::uint32_t, transform> map;
+
+    for (std::size_t i(0u); i != size; ++i)
+      map.emplace(static_cast<std::uint32_t>(i), transform{{float(i), 0.f, 0.f}, {1.f, 0.f, 0.f}});
+    for (auto _ : state)
+      {
+        for (auto &[key, value] : map)
+          for (int axis = 0; axis < 3; ++axis)
+            value.position[axis] += value.velocity[axis];
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // Erases and reinserts a tenth of the entities per iteration
+  void slot_map_churn(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    entity_map map;
+    std::vector<entity> keys;
+    std::mt19937 engine(42);
+
+    for (std::size_t i(0u); i != size; ++i)
+      keys.push_back(map.insert({}));
+    for (auto _ : state)
+      for (std::size_t i(0u); i != size / 10; ++i)
+        {
+          auto &key = keys[engine() % size];
+
+          map.erase(key);
+          key = map.insert({});
+        }
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 10);
+  }
+
+  void unordered_map_churn(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    std::unordered_map<std::uint32_t, transform> map;
+    std::vector<std::uint32_t> keys;
+    std::uint32_t next_key = 0;
+    std::mt19937 engine(42);
+
+    for (std::size_t i(0u); i != size; ++i)
+      {
+        keys.push_back(next_key);
+        map.emplace(next_key++, transform{});
+      }
+    for (auto _ : state)
+      for (std::size_t i(0u); i != size / 10; ++i)
+        {
+          auto &key = keys[engine() % size];
+
+          map.erase(key);
+          key = next_key;
+          map.emplace(next_key++, transform{});
+        }
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 10);
+  }
+}
+
+BENCHMARK(slot_map_lookup)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(unordered_map_lookup)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(slot_map_iteration)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(unordered_map_iteration)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(slot_map_churn)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(unordered_map_churn)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
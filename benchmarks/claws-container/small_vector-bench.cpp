@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/small_vector.hpp>
+#include <claws/container/static_vector.hpp>
+
+namespace
+{
+  // Counts the allocations of the containers using it
+  template<class T>
+  struct counting_allocator
+  {
+    using value_type = T;
+
+    static inline std::uint64_t allocations = 0u;
+
+    counting_allocator() noexcept = default;
+
+    template<class U>
+    counting_allocator(counting_allocator<U> const &) noexcept
+    {}
+
+    T *allocate(std::size_t count)
+    {
+      ++allocations;
+      return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *pointer, std::size_t count) noexcept
+    {
+      std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template<class U>
+    bool operator==(counting_allocator<U> const &) const noexcept
+    {
+      return true;
+    }
+
+    template<class U>
+    bool operator!=(counting_allocator<U> const &) const noexcept
+    {
+      return false;
+    }
+  };
+
+  // Per-node lists: mostly 0 to 8 values, occasionally up to 64
+  std::vector<std::uint32_t> list_sizes(std::size_t count)
+  {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::uint32_t> small(0u, 8u);
+    std::uniform_int_distribution<std::uint32_t> large(9u, 64u);
+    std::vector<std::uint32_t> sizes(count);
+
+    for (auto &size : sizes)
+      size = generator() % 32u ? small(generator) : large(generator);
+    return sizes;
+  }
+
+  // Builds one list per node, then sums them all
+  template<class list_type>
+  void build_lists(benchmark::State &state)
+  {
+    auto const sizes = list_sizes(static_cast<std::size_t>(state.range(0)));
+    auto const before = counting_allocator<std::uint32_t>::allocations;
+
+    for (auto _ : state)
+      {
+        std::vector<list_type> lists(sizes.size());
+        std::uint64_t sum(0u);
+
+        for (std::size_t node(0u); node != sizes.size(); ++node)
+          for (std::uint32_t i(0u); i != sizes[node]; ++i)
+            lists[node].push_back(i);
+        for (auto const &list : lists)
+          for (auto value : list)
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.counters["allocations_per_list"] = benchmark::Counter(double(counting_allocator<std::uint32_t>::allocations - before) / double(state.range(0)),
+                                                                benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void std_vector_lists(benchmark::State &state)
+  {
+    build_lists<std::vector<std::uint32_t, counting_allocator<std::uint32_t>>>(state);
+  }
+
+  void small_vector_lists(benchmark::State &state)
+  {
+    build_lists<claws::small_vector<std::uint32_t, 8, counting_allocator<std::uint32_t>>>(state);
+  }
+
+  // Scratch buffer on the stack, filled and drained in a loop
+  void std_vector_scratch(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        std::vector<int> scratch;
+
+        for (int i(0); i != 16; ++i)
+          scratch.push_back(i);
+        benchmark::DoNotOptimize(scratch.data());
+      }
+  }
+
+  void static_vector_scratch(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        claws::static_vector<int, 16> scratch;
+
+        for (int i(0); i != 16; ++i)
+          scratch.push_back(i);
+        benchmark::DoNotOptimize(scratch.data());
+      }
+  }
+
+  // Growth past the inline storage: relocating unique_ptrs is a memcpy
+  void std_vector_grow_unique_ptrs(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        std::vector<std::unique_ptr<int>> values;
+
+        for (int i(0); i != state.range(0); ++i)
+          values.emplace_back(nullptr);
+        benchmark::DoNotOptimize(values.data());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void small_vector_grow_unique_ptrs(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        claws::small_vector<std::unique_ptr<int>, 8> values;
+
+        for (int i(0); i != state.range(0); ++i)
+          values.emplace_back(nullptr);
+        benchmark::DoNotOptimize(values.data());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(std_vector_lists)->Arg(1 << 12);
+BENCHMARK(small_vector_lists)->Arg(1 << 12);
+BENCHMARK(std_vector_scratch);
+BENCHMARK(static_vector_scratch);
+BENCHMARK(std_vector_grow_unique_ptrs)->Arg(1 << 10);
+BENCHMARK(small_vector_grow_unique_ptrs)->Arg(1 << 10);
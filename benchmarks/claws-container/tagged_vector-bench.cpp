@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/tagged_vector.hpp>
+
+namespace
+{
+  constexpr std::size_t neighbor_count = 4;
+
+  struct node_tag;
+
+  using node_index = claws::tagged_index<node_tag>;
+
+  struct pointer_node
+  {
+    float weight;
+    pointer_node *neighbors[neighbor_count];
+  };
+
+  struct index_node
+  {
+    float weight;
+    node_index neighbors[neighbor_count];
+  };
+
+  std::vector<std::uint32_t> random_neighbors(std::size_t size)
+  {
+    std::vector<std::uint32_t> result(size * neighbor_count);
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::uint32_t> distribution(0u, static_cast<std::uint32_t>(size - 1u));
+
+    for (auto &neighbor : result)
+      neighbor = distribution(random);
+    return result;
+  }
+
+  // Sums the weights of every node's neighbors, through 8 bytes pointers
+  void graph_pointers(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const neighbors = random_neighbors(size);
+    std::vector<pointer_node> nodes(size);
+
+    for (std::size_t i(0u); i != size; ++i)
+      {
+        nodes[i].weight = static_cast<float>(i % 7u);
+        for (std::size_t j(0u); j != neighbor_count; ++j)
+          nodes[i].neighbors[j] = &nodes[neighbors[i * neighbor_count + j]];
+      }
+    for (auto _ : state)
+      {
+        float sum = 0.f;
+
+        for (auto const &node : nodes)
+          for (auto neighbor : node.neighbors)
+            sum += neighbor->weight;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size * neighbor_count));
+    state.counters["node_bytes"] = sizeof(pointer_node);
+  }
+
+  // Same, through 4 bytes tagged indices
+  void graph_tagged_indices(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const neighbors = random_neighbors(size);
+    claws::tagged_vector<node_tag, index_node> nodes(node_index(static_cast<std::uint32_t>(size)));
+
+    for (auto index : nodes.indices())
+      {
+        nodes[index].weight = static_cast<float>(index.data % 7u);
+        for (std::size_t j(0u); j != neighbor_count; ++j)
+          nodes[index].neighbors[j] = node_index(neighbors[index.data * neighbor_count + j]);
+      }
+    for (auto _ : state)
+      {
+        float sum = 0.f;
+
+        for (auto const &node : nodes)
+          for (auto neighbor : node.neighbors)
+            sum += nodes[neighbor].weight;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size * neighbor_count));
+    state.counters["node_bytes"] = sizeof(index_node);
+  }
+}
+
+BENCHMARK(graph_pointers)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(graph_tagged_indices)->Arg(1 << 12)->Arg(1 << 20);
@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/container/vect.hpp>
+
+namespace
+{
+  template<class T, std::size_t size>
+  std::vector<claws::vect<T, size>> make_input(std::size_t count, unsigned seed)
+  {
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+    std::vector<claws::vect<T, size>> result(count);
+
+    for (auto &value : result)
+      for (auto &component : value)
+        component = static_cast<T>(distribution(engine));
+    return result;
+  }
+
+  // Plain arrays running the same loops, the baseline `vect`'s operators should match
+  template<class T, std::size_t size>
+  struct raw_vect
+  {
+    T data[size];
+  };
+
+  template<class T, std::size_t size>
+  void raw_add(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const vects = make_input<T, size>(count, 1);
+    std::vector<raw_vect<T, size>> lh(count);
+    std::vector<raw_vect<T, size>> rh(count);
+    std::vector<raw_vect<T, size>> out(count);
+
+    for (std::size_t i(0u); i != count; ++i)
+      for (std::size_t j(0u); j != size; ++j)
+        lh[i].data[j] = rh[i].data[j] = vects[i][j];
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          for (std::size_t j(0u); j != size; ++j)
+            out[i].data[j] = lh[i].data[j] + rh[i].data[j];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void vect_add(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const lh = make_input<T, size>(count, 1);
+    auto const rh = make_input<T, size>(count, 2);
+    std::vector<claws::vect<T, size>> out(count);
+
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          out[i] = lh[i] + rh[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void vect_scale_in_place(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto values = make_input<T, size>(count, 1);
+
+    for (auto _ : state)
+      {
+        for (auto &value : values)
+          value *= T(1);
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void vect_scalar(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const lh = make_input<T, size>(count, 1);
+    auto const rh = make_input<T, size>(count, 2);
+
+    for (auto _ : state)
+      {
+        T sum{};
+
+        for (std::size_t i(0u); i != count; ++i)
+          sum += lh[i].scalar(rh[i]);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void vect_normalized(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const values = make_input<T, size>(count, 1);
+    std::vector<claws::vect<T, size>> out(count);
+
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          out[i] = values[i].normalized();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template<class T, std::size_t size>
+  void vect_compare(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const lh = make_input<T, size>(count, 1);
+    auto const rh = make_input<T, size>(count, 2);
+
+    for (auto _ : state)
+      {
+        std::size_t less = 0;
+
+        for (std::size_t i(0u); i != count; ++i)
+          less += lh[i] < rh[i];
+        benchmark::DoNotOptimize(less);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+#define CLAWS_VECT_BENCH(TYPE, SIZE)                                                                   \
+  BENCHMARK_TEMPLATE(raw_add, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);             \
+  BENCHMARK_TEMPLATE(vect_add, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);            \
+  BENCHMARK_TEMPLATE(vect_scale_in_place, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14); \
+  BENCHMARK_TEMPLATE(vect_scalar, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);         \
+  BENCHMARK_TEMPLATE(vect_normalized, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);     \
+  BENCHMARK_TEMPLATE(vect_compare, TYPE, SIZE)->RangeMultiplier(16)->Range(1 << 6, 1 << 14)
+
+CLAWS_VECT_BENCH(float, 3);
+CLAWS_VECT_BENCH(float, 4);
+CLAWS_VECT_BENCH(double, 3);
+
+#undef CLAWS_VECT_BENCH
@@ -0,0 +1,47 @@
+#include <cstdint>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/io/binary_format.hpp>
+
+namespace
+{
+  constexpr std::size_t value_count = 1u << 20u;
+
+  using element = claws::vect<float, 3>;
+
+  std::vector<std::byte> make_buffer()
+  {
+    std::vector<element> values(value_count, element{1.f, 2.f, 3.f});
+    std::vector<std::byte> buffer(claws::binary_size<element>(value_count));
+
+    claws::write_binary(buffer.data(), buffer.size(), values.data(), values.size());
+    return buffer;
+  }
+
+  // Matching host: only the header is read
+  void view_native(benchmark::State &state)
+  {
+    auto const buffer = make_buffer();
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::view_binary<element>(buffer.data(), buffer.size()).begin());
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(buffer.size()));
+  }
+
+  // Host of opposite endianness: the payload is byte swapped as 32 bit words
+  void swap_bulk(benchmark::State &state)
+  {
+    auto buffer = make_buffer();
+    auto const payload = buffer.data() + claws::binary_size<element>(0u);
+
+    for (auto _ : state)
+      {
+        claws::impl::binary::swap_elements<element>(payload, value_count);
+        benchmark::DoNotOptimize(buffer.data());
+      }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(value_count * sizeof(element)));
+  }
+}
+
+BENCHMARK(view_native);
+BENCHMARK(swap_bulk);
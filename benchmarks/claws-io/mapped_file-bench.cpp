@@ -0,0 +1,88 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include <claws/io/mapped_file.hpp>
+
+namespace
+{
+  constexpr std::size_t file_size = std::size_t(16u) << 20u;
+
+  /// A file shared by the benchmarks, in the page cache after the first run
+  std::string const &get_file_path()
+  {
+    static struct file
+    {
+      std::string path = "/tmp/claws-bench-" + std::to_string(::getpid());
+
+      file()
+      {
+        std::ofstream out(path, std::ios::binary);
+        std::string block(4096u, 'x');
+
+        for (std::size_t i(0u); i != file_size / block.size(); ++i)
+          {
+            block[i % block.size()] = '\n';
+            out << block;
+          }
+      }
+
+      ~file()
+      {
+        std::remove(path.c_str());
+      }
+    } file;
+
+    return file.path;
+  }
+
+  std::size_t count_lines(char const *data, std::size_t size)
+  {
+    std::size_t lines(0u);
+
+    for (std::size_t i(0u); i != size; ++i)
+      lines += data[i] == '\n';
+    return lines;
+  }
+
+  // Copies the file into a buffer before reading it
+  void load_ifstream(benchmark::State &state)
+  {
+    auto const &path = get_file_path();
+
+    for (auto _ : state)
+      {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> buffer(file_size);
+
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        benchmark::DoNotOptimize(count_lines(buffer.data(), static_cast<std::size_t>(in.gcount())));
+      }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(file_size));
+  }
+
+  // Reads the page cache in place
+  void load_mapped_file(benchmark::State &state)
+  {
+    auto const &path = get_file_path();
+
+    for (auto _ : state)
+      {
+        auto file = claws::mapped_file::open(path.c_str());
+
+        file.advise(claws::map_advice::sequential);
+        benchmark::DoNotOptimize(count_lines(file.chars().data(), file.size()));
+      }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(file_size));
+  }
+}
+
+BENCHMARK(load_ifstream);
+BENCHMARK(load_mapped_file);
+
+#endif
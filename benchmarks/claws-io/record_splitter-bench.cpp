@@ -0,0 +1,101 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include <claws/io/record_splitter.hpp>
+
+namespace
+{
+  constexpr std::size_t buffer_size = std::size_t(16u) << 20u;
+
+  /// CSV-like lines of 20 to 120 bytes, some with quoted fields holding newlines
+  std::string const &get_buffer()
+  {
+    static std::string const buffer = []() {
+      std::string result;
+      std::mt19937 random(42);
+      std::uniform_int_distribution<std::size_t> length(20u, 120u);
+
+      result.reserve(buffer_size + 128u);
+      while (result.size() < buffer_size)
+        {
+          result.append(length(random), 'x');
+          if (random() % 8u == 0u)
+            result += ",\"quoted\nfield\"";
+          result += '\n';
+        }
+      return result;
+    }();
+
+    return buffer;
+  }
+
+  // One comparison per byte, tracking quotes
+  void split_bytewise(benchmark::State &state)
+  {
+    std::string_view const buffer = get_buffer();
+
+    for (auto _ : state)
+      {
+        std::size_t records(0u);
+        std::size_t length(0u);
+        std::size_t start(0u);
+        bool quoted = false;
+
+        for (std::size_t i(0u); i != buffer.size(); ++i)
+          if (buffer[i] == '"')
+            quoted = !quoted;
+          else if (buffer[i] == '\n' && !quoted)
+            {
+              ++records;
+              length += i - start;
+              start = i + 1;
+            }
+        benchmark::DoNotOptimize(records);
+        benchmark::DoNotOptimize(length);
+      }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(buffer.size()));
+  }
+
+  void split_simd(benchmark::State &state)
+  {
+    std::string_view const buffer = get_buffer();
+
+    for (auto _ : state)
+      {
+        std::size_t records(0u);
+        std::size_t length(0u);
+
+        for (auto record : claws::split_records(buffer, claws::csv_records))
+          {
+            ++records;
+            length += record.size();
+          }
+        benchmark::DoNotOptimize(records);
+        benchmark::DoNotOptimize(length);
+      }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(buffer.size()));
+  }
+
+  void split_parallel(benchmark::State &state)
+  {
+    std::string_view const buffer = get_buffer();
+
+    for (auto _ : state)
+      {
+        std::atomic<std::size_t> length(0u);
+
+        claws::for_each_record_parallel(buffer, claws::csv_records, static_cast<unsigned>(state.range(0)), [&](std::string_view record) {
+          length.fetch_add(record.size(), std::memory_order_relaxed);
+        });
+        benchmark::DoNotOptimize(length.load());
+      }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(buffer.size()));
+  }
+}
+
+BENCHMARK(split_bytewise);
+BENCHMARK(split_simd);
+BENCHMARK(split_parallel)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/io/text_codec.hpp>
+
+namespace
+{
+  constexpr std::size_t value_count = 1u << 16u;
+
+  std::vector<claws::vect<float, 3>> const &get_vects()
+  {
+    static std::vector<claws::vect<float, 3>> const vects = []() {
+      std::vector<claws::vect<float, 3>> result(value_count);
+      std::mt19937 random(42);
+      std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+
+      for (auto &vect : result)
+        vect = claws::vect<float, 3>{distribution(random), distribution(random), distribution(random)};
+      return result;
+    }();
+
+    return vects;
+  }
+
+  std::vector<std::int64_t> const &get_integers()
+  {
+    static std::vector<std::int64_t> const integers = []() {
+      std::vector<std::int64_t> result(value_count);
+      std::mt19937_64 random(42);
+
+      for (auto &integer : result)
+        integer = static_cast<std::int64_t>(random()) >> (random() % 48u);
+      return result;
+    }();
+
+    return integers;
+  }
+
+  template<class T>
+  std::string const &get_text(std::vector<T> const &values)
+  {
+    static std::string const text = [&]() {
+      std::string result;
+
+      claws::append_text(result, values.data(), values.size());
+      return result;
+    }();
+
+    return text;
+  }
+
+  void write_vects_ostream(benchmark::State &state)
+  {
+    auto const &vects = get_vects();
+
+    for (auto _ : state)
+      {
+        std::ostringstream out;
+
+        out.precision(9);
+        for (auto const &vect : vects)
+          out << vect.x() << ' ' << vect.y() << ' ' << vect.z() << '\n';
+        benchmark::DoNotOptimize(out.str().size());
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(value_count));
+  }
+
+  void write_vects_to_chars(benchmark::State &state)
+  {
+    auto const &vects = get_vects();
+    std::string buffer(claws::text_capacity<claws::vect<float, 3>>(vects.size()), '\0');
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::write_text(buffer.data(), buffer.data() + buffer.size(), vects.data(), vects.size()).ptr);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(value_count));
+  }
+
+  void parse_vects_strtof(benchmark::State &state)
+  {
+    auto const &text = get_text(get_vects());
+    std::vector<claws::vect<float, 3>> vects(value_count);
+
+    for (auto _ : state)
+      {
+        char const *ptr = text.c_str();
+
+        for (auto &vect : vects)
+          for (auto &component : vect)
+            {
+              char *end;
+
+              component = std::strtof(ptr, &end);
+              ptr = end;
+            }
+        benchmark::DoNotOptimize(vects.data());
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(value_count));
+  }
+
+  void parse_vects_from_chars(benchmark::State &state)
+  {
+    auto const &text = get_text(get_vects());
+    std::vector<claws::vect<float, 3>> vects(value_count);
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::parse_text(text.data(), text.data() + text.size(), vects.data(), vects.size()).count);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(value_count));
+  }
+
+  void parse_integers_strtoll(benchmark::State &state)
+  {
+    auto const &text = get_text(get_integers());
+    std::vector<std::int64_t> integers(value_count);
+
+    for (auto _ : state)
+      {
+        char const *ptr = text.c_str();
+
+        for (auto &integer : integers)
+          {
+            char *end;
+
+            integer = std::strtoll(ptr, &end, 10);
+            ptr = end;
+          }
+        benchmark::DoNotOptimize(integers.data());
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(value_count));
+  }
+
+  void parse_integers_swar(benchmark::State &state)
+  {
+    auto const &text = get_text(get_integers());
+    std::vector<std::int64_t> integers(value_count);
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(claws::parse_text(text.data(), text.data() + text.size(), integers.data(), integers.size()).count);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(value_count));
+  }
+}
+
+BENCHMARK(write_vects_ostream);
+BENCHMARK(write_vects_to_chars);
+BENCHMARK(parse_vects_strtof);
+BENCHMARK(parse_vects_from_chars);
+BENCHMARK(parse_integers_strtoll);
+BENCHMARK(parse_integers_swar);
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/iterator/circular_iterator.hpp>
+
+namespace
+{
+  // Every benchmark walks `steps` elements of a ring of `range(0)` elements, wrapping around many times
+  constexpr std::size_t steps = 1 << 16;
+
+  std::vector<std::uint32_t> make_ring(std::size_t size)
+  {
+    std::vector<std::uint32_t> result(size);
+
+    std::iota(result.begin(), result.end(), 0u);
+    return result;
+  }
+
+  void modulo_index(benchmark::State &state)
+  {
+    auto const ring = make_ring(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (std::size_t i(0u); i != steps; ++i)
+          sum += ring[i % ring.size()];
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(steps));
+  }
+
+  void wrapping_index(benchmark::State &state)
+  {
+    auto const ring = make_ring(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+        std::size_t index = 0;
+
+        for (std::size_t i(0u); i != steps; ++i)
+          {
+            sum += ring[index];
+            if (++index == ring.size())
+              index = 0;
+          }
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(steps));
+  }
+
+  void circular_iterator(benchmark::State &state)
+  {
+    auto const ring = make_ring(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+        auto it = claws::get_circular_iterator(ring);
+
+        for (std::size_t i(0u); i != steps; ++i, ++it)
+          sum += *it;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(steps));
+  }
+}
+
+BENCHMARK(modulo_index)->Arg(7)->Arg(64)->Arg(1000);
+BENCHMARK(wrapping_index)->Arg(7)->Arg(64)->Arg(1000);
+BENCHMARK(circular_iterator)->Arg(7)->Arg(64)->Arg(1000);
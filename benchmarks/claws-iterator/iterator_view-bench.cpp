@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/iterator/iterator_view.hpp>
+
+namespace
+{
+  std::vector<std::uint32_t> make_input(std::size_t size)
+  {
+    std::vector<std::uint32_t> result(size);
+
+    std::iota(result.begin(), result.end(), 0u);
+    return result;
+  }
+
+  constexpr auto transform = [](std::uint32_t value) noexcept { return value * 3u + 1u; };
+
+  void raw_iteration(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (auto it = input.begin(); it != input.end(); ++it)
+          sum += transform(*it);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void iterator_view_iteration(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+        auto const end = claws::iterator_view(input.end(), transform);
+
+        for (auto it = claws::iterator_view(input.begin(), transform); it != end; ++it)
+          sum += *it;
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void iterator_view_random_access(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+    auto const begin = claws::iterator_view(input.begin(), transform);
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        // Strided walk, exercising `operator[]` rather than increments
+        for (std::size_t i(0u); i != input.size(); ++i)
+          sum += begin[(i * 7u) % input.size()];
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(raw_iteration)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK(iterator_view_iteration)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK(iterator_view_random_access)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,102 @@
+#if defined(__linux__)
+
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include <claws/utils/handle_array.hpp>
+#include <claws/utils/handle_types.hpp>
+
+namespace
+{
+  /// File descriptors, -1 when empty
+  struct fd
+  {
+    int value{-1};
+
+    bool operator==(fd const &other) const noexcept
+    {
+      return value == other.value;
+    }
+  };
+
+  struct fd_closer
+  {
+    void operator()(fd value) const noexcept
+    {
+      if (value.value != -1)
+        ::close(value.value);
+    }
+  };
+
+  /// Closes runs of consecutive descriptors with a single close_range
+  struct fd_batch_closer
+  {
+    void operator()(fd *values, std::size_t count) const noexcept
+    {
+      for (std::size_t first(0u); first != count;)
+        {
+          auto last = first + 1;
+
+          for (; last != count && values[last].value == values[last - 1].value + 1; ++last)
+            ;
+          ::close_range(static_cast<unsigned>(values[first].value), static_cast<unsigned>(values[last - 1].value), 0);
+          first = last;
+        }
+    }
+  };
+
+  int open_null()
+  {
+    return ::open("/dev/null", O_RDONLY);
+  }
+
+  // Descriptors are allocated lowest first, so dups of one descriptor are mostly consecutive
+  std::size_t dup_fds(fd *values, std::size_t count, int source)
+  {
+    std::size_t created(0u);
+
+    for (; created != count; ++created)
+      if ((values[created].value = ::dup(source)) == -1)
+        break;
+    return created;
+  }
+
+  void fd_handles_teardown(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const source = open_null();
+
+    for (auto _ : state)
+      {
+        std::vector<claws::handle<fd, fd_closer>> fds;
+
+        fds.reserve(count);
+        for (std::size_t i(0u); i != count; ++i)
+          fds.emplace_back(fd_closer{}, fd{::dup(source)});
+      }
+    ::close(source);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void fd_handle_array_teardown(benchmark::State &state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const source = open_null();
+
+    for (auto _ : state)
+      {
+        claws::handle_array<fd, fd_batch_closer> fds;
+
+        fds.create(count, [source](fd *values, std::size_t size) { return dup_fds(values, size, source); });
+      }
+    ::close(source);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+// Stays well below the usual 1024 descriptors soft limit
+BENCHMARK(fd_handles_teardown)->Arg(64)->Arg(512);
+BENCHMARK(fd_handle_array_teardown)->Arg(64)->Arg(512);
+
+#endif
@@ -0,0 +1,84 @@
+#include <memory>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/utils/handle_types.hpp>
+
+namespace
+{
+  struct int_deleter
+  {
+    void operator()(int *value) const noexcept
+    {
+      delete value;
+    }
+  };
+
+  using int_handle = claws::handle<int *, int_deleter>;
+
+  template<class owner>
+  owner make_owner(int value)
+  {
+    if constexpr (std::is_same_v<owner, int_handle>)
+      return int_handle(int_deleter{}, new int(value));
+    else
+      return owner(new int(value));
+  }
+
+  // Allocation and destruction, dominated by the allocator for both
+  template<class owner>
+  void create_destroy(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        auto value = make_owner<owner>(1);
+
+        benchmark::DoNotOptimize(value);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Moves every owner to the other vector and back, destroying the emptied moved-from owners on assignment
+  template<class owner>
+  void move_assign(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    std::vector<owner> lh;
+    std::vector<owner> rh(size);
+
+    lh.reserve(size);
+    for (std::size_t i(0u); i != size; ++i)
+      lh.push_back(make_owner<owner>(static_cast<int>(i)));
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != size; ++i)
+          rh[i] = std::move(lh[i]);
+        for (std::size_t i(0u); i != size; ++i)
+          lh[i] = std::move(rh[i]);
+        benchmark::ClobberMemory();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+  }
+
+  // Destroying empty owners: the deleter still runs on the empty value for a handle
+  template<class owner>
+  void destroy_empty(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+      {
+        std::vector<owner> owners(size);
+
+        benchmark::DoNotOptimize(owners.data());
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK_TEMPLATE(create_destroy, int_handle);
+BENCHMARK_TEMPLATE(create_destroy, std::unique_ptr<int>);
+BENCHMARK_TEMPLATE(move_assign, int_handle)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);
+BENCHMARK_TEMPLATE(move_assign, std::unique_ptr<int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);
+BENCHMARK_TEMPLATE(destroy_empty, int_handle)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);
+BENCHMARK_TEMPLATE(destroy_empty, std::unique_ptr<int>)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);
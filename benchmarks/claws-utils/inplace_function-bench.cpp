@@ -0,0 +1,108 @@
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/utils/function_ref.hpp>
+#include <claws/utils/inplace_function.hpp>
+
+namespace
+{
+  // 32 bytes of captures: past std::function's inline buffer in libstdc++
+  struct weights
+  {
+    std::uint32_t values[8];
+  };
+
+  weights make_weights() noexcept
+  {
+    weights result;
+
+    std::iota(std::begin(result.values), std::end(result.values), 1u);
+    return result;
+  }
+
+  auto make_weighting(weights const &captured) noexcept
+  {
+    return [captured](std::uint32_t value) { return value * captured.values[value & 7u]; };
+  }
+
+  // Calls go through a function not inlined into the loop, like a callback stored by a library
+  template<class function_type>
+  [[gnu::noinline]] std::uint32_t sum_calls(function_type const &function, std::uint32_t count)
+  {
+    std::uint32_t sum(0u);
+
+    for (std::uint32_t i(0u); i != count; ++i)
+      sum += function(i);
+    return sum;
+  }
+
+  void std_function_call(benchmark::State &state)
+  {
+    std::function<std::uint32_t(std::uint32_t)> const function = make_weighting(make_weights());
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(sum_calls(function, 1024u));
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void function_ref_call(benchmark::State &state)
+  {
+    auto const weighting = make_weighting(make_weights());
+    claws::function_ref<std::uint32_t(std::uint32_t)> const function = weighting;
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(sum_calls(function, 1024u));
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void inplace_function_call(benchmark::State &state)
+  {
+    claws::inplace_function<std::uint32_t(std::uint32_t)> const function = make_weighting(make_weights());
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(sum_calls(function, 1024u));
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  // Storing callbacks in a container, like an event queue
+  void std_function_construction(benchmark::State &state)
+  {
+    auto const captured = make_weights();
+    std::vector<std::function<std::uint32_t(std::uint32_t)>> callbacks;
+
+    callbacks.reserve(256u);
+    for (auto _ : state)
+      {
+        for (int i(0); i != 256; ++i)
+          callbacks.emplace_back(make_weighting(captured));
+        benchmark::DoNotOptimize(callbacks.data());
+        callbacks.clear();
+      }
+    state.SetItemsProcessed(state.iterations() * 256);
+  }
+
+  void inplace_function_construction(benchmark::State &state)
+  {
+    auto const captured = make_weights();
+    std::vector<claws::inplace_function<std::uint32_t(std::uint32_t)>> callbacks;
+
+    callbacks.reserve(256u);
+    for (auto _ : state)
+      {
+        for (int i(0); i != 256; ++i)
+          callbacks.emplace_back(make_weighting(captured));
+        benchmark::DoNotOptimize(callbacks.data());
+        callbacks.clear();
+      }
+    state.SetItemsProcessed(state.iterations() * 256);
+  }
+}
+
+BENCHMARK(std_function_call);
+BENCHMARK(function_ref_call);
+BENCHMARK(inplace_function_call);
+BENCHMARK(std_function_construction);
+BENCHMARK(inplace_function_construction);
@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/utils/lambda_ops.hpp>
+
+namespace
+{
+  std::vector<std::uint32_t> make_input(std::size_t size)
+  {
+    std::vector<std::uint32_t> result(size);
+
+    std::iota(result.begin(), result.end(), 0u);
+    return result;
+  }
+
+  constexpr auto add_one = [](std::uint32_t value) { return value + 1u; };
+  constexpr auto times_three = [](std::uint32_t value) { return value * 3u; };
+  constexpr auto mix = [](std::uint32_t value) { return value ^ (value >> 7u); };
+
+  // `lambda_ops::operator*` should compile down to the hand-written composition
+  void hand_written_composition(benchmark::State &state)
+  {
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+    auto const composed = [](std::uint32_t value) { return mix(times_three(add_one(value))); };
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (auto value : input)
+          sum += composed(value);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void lambda_ops_composition(benchmark::State &state)
+  {
+    using namespace claws::lambda_ops;
+
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+    auto const composed = mix * times_three * add_one;
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (auto value : input)
+          sum += composed(value);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // `lambda_ops::operator+` overload sets resolve statically, like a hand-written overloaded functor
+  void lambda_ops_overload(benchmark::State &state)
+  {
+    using namespace claws::lambda_ops;
+
+    auto const input = make_input(static_cast<std::size_t>(state.range(0)));
+    auto const overloaded = [](std::uint32_t value) { return value * 3u; } + [](float value) { return static_cast<std::uint32_t>(value); };
+
+    for (auto _ : state)
+      {
+        std::uint32_t sum = 0;
+
+        for (auto value : input)
+          sum += overloaded(value) + overloaded(static_cast<float>(value & 0xFFu));
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(hand_written_composition)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK(lambda_ops_composition)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK(lambda_ops_overload)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,77 @@
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/utils/shared_handle.hpp>
+
+namespace
+{
+  struct widget
+  {
+    int value[4];
+  };
+
+  using atomic_widget = claws::shared_handle<widget, claws::forget, claws::atomic_count>;
+  using local_widget = claws::shared_handle<widget, claws::forget, claws::local_count>;
+
+  template<class owner>
+  owner make_owner()
+  {
+    if constexpr (std::is_same_v<owner, std::shared_ptr<widget>>)
+      return std::make_shared<widget>();
+    else
+      return claws::make_shared_handle<widget, typename owner::count_policy>();
+  }
+
+  // Creation and destruction of the last owner: one allocation for all three
+  template<class owner>
+  void shared_create_destroy(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        auto value = make_owner<owner>();
+
+        benchmark::DoNotOptimize(value);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Separate control block allocation for std::shared_ptr, as when adopting a raw pointer
+  void shared_ptr_adopt_destroy(benchmark::State &state)
+  {
+    for (auto _ : state)
+      {
+        std::shared_ptr<widget> value(new widget{});
+
+        benchmark::DoNotOptimize(value);
+      }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  // Copies then destroys many owners of one value, as when handing a resource to many consumers
+  template<class owner>
+  void shared_copy_destroy(benchmark::State &state)
+  {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const value = make_owner<owner>();
+    std::vector<owner> copies;
+
+    copies.reserve(size);
+    for (auto _ : state)
+      {
+        for (std::size_t i(0u); i != size; ++i)
+          copies.push_back(value);
+        benchmark::DoNotOptimize(copies.data());
+        copies.clear();
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK_TEMPLATE(shared_create_destroy, atomic_widget);
+BENCHMARK_TEMPLATE(shared_create_destroy, local_widget);
+BENCHMARK_TEMPLATE(shared_create_destroy, std::shared_ptr<widget>);
+BENCHMARK(shared_ptr_adopt_destroy);
+BENCHMARK_TEMPLATE(shared_copy_destroy, atomic_widget)->Arg(1024);
+BENCHMARK_TEMPLATE(shared_copy_destroy, local_widget)->Arg(1024);
+BENCHMARK_TEMPLATE(shared_copy_destroy, std::shared_ptr<widget>)->Arg(1024);
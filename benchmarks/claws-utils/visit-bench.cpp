@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <random>
+#include <variant>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <claws/utils/lambda_ops.hpp>
+#include <claws/utils/visit.hpp>
+
+namespace
+{
+  struct ping
+  {
+    std::uint32_t sequence;
+  };
+
+  struct data
+  {
+    std::uint32_t size;
+    std::uint32_t checksum;
+  };
+
+  struct ack
+  {
+    std::uint32_t sequence;
+  };
+
+  struct close
+  {
+    std::uint32_t reason;
+  };
+
+  using message = std::variant<ping, data, ack, close>;
+
+  // Messages of random kinds, so the dispatch branch can't be predicted from the previous one
+  std::vector<message> make_messages(std::size_t count)
+  {
+    std::mt19937 generator(42);
+    std::vector<message> result;
+
+    result.reserve(count);
+    for (std::uint32_t i(0u); i != count; ++i)
+      switch (generator() % 4u)
+        {
+        case 0:
+          result.emplace_back(ping{i});
+          break;
+        case 1:
+          result.emplace_back(data{i, i * 7u});
+          break;
+        case 2:
+          result.emplace_back(ack{i});
+          break;
+        default:
+          result.emplace_back(close{i});
+        }
+    return result;
+  }
+
+  auto make_handler(std::uint64_t &sum)
+  {
+    using namespace claws::lambda_ops;
+
+    return [&sum](ping const &value) { sum += value.sequence; } + [&sum](data const &value) { sum += value.size ^ value.checksum; }
+      + [&sum](ack const &value) { sum -= value.sequence; } + [&sum](close const &value) { sum *= value.reason | 1u; };
+  }
+
+  void std_visit(benchmark::State &state)
+  {
+    auto const messages = make_messages(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+        auto const handler = make_handler(sum);
+
+        for (auto const &value : messages)
+          std::visit(handler, value);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void claws_visit(benchmark::State &state)
+  {
+    auto const messages = make_messages(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+        auto const handler = make_handler(sum);
+
+        for (auto const &value : messages)
+          claws::visit(handler, value);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void claws_visit_grouped(benchmark::State &state)
+  {
+    auto const messages = make_messages(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+
+        claws::visit_grouped(make_handler(sum), messages.begin(), messages.end());
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // Two variants: 16 combinations
+  void std_visit_pairs(benchmark::State &state)
+  {
+    auto const lh = make_messages(static_cast<std::size_t>(state.range(0)));
+    auto const rh = make_messages(static_cast<std::size_t>(state.range(0)) + 1u);
+
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+
+        for (std::size_t i(0u); i != lh.size(); ++i)
+          sum += std::visit([](auto const &a, auto const &b) { return sizeof(a) * 3u + sizeof(b); }, lh[i], rh[i + 1u]);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void claws_visit_pairs(benchmark::State &state)
+  {
+    auto const lh = make_messages(static_cast<std::size_t>(state.range(0)));
+    auto const rh = make_messages(static_cast<std::size_t>(state.range(0)) + 1u);
+
+    for (auto _ : state)
+      {
+        std::uint64_t sum(0u);
+
+        for (std::size_t i(0u); i != lh.size(); ++i)
+          sum += claws::visit([](auto const &a, auto const &b) { return sizeof(a) * 3u + sizeof(b); }, lh[i], rh[i + 1u]);
+        benchmark::DoNotOptimize(sum);
+      }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+BENCHMARK(std_visit)->Arg(1 << 12);
+BENCHMARK(claws_visit)->Arg(1 << 12);
+BENCHMARK(claws_visit_grouped)->Arg(1 << 12);
+BENCHMARK(std_visit_pairs)->Arg(1 << 12);
+BENCHMARK(claws_visit_pairs)->Arg(1 << 12);
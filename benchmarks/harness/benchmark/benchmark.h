@@ -0,0 +1,722 @@
+///
+/// Minimal stand-in for Google Benchmark, used to build `claws-bench` when the library isn't installed.
+///
+/// Only the subset claws' benchmarks rely on is provided:
+/// - `benchmark::State` with range-for iteration, `range`, `iterations`, `threads`, `thread_index`,
+///   `PauseTiming`, `ResumeTiming`, `SetItemsProcessed`, `SetBytesProcessed` and `counters`
+/// - `benchmark::Counter`, summed over threads then scaled by its flags, and reported next to the timings
+/// - `DoNotOptimize` and `ClobberMemory`
+/// - `BENCHMARK`, `BENCHMARK_TEMPLATE` and `BENCHMARK_MAIN`, with `Arg`, `Args`, `ArgName`, `ArgNames`, `Range`, `RangeMultiplier`,
+///   `DenseRange`, `Threads`, `ThreadRange` and `UseRealTime`
+/// - `--benchmark_filter`, `--benchmark_min_time`, `--benchmark_format`, `--benchmark_out` and `--benchmark_out_format`
+///
+/// JSON reports follow Google Benchmark's layout, so results of both harnesses can be compared with the same tools.
+///
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace benchmark
+{
+  class State;
+
+  namespace internal
+  {
+    struct runner;
+  }
+
+  template<class T>
+  inline void DoNotOptimize(T const &value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static std::atomic<void const *> sink;
+
+    sink.store(&value, std::memory_order_relaxed);
+#endif
+  }
+
+  template<class T>
+  inline void DoNotOptimize(T &value)
+  {
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#elif defined(__GNUC__)
+    // GCC rejects the register alternative first for values that don't fit in one
+    asm volatile("" : "+m,r"(value) : : "memory");
+#else
+    static std::atomic<void const *> sink;
+
+    sink.store(&value, std::memory_order_relaxed);
+#endif
+  }
+
+  inline void ClobberMemory()
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+  namespace internal
+  {
+    using clock = std::chrono::steady_clock;
+
+    inline double cpu_seconds() noexcept
+    {
+      return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    }
+  }
+
+  ///
+  /// \brief User counter, set through `State::counters`.
+  ///
+  class Counter
+  {
+  public:
+    /// Applied in Google Benchmark's order: divided by the seconds, by the threads, multiplied then divided by the iterations
+    enum Flags
+    {
+      kDefaults = 0,
+      kIsRate = 1 << 0,
+      kAvgThreads = 1 << 1,
+      kAvgThreadsRate = kIsRate | kAvgThreads,
+      kIsIterationInvariant = 1 << 2,
+      kIsIterationInvariantRate = kIsRate | kIsIterationInvariant,
+      kAvgIterations = 1 << 3,
+      kAvgIterationsRate = kIsRate | kAvgIterations
+    };
+
+    double value;
+    Flags flags;
+
+    Counter(double value = 0.0, Flags flags = kDefaults) noexcept
+      : value(value)
+      , flags(flags)
+    {}
+
+    operator double const &() const noexcept
+    {
+      return value;
+    }
+
+    operator double &() noexcept
+    {
+      return value;
+    }
+  };
+
+  using UserCounters = std::map<std::string, Counter>;
+
+  class State
+  {
+    std::int64_t max_iterations;
+    std::vector<std::int64_t> ranges;
+    int thread_count;
+    int thread_id;
+
+    internal::clock::time_point started;
+    double elapsed{0.0};
+    bool running{false};
+
+    std::int64_t items_processed{0};
+    std::int64_t bytes_processed{0};
+
+  public:
+    UserCounters counters;
+
+    class StateIterator
+    {
+      State *state;
+      std::int64_t remaining;
+
+    public:
+      // Keeps `for (auto _ : state)` free of unused variable warnings
+#if defined(__GNUC__) || defined(__clang__)
+      struct __attribute__((unused)) Value
+      {};
+#else
+      struct Value
+      {};
+#endif
+
+      StateIterator(State *state, std::int64_t remaining) noexcept
+        : state(state)
+        , remaining(remaining)
+      {}
+
+      Value operator*() const noexcept
+      {
+        return {};
+      }
+
+      StateIterator &operator++() noexcept
+      {
+        --remaining;
+        return *this;
+      }
+
+      bool operator!=(StateIterator const &) noexcept
+      {
+        if (remaining > 0)
+          return true;
+        state->PauseTiming();
+        return false;
+      }
+    };
+
+    State(std::int64_t max_iterations, std::vector<std::int64_t> ranges, int thread_count, int thread_id)
+      : max_iterations(max_iterations)
+      , ranges(std::move(ranges))
+      , thread_count(thread_count)
+      , thread_id(thread_id)
+    {}
+
+    StateIterator begin()
+    {
+      ResumeTiming();
+      return {this, max_iterations};
+    }
+
+    StateIterator end()
+    {
+      return {this, 0};
+    }
+
+    void PauseTiming()
+    {
+      if (running)
+        elapsed += std::chrono::duration<double>(internal::clock::now() - started).count();
+      running = false;
+    }
+
+    void ResumeTiming()
+    {
+      started = internal::clock::now();
+      running = true;
+    }
+
+    std::int64_t range(std::size_t index = 0) const
+    {
+      return ranges.at(index);
+    }
+
+    std::int64_t iterations() const noexcept
+    {
+      return max_iterations;
+    }
+
+    int threads() const noexcept
+    {
+      return thread_count;
+    }
+
+    int thread_index() const noexcept
+    {
+      return thread_id;
+    }
+
+    void SetItemsProcessed(std::int64_t items) noexcept
+    {
+      items_processed = items;
+    }
+
+    void SetBytesProcessed(std::int64_t bytes) noexcept
+    {
+      bytes_processed = bytes;
+    }
+
+    double timed_seconds() const noexcept
+    {
+      return elapsed;
+    }
+
+    std::int64_t items() const noexcept
+    {
+      return items_processed;
+    }
+
+    std::int64_t bytes() const noexcept
+    {
+      return bytes_processed;
+    }
+  };
+
+  namespace internal
+  {
+    using function = void (*)(State &);
+
+    class Benchmark
+    {
+      std::string name;
+      function run;
+      std::vector<std::vector<std::int64_t>> argument_sets;
+      std::vector<std::string> argument_names;
+      std::vector<int> thread_counts;
+      int range_multiplier{8};
+      bool use_real_time{false};
+
+    public:
+      Benchmark(std::string name, function run)
+        : name(std::move(name))
+        , run(run)
+      {}
+
+      Benchmark *Arg(std::int64_t value)
+      {
+        argument_sets.push_back({value});
+        return this;
+      }
+
+      Benchmark *Args(std::vector<std::int64_t> values)
+      {
+        argument_sets.push_back(std::move(values));
+        return this;
+      }
+
+      /// Runs are named `name/arg_name:value` instead of `name/value`
+      Benchmark *ArgName(std::string name)
+      {
+        argument_names = {std::move(name)};
+        return this;
+      }
+
+      Benchmark *ArgNames(std::vector<std::string> names)
+      {
+        argument_names = std::move(names);
+        return this;
+      }
+
+      Benchmark *RangeMultiplier(int multiplier)
+      {
+        range_multiplier = multiplier;
+        return this;
+      }
+
+      /// `low`, every power of the range multiplier in between, and `high`
+      Benchmark *Range(std::int64_t low, std::int64_t high)
+      {
+        Arg(low);
+        for (std::int64_t value = 1; value < high; value *= range_multiplier)
+          if (value > low)
+            Arg(value);
+        if (high != low)
+          Arg(high);
+        return this;
+      }
+
+      Benchmark *DenseRange(std::int64_t low, std::int64_t high, std::int64_t step = 1)
+      {
+        for (auto value = low; value <= high; value += step)
+          Arg(value);
+        return this;
+      }
+
+      Benchmark *Threads(int count)
+      {
+        thread_counts.push_back(count);
+        return this;
+      }
+
+      /// `low`, then doubling up to `high`
+      Benchmark *ThreadRange(int low, int high)
+      {
+        for (auto count = low; count < high; count *= 2)
+          Threads(count);
+        return Threads(high);
+      }
+
+      Benchmark *UseRealTime()
+      {
+        use_real_time = true;
+        return this;
+      }
+
+      friend struct runner;
+    };
+
+    inline std::vector<std::unique_ptr<Benchmark>> &registry()
+    {
+      static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+
+      return benchmarks;
+    }
+
+    struct options
+    {
+      std::string filter{"."};
+      double min_time{0.5};
+      bool json_console{false};
+      std::string out;
+    };
+
+    inline options &get_options()
+    {
+      static options result;
+
+      return result;
+    }
+
+    struct result
+    {
+      std::string name;
+      std::string run_name;
+      int threads;
+      std::int64_t iterations;
+      double real_time;
+      double cpu_time;
+      double items_per_second;
+      double bytes_per_second;
+      std::map<std::string, double> counters;
+    };
+  }
+
+  inline internal::Benchmark *RegisterBenchmark(char const *name, internal::function run)
+  {
+    internal::registry().push_back(std::make_unique<internal::Benchmark>(name, run));
+    return internal::registry().back().get();
+  }
+
+  namespace internal
+  {
+    struct runner
+    {
+      struct measure
+      {
+        double real_seconds;
+        double cpu_seconds;
+        std::int64_t items;
+        std::int64_t bytes;
+        UserCounters counters;
+      };
+
+      static measure run_once(internal::function function, std::vector<std::int64_t> const &args, int thread_count, std::int64_t iterations)
+      {
+        std::vector<std::unique_ptr<State>> states;
+
+        for (int i = 0; i < thread_count; ++i)
+          states.push_back(std::make_unique<State>(iterations, args, thread_count, i));
+
+        auto const cpu_start = internal::cpu_seconds();
+
+        if (thread_count == 1)
+          function(*states.front());
+        else
+          {
+            std::atomic<bool> go{false};
+            std::vector<std::thread> threads;
+
+            for (auto &state : states)
+              threads.emplace_back([&go, &state, function]() {
+                while (!go.load(std::memory_order_acquire))
+                  std::this_thread::yield();
+                function(*state);
+              });
+            go.store(true, std::memory_order_release);
+            for (auto &thread : threads)
+              thread.join();
+          }
+
+        measure result{0.0, internal::cpu_seconds() - cpu_start, 0, 0, {}};
+
+        // Like Google Benchmark, the real time of a multithreaded run is the average of every thread's
+        for (auto const &state : states)
+          {
+            result.real_seconds += state->timed_seconds() / thread_count;
+            result.items += state->items();
+            result.bytes += state->bytes();
+            for (auto const &counter : state->counters)
+              {
+                auto &sum = result.counters[counter.first];
+
+                sum.value += counter.second.value;
+                sum.flags = counter.second.flags;
+              }
+          }
+        return result;
+      }
+
+      static internal::result run(internal::Benchmark const &benchmark, std::string const &name, std::vector<std::int64_t> const &args, int thread_count)
+      {
+        auto const min_time = internal::get_options().min_time;
+        std::int64_t iterations = 1;
+        measure measured{};
+
+        // Grows the iteration count until a run lasts long enough to be meaningful
+        for (;;)
+          {
+            measured = run_once(benchmark.run, args, thread_count, iterations);
+
+            auto const seconds = benchmark.use_real_time ? measured.real_seconds : measured.cpu_seconds / thread_count;
+
+            if (seconds >= min_time || iterations >= 1'000'000'000)
+              break;
+
+            auto const factor = seconds <= min_time / 100 ? 10.0 : std::min(10.0, std::max(1.4 * min_time / seconds, 1.1));
+
+            iterations = static_cast<std::int64_t>(static_cast<double>(iterations) * factor) + 1;
+          }
+
+        auto const total_iterations = iterations * thread_count;
+        auto const rate_seconds = benchmark.use_real_time ? measured.real_seconds : measured.cpu_seconds / thread_count;
+        std::map<std::string, double> counters;
+
+        for (auto const &counter : measured.counters)
+          {
+            auto value = counter.second.value;
+            auto const flags = counter.second.flags;
+
+            if (flags & Counter::kIsRate)
+              value = rate_seconds > 0 ? value / rate_seconds : 0.0;
+            if (flags & Counter::kAvgThreads)
+              value /= thread_count;
+            if (flags & Counter::kIsIterationInvariant)
+              value *= static_cast<double>(total_iterations);
+            if (flags & Counter::kAvgIterations)
+              value /= static_cast<double>(total_iterations);
+            counters[counter.first] = value;
+          }
+        return {name,
+                name,
+                thread_count,
+                total_iterations,
+                measured.real_seconds * 1e9 / static_cast<double>(iterations),
+                measured.cpu_seconds * 1e9 / static_cast<double>(total_iterations),
+                rate_seconds > 0 ? static_cast<double>(measured.items) / rate_seconds : 0.0,
+                rate_seconds > 0 ? static_cast<double>(measured.bytes) / rate_seconds : 0.0,
+                std::move(counters)};
+      }
+
+      static std::string json_escape(std::string const &value)
+      {
+        std::string result;
+
+        for (auto c : value)
+          {
+            if (c == '"' || c == '\\')
+              result += '\\';
+            result += c;
+          }
+        return result;
+      }
+
+      static void write_json(std::ostream &out, std::vector<internal::result> const &results, char const *executable)
+      {
+        auto const now = std::time(nullptr);
+        char date[64];
+
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"executable\": \"" << json_escape(executable) << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+            << "    \"harness\": \"claws-vendored\",\n"
+#if defined(NDEBUG) || defined(RELEASE)
+            << "    \"library_build_type\": \"release\"\n"
+#else
+            << "    \"library_build_type\": \"debug\"\n"
+#endif
+            << "  },\n  \"benchmarks\": [";
+        for (std::size_t i(0u); i != results.size(); ++i)
+          {
+            auto const &result = results[i];
+
+            out << (i ? ",\n" : "\n") << "    {\n"
+                << "      \"name\": \"" << json_escape(result.name) << "\",\n"
+                << "      \"run_name\": \"" << json_escape(result.run_name) << "\",\n"
+                << "      \"run_type\": \"iteration\",\n"
+                << "      \"repetitions\": 1,\n"
+                << "      \"repetition_index\": 0,\n"
+                << "      \"threads\": " << result.threads << ",\n"
+                << "      \"iterations\": " << result.iterations << ",\n"
+                << "      \"real_time\": " << result.real_time << ",\n"
+                << "      \"cpu_time\": " << result.cpu_time << ",\n"
+                << "      \"time_unit\": \"ns\"";
+            if (result.items_per_second > 0)
+              out << ",\n      \"items_per_second\": " << result.items_per_second;
+            if (result.bytes_per_second > 0)
+              out << ",\n      \"bytes_per_second\": " << result.bytes_per_second;
+            for (auto const &counter : result.counters)
+              out << ",\n      \"" << json_escape(counter.first) << "\": " << counter.second;
+            out << "\n    }";
+          }
+        out << "\n  ]\n}\n";
+      }
+
+      /// `value` with a k, M or G suffix, as Google Benchmark prints counters
+      static std::string human_readable(double value)
+      {
+        char const *suffix = "";
+        char buffer[32];
+
+        for (auto next : {"k", "M", "G", "T"})
+          {
+            if (value < 1000.0)
+              break;
+            value /= 1000.0;
+            suffix = next;
+          }
+        std::snprintf(buffer, sizeof(buffer), "%.5g%s", value, suffix);
+        return buffer;
+      }
+
+      static void write_console_line(internal::result const &result)
+      {
+        auto const print_time = [](double nanoseconds) { std::printf(nanoseconds >= 100.0 ? " %13.0f ns" : " %13.3g ns", nanoseconds); };
+
+        std::printf("%-60s", result.name.c_str());
+        print_time(result.real_time);
+        print_time(result.cpu_time);
+        std::printf(" %12lld", static_cast<long long>(result.iterations));
+        if (result.items_per_second > 0)
+          std::printf(" items_per_second=%s/s", human_readable(result.items_per_second).c_str());
+        if (result.bytes_per_second > 0)
+          std::printf(" bytes_per_second=%s/s", human_readable(result.bytes_per_second).c_str());
+        for (auto const &counter : result.counters)
+          std::printf(" %s=%s", counter.first.c_str(), human_readable(counter.second).c_str());
+        std::printf("\n");
+        std::fflush(stdout);
+      }
+
+      static int run_all(char const *executable)
+      {
+        auto const &options = internal::get_options();
+        std::regex const filter(options.filter);
+        std::vector<internal::result> results;
+
+        if (!options.json_console)
+          std::printf("%-60s %16s %16s %12s\n%s\n", "Benchmark", "Time", "CPU", "Iterations", std::string(108, '-').c_str());
+        for (auto const &benchmark : internal::registry())
+          {
+            auto argument_sets = benchmark->argument_sets;
+            auto thread_counts = benchmark->thread_counts;
+
+            if (argument_sets.empty())
+              argument_sets.emplace_back();
+            if (thread_counts.empty())
+              thread_counts.push_back(1);
+            for (auto const &args : argument_sets)
+              for (auto thread_count : thread_counts)
+                {
+                  auto name = benchmark->name;
+
+                  for (std::size_t i(0u); i != args.size(); ++i)
+                    {
+                      name += "/";
+                      if (i < benchmark->argument_names.size() && !benchmark->argument_names[i].empty())
+                        name += benchmark->argument_names[i] + ":";
+                      name += std::to_string(args[i]);
+                    }
+                  if (benchmark->use_real_time)
+                    name += "/real_time";
+                  if (!benchmark->thread_counts.empty())
+                    name += "/threads:" + std::to_string(thread_count);
+                  if (!std::regex_search(name, filter))
+                    continue;
+                  results.push_back(run(*benchmark, name, args, thread_count));
+                  if (!options.json_console)
+                    write_console_line(results.back());
+                }
+          }
+        if (options.json_console)
+          write_json(std::cout, results, executable);
+        if (!options.out.empty())
+          {
+            std::ofstream out(options.out);
+
+            if (!out)
+              {
+                std::fprintf(stderr, "claws-bench: can't open %s\n", options.out.c_str());
+                return 1;
+              }
+            write_json(out, results, executable);
+          }
+        return 0;
+      }
+    };
+  }
+
+  inline bool Initialize(int argc, char **argv)
+  {
+    auto &options = internal::get_options();
+
+    for (int i = 1; i < argc; ++i)
+      {
+        std::string const arg(argv[i]);
+        auto const value_of = [&arg](char const *flag) {
+          auto const prefix = std::string(flag) + "=";
+
+          return arg.compare(0, prefix.size(), prefix) ? std::string{} : arg.substr(prefix.size());
+        };
+
+        if (auto value = value_of("--benchmark_filter"); !value.empty())
+          options.filter = value;
+        else if (auto value = value_of("--benchmark_min_time"); !value.empty())
+          options.min_time = std::stod(value);
+        else if (auto value = value_of("--benchmark_format"); !value.empty())
+          options.json_console = value == "json";
+        else if (auto value = value_of("--benchmark_out"); !value.empty())
+          options.out = value;
+        else if (auto value = value_of("--benchmark_out_format"); !value.empty())
+          {
+            if (value != "json")
+              {
+                std::fprintf(stderr, "claws-bench: only json output is supported by the vendored harness\n");
+                return false;
+              }
+          }
+        else
+          {
+            std::fprintf(stderr,
+                         "usage: %s [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>] [--benchmark_format=console|json]\n"
+                         "          [--benchmark_out=<file>] [--benchmark_out_format=json]\n",
+                         argv[0]);
+            return false;
+          }
+      }
+    return true;
+  }
+
+  inline int RunSpecifiedBenchmarks(char const *executable = "claws-bench")
+  {
+    return internal::runner::run_all(executable);
+  }
+}
+
+#define CLAWS_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define CLAWS_BENCHMARK_CONCAT(a, b) CLAWS_BENCHMARK_CONCAT_IMPL(a, b)
+#define CLAWS_BENCHMARK_UNIQUE_NAME CLAWS_BENCHMARK_CONCAT(claws_benchmark_, __COUNTER__)
+
+#define BENCHMARK(...) \
+  static ::benchmark::internal::Benchmark *CLAWS_BENCHMARK_UNIQUE_NAME [[maybe_unused]] = ::benchmark::RegisterBenchmark(#__VA_ARGS__, __VA_ARGS__)
+
+#define BENCHMARK_TEMPLATE(NAME, ...)                                                                             \
+  static ::benchmark::internal::Benchmark *CLAWS_BENCHMARK_UNIQUE_NAME [[maybe_unused]] = ::benchmark::RegisterBenchmark( \
+    #NAME "<" #__VA_ARGS__ ">", NAME<__VA_ARGS__>)
+
+#define BENCHMARK_MAIN()                          \
+  int main(int argc, char **argv)                 \
+  {                                               \
+    if (!::benchmark::Initialize(argc, argv))     \
+      return 1;                                   \
+    return ::benchmark::RunSpecifiedBenchmarks(argv[0]); \
+  }                                               \
+  int main(int, char **)
@@ -0,0 +1,34 @@
+###################### INTERNAL ####################################
+macro(__internal_specific_benchmark_properties EXECUTABLE_NAME)
+    set_target_properties(${EXECUTABLE_NAME}
+            PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_SOURCE_DIR}/bin"
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG "${CMAKE_SOURCE_DIR}/bin"
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE "${CMAKE_SOURCE_DIR}/bin"
+            VS_DEBUGGER_WORKING_DIRECTORY "${CMAKE_SOURCE_DIR}/bin")
+endmacro()
+###################### INTERNAL ####################################
+
+##! Creates the benchmark executable, every module's benchmarks are then added to it with ADD_BENCHMARK_SOURCES
+##! CLAWS_BENCHMARK_LIBRARY must name the benchmark library: Google Benchmark, or the bundled harness
+macro(CREATE_BENCHMARK EXECUTABLE_NAME SOURCES)
+    add_executable(${EXECUTABLE_NAME} ${SOURCES})
+    target_link_libraries(${EXECUTABLE_NAME} ${CLAWS_BENCHMARK_LIBRARY})
+    __internal_specific_benchmark_properties(${EXECUTABLE_NAME})
+endmacro()
+
+macro(ADD_BENCHMARK_SOURCES EXECUTABLE_NAME SOURCES)
+    foreach (source ${SOURCES})
+        target_sources(${EXECUTABLE_NAME} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/${source})
+    endforeach ()
+endmacro()
+
+##! Adds a `<EXECUTABLE_NAME>-json` target running every benchmark and writing Google Benchmark's JSON report to OUTPUT
+macro(ADD_BENCHMARK_JSON_TARGET EXECUTABLE_NAME OUTPUT)
+    add_custom_target(${EXECUTABLE_NAME}-json
+            COMMAND ${EXECUTABLE_NAME} --benchmark_out=${OUTPUT} --benchmark_out_format=json
+            DEPENDS ${EXECUTABLE_NAME}
+            WORKING_DIRECTORY "${CMAKE_SOURCE_DIR}/bin"
+            COMMENT "Writing ${EXECUTABLE_NAME} results to ${OUTPUT}"
+            USES_TERMINAL)
+endmacro()
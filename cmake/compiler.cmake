@@ -38,8 +38,13 @@ macro(__internal_debug_cxx_flags)
 endmacro()
 
 ##! Internal Release configuration
+# CLAWS_PORTABLE_BUILD keeps the compiler's baseline architecture, so binaries run on any CPU of the target family
 macro(__internal_release_unix_cxx_flags)
-    set(CMAKE_CXX_FLAGS_RELEASE "-O3 -march=native ${STANDARD_UNIX_CXX_FLAGS}")
+    if (CLAWS_PORTABLE_BUILD)
+        set(CMAKE_CXX_FLAGS_RELEASE "-O3 ${STANDARD_UNIX_CXX_FLAGS}")
+    else()
+        set(CMAKE_CXX_FLAGS_RELEASE "-O3 -march=native ${STANDARD_UNIX_CXX_FLAGS}")
+    endif()
 endmacro()
 
 macro(__internal_release_msvc_cxx_flags)
@@ -11,5 +11,6 @@ include(compiler)
 include(coverage)
 include(compiler_utility)
 include(unit_tests)
+include(benchmarks)
 include(directory)
 include(module)
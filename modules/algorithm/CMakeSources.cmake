@@ -3,10 +3,14 @@ set(MODULE_PATH
 
 set(MODULE_PUBLIC_HEADERS
         "${MODULE_PATH}/constexpr_algorithm.hpp"
+        "${MODULE_PATH}/radix_sort.hpp"
+        "${MODULE_PATH}/search.hpp"
+        "${MODULE_PATH}/sort.hpp"
         )
 
 set(MODULE_PRIVATE_HEADERS
-        "")
+        "${MODULE_PATH}/impl/search_kernels.hpp"
+        )
 
 set(MODULE_SOURCES
         ${MODULE_PUBLIC_HEADERS}
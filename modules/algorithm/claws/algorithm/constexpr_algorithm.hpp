@@ -1,12 +1,245 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
+#include <claws/utils/is_constant_evaluated.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLAWS_HAS_SSE2 1
+#endif
 
 namespace claws
 {
+  namespace impl
+  {
+    template<class iterator, class value_type>
+    struct is_iterator_of_vector
+      : std::bool_constant<std::is_same_v<iterator, typename std::vector<value_type>::iterator>
+                           || std::is_same_v<iterator, typename std::vector<value_type>::const_iterator>>
+    {};
+
+    template<class iterator, class = void>
+    struct is_vector_iterator : std::false_type
+    {};
+
+    /// `std::vector<value_type>` is only named for object types: output iterators like `std::back_insert_iterator` have a `void` value type
+    template<class iterator>
+    struct is_vector_iterator<iterator, std::void_t<typename std::iterator_traits<iterator>::value_type>>
+      : std::conjunction<std::is_object<typename std::iterator_traits<iterator>::value_type>,
+                         std::negation<std::is_same<typename std::iterator_traits<iterator>::value_type, bool>>,
+                         is_iterator_of_vector<iterator, typename std::iterator_traits<iterator>::value_type>>
+    {};
+  }
+
+  ///
+  /// \brief Tells if `iterator` points into contiguous memory.
+  ///
+  /// True for raw pointers and `std::vector` iterators. Specialise it for other contiguous iterators (`*(it + n) == *(&*it + n)` must hold)
+  /// to let `claws::copy` and friends lower them to `memmove`.
+  ///
+  template<class iterator>
+  struct is_contiguous_iterator : std::bool_constant<std::is_pointer_v<iterator> || impl::is_vector_iterator<iterator>::value>
+  {};
+
+  template<class iterator>
+  inline constexpr bool is_contiguous_iterator_v = is_contiguous_iterator<iterator>::value;
+
+  namespace impl
+  {
+    /// Copies at least this many bytes bypass the cache with non-temporal stores
+    inline constexpr std::size_t non_temporal_threshold = std::size_t(4u) << 20u;
+
+    template<class iterator>
+    using pointee_t = std::remove_reference_t<decltype(*std::declval<iterator>())>;
+
+    template<class input_it, class output_it, bool is_move>
+    constexpr bool is_bitwise_copyable()
+    {
+      if constexpr (is_contiguous_iterator_v<input_it> && is_contiguous_iterator_v<output_it>)
+        {
+          using in_type = pointee_t<input_it>;
+          using out_type = pointee_t<output_it>;
+
+          if constexpr (!std::is_same_v<std::remove_const_t<in_type>, out_type> || std::is_volatile_v<out_type>)
+            return false;
+          else if constexpr (is_move)
+            return std::is_trivially_copyable_v<out_type> && std::is_trivially_move_assignable_v<out_type>;
+          else
+            return std::is_trivially_copyable_v<out_type> && std::is_trivially_copy_assignable_v<out_type>;
+        }
+      else
+        return false;
+    }
+
+    template<class output_it, class value_type>
+    constexpr bool is_bitwise_fillable()
+    {
+      if constexpr (is_contiguous_iterator_v<output_it>)
+        {
+          using out_type = pointee_t<output_it>;
+
+          if constexpr (std::is_const_v<out_type> || std::is_volatile_v<out_type> || !std::is_trivially_copyable_v<out_type>)
+            return false;
+          else
+            return std::is_same_v<std::remove_cv_t<value_type>, out_type>
+              || (std::is_arithmetic_v<out_type> && std::is_arithmetic_v<std::remove_cv_t<value_type>>);
+        }
+      else
+        return false;
+    }
+
+    inline bool overlaps(void const *lh, void const *rh, std::size_t bytes) noexcept
+    {
+      auto const lh_address = reinterpret_cast<std::uintptr_t>(lh);
+      auto const rh_address = reinterpret_cast<std::uintptr_t>(rh);
+
+      return lh_address < rh_address + bytes && rh_address < lh_address + bytes;
+    }
+
+    ///
+    /// \brief Copies `bytes` bytes from `src` to `dst` without polluting the cache.
+    ///
+    /// Ranges must not overlap.
+    ///
+    inline void stream_copy(void *dst, void const *src, std::size_t bytes) noexcept
+    {
+#if defined(CLAWS_HAS_SSE2)
+      auto *out = static_cast<unsigned char *>(dst);
+      auto const *in = static_cast<unsigned char const *>(src);
+      std::size_t const head = (16u - (reinterpret_cast<std::uintptr_t>(out) & 15u)) & 15u;
+
+      std::memcpy(out, in, head);
+      out += head;
+      in += head;
+      bytes -= head;
+      for (; bytes >= 64u; bytes -= 64u, out += 64u, in += 64u)
+        {
+          __m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in));
+          __m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 16));
+          __m128i const c = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 32));
+          __m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 48));
+
+          _mm_stream_si128(reinterpret_cast<__m128i *>(out), a);
+          _mm_stream_si128(reinterpret_cast<__m128i *>(out + 16), b);
+          _mm_stream_si128(reinterpret_cast<__m128i *>(out + 32), c);
+          _mm_stream_si128(reinterpret_cast<__m128i *>(out + 48), d);
+        }
+      _mm_sfence();
+      std::memcpy(out, in, bytes);
+#else
+      std::memcpy(dst, src, bytes);
+#endif
+    }
+
+    ///
+    /// \brief Fills `count` elements at `dst` with `value` without polluting the cache.
+    ///
+    /// Returns `false` (and does nothing) if `T` can't be expanded into a 16 bytes pattern.
+    ///
+    template<class T>
+    bool stream_fill(T *dst, std::size_t count, T const &value) noexcept
+    {
+#if defined(CLAWS_HAS_SSE2)
+      if constexpr (16u % sizeof(T) == 0u)
+        {
+          if (reinterpret_cast<std::uintptr_t>(dst) % sizeof(T) != 0u)
+            return false;
+          for (; count && (reinterpret_cast<std::uintptr_t>(dst) & 15u); --count)
+            *dst++ = value;
+
+          unsigned char pattern[16];
+
+          for (std::size_t i(0u); i != 16u; i += sizeof(T))
+            std::memcpy(pattern + i, &value, sizeof(T));
+
+          __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pattern));
+          constexpr std::size_t per_iteration = 64u / sizeof(T);
+          auto *out = reinterpret_cast<unsigned char *>(dst);
+
+          for (; count >= per_iteration; count -= per_iteration, out += 64u)
+            {
+              _mm_stream_si128(reinterpret_cast<__m128i *>(out), block);
+              _mm_stream_si128(reinterpret_cast<__m128i *>(out + 16), block);
+              _mm_stream_si128(reinterpret_cast<__m128i *>(out + 32), block);
+              _mm_stream_si128(reinterpret_cast<__m128i *>(out + 48), block);
+            }
+          _mm_sfence();
+          dst = reinterpret_cast<T *>(out);
+          while (count--)
+            *dst++ = value;
+          return true;
+        }
+#endif
+      static_cast<void>(dst);
+      static_cast<void>(count);
+      static_cast<void>(value);
+      return false;
+    }
+
+    template<class input_it, class output_it>
+    output_it bitwise_copy(input_it begin, std::size_t count, output_it out) noexcept
+    {
+      if (count == 0u)
+        return out;
+
+      std::size_t const bytes = count * sizeof(pointee_t<output_it>);
+      void *dst = std::addressof(*out);
+      void const *src = std::addressof(*begin);
+
+      if (bytes >= non_temporal_threshold && !overlaps(dst, src, bytes))
+        stream_copy(dst, src, bytes);
+      else
+        std::memmove(dst, src, bytes);
+      return out + static_cast<std::ptrdiff_t>(count);
+    }
+
+    template<class output_it, class value_type>
+    output_it bitwise_fill(output_it out, std::size_t count, value_type const &raw_value) noexcept
+    {
+      using type = pointee_t<output_it>;
+
+      if (count == 0u)
+        return out;
+
+      type const value(static_cast<type>(raw_value));
+      type *dst = std::addressof(*out);
+      unsigned char bytes[sizeof(type)];
+
+      std::memcpy(bytes, &value, sizeof(type));
+
+      bool uniform_bytes = true;
+
+      for (unsigned char byte : bytes)
+        uniform_bytes &= byte == bytes[0];
+
+      if (uniform_bytes)
+        std::memset(static_cast<void *>(dst), bytes[0], count * sizeof(type));
+      else if (count * sizeof(type) < non_temporal_threshold || !stream_fill(dst, count, value))
+        for (std::size_t i(0u); i != count; ++i)
+          dst[i] = value;
+      return out + static_cast<std::ptrdiff_t>(count);
+    }
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::copy`
+  ///
+  /// Outside of constant evaluation, contiguous ranges of trivially copyable values lower to `memmove`,
+  /// or to non-temporal stores for very large non-overlapping copies.
+  ///
   template<class input_it, class output_it>
   constexpr output_it copy(input_it begin, input_it end, output_it out)
   {
+    if constexpr (impl::is_bitwise_copyable<input_it, output_it, false>())
+      if (!is_constant_evaluated())
+        return impl::bitwise_copy(begin, static_cast<std::size_t>(end - begin), out);
     while (begin != end)
       {
         *out = *begin;
@@ -16,9 +249,39 @@ namespace claws
     return out;
   }
 
+  ///
+  /// \brief `constexpr` equivalent of `std::copy_n`
+  ///
+  /// Same lowering rules as `claws::copy`.
+  ///
+  template<class input_it, class size_type, class output_it>
+  constexpr output_it copy_n(input_it begin, size_type count, output_it out)
+  {
+    if (count <= 0)
+      return out;
+    if constexpr (impl::is_bitwise_copyable<input_it, output_it, false>())
+      if (!is_constant_evaluated())
+        return impl::bitwise_copy(begin, static_cast<std::size_t>(count), out);
+    for (; count > 0; --count)
+      {
+        *out = *begin;
+        ++begin;
+        ++out;
+      }
+    return out;
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::move`
+  ///
+  /// Same lowering rules as `claws::copy`.
+  ///
   template<class input_it, class output_it>
   constexpr output_it move(input_it begin, input_it end, output_it out) noexcept(noexcept(*out = std::move(*begin)))
   {
+    if constexpr (impl::is_bitwise_copyable<input_it, output_it, true>())
+      if (!is_constant_evaluated())
+        return impl::bitwise_copy(begin, static_cast<std::size_t>(end - begin), out);
     while (begin != end)
       {
         *out = std::move(*begin);
@@ -27,4 +290,44 @@ namespace claws
       }
     return out;
   }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::fill_n`
+  ///
+  /// Outside of constant evaluation, contiguous ranges of trivially copyable values lower to `memset` when all bytes of `value` are equal,
+  /// to non-temporal stores for very large ranges, and to a plain store loop otherwise.
+  ///
+  template<class output_it, class size_type, class value_type>
+  constexpr output_it fill_n(output_it out, size_type count, value_type const &value)
+  {
+    if (count <= 0)
+      return out;
+    if constexpr (impl::is_bitwise_fillable<output_it, value_type>())
+      if (!is_constant_evaluated())
+        return impl::bitwise_fill(out, static_cast<std::size_t>(count), value);
+    for (; count > 0; --count)
+      {
+        *out = value;
+        ++out;
+      }
+    return out;
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::fill`
+  ///
+  /// Same lowering rules as `claws::fill_n`.
+  ///
+  template<class output_it, class value_type>
+  constexpr void fill(output_it begin, output_it end, value_type const &value)
+  {
+    if constexpr (impl::is_bitwise_fillable<output_it, value_type>())
+      if (!is_constant_evaluated())
+        {
+          impl::bitwise_fill(begin, static_cast<std::size_t>(end - begin), value);
+          return;
+        }
+    for (; begin != end; ++begin)
+      *begin = value;
+  }
 };
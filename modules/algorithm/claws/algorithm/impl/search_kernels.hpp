@@ -0,0 +1,167 @@
+// Deliberately no include guard: this file is included once per SIMD tier by `claws/algorithm/search.hpp`,
+// with `CLAWS_SIMD_TIER` naming both the kernels' namespace and the `claws::simd` wrapper,
+// and `CLAWS_SIMD_TARGET` the matching target attribute.
+
+namespace CLAWS_SIMD_TIER
+{
+  template<class mask>
+  CLAWS_SIMD_TARGET inline unsigned lowest_bit(mask value) noexcept
+  {
+    if constexpr (sizeof(mask) > sizeof(unsigned))
+      return static_cast<unsigned>(__builtin_ctzll(value));
+    else
+      return static_cast<unsigned>(__builtin_ctz(value));
+  }
+
+  template<class mask>
+  CLAWS_SIMD_TARGET inline unsigned highest_bit(mask value) noexcept
+  {
+    if constexpr (sizeof(mask) > sizeof(unsigned))
+      return static_cast<unsigned>(63 - __builtin_clzll(value));
+    else
+      return static_cast<unsigned>(31 - __builtin_clz(value));
+  }
+
+  template<class mask>
+  CLAWS_SIMD_TARGET inline unsigned bit_count(mask value) noexcept
+  {
+    if constexpr (sizeof(mask) > sizeof(unsigned))
+      return static_cast<unsigned>(__builtin_popcountll(value));
+    else
+      return static_cast<unsigned>(__builtin_popcount(value));
+  }
+
+  template<class lane>
+  CLAWS_SIMD_TARGET lane const *find(lane const *begin, lane const *end, lane value) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<lane>;
+    auto const needle = ops::broadcast(value);
+
+    for (; static_cast<std::size_t>(end - begin) >= ops::lanes; begin += ops::lanes)
+      if (auto const found = ops::eq(ops::load(begin), needle))
+        return begin + lowest_bit(found) / ops::bits_per_lane;
+    for (; begin != end; ++begin)
+      if (*begin == value)
+        return begin;
+    return end;
+  }
+
+  /// Returns `nullptr` if `value` isn't found
+  template<class lane>
+  CLAWS_SIMD_TARGET lane const *find_last(lane const *begin, lane const *end, lane value) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<lane>;
+    auto const needle = ops::broadcast(value);
+
+    while (static_cast<std::size_t>(end - begin) >= ops::lanes)
+      {
+        end -= ops::lanes;
+        if (auto const found = ops::eq(ops::load(end), needle))
+          return end + highest_bit(found) / ops::bits_per_lane;
+      }
+    while (end != begin)
+      if (*--end == value)
+        return end;
+    return nullptr;
+  }
+
+  template<class lane>
+  CLAWS_SIMD_TARGET lane const *find_any(lane const *begin, lane const *end, lane const *needles, std::size_t needle_count) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<lane>;
+    typename ops::vector needle_vectors[max_needles];
+
+    for (std::size_t i(0u); i != needle_count; ++i)
+      needle_vectors[i] = ops::broadcast(needles[i]);
+    for (; static_cast<std::size_t>(end - begin) >= ops::lanes; begin += ops::lanes)
+      {
+        auto const values = ops::load(begin);
+        typename ops::mask found = 0;
+
+        for (std::size_t i(0u); i != needle_count; ++i)
+          found |= ops::eq(values, needle_vectors[i]);
+        if (found)
+          return begin + lowest_bit(found) / ops::bits_per_lane;
+      }
+    for (; begin != end; ++begin)
+      for (std::size_t i(0u); i != needle_count; ++i)
+        if (*begin == needles[i])
+          return begin;
+    return end;
+  }
+
+  template<class lane>
+  CLAWS_SIMD_TARGET std::size_t count(lane const *begin, lane const *end, lane value) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<lane>;
+    auto const needle = ops::broadcast(value);
+    std::size_t bits = 0;
+    std::size_t result = 0;
+
+    // Every matching lane sets exactly `bits_per_lane` bits
+    for (; static_cast<std::size_t>(end - begin) >= ops::lanes; begin += ops::lanes)
+      bits += bit_count(ops::eq(ops::load(begin), needle));
+    for (; begin != end; ++begin)
+      result += *begin == value;
+    return result + bits / ops::bits_per_lane;
+  }
+
+  /// Returns the offset of the first mismatch, or `size` if both ranges are equal
+  template<class lane>
+  CLAWS_SIMD_TARGET std::size_t mismatch(lane const *lh, lane const *rh, std::size_t size) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<lane>;
+    std::size_t i(0u);
+
+    for (; size - i >= ops::lanes; i += ops::lanes)
+      {
+        auto const equal = ops::eq(ops::load(lh + i), ops::load(rh + i));
+
+        if (equal != ops::full_mask)
+          return i + lowest_bit(static_cast<typename ops::mask>(~equal & ops::full_mask)) / ops::bits_per_lane;
+      }
+    for (; i != size; ++i)
+      if (!(lh[i] == rh[i]))
+        return i;
+    return size;
+  }
+
+  /// `size` must be at least `lanes`
+  template<class lane>
+  CLAWS_SIMD_TARGET void min_max(lane const *begin, std::size_t size, lane &min, lane &max) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<lane>;
+    auto min_vector = ops::load(begin);
+    auto max_vector = min_vector;
+    std::size_t i(ops::lanes);
+
+    for (; size - i >= ops::lanes; i += ops::lanes)
+      {
+        auto const values = ops::load(begin + i);
+
+        min_vector = ops::min(min_vector, values);
+        max_vector = ops::max(max_vector, values);
+      }
+    // Overlapping last load: lanes already seen don't change the result
+    if (i != size)
+      {
+        auto const values = ops::load(begin + size - ops::lanes);
+
+        min_vector = ops::min(min_vector, values);
+        max_vector = ops::max(max_vector, values);
+      }
+
+    lane mins[ops::lanes];
+    lane maxs[ops::lanes];
+
+    ops::store(mins, min_vector);
+    ops::store(maxs, max_vector);
+    min = mins[0];
+    max = maxs[0];
+    for (std::size_t lane_index(1u); lane_index != ops::lanes; ++lane_index)
+      {
+        min = mins[lane_index] < min ? mins[lane_index] : min;
+        max = max < maxs[lane_index] ? maxs[lane_index] : max;
+      }
+  }
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <claws/algorithm/constexpr_algorithm.hpp>
+#include <claws/algorithm/sort.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Maps a key to an unsigned integer with the same ordering, for `claws::radix_sort`.
+  ///
+  /// Provides `type`, the unsigned encoded type, and `static type encode(T)`.
+  /// Defined for integers, floating point numbers (negative numbers have all their bits flipped, positive ones their sign bit),
+  /// and `claws::tagged_data` of those. Specialise it for other key types.
+  ///
+  template<class T, class = void>
+  struct radix_key;
+
+  template<class T>
+  struct radix_key<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T> && !std::is_same_v<T, bool>>>
+  {
+    using type = T;
+
+    static constexpr type encode(T value) noexcept
+    {
+      return value;
+    }
+  };
+
+  template<class T>
+  struct radix_key<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>>
+  {
+    using type = std::make_unsigned_t<T>;
+
+    static constexpr type encode(T value) noexcept
+    {
+      return static_cast<type>(static_cast<type>(value) ^ (type(1) << (std::numeric_limits<type>::digits - 1)));
+    }
+  };
+
+  template<class T>
+  struct radix_key<T, std::enable_if_t<std::is_floating_point_v<T>>>
+  {
+    static_assert(std::numeric_limits<T>::is_iec559, "radix_key expects IEEE 754 floating point numbers");
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "radix_key only supports 32 and 64 bits floating point numbers");
+
+    using type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+    static type encode(T value) noexcept
+    {
+      constexpr type sign_bit = type(1) << (sizeof(type) * 8 - 1);
+      type bits;
+
+      std::memcpy(&bits, &value, sizeof(type));
+      return (bits & sign_bit) ? type(~bits) : type(bits | sign_bit);
+    }
+  };
+
+  template<class data_type, class offset_type, class tag>
+  struct radix_key<tagged_data<data_type, offset_type, tag>>
+  {
+    using type = typename radix_key<data_type>::type;
+
+    static constexpr type encode(tagged_data<data_type, offset_type, tag> const &value) noexcept
+    {
+      return radix_key<data_type>::encode(value.data);
+    }
+  };
+
+  namespace impl
+  {
+    namespace radix
+    {
+      /// Below this size, comparison sort on the encoded keys is faster than building histograms
+      inline constexpr std::size_t small_size = 64;
+
+      inline constexpr std::size_t digit_bits = 8;
+
+      inline constexpr std::size_t bucket_count = std::size_t(1) << digit_bits;
+
+      struct no_payload
+      {};
+
+      template<class key_type, class payload_type>
+      void sort(key_type *keys, payload_type *payload, std::size_t size)
+      {
+        using traits = radix_key<key_type>;
+        using encoded_type = typename traits::type;
+        constexpr bool has_payload = !std::is_same_v<payload_type, no_payload>;
+        constexpr std::size_t digit_count = sizeof(encoded_type) * 8 / digit_bits;
+
+        // One pass over the keys computes the histograms of every digit
+        std::array<std::array<std::size_t, bucket_count>, digit_count> histograms{};
+
+        for (std::size_t i(0u); i != size; ++i)
+          {
+            encoded_type const encoded = traits::encode(keys[i]);
+
+            for (std::size_t digit(0u); digit != digit_count; ++digit)
+              ++histograms[digit][(encoded >> (digit * digit_bits)) & (bucket_count - 1)];
+          }
+
+        std::vector<key_type> key_buffer(size);
+        std::vector<std::conditional_t<has_payload, payload_type, no_payload>> payload_buffer(has_payload ? size : 0u);
+        key_type *key_src = keys;
+        key_type *key_dst = key_buffer.data();
+        payload_type *payload_src = payload;
+        payload_type *payload_dst = nullptr;
+
+        if constexpr (has_payload)
+          payload_dst = payload_buffer.data();
+        for (std::size_t digit(0u); digit != digit_count; ++digit)
+          {
+            auto &histogram = histograms[digit];
+            std::size_t const shift = digit * digit_bits;
+
+            // All keys share this digit: the pass would be the identity permutation
+            if (histogram[(traits::encode(key_src[0]) >> shift) & (bucket_count - 1)] == size)
+              continue;
+
+            std::size_t offset = 0;
+
+            for (auto &count : histogram)
+              {
+                std::size_t const bucket_size = count;
+
+                count = offset;
+                offset += bucket_size;
+              }
+            for (std::size_t i(0u); i != size; ++i)
+              {
+                std::size_t const destination = histogram[(traits::encode(key_src[i]) >> shift) & (bucket_count - 1)]++;
+
+                key_dst[destination] = std::move(key_src[i]);
+                if constexpr (has_payload)
+                  payload_dst[destination] = std::move(payload_src[i]);
+              }
+            std::swap(key_src, key_dst);
+            if constexpr (has_payload)
+              std::swap(payload_src, payload_dst);
+          }
+        if (key_src != keys)
+          {
+            claws::move(key_src, key_src + size, keys);
+            if constexpr (has_payload)
+              claws::move(payload_src, payload_src + size, payload);
+          }
+      }
+
+      template<class it>
+      auto to_pointer(it iterator)
+      {
+        static_assert(is_contiguous_iterator_v<it>, "radix_sort requires contiguous iterators");
+        return std::addressof(*iterator);
+      }
+    }
+  }
+
+  ///
+  /// \brief Stable LSD radix sort of a contiguous range of keys.
+  ///
+  /// Keys are sorted by 8 bits digits, least significant first. Digits which are the same for all keys are skipped,
+  /// so small indices stored in wide integers only pay for their significant digits.
+  /// Uses a temporary buffer of the same size as the range.
+  ///
+  /// \tparam it a contiguous iterator, whose `value_type` has a `claws::radix_key` specialisation.
+  ///
+  template<class it>
+  void radix_sort(it begin, it end)
+  {
+    using key_type = typename std::iterator_traits<it>::value_type;
+    using encoded_type = typename radix_key<key_type>::type;
+    auto const size = static_cast<std::size_t>(end - begin);
+
+    if (size < 2)
+      return;
+    if (size < impl::radix::small_size)
+      {
+        claws::sort(begin, end, [](key_type const &lh, key_type const &rh) -> bool {
+          return encoded_type(radix_key<key_type>::encode(lh)) < encoded_type(radix_key<key_type>::encode(rh));
+        });
+        return;
+      }
+    impl::radix::sort(impl::radix::to_pointer(begin), static_cast<impl::radix::no_payload *>(nullptr), size);
+  }
+
+  ///
+  /// \brief Stable LSD radix sort of a contiguous range of keys, applying the same permutation to a payload range.
+  ///
+  /// After the call, `payload_begin[i]` is the payload which was associated with the key now at `begin[i]`.
+  /// Uses temporary buffers of the same size as both ranges.
+  ///
+  /// \tparam it a contiguous iterator, whose `value_type` has a `claws::radix_key` specialisation.
+  /// \tparam payload_it a contiguous iterator, pointing to at least `end - begin` elements.
+  ///
+  template<class it, class payload_it>
+  void radix_sort(it begin, it end, payload_it payload_begin)
+  {
+    auto const size = static_cast<std::size_t>(end - begin);
+
+    if (size < 2)
+      return;
+    impl::radix::sort(impl::radix::to_pointer(begin), impl::radix::to_pointer(payload_begin), size);
+  }
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <claws/algorithm/constexpr_algorithm.hpp>
+#include <claws/utils/cpu_features.hpp>
+#include <claws/utils/is_constant_evaluated.hpp>
+#include <claws/utils/simd.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace search
+    {
+      /// `find_if_eq_any` only vectorises searches for up to this many needles
+      inline constexpr std::size_t max_needles = 16;
+
+      /// The arithmetic type a vectorised kernel works on for a given value type, `void` if there is none
+      template<class T>
+      struct lane_of
+      {
+        using type = std::conditional_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, T, void>;
+      };
+
+      template<class data_type, class offset_type, class tag>
+      struct lane_of<tagged_data<data_type, offset_type, tag>>
+      {
+        static_assert(sizeof(tagged_data<data_type, offset_type, tag>) == sizeof(data_type));
+
+        using type = typename lane_of<data_type>::type;
+      };
+
+      template<class T>
+      using lane_of_t = typename lane_of<T>::type;
+
+      template<class it>
+      using value_of_t = typename std::iterator_traits<it>::value_type;
+
+      ///
+      /// \brief True if `element == needle` can be tested by comparing `element` to a single value of its own type.
+      ///
+      /// Holds for identical types, and for mixed integer or mixed floating point types, see `as_needle`.
+      ///
+      template<class element, class needle>
+      inline constexpr bool is_needle_compatible_v = std::is_same_v<element, needle>
+        || (std::is_integral_v<element> && std::is_integral_v<needle> && !std::is_same_v<needle, bool>)
+        || (std::is_floating_point_v<element> && std::is_floating_point_v<needle>);
+
+      template<class it>
+      constexpr bool is_vectorizable()
+      {
+#if defined(CLAWS_SIMD_X86)
+        if constexpr (is_contiguous_iterator_v<it>)
+          return !std::is_void_v<lane_of_t<value_of_t<it>>>;
+#endif
+        return false;
+      }
+
+      template<class it, class T>
+      constexpr bool is_vectorizable_search()
+      {
+        if constexpr (is_vectorizable<it>())
+          return is_needle_compatible_v<value_of_t<it>, std::remove_cv_t<T>>;
+        else
+          return false;
+      }
+
+      ///
+      /// \brief Returns the lane value `lane_needle` such that `element == needle` iff `element == lane_needle`.
+      ///
+      /// Usual arithmetic conversions make `element == needle` compare both as their common type,
+      /// and converting `element` to it is injective. So at most one `element` value can match,
+      /// and it is `static_cast<element>(needle)` if that converts back to `needle`.
+      ///
+      template<class element, class needle>
+      constexpr std::optional<lane_of_t<element>> as_needle(needle const &value) noexcept
+      {
+        if constexpr (std::is_same_v<element, needle>)
+          {
+            if constexpr (std::is_arithmetic_v<element>)
+              return value;
+            else
+              return value.data;
+          }
+        else
+          {
+            using common_type = decltype(std::declval<element>() + std::declval<needle>());
+            auto const candidate = static_cast<element>(value);
+
+            if (static_cast<common_type>(candidate) == static_cast<common_type>(value))
+              return candidate;
+            return std::nullopt;
+          }
+      }
+
+      template<class it>
+      auto to_lanes(it iterator) noexcept
+      {
+        return reinterpret_cast<lane_of_t<value_of_t<it>> const *>(std::addressof(*iterator));
+      }
+
+      /// False once `claws::set_simd_tier` selected the scalar tier, kernels are then never called
+      inline bool has_simd() noexcept
+      {
+        return get_simd_tier() != simd_tier::scalar;
+      }
+
+#if defined(CLAWS_SIMD_X86)
+#define CLAWS_SIMD_TIER sse2
+#define CLAWS_SIMD_TARGET CLAWS_TARGET_SSE2
+#include <claws/algorithm/impl/search_kernels.hpp>
+#undef CLAWS_SIMD_TARGET
+#undef CLAWS_SIMD_TIER
+
+#define CLAWS_SIMD_TIER avx2
+#define CLAWS_SIMD_TARGET CLAWS_TARGET_AVX2
+#include <claws/algorithm/impl/search_kernels.hpp>
+#undef CLAWS_SIMD_TARGET
+#undef CLAWS_SIMD_TIER
+
+#define CLAWS_SIMD_TIER avx512
+#define CLAWS_SIMD_TARGET CLAWS_TARGET_AVX512
+#include <claws/algorithm/impl/search_kernels.hpp>
+#undef CLAWS_SIMD_TARGET
+#undef CLAWS_SIMD_TIER
+
+// Calls the kernel of the active tier, callers must have checked `has_simd()`
+#define CLAWS_SEARCH_DISPATCH(KERNEL, ...)     \
+  switch (get_simd_tier())                     \
+    {                                          \
+    case simd_tier::avx512:                    \
+      return avx512::KERNEL(__VA_ARGS__);      \
+    case simd_tier::avx2:                      \
+      return avx2::KERNEL(__VA_ARGS__);        \
+    default:                                   \
+      return sse2::KERNEL(__VA_ARGS__);        \
+    }
+
+      template<class lane>
+      lane const *find(lane const *begin, lane const *end, lane value) noexcept
+      {
+        CLAWS_SEARCH_DISPATCH(find, begin, end, value);
+      }
+
+      template<class lane>
+      lane const *find_last(lane const *begin, lane const *end, lane value) noexcept
+      {
+        CLAWS_SEARCH_DISPATCH(find_last, begin, end, value);
+      }
+
+      template<class lane>
+      lane const *find_any(lane const *begin, lane const *end, lane const *needles, std::size_t needle_count) noexcept
+      {
+        CLAWS_SEARCH_DISPATCH(find_any, begin, end, needles, needle_count);
+      }
+
+      template<class lane>
+      std::size_t count(lane const *begin, lane const *end, lane value) noexcept
+      {
+        CLAWS_SEARCH_DISPATCH(count, begin, end, value);
+      }
+
+      template<class lane>
+      std::size_t mismatch(lane const *lh, lane const *rh, std::size_t size) noexcept
+      {
+        CLAWS_SEARCH_DISPATCH(mismatch, lh, rh, size);
+      }
+
+      /// Returns `false` if no kernel of the active tier or below handles this lane type, or if `size` is too small for them
+      template<class lane>
+      bool min_max(lane const *begin, std::size_t size, lane &min, lane &max) noexcept
+      {
+        auto const tier = get_simd_tier();
+
+        if constexpr (simd::avx512<lane>::has_minmax)
+          if (tier >= simd_tier::avx512 && size >= simd::avx512<lane>::lanes)
+            {
+              avx512::min_max(begin, size, min, max);
+              return true;
+            }
+        if constexpr (simd::avx2<lane>::has_minmax)
+          if (tier >= simd_tier::avx2 && size >= simd::avx2<lane>::lanes)
+            {
+              avx2::min_max(begin, size, min, max);
+              return true;
+            }
+        if constexpr (simd::sse2<lane>::has_minmax)
+          if (tier >= simd_tier::sse2 && size >= simd::sse2<lane>::lanes)
+            {
+              sse2::min_max(begin, size, min, max);
+              return true;
+            }
+        return false;
+      }
+
+#undef CLAWS_SEARCH_DISPATCH
+#endif
+    }
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::find`
+  ///
+  /// Outside of constant evaluation, contiguous ranges of arithmetic values or `claws::tagged_data`
+  /// are searched with the SIMD kernel of the active `claws::simd_tier`.
+  ///
+  template<class it, class T>
+  constexpr it find(it begin, it end, T const &value)
+  {
+    if constexpr (impl::search::is_vectorizable_search<it, T>())
+      if (!is_constant_evaluated() && impl::search::has_simd())
+        {
+          using element = impl::search::value_of_t<it>;
+
+          auto const needle = impl::search::as_needle<element, std::remove_cv_t<T>>(value);
+
+          if (!needle || begin == end)
+            return end;
+
+          auto const first = impl::search::to_lanes(begin);
+
+          return begin + (impl::search::find(first, first + (end - begin), *needle) - first);
+        }
+    for (; begin != end; ++begin)
+      if (*begin == value)
+        break;
+    return begin;
+  }
+
+  ///
+  /// \brief Returns the first element equal to any of the needles, or `end`.
+  ///
+  /// Equivalent of `std::find_first_of` with `operator==`, vectorised the same way as `claws::find` for up to 16 needles.
+  ///
+  template<class it, class needle_it>
+  constexpr it find_if_eq_any(it begin, it end, needle_it needles_begin, needle_it needles_end)
+  {
+    if constexpr (impl::search::is_vectorizable_search<it, impl::search::value_of_t<needle_it>>())
+      if (!is_constant_evaluated() && impl::search::has_simd() && static_cast<std::size_t>(std::distance(needles_begin, needles_end)) <= impl::search::max_needles)
+        {
+          using element = impl::search::value_of_t<it>;
+          using needle_type = impl::search::value_of_t<needle_it>;
+
+          impl::search::lane_of_t<element> needles[impl::search::max_needles]{};
+          std::size_t needle_count = 0;
+
+          for (; needles_begin != needles_end; ++needles_begin)
+            if (auto const needle = impl::search::as_needle<element, needle_type>(*needles_begin))
+              needles[needle_count++] = *needle;
+          if (!needle_count || begin == end)
+            return end;
+
+          auto const first = impl::search::to_lanes(begin);
+
+          return begin + (impl::search::find_any(first, first + (end - begin), needles, needle_count) - first);
+        }
+    for (; begin != end; ++begin)
+      for (auto needle = needles_begin; needle != needles_end; ++needle)
+        if (*begin == *needle)
+          return begin;
+    return end;
+  }
+
+  template<class it, class T>
+  constexpr it find_if_eq_any(it begin, it end, std::initializer_list<T> needles)
+  {
+    return claws::find_if_eq_any(begin, end, needles.begin(), needles.end());
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::count`
+  ///
+  /// Vectorised the same way as `claws::find`.
+  ///
+  template<class it, class T>
+  constexpr typename std::iterator_traits<it>::difference_type count(it begin, it end, T const &value)
+  {
+    using difference_type = typename std::iterator_traits<it>::difference_type;
+
+    if constexpr (impl::search::is_vectorizable_search<it, T>())
+      if (!is_constant_evaluated() && impl::search::has_simd())
+        {
+          using element = impl::search::value_of_t<it>;
+
+          auto const needle = impl::search::as_needle<element, std::remove_cv_t<T>>(value);
+
+          if (!needle || begin == end)
+            return 0;
+
+          auto const first = impl::search::to_lanes(begin);
+
+          return static_cast<difference_type>(impl::search::count(first, first + (end - begin), *needle));
+        }
+
+    difference_type result = 0;
+
+    for (; begin != end; ++begin)
+      if (*begin == value)
+        ++result;
+    return result;
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::mismatch`
+  ///
+  /// `lh_begin` and `rh_begin` ranges of the same value type are compared with the SIMD kernel of the active `claws::simd_tier`.
+  ///
+  template<class lh_it, class rh_it>
+  constexpr std::pair<lh_it, rh_it> mismatch(lh_it lh_begin, lh_it lh_end, rh_it rh_begin)
+  {
+    if constexpr (impl::search::is_vectorizable<lh_it>() && impl::search::is_vectorizable<rh_it>()
+                  && std::is_same_v<impl::search::value_of_t<lh_it>, impl::search::value_of_t<rh_it>>)
+      if (!is_constant_evaluated() && impl::search::has_simd())
+        {
+          if (lh_begin == lh_end)
+            return {lh_begin, rh_begin};
+
+          auto const size = static_cast<std::size_t>(lh_end - lh_begin);
+          auto const offset = static_cast<std::ptrdiff_t>(impl::search::mismatch(impl::search::to_lanes(lh_begin), impl::search::to_lanes(rh_begin), size));
+
+          return {lh_begin + offset, rh_begin + offset};
+        }
+    while (lh_begin != lh_end && *lh_begin == *rh_begin)
+      {
+        ++lh_begin;
+        ++rh_begin;
+      }
+    return {lh_begin, rh_begin};
+  }
+
+  ///
+  /// \brief `constexpr` equivalent of `std::minmax_element`
+  ///
+  /// Returns the first smallest and the last greatest element, `{end, end}` if the range is empty.
+  /// Contiguous ranges of integers or `claws::tagged_data` of integers are reduced with SIMD min/max,
+  /// then both positions are located with the vectorised `find`.
+  /// Floating point ranges stay scalar to keep `std::minmax_element`'s NaN behaviour.
+  ///
+  template<class it>
+  constexpr std::pair<it, it> minmax_element(it begin, it end)
+  {
+#if defined(CLAWS_SIMD_X86)
+    if constexpr (impl::search::is_vectorizable<it>())
+      {
+        using lane = impl::search::lane_of_t<impl::search::value_of_t<it>>;
+
+        if constexpr (std::is_integral_v<lane>)
+          if (!is_constant_evaluated() && begin != end)
+            {
+              auto const first = impl::search::to_lanes(begin);
+              auto const size = static_cast<std::size_t>(end - begin);
+              lane min{};
+              lane max{};
+
+              if (impl::search::min_max(first, size, min, max))
+                return {begin + (impl::search::find(first, first + size, min) - first), begin + (impl::search::find_last(first, first + size, max) - first)};
+            }
+      }
+#endif
+    std::pair<it, it> result{begin, begin};
+
+    if (begin == end)
+      return result;
+    while (++begin != end)
+      {
+        if (*begin < *result.first)
+          result.first = begin;
+        else if (!(*begin < *result.second))
+          result.second = begin;
+      }
+    return result;
+  }
+}
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace pdq
+    {
+      /// Partitions below this size are sorted with insertion sort
+      inline constexpr std::ptrdiff_t insertion_sort_threshold = 24;
+
+      /// Partitions above this size use Tukey's ninther to select the pivot
+      inline constexpr std::ptrdiff_t ninther_threshold = 128;
+
+      /// When the partition was already partitioned, insertion sort is attempted, but bails out after this many element moves
+      inline constexpr std::size_t partial_insertion_sort_limit = 8;
+
+      /// Number of elements classified at once by the branchless partition
+      inline constexpr std::size_t block_size = 64;
+
+      template<class T>
+      struct is_cheaply_comparable : std::is_arithmetic<T>
+      {};
+
+      template<class data_type, class offset_type, class tag>
+      struct is_cheaply_comparable<tagged_data<data_type, offset_type, tag>> : std::is_arithmetic<data_type>
+      {};
+
+      template<class T, class comp_type>
+      struct is_cheap_comparison : std::false_type
+      {};
+
+      template<class T>
+      struct is_cheap_comparison<T, std::less<>> : is_cheaply_comparable<T>
+      {};
+
+      template<class T>
+      struct is_cheap_comparison<T, std::greater<>> : is_cheaply_comparable<T>
+      {};
+
+      template<class T>
+      struct is_cheap_comparison<T, std::less<T>> : is_cheaply_comparable<T>
+      {};
+
+      template<class T>
+      struct is_cheap_comparison<T, std::greater<T>> : is_cheaply_comparable<T>
+      {};
+
+      template<class it>
+      constexpr void swap_values(it lh, it rh)
+      {
+        auto tmp(std::move(*lh));
+
+        *lh = std::move(*rh);
+        *rh = std::move(tmp);
+      }
+
+      template<class it, class comp_type>
+      constexpr void sort2(it a, it b, comp_type &comp)
+      {
+        if (comp(*b, *a))
+          swap_values(a, b);
+      }
+
+      template<class it, class comp_type>
+      constexpr void sort3(it a, it b, it c, comp_type &comp)
+      {
+        sort2(a, b, comp);
+        sort2(b, c, comp);
+        sort2(a, b, comp);
+      }
+
+      template<class it, class comp_type>
+      constexpr void insertion_sort(it begin, it end, comp_type &comp)
+      {
+        if (begin == end)
+          return;
+        for (it current = begin + 1; current != end; ++current)
+          {
+            it sift = current;
+            it sift_1 = current - 1;
+
+            if (comp(*sift, *sift_1))
+              {
+                auto tmp(std::move(*sift));
+
+                do
+                  {
+                    *sift-- = std::move(*sift_1);
+                  }
+                while (sift != begin && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+              }
+          }
+      }
+
+      /// Insertion sort assuming `*(begin - 1)` is not greater than any element of the range
+      template<class it, class comp_type>
+      constexpr void unguarded_insertion_sort(it begin, it end, comp_type &comp)
+      {
+        if (begin == end)
+          return;
+        for (it current = begin + 1; current != end; ++current)
+          {
+            it sift = current;
+            it sift_1 = current - 1;
+
+            if (comp(*sift, *sift_1))
+              {
+                auto tmp(std::move(*sift));
+
+                do
+                  {
+                    *sift-- = std::move(*sift_1);
+                  }
+                while (comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+              }
+          }
+      }
+
+      /// Insertion sort which gives up (returning `false`) after `partial_insertion_sort_limit` moves
+      template<class it, class comp_type>
+      constexpr bool partial_insertion_sort(it begin, it end, comp_type &comp)
+      {
+        if (begin == end)
+          return true;
+
+        std::size_t moves = 0;
+
+        for (it current = begin + 1; current != end; ++current)
+          {
+            it sift = current;
+            it sift_1 = current - 1;
+
+            if (comp(*sift, *sift_1))
+              {
+                auto tmp(std::move(*sift));
+
+                do
+                  {
+                    *sift-- = std::move(*sift_1);
+                  }
+                while (sift != begin && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+                moves += static_cast<std::size_t>(current - sift);
+              }
+            if (moves > partial_insertion_sort_limit)
+              return false;
+          }
+        return true;
+      }
+
+      template<class it, class comp_type>
+      constexpr void sift_down(it begin, std::ptrdiff_t size, std::ptrdiff_t start, comp_type &comp)
+      {
+        auto value(std::move(begin[start]));
+
+        for (std::ptrdiff_t child = 2 * start + 1; child < size; child = 2 * start + 1)
+          {
+            if (child + 1 < size && comp(begin[child], begin[child + 1]))
+              ++child;
+            if (!comp(value, begin[child]))
+              break;
+            begin[start] = std::move(begin[child]);
+            start = child;
+          }
+        begin[start] = std::move(value);
+      }
+
+      template<class it, class comp_type>
+      constexpr void heap_sort(it begin, it end, comp_type &comp)
+      {
+        std::ptrdiff_t const size = end - begin;
+
+        for (std::ptrdiff_t start = size / 2 - 1; start >= 0; --start)
+          sift_down(begin, size, start, comp);
+        for (std::ptrdiff_t last = size - 1; last > 0; --last)
+          {
+            swap_values(begin, begin + last);
+            sift_down(begin, last, 0, comp);
+          }
+      }
+
+      /// Moves elements of `first + offsets_l[i]` to `last - offsets_r[i]` and vice versa, as a cyclic permutation when `use_swaps` is false.
+      template<class it>
+      constexpr void swap_offsets(it first, it last, unsigned char const *offsets_l, unsigned char const *offsets_r, std::size_t count, bool use_swaps)
+      {
+        if (use_swaps)
+          {
+            // Needed when the same number of elements is misplaced on both sides, which a cyclic permutation can't handle.
+            for (std::size_t i = 0; i < count; ++i)
+              swap_values(first + offsets_l[i], last - offsets_r[i]);
+          }
+        else if (count > 0)
+          {
+            it l = first + offsets_l[0];
+            it r = last - offsets_r[0];
+            auto tmp(std::move(*l));
+
+            *l = std::move(*r);
+            for (std::size_t i = 1; i < count; ++i)
+              {
+                l = first + offsets_l[i];
+                *r = std::move(*l);
+                r = last - offsets_r[i];
+                *l = std::move(*r);
+              }
+            *r = std::move(tmp);
+          }
+      }
+
+      ///
+      /// \brief Partitions around `*begin`, elements equal to the pivot go right.
+      ///
+      /// Returns the pivot's final position, and whether the range was already partitioned.
+      /// Assumes the range holds at least 3 elements, and that the median of 3 has been computed.
+      ///
+      template<class it, class comp_type>
+      constexpr std::pair<it, bool> partition_right(it begin, it end, comp_type &comp)
+      {
+        auto pivot(std::move(*begin));
+        it first = begin;
+        it last = end;
+
+        // Pivot is a median so these loops are guarded on the side they scan towards
+        while (comp(*++first, pivot))
+          ;
+        if (first - 1 == begin)
+          while (first < last && !comp(*--last, pivot))
+            ;
+        else
+          while (!comp(*--last, pivot))
+            ;
+
+        bool const already_partitioned = first >= last;
+
+        while (first < last)
+          {
+            swap_values(first, last);
+            while (comp(*++first, pivot))
+              ;
+            while (!comp(*--last, pivot))
+              ;
+          }
+
+        it pivot_position = first - 1;
+
+        *begin = std::move(*pivot_position);
+        *pivot_position = std::move(pivot);
+        return {pivot_position, already_partitioned};
+      }
+
+      ///
+      /// \brief Same as `partition_right`, but classifies elements by blocks of offsets to avoid branch mispredictions.
+      ///
+      /// This is the BlockQuicksort scheme: comparison results only feed offset counters, and misplaced elements are swapped in bulk.
+      ///
+      template<class it, class comp_type>
+      constexpr std::pair<it, bool> partition_right_branchless(it begin, it end, comp_type &comp)
+      {
+        auto pivot(std::move(*begin));
+        it first = begin;
+        it last = end;
+
+        while (comp(*++first, pivot))
+          ;
+        if (first - 1 == begin)
+          while (first < last && !comp(*--last, pivot))
+            ;
+        else
+          while (!comp(*--last, pivot))
+            ;
+
+        bool const already_partitioned = first >= last;
+
+        if (!already_partitioned)
+          {
+            swap_values(first, last);
+            ++first;
+
+            unsigned char offsets_l[block_size]{};
+            unsigned char offsets_r[block_size]{};
+            it offsets_l_base = first;
+            it offsets_r_base = last;
+            std::size_t count_l = 0;
+            std::size_t count_r = 0;
+            std::size_t start_l = 0;
+            std::size_t start_r = 0;
+
+            while (first < last)
+              {
+                // Only fill a side's offsets once all its previous offsets are consumed
+                auto const unknown = static_cast<std::size_t>(last - first);
+                std::size_t const left_split = count_l == 0 ? (count_r == 0 ? unknown / 2 : unknown) : 0;
+                std::size_t const right_split = count_r == 0 ? (unknown - left_split) : 0;
+                std::size_t const left_count = left_split < block_size ? left_split : block_size;
+                std::size_t const right_count = right_split < block_size ? right_split : block_size;
+
+                for (std::size_t i = 0; i < left_count; ++i, ++first)
+                  {
+                    offsets_l[count_l] = static_cast<unsigned char>(i);
+                    count_l += !comp(*first, pivot);
+                  }
+                for (std::size_t i = 0; i < right_count;)
+                  {
+                    offsets_r[count_r] = static_cast<unsigned char>(++i);
+                    count_r += comp(*--last, pivot);
+                  }
+
+                std::size_t const count = count_l < count_r ? count_l : count_r;
+
+                swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, count, count_l == count_r);
+                count_l -= count;
+                count_r -= count;
+                start_l += count;
+                start_r += count;
+                if (count_l == 0)
+                  {
+                    start_l = 0;
+                    offsets_l_base = first;
+                  }
+                if (count_r == 0)
+                  {
+                    start_r = 0;
+                    offsets_r_base = last;
+                  }
+              }
+
+            // Either the left or the right side may still hold misplaced elements, move them next to the pivot's position
+            if (count_l)
+              {
+                while (count_l--)
+                  swap_values(offsets_l_base + offsets_l[start_l + count_l], --last);
+                first = last;
+              }
+            if (count_r)
+              {
+                while (count_r--)
+                  {
+                    swap_values(offsets_r_base - offsets_r[start_r + count_r], first);
+                    ++first;
+                  }
+                last = first;
+              }
+          }
+
+        it pivot_position = first - 1;
+
+        *begin = std::move(*pivot_position);
+        *pivot_position = std::move(pivot);
+        return {pivot_position, already_partitioned};
+      }
+
+      ///
+      /// \brief Partitions around `*begin`, elements equal to the pivot go left.
+      ///
+      /// Used when the pivot equals the element preceding the range: everything equal to it is then at its final place.
+      ///
+      template<class it, class comp_type>
+      constexpr it partition_left(it begin, it end, comp_type &comp)
+      {
+        auto pivot(std::move(*begin));
+        it first = begin;
+        it last = end;
+
+        while (comp(pivot, *--last))
+          ;
+        if (last + 1 == end)
+          while (first < last && !comp(pivot, *++first))
+            ;
+        else
+          while (!comp(pivot, *++first))
+            ;
+        while (first < last)
+          {
+            swap_values(first, last);
+            while (comp(pivot, *--last))
+              ;
+            while (!comp(pivot, *++first))
+              ;
+          }
+
+        it pivot_position = last;
+
+        *begin = std::move(*pivot_position);
+        *pivot_position = std::move(pivot);
+        return pivot_position;
+      }
+
+      template<bool branchless, class it, class comp_type>
+      constexpr void sort_loop(it begin, it end, comp_type &comp, int bad_allowed, bool leftmost)
+      {
+        while (true)
+          {
+            std::ptrdiff_t const size = end - begin;
+
+            if (size < insertion_sort_threshold)
+              {
+                if (leftmost)
+                  insertion_sort(begin, end, comp);
+                else
+                  unguarded_insertion_sort(begin, end, comp);
+                return;
+              }
+
+            std::ptrdiff_t const half = size / 2;
+
+            if (size > ninther_threshold)
+              {
+                sort3(begin, begin + half, end - 1, comp);
+                sort3(begin + 1, begin + (half - 1), end - 2, comp);
+                sort3(begin + 2, begin + (half + 1), end - 3, comp);
+                sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+                swap_values(begin, begin + half);
+              }
+            else
+              sort3(begin + half, begin, end - 1, comp);
+
+            // If the pivot equals the preceding element, this partition only contains elements greater or equal to the pivot.
+            // Put all elements equal to the pivot on their final place at once, this is what makes many duplicates linear.
+            if (!leftmost && !comp(*(begin - 1), *begin))
+              {
+                begin = partition_left(begin, end, comp) + 1;
+                continue;
+              }
+
+            auto const [pivot_position, already_partitioned] = branchless ? partition_right_branchless(begin, end, comp) : partition_right(begin, end, comp);
+            std::ptrdiff_t const left_size = pivot_position - begin;
+            std::ptrdiff_t const right_size = end - (pivot_position + 1);
+
+            if (left_size < size / 8 || right_size < size / 8)
+              {
+                // Too many bad pivots: fall back to a guaranteed O(n log n) algorithm
+                if (--bad_allowed == 0)
+                  {
+                    pdq::heap_sort(begin, end, comp);
+                    return;
+                  }
+
+                // Shuffle some elements around to break patterns that lead to bad pivots
+                if (left_size >= insertion_sort_threshold)
+                  {
+                    swap_values(begin, begin + left_size / 4);
+                    swap_values(pivot_position - 1, pivot_position - left_size / 4);
+                    if (left_size > ninther_threshold)
+                      {
+                        swap_values(begin + 1, begin + (left_size / 4 + 1));
+                        swap_values(begin + 2, begin + (left_size / 4 + 2));
+                        swap_values(pivot_position - 2, pivot_position - (left_size / 4 + 1));
+                        swap_values(pivot_position - 3, pivot_position - (left_size / 4 + 2));
+                      }
+                  }
+                if (right_size >= insertion_sort_threshold)
+                  {
+                    swap_values(pivot_position + 1, pivot_position + (1 + right_size / 4));
+                    swap_values(end - 1, end - right_size / 4);
+                    if (right_size > ninther_threshold)
+                      {
+                        swap_values(pivot_position + 2, pivot_position + (2 + right_size / 4));
+                        swap_values(pivot_position + 3, pivot_position + (3 + right_size / 4));
+                        swap_values(end - 2, end - (1 + right_size / 4));
+                        swap_values(end - 3, end - (2 + right_size / 4));
+                      }
+                  }
+              }
+            else if (already_partitioned && partial_insertion_sort(begin, pivot_position, comp) && partial_insertion_sort(pivot_position + 1, end, comp))
+              return; // Probably already sorted input, and it was cheap to check
+
+            // Recurse on the left side, loop on the right one
+            sort_loop<branchless>(begin, pivot_position, comp, bad_allowed, leftmost);
+            begin = pivot_position + 1;
+            leftmost = false;
+          }
+      }
+
+      constexpr int floor_log2(std::ptrdiff_t value)
+      {
+        int result = 0;
+
+        while (value >>= 1)
+          ++result;
+        return result;
+      }
+    }
+  }
+
+  ///
+  /// \brief `constexpr` pattern-defeating quicksort. Equivalent of `std::sort`.
+  ///
+  /// Introsort variant: median-of-3 (or ninther) pivots, insertion sort for small partitions,
+  /// linear time on sorted, reverse sorted and few-unique inputs, and heapsort when too many pivots are bad.
+  /// Arithmetic values and `claws::tagged_data` compared with `std::less` or `std::greater` use a branchless block partition.
+  ///
+  /// Not stable. Requires random access iterators.
+  ///
+  template<class random_it, class comp_type = std::less<>>
+  constexpr void sort(random_it begin, random_it end, comp_type comp = {})
+  {
+    using value_type = typename std::iterator_traits<random_it>::value_type;
+    constexpr bool branchless = impl::pdq::is_cheap_comparison<value_type, comp_type>::value;
+
+    if (end - begin < 2)
+      return;
+    impl::pdq::sort_loop<branchless>(begin, end, comp, impl::pdq::floor_log2(end - begin), true);
+  }
+
+  ///
+  /// \brief `constexpr` heapsort. Guaranteed O(n log n), and uses no extra memory.
+  ///
+  template<class random_it, class comp_type = std::less<>>
+  constexpr void heap_sort(random_it begin, random_it end, comp_type comp = {})
+  {
+    impl::pdq::heap_sort(begin, end, comp);
+  }
+
+  template<class it, class comp_type = std::less<>>
+  constexpr bool is_sorted(it begin, it end, comp_type comp = {})
+  {
+    if (begin == end)
+      return true;
+    for (it next = std::next(begin); next != end; ++begin, ++next)
+      if (comp(*next, *begin))
+        return false;
+    return true;
+  }
+}
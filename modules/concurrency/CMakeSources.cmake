@@ -0,0 +1,21 @@
+set(MODULE_PATH
+        ${CMAKE_CURRENT_SOURCE_DIR}/claws/concurrency)
+
+set(MODULE_PUBLIC_HEADERS
+        "${MODULE_PATH}/concurrent_hash_map.hpp"
+        "${MODULE_PATH}/deferred_delete.hpp"
+        "${MODULE_PATH}/object_pool.hpp"
+        "${MODULE_PATH}/rcu_handle.hpp"
+        "${MODULE_PATH}/seqlock.hpp"
+        "${MODULE_PATH}/sharded_counter.hpp"
+        "${MODULE_PATH}/string_interner.hpp"
+        )
+
+set(MODULE_PRIVATE_HEADERS
+        "${MODULE_PATH}/impl/thread_records.hpp"
+        )
+
+set(MODULE_SOURCES
+        ${MODULE_PUBLIC_HEADERS}
+        ${MODULE_PRIVATE_HEADERS}
+        )
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/container/flat_hash_map.hpp>
+#include <claws/container/hash.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace concurrent
+    {
+      template<class mutex_type, class = void>
+      struct is_shared_mutex : std::false_type
+      {};
+
+      template<class mutex_type>
+      struct is_shared_mutex<mutex_type, std::void_t<decltype(std::declval<mutex_type &>().lock_shared())>> : std::true_type
+      {};
+    }
+  }
+
+  ///
+  /// \brief Hash map shared between threads, split in independently locked shards.
+  ///
+  /// \tparam hash, key_equal as for `claws::flat_hash_map`, which each shard is
+  /// \tparam mutex_type locks a shard. If it has `lock_shared`, like the default `std::shared_mutex`, lookups of a shard run concurrently
+  ///
+  /// A key's shard is picked from the high bits of its hash, so threads working on different keys rarely wait for each other,
+  /// and each shard sits on its own cache lines so locking one doesn't slow down threads using its neighbours.
+  ///
+  /// Values never escape their shard's lock: lookups return copies, or call a function on the value while the lock is held.
+  /// That function must not use the map, as it could try to lock the same shard again.
+  ///
+  /// `find_many` and `insert_many` take random access ranges and group keys by shard first,
+  /// locking each shard once per call instead of once per key.
+  ///
+  template<class K, class V, class hash = mix_hash, class key_equal = std::equal_to<>, class mutex_type = std::shared_mutex>
+  class concurrent_hash_map
+  {
+  public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+    using map_type = flat_hash_map<K, V, hash, key_equal>;
+
+    static constexpr size_type default_shard_count = 64u;
+
+  private:
+    struct alignas(64) shard
+    {
+      mutable mutex_type mutex;
+      map_type map;
+    };
+
+    std::unique_ptr<shard[]> shards;
+    size_type shard_count;
+    /// `64 - log2(shard_count)`, 64 for a single shard
+    std::uint32_t shift;
+
+    static size_type round_shard_count(size_type count) noexcept
+    {
+      size_type result(1u);
+
+      while (result < count)
+        result *= 2u;
+      return result;
+    }
+
+    template<class key_arg_type>
+    size_type shard_index(key_arg_type const &key) const noexcept
+    {
+      // Shifting by 64 is undefined, a single shard has no bits to take
+      return shift == 64u ? 0u : static_cast<size_type>(impl::hash::spread(hash{}, key) >> shift);
+    }
+
+    template<class key_arg_type>
+    shard &shard_of(key_arg_type const &key) const noexcept
+    {
+      return shards[shard_index(key)];
+    }
+
+    static auto read_lock(shard const &target)
+    {
+      if constexpr (impl::concurrent::is_shared_mutex<mutex_type>::value)
+        return std::shared_lock<mutex_type>(target.mutex);
+      else
+        return std::unique_lock<mutex_type>(target.mutex);
+    }
+
+    static std::unique_lock<mutex_type> write_lock(shard const &target)
+    {
+      return std::unique_lock<mutex_type>(target.mutex);
+    }
+
+    ///
+    /// \brief Orders the `count` keys from `first` by shard, `key_of` giving the key of an element.
+    ///
+    /// Fills `order` with the elements' positions, and returns the offset of each shard's first element in it, plus `count` at the end.
+    ///
+    template<class iterator_type, class projection_type>
+    std::vector<size_type> group_by_shard(iterator_type first, size_type count, projection_type key_of, std::vector<size_type> &order) const
+    {
+      std::vector<size_type> offsets(shard_count + 1u, 0u);
+      std::vector<size_type> element_shards(count);
+
+      for (size_type i(0u); i != count; ++i)
+        {
+          element_shards[i] = shard_index(key_of(first[i]));
+          ++offsets[element_shards[i] + 1u];
+        }
+      for (size_type i(0u); i != shard_count; ++i)
+        offsets[i + 1u] += offsets[i];
+      order.resize(count);
+
+      auto next = offsets;
+
+      for (size_type i(0u); i != count; ++i)
+        order[next[element_shards[i]]++] = i;
+      return offsets;
+    }
+
+  public:
+    ///
+    /// \param shard_count rounded up to a power of two. A few times the number of threads using the map keeps waiting rare
+    ///
+    explicit concurrent_hash_map(size_type shard_count = default_shard_count)
+      : shards(new shard[round_shard_count(shard_count)])
+      , shard_count(round_shard_count(shard_count))
+      , shift(64u)
+    {
+      for (auto count = this->shard_count; count > 1u; count >>= 1u)
+        --shift;
+    }
+
+    concurrent_hash_map(concurrent_hash_map const &) = delete;
+    concurrent_hash_map &operator=(concurrent_hash_map const &) = delete;
+
+    ///
+    /// \brief Inserts `key` with a value constructed from `args` if it isn't in the map yet. Returns whether it was inserted.
+    ///
+    template<class key_arg_type, class... args_type>
+    bool try_emplace(key_arg_type &&key, args_type &&... args)
+    {
+      auto &target = shard_of(key);
+      auto const lock = write_lock(target);
+
+      return target.map.try_emplace(std::forward<key_arg_type>(key), std::forward<args_type>(args)...).second;
+    }
+
+    bool insert(K const &key, V const &value)
+    {
+      return try_emplace(key, value);
+    }
+
+    ///
+    /// \brief Assigns `value` to `key`, inserting it if needed. Returns whether it was inserted.
+    ///
+    template<class key_arg_type, class mapped_arg_type>
+    bool insert_or_assign(key_arg_type &&key, mapped_arg_type &&value)
+    {
+      auto &target = shard_of(key);
+      auto const lock = write_lock(target);
+
+      return target.map.insert_or_assign(std::forward<key_arg_type>(key), std::forward<mapped_arg_type>(value)).second;
+    }
+
+    ///
+    /// \brief Returns a copy of the value of `key`, if it is in the map.
+    ///
+    template<class key_arg_type>
+    std::optional<V> find(key_arg_type const &key) const
+    {
+      auto &target = shard_of(key);
+      auto const lock = read_lock(target);
+      auto const found = target.map.find(key);
+
+      if (found == target.map.end())
+        return std::nullopt;
+      return found->second;
+    }
+
+    template<class key_arg_type>
+    bool contains(key_arg_type const &key) const
+    {
+      auto &target = shard_of(key);
+      auto const lock = read_lock(target);
+
+      return target.map.contains(key);
+    }
+
+    ///
+    /// \brief Calls `function(value)` with the value of `key` under its shard's lock, if it is in the map. Returns whether it was.
+    ///
+    /// The non-const version locks the shard exclusively, so `function` can modify the value.
+    ///
+    template<class key_arg_type, class function_type>
+    bool visit(key_arg_type const &key, function_type &&function)
+    {
+      auto &target = shard_of(key);
+      auto const lock = write_lock(target);
+      auto const found = target.map.find(key);
+
+      if (found == target.map.end())
+        return false;
+      std::forward<function_type>(function)(found->second);
+      return true;
+    }
+
+    template<class key_arg_type, class function_type>
+    bool visit(key_arg_type const &key, function_type &&function) const
+    {
+      auto &target = shard_of(key);
+      auto const lock = read_lock(target);
+      auto const found = target.map.find(key);
+
+      if (found == target.map.end())
+        return false;
+      std::forward<function_type>(function)(static_cast<V const &>(found->second));
+      return true;
+    }
+
+    ///
+    /// \brief Erases `key`. Returns whether it was in the map.
+    ///
+    template<class key_arg_type>
+    bool erase(key_arg_type const &key)
+    {
+      auto &target = shard_of(key);
+      auto const lock = write_lock(target);
+
+      return target.map.erase(key) != 0u;
+    }
+
+    ///
+    /// \brief Looks up every key of `keys`, calling `function(index, value)` under the shard's lock for each key found.
+    ///
+    /// `index` is the key's position in `keys`. Keys are visited shard by shard, not in order. Returns how many keys were found.
+    ///
+    template<class key_range, class function_type>
+    size_type find_many(key_range const &keys, function_type &&function) const
+    {
+      auto const first = std::begin(keys);
+      std::vector<size_type> order;
+      auto const offsets = group_by_shard(first, static_cast<size_type>(std::size(keys)), [](auto const &key) -> auto const & { return key; }, order);
+      size_type found_count(0u);
+
+      for (size_type i(0u); i != shard_count; ++i)
+        {
+          if (offsets[i] == offsets[i + 1u])
+            continue;
+
+          auto const lock = read_lock(shards[i]);
+
+          for (auto j = offsets[i]; j != offsets[i + 1u]; ++j)
+            if (auto const found = shards[i].map.find(first[order[j]]); found != shards[i].map.end())
+              {
+                function(order[j], static_cast<V const &>(found->second));
+                ++found_count;
+              }
+        }
+      return found_count;
+    }
+
+    ///
+    /// \brief Inserts the `(key, value)` pairs of `entries` whose key isn't in the map yet. Returns how many were inserted.
+    ///
+    /// Pairs are inserted shard by shard: other threads may see some before others.
+    ///
+    template<class entry_range>
+    size_type insert_many(entry_range const &entries)
+    {
+      auto const first = std::begin(entries);
+      std::vector<size_type> order;
+      auto const offsets = group_by_shard(first, static_cast<size_type>(std::size(entries)), [](auto const &entry) -> auto const & { return entry.first; }, order);
+      size_type inserted(0u);
+
+      for (size_type i(0u); i != shard_count; ++i)
+        {
+          if (offsets[i] == offsets[i + 1u])
+            continue;
+
+          auto const lock = write_lock(shards[i]);
+
+          shards[i].map.reserve(shards[i].map.size() + (offsets[i + 1u] - offsets[i]));
+          for (auto j = offsets[i]; j != offsets[i + 1u]; ++j)
+            inserted += shards[i].map.try_emplace(first[order[j]].first, first[order[j]].second).second;
+        }
+      return inserted;
+    }
+
+    ///
+    /// \brief Calls `function(key, value)` for every value, one shard at a time under its lock.
+    ///
+    /// Values inserted or erased in other shards meanwhile may or may not be visited.
+    ///
+    template<class function_type>
+    void for_each(function_type &&function) const
+    {
+      for (size_type i(0u); i != shard_count; ++i)
+        {
+          auto const lock = read_lock(shards[i]);
+
+          for (auto const &[key, value] : shards[i].map)
+            function(key, value);
+        }
+    }
+
+    ///
+    /// \brief Number of values. Only exact if no other thread modifies the map meanwhile.
+    ///
+    size_type size() const
+    {
+      size_type result(0u);
+
+      for (size_type i(0u); i != shard_count; ++i)
+        {
+          auto const lock = read_lock(shards[i]);
+
+          result += shards[i].map.size();
+        }
+      return result;
+    }
+
+    bool empty() const
+    {
+      return !size();
+    }
+
+    void clear()
+    {
+      for (size_type i(0u); i != shard_count; ++i)
+        {
+          auto const lock = write_lock(shards[i]);
+
+          shards[i].map.clear();
+        }
+    }
+
+    size_type get_shard_count() const noexcept
+    {
+      return shard_count;
+    }
+  };
+}
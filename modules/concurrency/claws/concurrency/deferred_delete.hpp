@@ -0,0 +1,444 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/concurrency/impl/thread_records.hpp>
+
+namespace claws
+{
+  class deletion_queue;
+  class background_reclaimer;
+
+  namespace impl
+  {
+    ///
+    /// \brief A type-erased `(deleter, value)` pair waiting to be run.
+    ///
+    /// Small trivially copyable pairs (a stateless deleter and a pointer or a file descriptor) are stored inline,
+    /// others are boxed on the heap. Either way the entry itself is trivially copyable, so batches are plain arrays.
+    ///
+    class deferred_deletion
+    {
+      static constexpr std::size_t inline_size = 2 * sizeof(void *);
+
+      template<class deleter_type, class T>
+      struct payload
+      {
+        deleter_type deleter;
+        T value;
+      };
+
+      template<class payload_type>
+      static constexpr bool is_stored_inline = sizeof(payload_type) <= inline_size
+        && alignof(payload_type) <= alignof(void *)
+        && std::is_trivially_copyable_v<payload_type>;
+
+      void (*run_deleter)(unsigned char *storage) noexcept;
+      std::size_t bytes;
+      alignas(void *) unsigned char storage[inline_size];
+
+      template<class payload_type>
+      static void run_inline(unsigned char *storage) noexcept
+      {
+        auto &stored = *std::launder(reinterpret_cast<payload_type *>(storage));
+
+        stored.deleter(std::move(stored.value));
+      }
+
+      template<class payload_type>
+      static void run_boxed(unsigned char *storage) noexcept
+      {
+        payload_type *boxed;
+
+        std::memcpy(&boxed, storage, sizeof(boxed));
+
+        std::unique_ptr<payload_type> owner(boxed);
+
+        owner->deleter(std::move(owner->value));
+      }
+
+    public:
+      ///
+      /// \brief Returns `false` if the pair needed boxing and the allocation failed, in which case nothing was stored.
+      ///
+      template<class deleter_type, class T>
+      bool assign(deleter_type const &deleter, T &&value, std::size_t value_bytes) noexcept
+      {
+        using payload_type = payload<deleter_type, std::decay_t<T>>;
+
+        bytes = value_bytes;
+        if constexpr (is_stored_inline<payload_type>)
+          {
+            new (storage) payload_type{deleter, std::forward<T>(value)};
+            run_deleter = &run_inline<payload_type>;
+          }
+        else
+          {
+            static_assert(std::is_nothrow_move_constructible_v<std::decay_t<T>> && std::is_nothrow_copy_constructible_v<deleter_type>,
+                          "deferred values and deleters must be nothrow movable");
+
+            auto const boxed = new (std::nothrow) payload_type{deleter, std::forward<T>(value)};
+
+            if (!boxed)
+              return false;
+            std::memcpy(storage, &boxed, sizeof(boxed));
+            run_deleter = &run_boxed<payload_type>;
+          }
+        return true;
+      }
+
+      std::size_t size_in_bytes() const noexcept
+      {
+        return bytes;
+      }
+
+      void run() noexcept
+      {
+        run_deleter(storage);
+      }
+    };
+
+    static_assert(std::is_trivially_copyable_v<deferred_deletion>);
+
+    /// Deletions pushed by one thread, published to the queue as a whole
+    struct deletion_batch
+    {
+      deletion_batch *next{nullptr};
+      std::size_t bytes{0u};
+      std::vector<deferred_deletion> entries;
+    };
+
+    /// The batch of one thread for one `claws::deletion_queue`
+    struct deletion_thread_slot
+    {
+      std::unique_ptr<deletion_batch> batch;
+      /// The queue, and the thread using the slot if any: whichever lets go last deletes the slot
+      std::atomic<unsigned> owners{2u};
+      deletion_thread_slot *next{nullptr};
+    };
+
+    /// Returns `deleter.bytes_of(value)` if the deleter provides it, 0 otherwise
+    template<class deleter_type, class T>
+    auto released_bytes(deleter_type const &deleter, T const &value, int) noexcept -> decltype(static_cast<std::size_t>(deleter.bytes_of(value)))
+    {
+      return static_cast<std::size_t>(deleter.bytes_of(value));
+    }
+
+    template<class deleter_type, class T>
+    constexpr std::size_t released_bytes(deleter_type const &, T const &, long) noexcept
+    {
+      return 0u;
+    }
+
+    /// Returns `true` if `value == T{}`, `false` if `T` can't be compared that way
+    template<class T>
+    constexpr auto is_empty_value(T const &value, int) noexcept -> decltype(static_cast<bool>(value == T{}))
+    {
+      return static_cast<bool>(value == T{});
+    }
+
+    template<class T>
+    constexpr bool is_empty_value(T const &, long) noexcept
+    {
+      return false;
+    }
+  }
+
+  ///
+  /// \brief Collects deletions so they can run in bulk, away from the code releasing the resources.
+  ///
+  /// Each thread pushing into a queue fills a private batch, without synchronisation.
+  /// A batch is published to the queue once it holds `batch_items` deletions or `batch_bytes` bytes,
+  /// and when its thread calls `flush()` or `drain()`. The batch of an exiting thread is left to the queue.
+  /// Published and left batches are run by `drain()`, `reclaim_published()` or a `claws::background_reclaimer`.
+  ///
+  /// The destructor runs every deletion pushed before it, published or not, so every push must happen before it.
+  /// Threads may outlive the queue: they forget it the next time they push into a queue for the first time.
+  ///
+  class deletion_queue
+  {
+    friend class background_reclaimer;
+
+    std::size_t const batch_items;
+    std::size_t const batch_bytes;
+    impl::thread_records<impl::deletion_thread_slot> slots;
+    std::atomic<impl::deletion_batch *> published{nullptr};
+    std::atomic<std::size_t> pending_item_count{0u};
+    std::atomic<std::size_t> pending_byte_count{0u};
+    std::atomic<unsigned> reclaimer_count{0u};
+    /// Only used to put reclaimers to sleep
+    std::mutex reclaimer_mutex;
+    std::condition_variable reclaimer_wakeup;
+
+    /// Runs the batches chained from `batch`, returns how many deletions ran
+    std::size_t run_batches(std::unique_ptr<impl::deletion_batch> batch) noexcept
+    {
+      std::size_t items(0u);
+      std::size_t bytes(0u);
+
+      while (batch)
+        {
+          for (auto &entry : batch->entries)
+            entry.run();
+          items += batch->entries.size();
+          bytes += batch->bytes;
+          batch.reset(std::exchange(batch->next, nullptr));
+        }
+      pending_item_count.fetch_sub(items, std::memory_order_relaxed);
+      pending_byte_count.fetch_sub(bytes, std::memory_order_relaxed);
+      return items;
+    }
+
+    void publish(std::unique_ptr<impl::deletion_batch> batch) noexcept
+    {
+      auto const node = batch.release();
+
+      node->next = published.load(std::memory_order_relaxed);
+      while (!published.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        ;
+      if (reclaimer_count.load(std::memory_order_relaxed))
+        reclaimer_wakeup.notify_all();
+    }
+
+    bool has_published() const noexcept
+    {
+      return published.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /// Returns a batch with room for `batch_items` entries, `nullptr` if it couldn't be allocated or the thread is exiting
+    std::unique_ptr<impl::deletion_batch> *get_thread_batch() noexcept
+    {
+      // The calling thread's batches were already left to their queues
+      if (slots.is_thread_exiting())
+        return nullptr;
+      try
+        {
+          auto &found = slots.get().batch;
+
+          if (!found)
+            {
+              auto batch = std::make_unique<impl::deletion_batch>();
+
+              batch->entries.reserve(batch_items);
+              found = std::move(batch);
+            }
+          return &found;
+        }
+      catch (std::bad_alloc const &)
+        {
+          return nullptr;
+        }
+    }
+
+  public:
+    static constexpr std::size_t default_batch_items = 256u;
+    static constexpr std::size_t default_batch_bytes = std::size_t(1u) << 20u;
+
+    explicit deletion_queue(std::size_t batch_items = default_batch_items, std::size_t batch_bytes = default_batch_bytes) noexcept
+      : batch_items(batch_items ? batch_items : 1u)
+      , batch_bytes(batch_bytes)
+    {}
+
+    deletion_queue(deletion_queue const &) = delete;
+    deletion_queue &operator=(deletion_queue const &) = delete;
+
+    ~deletion_queue()
+    {
+      drain();
+      // Threads still alive delete their slot when they exit, or when they forget the queue
+      for (auto slot = slots.first(); slot; slot = slot->next)
+        run_batches(std::move(slot->batch));
+    }
+
+    ///
+    /// \brief Queues `deleter(std::move(value))`, accounting for `bytes` bytes until it runs.
+    ///
+    /// Never throws: if memory for the queue can't be allocated, or if the calling thread's batches were already left
+    /// to their queues because it is exiting, the deleter runs immediately instead.
+    ///
+    template<class deleter_type, class T>
+    void push(deleter_type const &deleter, T &&value, std::size_t bytes = 0u) noexcept
+    {
+      auto const batch = get_thread_batch();
+      impl::deferred_deletion entry;
+
+      if (!batch || !entry.assign(deleter, std::forward<T>(value), bytes))
+        {
+          deleter_type copy(deleter);
+
+          copy(std::forward<T>(value));
+          return;
+        }
+
+      auto &current = **batch;
+
+      current.entries.push_back(entry);
+      current.bytes += bytes;
+      pending_item_count.fetch_add(1u, std::memory_order_relaxed);
+      pending_byte_count.fetch_add(bytes, std::memory_order_relaxed);
+      if (current.entries.size() >= batch_items || current.bytes >= batch_bytes)
+        publish(std::move(*batch));
+    }
+
+    ///
+    /// \brief Publishes the calling thread's batch, without running it.
+    ///
+    void flush() noexcept
+    {
+      if (auto const slot = slots.find(); slot && slot->batch && !slot->batch->entries.empty())
+        publish(std::move(slot->batch));
+    }
+
+    ///
+    /// \brief Runs every published deletion, and those left by exited threads, on the calling thread. Returns how many ran.
+    ///
+    /// Deletions run in no particular order.
+    ///
+    std::size_t reclaim_published() noexcept
+    {
+      auto items = run_batches(std::unique_ptr<impl::deletion_batch>(published.exchange(nullptr, std::memory_order_acquire)));
+
+      for (auto slot = slots.first(); slot; slot = slot->next)
+        // Claimed like a thread would, so a thread taking the slot over doesn't race with us
+        if (slots.claim(*slot))
+          {
+            auto batch = std::move(slot->batch);
+
+            slots.unclaim(*slot);
+            items += run_batches(std::move(batch));
+          }
+      return items;
+    }
+
+    ///
+    /// \brief Flushes the calling thread's batch, then runs every published deletion. Returns how many ran.
+    ///
+    /// Other threads' unpublished batches aren't touched: this is the safe point for the calling thread only.
+    ///
+    std::size_t drain() noexcept
+    {
+      flush();
+      return reclaim_published();
+    }
+
+    /// \brief Deletions pushed but not run yet, published or not.
+    std::size_t pending_items() const noexcept
+    {
+      return pending_item_count.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Sum of the byte counts of deletions pushed but not run yet, published or not.
+    std::size_t pending_bytes() const noexcept
+    {
+      return pending_byte_count.load(std::memory_order_relaxed);
+    }
+  };
+
+  ///
+  /// \brief Process-wide queue used by `claws::deferred_delete` by default.
+  ///
+  inline deletion_queue &get_default_deletion_queue() noexcept
+  {
+    static deletion_queue queue;
+
+    return queue;
+  }
+
+  ///
+  /// \ingroup handles
+  /// \brief Deleter adaptor pushing deletions to a `claws::deletion_queue` instead of running them.
+  ///
+  /// \tparam deleter_type the wrapped deleter, inherited to benefit from empty base optimisation
+  /// \tparam get_queue returns the queue to push into
+  ///
+  /// Empty values (equal to `T{}`) are skipped, so moved-from handles cost nothing.
+  /// If `deleter_type` has a `bytes_of(value)` member, it is used to account for the memory waiting to be released.
+  ///
+  /// Deferred values and stateful deleters are copied into the queue, and must be nothrow movable.
+  ///
+  template<class deleter_type, deletion_queue &(*get_queue)() noexcept = get_default_deletion_queue>
+  struct deferred_delete : public deleter_type
+  {
+    using deleter_type::deleter_type;
+
+    constexpr deferred_delete() = default;
+
+    constexpr deferred_delete(deleter_type const &deleter)
+      : deleter_type(deleter)
+    {}
+
+    template<class T>
+    void operator()(T &&value) const noexcept
+    {
+      auto const &deleter = static_cast<deleter_type const &>(*this);
+
+      if (impl::is_empty_value(value, 0))
+        return;
+      get_queue().push(deleter, std::forward<T>(value), impl::released_bytes(deleter, value, 0));
+    }
+  };
+
+  ///
+  /// \brief Thread running a `claws::deletion_queue`'s published deletions as they come.
+  ///
+  /// The thread wakes up when a batch is published, and at least every `period` to pick up missed wake-ups
+  /// and the batches of exited threads.
+  /// Stops on destruction, after a last `reclaim_published()`. Must be destroyed before its queue.
+  ///
+  class background_reclaimer
+  {
+    deletion_queue &queue;
+    std::chrono::milliseconds period;
+    bool stopping{false};
+    std::thread thread;
+
+    void run() noexcept
+    {
+      std::unique_lock lock(queue.reclaimer_mutex);
+
+      while (!stopping)
+        {
+          queue.reclaimer_wakeup.wait_for(lock, period, [this]() noexcept { return stopping || queue.has_published(); });
+          lock.unlock();
+          queue.reclaim_published();
+          lock.lock();
+        }
+    }
+
+  public:
+    explicit background_reclaimer(deletion_queue &queue, std::chrono::milliseconds period = std::chrono::milliseconds(10))
+      : queue(queue)
+      , period(period)
+    {
+      thread = std::thread([this]() noexcept { run(); });
+      queue.reclaimer_count.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    background_reclaimer(background_reclaimer const &) = delete;
+    background_reclaimer &operator=(background_reclaimer const &) = delete;
+
+    ~background_reclaimer()
+    {
+      {
+        std::lock_guard lock(queue.reclaimer_mutex);
+
+        stopping = true;
+      }
+      queue.reclaimer_wakeup.notify_all();
+      thread.join();
+      queue.reclaimer_count.fetch_sub(1u, std::memory_order_relaxed);
+      queue.reclaim_published();
+    }
+  };
+}
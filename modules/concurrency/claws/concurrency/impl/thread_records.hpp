@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace claws
+{
+  namespace impl
+  {
+    ///
+    /// \brief Records private to each thread using an owner (a queue, a domain, a pool), listed by the owner.
+    ///
+    /// `record_type` must be default constructible with `std::atomic<unsigned> owners{2u}` and `record_type *next{nullptr}` members.
+    /// A record is owned by the owner, and by the thread using it if any: whichever lets go last deletes it.
+    /// The record of an exited thread is taken over by the next thread using the owner, with whatever it holds.
+    ///
+    /// Each thread keeps the records it uses in a list keyed by owner ids, ids not being reused unlike addresses.
+    /// Threads may outlive the owner: the records of destroyed owners are dropped from the calling thread's list
+    /// the next time it uses an owner for the first time, so threads outliving many owners don't scan an ever growing list.
+    ///
+    template<class record_type>
+    class thread_records
+    {
+      struct thread_list
+      {
+        std::vector<std::pair<std::uint64_t, record_type *>> records;
+
+        ~thread_list()
+        {
+          get_thread_exiting() = true;
+          // The owners may be gone: what the records hold is left to them
+          for (auto const &[id, record] : records)
+            release(*record);
+        }
+      };
+
+      /// Distinguishes owners reusing the address of a destroyed one in the threads' lists
+      std::uint64_t const id{get_counter().fetch_add(1u, std::memory_order_relaxed) + 1u};
+      std::atomic<record_type *> head{nullptr};
+
+      static std::atomic<std::uint64_t> &get_counter() noexcept
+      {
+        static std::atomic<std::uint64_t> counter{0u};
+
+        return counter;
+      }
+
+      /// Trivially destructible, so it can still be read while other thread locals are destroyed
+      static bool &get_thread_exiting() noexcept
+      {
+        thread_local bool exiting{false};
+
+        return exiting;
+      }
+
+      static thread_list &get_thread_list() noexcept
+      {
+        thread_local thread_list list;
+
+        return list;
+      }
+
+      /// Takes over the record of an exited thread, or adds a new one
+      record_type &acquire()
+      {
+        for (auto record = head.load(std::memory_order_acquire); record; record = record->next)
+          if (claim(*record))
+            return *record;
+
+        auto const record = new record_type;
+
+        record->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed))
+          ;
+        return *record;
+      }
+
+    public:
+      thread_records() noexcept = default;
+      thread_records(thread_records const &) = delete;
+      thread_records &operator=(thread_records const &) = delete;
+
+      /// Records of threads still alive are deleted when they exit, or when they drop them
+      ~thread_records()
+      {
+        for (auto record = head.load(std::memory_order_acquire); record;)
+          release(*std::exchange(record, record->next));
+      }
+
+      static void release(record_type &record) noexcept
+      {
+        if (record.owners.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+          delete &record;
+      }
+
+      ///
+      /// \brief Claims the record of an exited thread, as a thread taking it over would. Undone by `unclaim`.
+      ///
+      static bool claim(record_type &record) noexcept
+      {
+        unsigned unused = 1u;
+
+        return record.owners.load(std::memory_order_relaxed) == unused
+          && record.owners.compare_exchange_strong(unused, 2u, std::memory_order_acquire, std::memory_order_relaxed);
+      }
+
+      static void unclaim(record_type &record) noexcept
+      {
+        record.owners.fetch_sub(1u, std::memory_order_release);
+      }
+
+      /// \brief Whether the calling thread's list was destroyed, so it can't get records anymore.
+      static bool is_thread_exiting() noexcept
+      {
+        return get_thread_exiting();
+      }
+
+      /// \brief Every record of the owner, used or not, to be walked through `next`.
+      record_type *first() const noexcept
+      {
+        return head.load(std::memory_order_acquire);
+      }
+
+      ///
+      /// \brief The calling thread's record, `nullptr` if it has none yet or is exiting. Never allocates.
+      ///
+      record_type *find() const noexcept
+      {
+        if (get_thread_exiting())
+          return nullptr;
+        for (auto const &[record_id, record] : get_thread_list().records)
+          if (record_id == id)
+            return record;
+        return nullptr;
+      }
+
+      ///
+      /// \brief The calling thread's record, added first if it has none. The thread must not be exiting.
+      ///
+      record_type &get()
+      {
+        if (auto const found = find())
+          return *found;
+
+        auto &records = get_thread_list().records;
+
+        for (std::size_t i(0u); i != records.size();)
+          if (records[i].second->owners.load(std::memory_order_acquire) == 1u)
+            {
+              release(*records[i].second);
+              records[i] = records.back();
+              records.pop_back();
+            }
+          else
+            ++i;
+        records.reserve(records.size() + 1u);
+
+        auto &record = acquire();
+
+        records.emplace_back(id, &record);
+        return record;
+      }
+    };
+  }
+}
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/concurrency/impl/thread_records.hpp>
+#include <claws/utils/handle_types.hpp>
+#include <claws/utils/padded.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    struct pool_free_slot
+    {
+      pool_free_slot *next;
+    };
+
+    /// Free slots of one thread for one `claws::fixed_pool`, on its own cache line so threads don't share lines
+    struct alignas(cache_line_size) pool_thread_cache
+    {
+      pool_free_slot *head{nullptr};
+      std::size_t count{0u};
+      /// The pool, and the thread using the cache if any: whichever lets go last deletes the cache
+      std::atomic<unsigned> owners{2u};
+      pool_thread_cache *next{nullptr};
+    };
+  }
+
+  ///
+  /// \brief Allocator of fixed-size slots, each thread allocating from and freeing to its own free list.
+  ///
+  /// Allocating pops the calling thread's list and freeing pushes to it, without locking nor atomic operations.
+  /// Threads exchange slots with a shared list, under a mutex, `batch_size` slots at a time:
+  /// when their list runs out, or grows past twice `batch_size` because they free more than they allocate.
+  /// Slots come from chunks of `chunk_slots` slots, given back when the pool is destroyed.
+  ///
+  /// A `std::pmr::memory_resource`: requests larger than a slot, or more aligned, go to `operator new`.
+  /// Slots may be freed by any thread, and must be freed before the pool is destroyed.
+  /// The free list of an exiting thread is kept for the next thread using the pool.
+  /// A thread forgets the caches of destroyed pools the next time it uses a pool for the first time.
+  ///
+  class fixed_pool : public std::pmr::memory_resource
+  {
+  public:
+    static constexpr std::size_t batch_size = 32u;
+    static constexpr std::size_t default_chunk_slots = 256u;
+
+  private:
+    std::size_t const slot_alignment;
+    std::size_t const slot_size;
+    std::size_t const chunk_slots;
+    impl::thread_records<impl::pool_thread_cache> caches;
+    std::mutex shared_mutex;
+    impl::pool_free_slot *shared_head{nullptr};
+    std::vector<void *> chunks;
+
+    static std::size_t round_up(std::size_t value, std::size_t alignment) noexcept
+    {
+      return (value + alignment - 1u) & ~(alignment - 1u);
+    }
+
+    /// Takes a batch from the shared list, or carves a new chunk, into the empty `cache`
+    void refill(impl::pool_thread_cache &cache)
+    {
+      std::byte *chunk;
+      {
+        std::lock_guard lock(shared_mutex);
+
+        if (shared_head)
+          {
+            auto last = shared_head;
+            std::size_t count(1u);
+
+            for (; count != batch_size && last->next; ++count)
+              last = last->next;
+            cache.head = std::exchange(shared_head, last->next);
+            cache.count = count;
+            last->next = nullptr;
+            return;
+          }
+        chunk = static_cast<std::byte *>(::operator new(slot_size * chunk_slots, std::align_val_t(slot_alignment)));
+        try
+          {
+            chunks.push_back(chunk);
+          }
+        catch (...)
+          {
+            ::operator delete(chunk, std::align_val_t(slot_alignment));
+            throw;
+          }
+      }
+
+      // The chunk is only known to this thread until its slots are handed out
+      impl::pool_free_slot *head = nullptr;
+
+      for (std::size_t i(chunk_slots); i--;)
+        head = new (chunk + i * slot_size) impl::pool_free_slot{head};
+      cache.head = head;
+      cache.count = chunk_slots;
+    }
+
+    /// Moves `batch_size` slots from `cache` to the shared list
+    void flush(impl::pool_thread_cache &cache) noexcept
+    {
+      auto const first = cache.head;
+      auto last = first;
+
+      for (std::size_t i(1u); i != batch_size; ++i)
+        last = last->next;
+      cache.head = last->next;
+      cache.count -= batch_size;
+
+      std::lock_guard lock(shared_mutex);
+
+      last->next = shared_head;
+      shared_head = first;
+    }
+
+  protected:
+    void *do_allocate(std::size_t size, std::size_t alignment) override
+    {
+      return allocate(size, alignment);
+    }
+
+    void do_deallocate(void *pointer, std::size_t size, std::size_t alignment) override
+    {
+      deallocate(pointer, size, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+  public:
+    ///
+    /// \param size size of the slots, at least that of a pointer
+    /// \param alignment alignment of the slots, a power of two
+    /// \param chunk_slots how many slots are allocated at once when the pool runs out, at least `batch_size`
+    ///
+    fixed_pool(std::size_t size, std::size_t alignment, std::size_t chunk_slots = default_chunk_slots)
+      : slot_alignment(alignment > alignof(impl::pool_free_slot) ? alignment : alignof(impl::pool_free_slot))
+      , slot_size(round_up(size > sizeof(impl::pool_free_slot) ? size : sizeof(impl::pool_free_slot), slot_alignment))
+      , chunk_slots(chunk_slots > batch_size ? chunk_slots : batch_size)
+    {}
+
+    fixed_pool(fixed_pool const &) = delete;
+    fixed_pool &operator=(fixed_pool const &) = delete;
+
+    ~fixed_pool() override
+    {
+      for (auto chunk : chunks)
+        ::operator delete(chunk, std::align_val_t(slot_alignment));
+    }
+
+    ///
+    /// \brief Returns a slot, on the calling thread's free list if possible.
+    ///
+    void *allocate_slot()
+    {
+      auto &cache = caches.get();
+
+      if (!cache.head)
+        refill(cache);
+
+      auto const slot = cache.head;
+
+      cache.head = slot->next;
+      --cache.count;
+      return slot;
+    }
+
+    ///
+    /// \brief Returns `pointer`, from `allocate_slot`, to the calling thread's free list.
+    ///
+    /// Threads which never allocated from the pool, or are exiting, have no free list: the slot goes to the shared list instead,
+    /// so freeing never allocates.
+    ///
+    void deallocate_slot(void *pointer) noexcept
+    {
+      auto const cache = caches.find();
+
+      if (!cache)
+        {
+          std::lock_guard lock(shared_mutex);
+
+          shared_head = new (pointer) impl::pool_free_slot{shared_head};
+          return;
+        }
+      cache->head = new (pointer) impl::pool_free_slot{cache->head};
+      if (++cache->count >= 2u * batch_size)
+        flush(*cache);
+    }
+
+    ///
+    /// \brief `allocate_slot` if a slot fits `size` and `alignment`, `operator new` otherwise.
+    ///
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+      if (size <= slot_size && alignment <= slot_alignment)
+        return allocate_slot();
+      return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void deallocate(void *pointer, std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+      if (size <= slot_size && alignment <= slot_alignment)
+        deallocate_slot(pointer);
+      else
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+
+    std::size_t get_slot_size() const noexcept
+    {
+      return slot_size;
+    }
+
+    /// \brief Slots allocated from the system so far
+    std::size_t get_capacity()
+    {
+      std::lock_guard lock(shared_mutex);
+
+      return chunks.size() * chunk_slots;
+    }
+  };
+
+  template<class T>
+  class object_pool;
+
+  ///
+  /// \brief Deleter destroying a value of a `claws::object_pool` and returning its slot, for `claws::handle`.
+  ///
+  /// Does nothing with `nullptr`, which moved-from and empty handles hold.
+  ///
+  template<class T>
+  struct pool_deleter
+  {
+    object_pool<T> *pool{nullptr};
+
+    void operator()(T *value) const
+    {
+      if (value)
+        pool->destroy(value);
+    }
+  };
+
+  ///
+  /// \brief Owning handle to a value of a `claws::object_pool`, see `object_pool::make_handle`.
+  ///
+  template<class T>
+  using pool_handle = handle<T *, pool_deleter<T>>;
+
+  ///
+  /// \brief `claws::fixed_pool` of slots for `T`s, constructing and destroying them.
+  ///
+  template<class T>
+  class object_pool : public fixed_pool
+  {
+  public:
+    using value_type = T;
+
+    explicit object_pool(std::size_t chunk_slots = default_chunk_slots)
+      : fixed_pool(sizeof(T), alignof(T), chunk_slots)
+    {}
+
+    template<class... args_type>
+    T *create(args_type &&... args)
+    {
+      auto const slot = allocate_slot();
+
+      try
+        {
+          return new (slot) T(std::forward<args_type>(args)...);
+        }
+      catch (...)
+        {
+          deallocate_slot(slot);
+          throw;
+        }
+    }
+
+    void destroy(T *value) noexcept(std::is_nothrow_destructible_v<T>)
+    {
+      value->~T();
+      deallocate_slot(value);
+    }
+
+    ///
+    /// \brief `create`, returning a handle which gives the value back to the pool instead of calling `delete`.
+    ///
+    template<class... args_type>
+    pool_handle<T> make_handle(args_type &&... args)
+    {
+      return pool_handle<T>(pool_deleter<T>{this}, create(std::forward<args_type>(args)...));
+    }
+  };
+
+  ///
+  /// \brief Standard allocator allocating from a `claws::fixed_pool`, for node-based containers like `std::list` or `std::map`.
+  ///
+  /// Nodes that fit a slot come from the pool, anything else from `operator new`.
+  /// Unlike `std::pmr::polymorphic_allocator`, allocations are inlined rather than going through a virtual call.
+  ///
+  template<class T>
+  class pool_allocator
+  {
+    fixed_pool *pool;
+
+    template<class U>
+    friend class pool_allocator;
+
+  public:
+    using value_type = T;
+
+    explicit pool_allocator(fixed_pool &pool) noexcept
+      : pool(&pool)
+    {}
+
+    template<class U>
+    pool_allocator(pool_allocator<U> const &other) noexcept
+      : pool(other.pool)
+    {}
+
+    T *allocate(std::size_t count)
+    {
+      if (count > ~std::size_t(0u) / sizeof(T))
+        throw std::bad_alloc();
+      return static_cast<T *>(pool->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *pointer, std::size_t count) noexcept
+    {
+      pool->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    fixed_pool &get_pool() const noexcept
+    {
+      return *pool;
+    }
+
+    template<class U>
+    bool operator==(pool_allocator<U> const &other) const noexcept
+    {
+      return pool == other.pool;
+    }
+
+    template<class U>
+    bool operator!=(pool_allocator<U> const &other) const noexcept
+    {
+      return pool != other.pool;
+    }
+  };
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/concurrency/deferred_delete.hpp>
+#include <claws/concurrency/impl/thread_records.hpp>
+#include <claws/utils/padded.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    /// One per thread reading through a `claws::rcu_domain`, on its own cache line so readers don't share lines
+    struct alignas(cache_line_size) rcu_reader_record
+    {
+      /// Epoch the thread entered its read section in, 0 outside read sections
+      std::atomic<std::uint64_t> epoch{0u};
+      /// The domain, and the thread using the record if any: whichever lets go last deletes the record
+      std::atomic<unsigned> owners{2u};
+      /// Nesting depth of read sections, only touched by the owning thread
+      unsigned depth{0u};
+      rcu_reader_record *next{nullptr};
+    };
+  }
+
+  ///
+  /// \brief Epoch-based reclamation domain: tracks readers, and retired values until no reader can see them anymore.
+  ///
+  /// Readers announce the epoch they start reading in, in a record private to their thread: entering and leaving a read section
+  /// costs a sequentially consistent store on a cache line no other reader writes to, instead of a reference count shared by all readers.
+  /// Values retired in an epoch are deleted once every reader is either outside a read section or in a later epoch.
+  ///
+  /// The destructor deletes every retired value. No thread may be in a read section of the domain by then.
+  /// Threads may outlive the domain: they forget its record the next time they read through a domain for the first time.
+  ///
+  class rcu_domain
+  {
+    struct retired_value
+    {
+      std::uint64_t epoch;
+      impl::deferred_deletion deletion;
+    };
+
+    std::size_t const reclaim_threshold;
+    std::atomic<std::uint64_t> epoch{1u};
+    impl::thread_records<impl::rcu_reader_record> readers;
+    std::mutex retired_mutex;
+    std::vector<retired_value> retired;
+    std::atomic<std::size_t> retired_size{0u};
+
+    /// Oldest epoch a reader is still in, `~0` if no thread is reading
+    std::uint64_t oldest_reader_epoch() const noexcept
+    {
+      std::uint64_t oldest = ~std::uint64_t(0u);
+
+      // Sequentially consistent with the readers' epoch store and value load: either they see the new value, or we see their epoch
+      for (auto record = readers.first(); record; record = record->next)
+        if (auto const reader_epoch = record->epoch.load(std::memory_order_seq_cst); reader_epoch && reader_epoch < oldest)
+          oldest = reader_epoch;
+      return oldest;
+    }
+
+    /// Waits for every read section in progress to end, so values retired before the call can be deleted
+    void wait_for_readers() noexcept
+    {
+      auto const current = epoch.fetch_add(1u, std::memory_order_seq_cst);
+
+      while (oldest_reader_epoch() <= current)
+        std::this_thread::yield();
+    }
+
+  public:
+    static constexpr std::size_t default_reclaim_threshold = 64u;
+
+    ///
+    /// \param reclaim_threshold how many values `retire` accumulates before trying to reclaim them
+    ///
+    explicit rcu_domain(std::size_t reclaim_threshold = default_reclaim_threshold) noexcept
+      : reclaim_threshold(reclaim_threshold)
+    {}
+
+    rcu_domain(rcu_domain const &) = delete;
+    rcu_domain &operator=(rcu_domain const &) = delete;
+
+    ~rcu_domain()
+    {
+      for (auto &value : retired)
+        value.deletion.run();
+    }
+
+    ///
+    /// \brief Enters a read section. Read sections nest, and must be left on the thread that entered them.
+    ///
+    /// Returns the calling thread's record, which `read_unlock` takes back to leave the section without looking it up again.
+    ///
+    impl::rcu_reader_record &read_lock()
+    {
+      auto &record = readers.get();
+
+      if (!record.depth++)
+        record.epoch.store(epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+      return record;
+    }
+
+    ///
+    /// \brief Leaves a read section, given the record `read_lock` returned when entering it.
+    ///
+    void read_unlock(impl::rcu_reader_record &record) noexcept
+    {
+      if (!--record.depth)
+        record.epoch.store(0u, std::memory_order_release);
+    }
+
+    ///
+    /// \brief Hands `value` over to the domain, `deleter(std::move(value))` runs once no reader can see it.
+    ///
+    /// `value` must already be unreachable for new readers. Tries to reclaim every `reclaim_threshold` retired values.
+    /// Never throws, so handles can retire their value on destruction:
+    /// if memory to store the value can't be allocated, waits for the read sections in progress and deletes it right away.
+    /// Must thus not be called from a read section of the domain, like `synchronize`: it could wait for itself.
+    ///
+    template<class deleter_type, class T>
+    void retire(deleter_type const &deleter, T &&value) noexcept
+    {
+      retired_value entry;
+
+      if (!entry.deletion.assign(deleter, std::forward<T>(value), 0u))
+        {
+          deleter_type copy(deleter);
+
+          wait_for_readers();
+          copy(std::forward<T>(value));
+          return;
+        }
+      // Readers entering after this see the new value
+      entry.epoch = epoch.fetch_add(1u, std::memory_order_seq_cst);
+
+      std::size_t size;
+
+      try
+        {
+          std::lock_guard lock(retired_mutex);
+
+          retired.push_back(entry);
+          size = retired.size();
+          retired_size.store(size, std::memory_order_relaxed);
+        }
+      catch (std::bad_alloc const &)
+        {
+          wait_for_readers();
+          entry.deletion.run();
+          return;
+        }
+      if (size >= reclaim_threshold)
+        try
+          {
+            reclaim();
+          }
+        catch (std::bad_alloc const &)
+          {
+            // The values stay retired until the next reclaim
+          }
+    }
+
+    ///
+    /// \brief Deletes the retired values no reader can see anymore, without waiting. Returns how many were deleted.
+    ///
+    std::size_t reclaim()
+    {
+      std::vector<retired_value> reclaimable;
+      {
+        std::lock_guard lock(retired_mutex);
+        auto const oldest = oldest_reader_epoch();
+        auto const kept = std::partition(retired.begin(), retired.end(), [oldest](auto const &value) noexcept { return value.epoch >= oldest; });
+
+        reclaimable.assign(kept, retired.end());
+        retired.erase(kept, retired.end());
+        retired_size.store(retired.size(), std::memory_order_relaxed);
+      }
+      // Outside the lock, deleters may retire values themselves
+      for (auto &value : reclaimable)
+        value.deletion.run();
+      return reclaimable.size();
+    }
+
+    ///
+    /// \brief Waits for every read section in progress to end, then deletes every value retired before the call.
+    ///
+    /// Must not be called from a read section, it would wait for itself.
+    ///
+    std::size_t synchronize()
+    {
+      wait_for_readers();
+      return reclaim();
+    }
+
+    /// \brief Number of retired values waiting for readers to move on.
+    std::size_t retired_count() const noexcept
+    {
+      return retired_size.load(std::memory_order_relaxed);
+    }
+  };
+
+  ///
+  /// \brief Process-wide domain used by `claws::rcu_handle` by default.
+  ///
+  inline rcu_domain &get_default_rcu_domain() noexcept
+  {
+    static rcu_domain domain;
+
+    return domain;
+  }
+
+  ///
+  /// \brief RAII read section of a `claws::rcu_domain`.
+  ///
+  /// Values read from any `claws::rcu_handle` of the domain stay alive until the section ends.
+  ///
+  class rcu_read_lock
+  {
+    rcu_domain &domain;
+    impl::rcu_reader_record &record;
+
+  public:
+    explicit rcu_read_lock(rcu_domain &domain = get_default_rcu_domain())
+      : domain(domain)
+      , record(domain.read_lock())
+    {}
+
+    rcu_read_lock(rcu_read_lock const &) = delete;
+    rcu_read_lock &operator=(rcu_read_lock const &) = delete;
+
+    ~rcu_read_lock()
+    {
+      domain.read_unlock(record);
+    }
+  };
+
+  ///
+  /// \brief A read section and the value read in it. The value stays alive as long as the reader.
+  ///
+  template<class T>
+  class rcu_reader
+  {
+    rcu_read_lock lock;
+    T const *value;
+
+  public:
+    rcu_reader(rcu_domain &domain, std::atomic<T *> const &source)
+      : lock(domain)
+      , value(source.load(std::memory_order_seq_cst))
+    {}
+
+    T const *get() const noexcept
+    {
+      return value;
+    }
+
+    T const &operator*() const noexcept
+    {
+      return *value;
+    }
+
+    T const *operator->() const noexcept
+    {
+      return value;
+    }
+
+    explicit operator bool() const noexcept
+    {
+      return value != nullptr;
+    }
+  };
+
+  ///
+  /// \brief Owning pointer to a read-mostly value, published to readers with read-copy-update.
+  ///
+  /// \tparam T the pointed-to type
+  /// \tparam _deleter_type deletes replaced values, as `claws::handle`'s deleter. Inherited protectedly.
+  ///
+  /// Readers get a plain pointer inside a read section, see `read()`. Writers replace the whole value with `update()`:
+  /// the previous value is retired to the `claws::rcu_domain`, which deletes it once every reader that could see it moved on.
+  /// Readers never wait for writers, and only ever see a value in full, never half updated.
+  ///
+  /// Concurrent writers must be synchronised by the caller, or use `exchange()`.
+  /// Writers, and the destructor, must not run in a read section of the domain: retiring may have to wait for readers.
+  ///
+  template<class T, class _deleter_type = std::default_delete<T>>
+  class rcu_handle : protected _deleter_type
+  {
+  public:
+    using type = T *;
+    using deleter_type = _deleter_type;
+
+  private:
+    std::atomic<T *> value;
+    rcu_domain &domain;
+
+  public:
+    explicit rcu_handle(rcu_domain &domain = get_default_rcu_domain())
+      : value(nullptr)
+      , domain(domain)
+    {}
+
+    explicit rcu_handle(T *value, rcu_domain &domain = get_default_rcu_domain())
+      : value(value)
+      , domain(domain)
+    {}
+
+    rcu_handle(deleter_type &&deleter, T *value, rcu_domain &domain = get_default_rcu_domain())
+      : deleter_type(std::move(deleter))
+      , value(value)
+      , domain(domain)
+    {}
+
+    rcu_handle(rcu_handle const &) = delete;
+    rcu_handle &operator=(rcu_handle const &) = delete;
+
+    ///
+    /// \brief Retires the current value. It is deleted once readers still using it are done.
+    ///
+    /// Must not run in a read section of the domain, see `claws::rcu_domain::retire`.
+    ///
+    ~rcu_handle()
+    {
+      if (auto const current = value.load(std::memory_order_relaxed))
+        domain.retire(static_cast<deleter_type const &>(*this), current);
+    }
+
+    ///
+    /// \brief Enters a read section and reads the current value, which may be `nullptr`.
+    ///
+    rcu_reader<T> read() const
+    {
+      return rcu_reader<T>(domain, value);
+    }
+
+    ///
+    /// \brief Reads the current value, in a read section the caller already entered.
+    ///
+    T const *get(rcu_read_lock const &) const noexcept
+    {
+      return value.load(std::memory_order_seq_cst);
+    }
+
+    ///
+    /// \brief Publishes `new_value` and returns the previous value without retiring it. The caller owns it, but readers may still use it.
+    ///
+    T *exchange(T *new_value) noexcept
+    {
+      return value.exchange(new_value, std::memory_order_seq_cst);
+    }
+
+    ///
+    /// \brief Publishes `new_value`, and retires the previous value.
+    ///
+    /// Must not be called from a read section of the domain, see `claws::rcu_domain::retire`.
+    ///
+    void update(T *new_value)
+    {
+      if (auto const previous = exchange(new_value))
+        domain.retire(static_cast<deleter_type const &>(*this), previous);
+    }
+
+    ///
+    /// \brief Read-copy-update: publishes a copy of the current value modified by `modify`, and retires the current value.
+    ///
+    /// Only available with `std::default_delete`, as the copy is allocated with `new`.
+    ///
+    template<class modifier_type>
+    void copy_update(modifier_type &&modify)
+    {
+      static_assert(std::is_same_v<deleter_type, std::default_delete<T>>, "copy_update allocates with new");
+
+      std::unique_ptr<T> copy;
+      {
+        auto const reader = read();
+
+        copy = std::make_unique<T>(*reader);
+      }
+      std::forward<modifier_type>(modify)(*copy);
+      update(copy.release());
+    }
+
+    ///
+    /// \brief Waits for readers of retired values and deletes them, see `claws::rcu_domain::synchronize`.
+    ///
+    std::size_t synchronize()
+    {
+      return domain.synchronize();
+    }
+
+    rcu_domain &get_domain() const noexcept
+    {
+      return domain;
+    }
+
+    constexpr auto const &get_deleter() const noexcept
+    {
+      return static_cast<deleter_type const &>(*this);
+    }
+  };
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <claws/utils/padded.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    ///
+    /// \brief A `T` stored as atomic words, so readers racing with a writer don't make a data race.
+    ///
+    /// Words are copied with relaxed operations, the sequence numbers around them provide the ordering.
+    ///
+    template<class T>
+    class seqlock_words
+    {
+      static constexpr std::size_t word_count = (sizeof(T) + sizeof(std::uint64_t) - 1u) / sizeof(std::uint64_t);
+
+      std::atomic<std::uint64_t> words[word_count];
+
+    public:
+      seqlock_words() noexcept
+      {
+        for (auto &word : words)
+          word.store(0u, std::memory_order_relaxed);
+      }
+
+      void store(T const &value) noexcept
+      {
+        std::uint64_t buffer[word_count] = {};
+
+        std::memcpy(buffer, &value, sizeof(T));
+        for (std::size_t i(0u); i != word_count; ++i)
+          words[i].store(buffer[i], std::memory_order_relaxed);
+      }
+
+      void load(T &value) const noexcept
+      {
+        std::uint64_t buffer[word_count];
+
+        for (std::size_t i(0u); i != word_count; ++i)
+          buffer[i] = words[i].load(std::memory_order_relaxed);
+        std::memcpy(&value, buffer, sizeof(T));
+      }
+    };
+  }
+
+  ///
+  /// \brief Cell holding a small trivially copyable value, written by one thread and read by any number of threads without locking.
+  ///
+  /// \tparam T trivially copyable, like arithmetic types, `claws::box`, `claws::vect` or `claws::tagged_data`
+  ///
+  /// A sequence number is odd while the writer copies a new value in.
+  /// Readers copy the value out, and retry if the sequence was odd or changed meanwhile, so they never see half a write.
+  /// Writes never wait. Reads retry as long as they overlap writes: see `claws::multi_seqlock` if writes are slow or frequent.
+  ///
+  /// Only one thread may write at a time.
+  ///
+  template<class T>
+  class seqlock
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock copies values bytewise");
+
+    std::atomic<std::uint64_t> sequence{0u};
+    impl::seqlock_words<T> value;
+
+  public:
+    using value_type = T;
+
+    seqlock() noexcept = default;
+
+    explicit seqlock(T const &initial) noexcept
+    {
+      value.store(initial);
+    }
+
+    seqlock(seqlock const &) = delete;
+    seqlock &operator=(seqlock const &) = delete;
+
+    ///
+    /// \brief Publishes `new_value`. Wait-free, but must not be called by several threads at once.
+    ///
+    void store(T const &new_value) noexcept
+    {
+      auto const current = sequence.load(std::memory_order_relaxed);
+
+      sequence.store(current + 1u, std::memory_order_relaxed);
+      // The odd sequence is visible before any word of the new value
+      std::atomic_thread_fence(std::memory_order_release);
+      value.store(new_value);
+      sequence.store(current + 2u, std::memory_order_release);
+    }
+
+    ///
+    /// \brief Copies the value to `result` if no write overlapped, and returns whether it did.
+    ///
+    bool try_load(T &result) const noexcept
+    {
+      auto const before = sequence.load(std::memory_order_acquire);
+
+      if (before & 1u)
+        return false;
+      value.load(result);
+      // The words are read before the sequence is checked again
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    ///
+    /// \brief Returns the value, retrying while writes overlap.
+    ///
+    T load() const noexcept
+    {
+      T result;
+
+      while (!try_load(result))
+        ;
+      return result;
+    }
+
+    ///
+    /// \brief Number of values stored so far. Readers can compare it to know if the value changed.
+    ///
+    std::uint64_t get_version() const noexcept
+    {
+      return sequence.load(std::memory_order_acquire) / 2u;
+    }
+  };
+
+  ///
+  /// \brief `claws::seqlock` with `slot_count` slots, so readers don't retry behind a slow writer.
+  ///
+  /// The writer fills the slot after the last published one, then publishes it: readers keep reading the previous slot meanwhile.
+  /// A reader only retries if the writer wraps around to its slot before it is done, after `slot_count - 1` more writes.
+  /// Each slot is on its own cache line(s), so writing one doesn't slow down readers of another.
+  ///
+  /// Only one thread may write at a time.
+  ///
+  template<class T, std::size_t slot_count = 4u>
+  class multi_seqlock
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "multi_seqlock copies values bytewise");
+    static_assert(slot_count >= 2u, "one slot is a plain seqlock");
+
+    struct alignas(cache_line_size) slot
+    {
+      std::atomic<std::uint64_t> sequence{0u};
+      impl::seqlock_words<T> value;
+    };
+
+    slot slots[slot_count];
+    /// Number of stores, the last published slot being `(version - 1) % slot_count` once there was one
+    alignas(cache_line_size) std::atomic<std::uint64_t> version{0u};
+
+  public:
+    using value_type = T;
+
+    multi_seqlock() noexcept = default;
+
+    explicit multi_seqlock(T const &initial) noexcept
+    {
+      for (auto &target : slots)
+        target.value.store(initial);
+    }
+
+    multi_seqlock(multi_seqlock const &) = delete;
+    multi_seqlock &operator=(multi_seqlock const &) = delete;
+
+    ///
+    /// \brief Publishes `new_value`. Wait-free, but must not be called by several threads at once.
+    ///
+    void store(T const &new_value) noexcept
+    {
+      auto const current = version.load(std::memory_order_relaxed);
+      auto &target = slots[current % slot_count];
+      auto const sequence = target.sequence.load(std::memory_order_relaxed);
+
+      target.sequence.store(sequence + 1u, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      target.value.store(new_value);
+      target.sequence.store(sequence + 2u, std::memory_order_release);
+      version.store(current + 1u, std::memory_order_release);
+    }
+
+    ///
+    /// \brief Copies the last published value to `result` if the writer didn't overwrite it meanwhile, and returns whether it did.
+    ///
+    bool try_load(T &result) const noexcept
+    {
+      auto const current = version.load(std::memory_order_acquire);
+      auto const &source = slots[(current + slot_count - 1u) % slot_count];
+      auto const before = source.sequence.load(std::memory_order_acquire);
+
+      if (before & 1u)
+        return false;
+      source.value.load(result);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return source.sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    ///
+    /// \brief Returns the last published value, retrying if the writer overwrote it meanwhile.
+    ///
+    T load() const noexcept
+    {
+      T result;
+
+      while (!try_load(result))
+        ;
+      return result;
+    }
+
+    std::uint64_t get_version() const noexcept
+    {
+      return version.load(std::memory_order_acquire);
+    }
+  };
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <claws/utils/padded.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    ///
+    /// \brief Number of a live thread, the lowest no other live thread has, given back when the thread exits.
+    ///
+    /// Live numbers are linked in increasing order, so numbering a thread takes the first gap without allocating.
+    ///
+    class thread_slot_number
+    {
+      thread_slot_number *next;
+
+      static std::mutex &get_mutex() noexcept
+      {
+        static std::mutex mutex;
+
+        return mutex;
+      }
+
+      static thread_slot_number *&get_head() noexcept
+      {
+        static thread_slot_number *head{nullptr};
+
+        return head;
+      }
+
+    public:
+      std::size_t number{0u};
+
+      thread_slot_number() noexcept
+      {
+        std::lock_guard lock(get_mutex());
+        auto link = &get_head();
+
+        for (; *link && (*link)->number == number; link = &(*link)->next)
+          ++number;
+        next = *link;
+        *link = this;
+      }
+
+      thread_slot_number(thread_slot_number const &) = delete;
+      thread_slot_number &operator=(thread_slot_number const &) = delete;
+
+      ~thread_slot_number()
+      {
+        std::lock_guard lock(get_mutex());
+        auto link = &get_head();
+
+        while (*link != this)
+          link = &(*link)->next;
+        *link = next;
+      }
+    };
+
+    /// Number of the calling thread: live threads have distinct numbers, lower than how many threads are alive
+    inline std::size_t get_thread_slot() noexcept
+    {
+      thread_local thread_slot_number const slot;
+
+      return slot.number;
+    }
+  }
+
+  ///
+  /// \brief Counter incremented by many threads and rarely read, split in one slot per thread.
+  ///
+  /// \tparam T an integer type
+  ///
+  /// Every slot is on its own cache line. When they first use a counter, threads take the lowest number no live thread has,
+  /// and give it back when they exit: as long as there are no more live threads than slots, a thread is the only one writing its slot's line,
+  /// so increments are relaxed atomic additions on a line already in the thread's cache, instead of a line bouncing between every core.
+  /// With more live threads than slots, threads share slots, which stays correct.
+  ///
+  /// Reading sums every slot. Increments that happen meanwhile may or may not be counted.
+  ///
+  template<class T = std::uint64_t>
+  class sharded_counter
+  {
+    static_assert(std::is_integral_v<T>, "sharded_counter counts integers");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+  private:
+    std::unique_ptr<padded<std::atomic<T>>[]> slots;
+    size_type mask;
+
+    static size_type round_slot_count(size_type count) noexcept
+    {
+      size_type result(1u);
+
+      while (result < count)
+        result *= 2u;
+      return result;
+    }
+
+    std::atomic<T> &get_slot() const noexcept
+    {
+      return *slots[impl::get_thread_slot() & mask];
+    }
+
+  public:
+    ///
+    /// \param slot_count rounded up to a power of two. The number of hardware threads by default
+    ///
+    explicit sharded_counter(size_type slot_count = std::thread::hardware_concurrency())
+      : slots(new padded<std::atomic<T>>[round_slot_count(slot_count)])
+      , mask(round_slot_count(slot_count) - 1u)
+    {
+      for (size_type i(0u); i <= mask; ++i)
+        slots[i]->store(0u, std::memory_order_relaxed);
+    }
+
+    sharded_counter(sharded_counter const &) = delete;
+    sharded_counter &operator=(sharded_counter const &) = delete;
+
+    void add(T value) noexcept
+    {
+      get_slot().fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void increment() noexcept
+    {
+      add(1u);
+    }
+
+    sharded_counter &operator+=(T value) noexcept
+    {
+      add(value);
+      return *this;
+    }
+
+    sharded_counter &operator++() noexcept
+    {
+      add(1u);
+      return *this;
+    }
+
+    ///
+    /// \brief Sum of every slot.
+    ///
+    T load() const noexcept
+    {
+      T result(0u);
+
+      for (size_type i(0u); i <= mask; ++i)
+        result += slots[i]->load(std::memory_order_relaxed);
+      return result;
+    }
+
+    operator T() const noexcept
+    {
+      return load();
+    }
+
+    ///
+    /// \brief Sets every slot to 0, and returns the previous sum. Increments that happen meanwhile are either counted or kept.
+    ///
+    T exchange_zero() noexcept
+    {
+      T result(0u);
+
+      for (size_type i(0u); i <= mask; ++i)
+        result += slots[i]->exchange(0u, std::memory_order_relaxed);
+      return result;
+    }
+
+    size_type get_slot_count() const noexcept
+    {
+      return mask + 1u;
+    }
+  };
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <claws/container/hash.hpp>
+#include <claws/utils/bit_ops.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  struct interned_tag;
+
+  ///
+  /// \brief Id of a string interned in a `claws::string_interner`.
+  ///
+  /// Ids are dense, from 0 in interning order, so they can index a `claws::tagged_vector` directly instead of being hashed.
+  ///
+  using interned_id = tagged_data<std::uint32_t, std::int32_t, interned_tag>;
+
+  ///
+  /// \brief Thread-safe pool of strings, each interned once and identified by a 32 bits `claws::interned_id`.
+  ///
+  /// Comparing interned strings is comparing their ids, and hashing them is hashing an integer.
+  ///
+  /// Bytes are stored in an append-only arena, null terminated, and never move: views of interned strings stay valid as long as the interner.
+  /// Strings are never removed.
+  ///
+  /// Looking up strings already interned doesn't lock, `intern` only takes a mutex for new strings:
+  /// - the index is an open addressing table of atomic slots, each holding an id and 32 bits of its string's hash,
+  ///   published with a release store once the string's bytes are written.
+  /// - When the index grows, the larger index is published atomically and the previous one is kept until the interner is destroyed,
+  ///   as readers may still be probing it. Since each index is twice as large as the previous one, all of them together take less than the current one.
+  /// - Ids are resolved through segments twice as large as the previous one, which never move either.
+  ///
+  class string_interner
+  {
+  public:
+    using size_type = std::size_t;
+
+  private:
+    /// Ids of the first segment, each following segment holding twice as many as the previous one
+    static constexpr std::uint64_t first_segment_size = 1024u;
+    static constexpr std::size_t max_segment_count = 23u;
+    static constexpr std::size_t chunk_size = 64u << 10u;
+
+    struct index
+    {
+      std::uint64_t mask;
+      /// `id + 1` in the low 32 bits and the high 32 bits of the string's hash in the high bits, 0 for empty slots
+      std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+
+      explicit index(std::uint64_t capacity)
+        : mask(capacity - 1u)
+        , slots(new std::atomic<std::uint64_t>[capacity])
+      {
+        for (std::uint64_t i(0u); i != capacity; ++i)
+          slots[i].store(0u, std::memory_order_relaxed);
+      }
+    };
+
+    std::atomic<index *> current_index;
+    std::atomic<std::string_view *> segments[max_segment_count];
+    std::atomic<std::uint32_t> count{0u};
+
+    /// Only touched with `mutex` held
+    std::mutex mutex;
+    std::vector<std::unique_ptr<index>> indices;
+    std::vector<std::unique_ptr<std::string_view[]>> segment_storage;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *chunk_position{nullptr};
+    std::size_t chunk_left{0u};
+
+    static std::uint64_t hash_of(std::string_view string) noexcept
+    {
+      return mix_hash{}(string);
+    }
+
+    static constexpr std::uint64_t slot_tag(std::uint64_t hash) noexcept
+    {
+      return hash & 0xFFFFFFFF00000000u;
+    }
+
+    /// Segment of `id`, and its position in it
+    static std::pair<std::size_t, std::uint64_t> locate(std::uint32_t id) noexcept
+    {
+      auto const rank = std::uint64_t(id) / first_segment_size + 1u;
+      auto const segment = static_cast<std::size_t>(63 - countl_zero(rank));
+
+      return {segment, std::uint64_t(id) - first_segment_size * ((std::uint64_t(1u) << segment) - 1u)};
+    }
+
+    std::string_view entry(std::uint32_t id) const noexcept
+    {
+      auto const [segment, position] = locate(id);
+
+      return segments[segment].load(std::memory_order_acquire)[position];
+    }
+
+    /// Probes `table` for `string`, returns the slot holding it, or the empty slot ending the probe
+    std::pair<std::uint64_t, std::uint64_t> probe(index const &table, std::string_view string, std::uint64_t hash) const noexcept
+    {
+      auto const tag = slot_tag(hash);
+
+      for (auto position = hash & table.mask;; position = (position + 1u) & table.mask)
+        {
+          auto const slot = table.slots[position].load(std::memory_order_acquire);
+
+          if (!slot || (slot_tag(slot) == tag && entry(static_cast<std::uint32_t>(slot) - 1u) == string))
+            return {position, slot};
+        }
+    }
+
+    std::optional<interned_id> find_hashed(std::string_view string, std::uint64_t hash) const noexcept
+    {
+      auto const table = current_index.load(std::memory_order_acquire);
+
+      if (auto const slot = probe(*table, string, hash).second)
+        return interned_id{static_cast<std::uint32_t>(slot) - 1u};
+      return std::nullopt;
+    }
+
+    /// Publishes an index with room for `size` strings at half load, if the current one is too small. `mutex` must be held
+    void grow_index(size_type size)
+    {
+      auto const table = current_index.load(std::memory_order_relaxed);
+      std::uint64_t capacity(table->mask + 1u);
+
+      if (size * 2u <= capacity)
+        return;
+      while (size * 2u > capacity)
+        capacity *= 2u;
+
+      auto larger = std::make_unique<index>(capacity);
+      auto const interned = count.load(std::memory_order_relaxed);
+
+      for (std::uint32_t id(0u); id != interned; ++id)
+        {
+          auto const string = entry(id);
+          auto const hash = hash_of(string);
+          auto position = hash & larger->mask;
+
+          while (larger->slots[position].load(std::memory_order_relaxed))
+            position = (position + 1u) & larger->mask;
+          larger->slots[position].store(slot_tag(hash) | (std::uint64_t(id) + 1u), std::memory_order_relaxed);
+        }
+      current_index.store(larger.get(), std::memory_order_release);
+      indices.push_back(std::move(larger));
+    }
+
+    /// Copies `string` to the arena, null terminated. `mutex` must be held
+    std::string_view store_bytes(std::string_view string)
+    {
+      if (string.size() + 1u > chunk_left)
+        {
+          auto const size = std::max(chunk_size, string.size() + 1u);
+
+          chunks.emplace_back(new char[size]);
+          chunk_position = chunks.back().get();
+          chunk_left = size;
+        }
+
+      auto const stored = chunk_position;
+
+      std::memcpy(stored, string.data(), string.size());
+      stored[string.size()] = '\0';
+      chunk_position += string.size() + 1u;
+      chunk_left -= string.size() + 1u;
+      return {stored, string.size()};
+    }
+
+    /// Interns `string`, which may have been interned by another thread since it was looked up. `mutex` must be held
+    interned_id insert_locked(std::string_view string, std::uint64_t hash)
+    {
+      auto const [position, slot] = probe(*current_index.load(std::memory_order_relaxed), string, hash);
+
+      if (slot)
+        return interned_id{static_cast<std::uint32_t>(slot) - 1u};
+
+      auto const id = count.load(std::memory_order_relaxed);
+
+      if (id == ~std::uint32_t(0u))
+        throw std::length_error("string_interner: too many strings");
+
+      auto const [segment, offset] = locate(id);
+
+      if (!offset)
+        {
+          segment_storage.emplace_back(new std::string_view[first_segment_size << segment]);
+          segments[segment].store(segment_storage.back().get(), std::memory_order_release);
+        }
+      segment_storage[segment][offset] = store_bytes(string);
+      count.store(id + 1u, std::memory_order_release);
+
+      // Growing rehashes every string, including the new one
+      auto const table = current_index.load(std::memory_order_relaxed);
+
+      if (std::uint64_t(id + 1u) * 2u > table->mask + 1u)
+        grow_index(id + 1u);
+      else
+        table->slots[position].store(slot_tag(hash) | (std::uint64_t(id) + 1u), std::memory_order_release);
+      return interned_id{id};
+    }
+
+  public:
+    ///
+    /// \param expected_count strings the index has room for before growing
+    ///
+    explicit string_interner(size_type expected_count = 0u)
+    {
+      std::uint64_t capacity(16u);
+
+      while (expected_count * 2u > capacity)
+        capacity *= 2u;
+      indices.push_back(std::make_unique<index>(capacity));
+      current_index.store(indices.back().get(), std::memory_order_relaxed);
+      for (auto &segment : segments)
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+
+    string_interner(string_interner const &) = delete;
+    string_interner &operator=(string_interner const &) = delete;
+
+    ///
+    /// \brief Returns the id of `string`, interning it first if needed.
+    ///
+    /// Doesn't lock if `string` is already interned. Throws `std::length_error` past 2^32 - 1 strings.
+    ///
+    interned_id intern(std::string_view string)
+    {
+      auto const hash = hash_of(string);
+
+      if (auto const found = find_hashed(string, hash))
+        return *found;
+
+      std::lock_guard lock(mutex);
+
+      return insert_locked(string, hash);
+    }
+
+    ///
+    /// \brief Interns every string of `strings`, writing their ids to `out`. Returns how many strings were new.
+    ///
+    /// Strings already interned are looked up without locking, then the new ones are all interned under a single lock.
+    ///
+    template<class string_range, class output_iterator>
+    size_type intern_many(string_range const &strings, output_iterator out)
+    {
+      struct missing_string
+      {
+        std::size_t position;
+        std::uint64_t hash;
+        std::string_view string;
+      };
+
+      std::vector<missing_string> missing;
+      std::vector<interned_id> ids;
+      size_type inserted(0u);
+
+      for (auto const &string : strings)
+        {
+          std::string_view const view(string);
+          auto const hash = hash_of(view);
+
+          if (auto const found = find_hashed(view, hash))
+            ids.push_back(*found);
+          else
+            {
+              missing.push_back({ids.size(), hash, view});
+              ids.emplace_back();
+            }
+        }
+      if (!missing.empty())
+        {
+          std::lock_guard lock(mutex);
+          auto const before = count.load(std::memory_order_relaxed);
+
+          grow_index(before + missing.size());
+          for (auto const &string : missing)
+            ids[string.position] = insert_locked(string.string, string.hash);
+          inserted = count.load(std::memory_order_relaxed) - before;
+        }
+      std::copy(ids.begin(), ids.end(), out);
+      return inserted;
+    }
+
+    ///
+    /// \brief Returns the id of `string` if it is interned, without ever locking or interning it.
+    ///
+    std::optional<interned_id> find(std::string_view string) const noexcept
+    {
+      return find_hashed(string, hash_of(string));
+    }
+
+    ///
+    /// \brief The string of `id`, null terminated. Lock-free, valid as long as the interner.
+    ///
+    /// `id` must come from this interner.
+    ///
+    std::string_view view(interned_id id) const noexcept
+    {
+      return entry(id.data);
+    }
+
+    char const *c_str(interned_id id) const noexcept
+    {
+      return view(id).data();
+    }
+
+    ///
+    /// \brief Makes room in the index for `size` strings, so interning them doesn't rehash.
+    ///
+    void reserve(size_type size)
+    {
+      std::lock_guard lock(mutex);
+
+      grow_index(size);
+    }
+
+    /// \brief Number of strings interned so far, which is also the next id
+    size_type size() const noexcept
+    {
+      return count.load(std::memory_order_acquire);
+    }
+  };
+}
@@ -5,12 +5,26 @@ set(MODULE_PUBLIC_HEADERS
         "${MODULE_PATH}/array_ops.hpp"
         "${MODULE_PATH}/container_view.hpp"
         "${MODULE_PATH}/contextful_container.hpp"
+        "${MODULE_PATH}/flat_hash_map.hpp"
+        "${MODULE_PATH}/flat_hash_set.hpp"
+        "${MODULE_PATH}/hash.hpp"
         "${MODULE_PATH}/iterator_pair.hpp"
+        "${MODULE_PATH}/monotonic_arena.hpp"
+        "${MODULE_PATH}/relocatable_arena.hpp"
+        "${MODULE_PATH}/relocatable_hash_map.hpp"
+        "${MODULE_PATH}/relocatable_slot_map.hpp"
+        "${MODULE_PATH}/relocatable_vector.hpp"
+        "${MODULE_PATH}/slot_map.hpp"
+        "${MODULE_PATH}/small_vector.hpp"
+        "${MODULE_PATH}/static_vector.hpp"
+        "${MODULE_PATH}/tagged_vector.hpp"
         "${MODULE_PATH}/vect.hpp"
         )
 
 set(MODULE_PRIVATE_HEADERS
-        "")
+        "${MODULE_PATH}/impl/swiss_table.hpp"
+        "${MODULE_PATH}/impl/vector_interface.hpp"
+        )
 
 set(MODULE_SOURCES
         ${MODULE_PUBLIC_HEADERS}
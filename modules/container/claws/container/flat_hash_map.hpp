@@ -0,0 +1,141 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <claws/container/hash.hpp>
+#include <claws/container/impl/swiss_table.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace swiss
+    {
+      template<class K, class V>
+      struct map_policy
+      {
+        using key_type = K;
+        using value_type = std::pair<K const, V>;
+
+        static constexpr bool const_values = false;
+
+        static K const &key(value_type const &value) noexcept
+        {
+          return value.first;
+        }
+      };
+    }
+  }
+
+  ///
+  /// \brief Open addressing hash map storing its values inline, probing 16 slots at a time with SSE2.
+  ///
+  /// \tparam hash `claws::mix_hash` by default, which needs no extra mixing and is transparent
+  /// \tparam key_equal transparent by default: if `hash` is too, keys can be looked up by any comparable type,
+  /// like `std::string_view`s in a map of `std::string`s
+  ///
+  /// Each slot has a control byte holding 7 bits of its key's hash, so a lookup compares a whole group of control bytes
+  /// at once and only compares keys whose 7 bits match: usually one.
+  ///
+  /// Rehashing moves values, copying keys since they are `const`: prefer cheap keys or `reserve` first.
+  /// Insertions invalidate iterators and references if they rehash. Erasures only invalidate those to the erased value.
+  ///
+  template<class K, class V, class hash = mix_hash, class key_equal = std::equal_to<>>
+  class flat_hash_map : public impl::swiss::table<impl::swiss::map_policy<K, V>, hash, key_equal>
+  {
+    using base = impl::swiss::table<impl::swiss::map_policy<K, V>, hash, key_equal>;
+
+    template<class key_arg_type>
+    static constexpr bool is_heterogeneous = !std::is_same_v<std::decay_t<key_arg_type>, K> && impl::swiss::is_transparent<hash>::value
+                                             && impl::swiss::is_transparent<key_equal>::value;
+
+  public:
+    using mapped_type = V;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    ///
+    /// \brief Inserts `key` with a value constructed from `args` if it isn't in the map yet.
+    ///
+    /// Returns an iterator to the value of `key`, and whether it was inserted. `args` are left untouched if it wasn't.
+    ///
+    template<class... args_type>
+    std::pair<iterator, bool> try_emplace(K const &key, args_type &&... args)
+    {
+      return emplace_at(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<args_type>(args)...));
+    }
+
+    template<class... args_type>
+    std::pair<iterator, bool> try_emplace(K &&key, args_type &&... args)
+    {
+      return emplace_at(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<args_type>(args)...));
+    }
+
+    /// \brief Heterogeneous version, `K` being constructed from `key` only if it is inserted
+    template<class key_arg_type, class... args_type, class = std::enable_if_t<is_heterogeneous<key_arg_type>>>
+    std::pair<iterator, bool> try_emplace(key_arg_type &&key, args_type &&... args)
+    {
+      return emplace_at(key,
+                        std::piecewise_construct,
+                        std::forward_as_tuple(std::forward<key_arg_type>(key)),
+                        std::forward_as_tuple(std::forward<args_type>(args)...));
+    }
+
+    std::pair<iterator, bool> insert(value_type const &value)
+    {
+      return emplace_at(value.first, value);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value)
+    {
+      return emplace_at(value.first, std::move(value));
+    }
+
+    ///
+    /// \brief Assigns `value` to `key`, inserting it if needed.
+    ///
+    template<class key_arg_type, class mapped_arg_type>
+    std::pair<iterator, bool> insert_or_assign(key_arg_type &&key, mapped_arg_type &&value)
+    {
+      auto result = try_emplace(std::forward<key_arg_type>(key), std::forward<mapped_arg_type>(value));
+
+      if (!result.second)
+        result.first->second = std::forward<mapped_arg_type>(value);
+      return result;
+    }
+
+    ///
+    /// \brief Returns the value of `key`, default constructing it if needed.
+    ///
+    V &operator[](K const &key)
+    {
+      return try_emplace(key).first->second;
+    }
+
+    V &operator[](K &&key)
+    {
+      return try_emplace(std::move(key)).first->second;
+    }
+
+    template<class key_arg_type, class = std::enable_if_t<is_heterogeneous<key_arg_type>>>
+    V &operator[](key_arg_type &&key)
+    {
+      return try_emplace(std::forward<key_arg_type>(key)).first->second;
+    }
+
+  private:
+    template<class key_arg_type, class... args_type>
+    std::pair<iterator, bool> emplace_at(key_arg_type const &key, args_type &&... args)
+    {
+      auto const [index, inserted] = this->find_or_insert(key, std::forward<args_type>(args)...);
+
+      return {this->iterator_at(index), inserted};
+    }
+  };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <claws/container/hash.hpp>
+#include <claws/container/impl/swiss_table.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace swiss
+    {
+      template<class K>
+      struct set_policy
+      {
+        using key_type = K;
+        using value_type = K;
+
+        static constexpr bool const_values = true;
+
+        static K const &key(value_type const &value) noexcept
+        {
+          return value;
+        }
+      };
+    }
+  }
+
+  ///
+  /// \brief Open addressing hash set storing its keys inline, the set counterpart of `claws::flat_hash_map`.
+  ///
+  /// Keys are moved on rehash, and can be looked up by any type accepted by both `hash` and `key_equal` if they are transparent.
+  ///
+  template<class K, class hash = mix_hash, class key_equal = std::equal_to<>>
+  class flat_hash_set : public impl::swiss::table<impl::swiss::set_policy<K>, hash, key_equal>
+  {
+    using base = impl::swiss::table<impl::swiss::set_policy<K>, hash, key_equal>;
+
+    template<class key_arg_type>
+    static constexpr bool is_heterogeneous = !std::is_same_v<std::decay_t<key_arg_type>, K> && impl::swiss::is_transparent<hash>::value
+                                             && impl::swiss::is_transparent<key_equal>::value;
+
+  public:
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    ///
+    /// \brief Inserts `key` if it isn't in the set yet.
+    ///
+    /// Returns an iterator to `key`, and whether it was inserted.
+    ///
+    std::pair<iterator, bool> insert(K const &key)
+    {
+      return emplace_at(key, key);
+    }
+
+    std::pair<iterator, bool> insert(K &&key)
+    {
+      return emplace_at(key, std::move(key));
+    }
+
+    /// \brief Heterogeneous version, `K` being constructed from `key` only if it is inserted
+    template<class key_arg_type, class = std::enable_if_t<is_heterogeneous<key_arg_type>>>
+    std::pair<iterator, bool> insert(key_arg_type &&key)
+    {
+      return emplace_at(key, std::forward<key_arg_type>(key));
+    }
+
+  private:
+    template<class key_arg_type, class... args_type>
+    std::pair<iterator, bool> emplace_at(key_arg_type const &key, args_type &&... args)
+    {
+      auto const [index, inserted] = this->find_or_insert(key, std::forward<args_type>(args)...);
+
+      return {this->iterator_at(index), inserted};
+    }
+  };
+}
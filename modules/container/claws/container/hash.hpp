@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <claws/container/vect.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace hash
+    {
+      /// Xor of the low and high halves of the 128 bits product of `a` and `b`
+      inline std::uint64_t fold_multiply(std::uint64_t a, std::uint64_t b) noexcept
+      {
+#if defined(__SIZEOF_INT128__)
+        auto const product = static_cast<unsigned __int128>(a) * b;
+
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64u);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        std::uint64_t high;
+        auto const low = _umul128(a, b, &high);
+
+        return low ^ high;
+#else
+        // Schoolbook multiplication on 32 bits halves
+        auto const a_low = a & 0xFFFFFFFFu;
+        auto const a_high = a >> 32u;
+        auto const b_low = b & 0xFFFFFFFFu;
+        auto const b_high = b >> 32u;
+        auto const low_low = a_low * b_low;
+        auto const high_low = a_high * b_low;
+        auto const low_high = a_low * b_high;
+        auto const middle = (low_low >> 32u) + (high_low & 0xFFFFFFFFu) + low_high;
+        auto const high = a_high * b_high + (high_low >> 32u) + (middle >> 32u);
+
+        return ((middle << 32u) | (low_low & 0xFFFFFFFFu)) ^ high;
+#endif
+      }
+
+      /// Multiplies by an odd constant and folds the 128 bits product: every input bit affects every output bit
+      inline std::uint64_t mix(std::uint64_t value) noexcept
+      {
+        return fold_multiply(value, 0x9E3779B97F4A7C15u);
+      }
+
+      inline std::uint64_t combine(std::uint64_t seed, std::uint64_t value) noexcept
+      {
+        return mix(seed ^ (value + 0x2545F4914F6CDD1Du));
+      }
+
+      /// Hash functions declaring `is_avalanching` give well spread hashes, which tables can use as is
+      template<class T, class = void>
+      struct is_avalanching : std::false_type
+      {};
+
+      template<class T>
+      struct is_avalanching<T, std::void_t<typename T::is_avalanching>> : std::true_type
+      {};
+
+      /// `hash(key)`, mixed unless `hash` is avalanching
+      template<class hash_type, class K>
+      std::uint64_t spread(hash_type const &hash, K const &key) noexcept(noexcept(hash(key)))
+      {
+        std::uint64_t const value = hash(key);
+
+        if constexpr (is_avalanching<hash_type>::value)
+          return value;
+        else
+          return mix(value);
+      }
+    }
+  }
+
+  ///
+  /// \brief Hash function for hash tables using the low and high bits of hashes alike, like `claws::flat_hash_map`.
+  ///
+  /// Handles integers, enums, pointers, `claws::tagged_data`, `claws::vect` and `std::array` of those, and strings.
+  /// `std::hash` is the identity for integers, which clusters keys in power of two tables: every hash is mixed here.
+  ///
+  /// Transparent: strings, `std::string_view`s and `char const *`s hash the same, as do integers of equal value,
+  /// so tables can be searched without building a `key_type`.
+  ///
+  struct mix_hash
+  {
+    using is_transparent = void;
+    /// Hashes are well spread already, tables don't need to mix them again
+    using is_avalanching = void;
+
+    template<class T>
+    std::size_t operator()(T const &value) const noexcept
+    {
+      if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        return impl::hash::mix(static_cast<std::uint64_t>(value));
+      else if constexpr (std::is_pointer_v<T> && !std::is_convertible_v<T, char const *>)
+        return impl::hash::mix(reinterpret_cast<std::uintptr_t>(value));
+      else if constexpr (std::is_convertible_v<T const &, std::string_view>)
+        return impl::hash::mix(std::hash<std::string_view>{}(std::string_view(value)));
+      else
+        return hash_compound(value);
+    }
+
+  private:
+    template<class data_type, class offset_type, class tag>
+    std::size_t hash_compound(tagged_data<data_type, offset_type, tag> const &value) const noexcept
+    {
+      return (*this)(value.data);
+    }
+
+    /// Integers fitting in 64 bits together are packed and mixed once, others are combined one by one
+    template<class T, std::size_t Size, class container_type>
+    std::size_t hash_elements(container_type const &value) const noexcept
+    {
+      if constexpr (std::is_integral_v<T> && sizeof(T) * Size <= sizeof(std::uint64_t))
+        {
+          std::uint64_t packed(0u);
+
+          for (std::size_t i(0u); i != Size; ++i)
+            packed |= static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<T>>(value[i])) << (i * sizeof(T) * 8u);
+          return impl::hash::mix(packed);
+        }
+      else
+        {
+          std::uint64_t result(Size);
+
+          for (auto const &element : value)
+            result = impl::hash::combine(result, (*this)(element));
+          return result;
+        }
+    }
+
+    template<class T, std::size_t Size>
+    std::size_t hash_compound(vect<T, Size> const &value) const noexcept
+    {
+      return hash_elements<T, Size>(value);
+    }
+
+    template<class T, std::size_t Size>
+    std::size_t hash_compound(std::array<T, Size> const &value) const noexcept
+    {
+      return hash_elements<T, Size>(value);
+    }
+  };
+}
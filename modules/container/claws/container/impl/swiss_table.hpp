@@ -0,0 +1,705 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/container/hash.hpp>
+#include <claws/utils/bit_ops.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+/// MSVC doesn't define `__SSE2__`, even when targeting x64 where SSE2 is always available
+#define CLAWS_SWISS_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace claws
+{
+  namespace impl
+  {
+    namespace swiss
+    {
+      ///
+      /// Control bytes, one per slot: the 7 low bits of the hash of full slots (`h2`), negative for empty and deleted ones.
+      ///
+      using ctrl_t = std::int8_t;
+
+      inline constexpr ctrl_t ctrl_empty = -128;
+      inline constexpr ctrl_t ctrl_deleted = -2;
+
+      /// Control bytes probed at once. Fixed, so the table's layout doesn't depend on the SIMD tier
+      inline constexpr std::size_t group_width = 16;
+
+      /// Control bytes of tables without slots, so lookups don't need to check for them
+      alignas(group_width) inline constexpr ctrl_t empty_group[group_width] = {ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+                                                                              ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+                                                                              ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+                                                                              ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty};
+
+      ///
+      /// \brief 16 control bytes, bit `i` of each match being set if byte `i` matches.
+      ///
+      class group
+      {
+#if defined(CLAWS_SWISS_TABLE_SSE2)
+        __m128i ctrl;
+
+      public:
+        explicit group(ctrl_t const *position) noexcept
+          : ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const *>(position)))
+        {}
+
+        std::uint32_t match(ctrl_t h2) const noexcept
+        {
+          return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+
+        std::uint32_t match_empty() const noexcept
+        {
+          return match(ctrl_empty);
+        }
+
+        /// Empty and deleted are the only control bytes under -1
+        std::uint32_t match_empty_or_deleted() const noexcept
+        {
+          return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+        }
+
+        std::uint32_t match_full() const noexcept
+        {
+          return ~static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl)) & 0xFFFFu;
+        }
+#else
+        ctrl_t ctrl[group_width];
+
+        template<class predicate_type>
+        std::uint32_t match_if(predicate_type predicate) const noexcept
+        {
+          std::uint32_t result(0u);
+
+          for (std::size_t i(0u); i != group_width; ++i)
+            result |= std::uint32_t(predicate(ctrl[i])) << i;
+          return result;
+        }
+
+      public:
+        explicit group(ctrl_t const *position) noexcept
+        {
+          std::memcpy(ctrl, position, group_width);
+        }
+
+        std::uint32_t match(ctrl_t h2) const noexcept
+        {
+          return match_if([h2](ctrl_t value) { return value == h2; });
+        }
+
+        std::uint32_t match_empty() const noexcept
+        {
+          return match(ctrl_empty);
+        }
+
+        std::uint32_t match_empty_or_deleted() const noexcept
+        {
+          return match_if([](ctrl_t value) { return value < -1; });
+        }
+
+        std::uint32_t match_full() const noexcept
+        {
+          return match_if([](ctrl_t value) { return value >= 0; });
+        }
+#endif
+      };
+
+      template<class T, class = void>
+      struct is_transparent : std::false_type
+      {};
+
+      template<class T>
+      struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type
+      {};
+
+      ///
+      /// \brief Open addressing table of `policy::value_type`s, the shared core of `claws::flat_hash_map` and `claws::flat_hash_set`.
+      ///
+      /// `policy` provides `key_type`, `value_type` and `static key_type const &key(value_type const &)`.
+      ///
+      /// Slots are probed a group of 16 at a time: one SIMD comparison of the group's control bytes against the key's `h2`
+      /// finds every candidate slot, and a group with an empty slot ends the probe.
+      /// Capacity is a power of two, and the first group of control bytes is mirrored after the last one so groups can start anywhere.
+      ///
+      template<class policy, class hash_type, class key_equal>
+      class table : private hash_type, private key_equal
+      {
+      public:
+        using key_type = typename policy::key_type;
+        using value_type = typename policy::value_type;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher = hash_type;
+        using key_compare = key_equal;
+
+        template<bool is_const>
+        class basic_iterator
+        {
+        public:
+          using iterator_category = std::forward_iterator_tag;
+          using value_type = typename policy::value_type;
+          using difference_type = std::ptrdiff_t;
+          using reference = std::conditional_t<is_const || policy::const_values, value_type const &, value_type &>;
+          using pointer = std::conditional_t<is_const || policy::const_values, value_type const *, value_type *>;
+
+        private:
+          friend class table;
+
+          template<bool>
+          friend class basic_iterator;
+
+          ctrl_t const *ctrl{nullptr};
+          value_type *slot{nullptr};
+          ctrl_t const *end{nullptr};
+
+          basic_iterator(ctrl_t const *ctrl, value_type *slot, ctrl_t const *end) noexcept
+            : ctrl(ctrl)
+            , slot(slot)
+            , end(end)
+          {}
+
+          /// Moves to the first full slot at or after the current one, a group at a time
+          void skip_empty() noexcept
+          {
+            while (ctrl < end)
+              {
+                auto const full = group(ctrl).match_full();
+
+                if (full)
+                  {
+                    auto const shift = static_cast<std::size_t>(countr_zero(full));
+
+                    // Bytes past `end` mirror the first group
+                    if (shift < static_cast<std::size_t>(end - ctrl))
+                      {
+                        ctrl += shift;
+                        slot += shift;
+                        return;
+                      }
+                    break;
+                  }
+                ctrl += group_width;
+                slot += group_width;
+              }
+            ctrl = end;
+          }
+
+        public:
+          basic_iterator() noexcept = default;
+
+          /// \brief A const iterator can be made from an iterator
+          template<bool other_const, class = std::enable_if_t<is_const && !other_const>>
+          basic_iterator(basic_iterator<other_const> const &other) noexcept
+            : ctrl(other.ctrl)
+            , slot(other.slot)
+            , end(other.end)
+          {}
+
+          reference operator*() const noexcept
+          {
+            return *slot;
+          }
+
+          pointer operator->() const noexcept
+          {
+            return slot;
+          }
+
+          basic_iterator &operator++() noexcept
+          {
+            ++ctrl;
+            ++slot;
+            skip_empty();
+            return *this;
+          }
+
+          basic_iterator operator++(int) noexcept
+          {
+            auto copy(*this);
+
+            ++*this;
+            return copy;
+          }
+
+          bool operator==(basic_iterator const &other) const noexcept
+          {
+            return ctrl == other.ctrl;
+          }
+
+          bool operator!=(basic_iterator const &other) const noexcept
+          {
+            return ctrl != other.ctrl;
+          }
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+      private:
+        static constexpr size_type npos = ~size_type(0u);
+
+        ctrl_t *ctrl{const_cast<ctrl_t *>(empty_group)};
+        value_type *slots{nullptr};
+        size_type slot_count{0u};
+        size_type count{0u};
+        /// Empty slots that can still be filled before reaching the maximum load factor of 7/8
+        size_type growth_left{0u};
+
+        static constexpr size_type max_load(size_type capacity) noexcept
+        {
+          return capacity - capacity / 8u;
+        }
+
+        template<class K>
+        std::uint64_t hash_of(K const &key) const noexcept
+        {
+          return impl::hash::spread(static_cast<hash_type const &>(*this), key);
+        }
+
+        static constexpr size_type h1(std::uint64_t hash) noexcept
+        {
+          return static_cast<size_type>(hash >> 7u);
+        }
+
+        static constexpr ctrl_t h2(std::uint64_t hash) noexcept
+        {
+          return static_cast<ctrl_t>(hash & 0x7Fu);
+        }
+
+        template<class lh_type, class rh_type>
+        bool equal(lh_type const &lh, rh_type const &rh) const noexcept(noexcept(std::declval<key_equal const &>()(lh, rh)))
+        {
+          return static_cast<key_equal const &>(*this)(lh, rh);
+        }
+
+        void set_ctrl(size_type index, ctrl_t value) noexcept
+        {
+          ctrl[index] = value;
+          if (index < group_width)
+            ctrl[slot_count + index] = value;
+        }
+
+        template<class K>
+        size_type find_index(K const &key, std::uint64_t hash) const
+        {
+          if (!count)
+            return npos;
+
+          auto const mask = slot_count - 1u;
+          auto position = h1(hash) & mask;
+
+          for (size_type step(group_width);; step += group_width)
+            {
+              group const current(ctrl + position);
+
+              for (auto matches = current.match(h2(hash)); matches; matches &= matches - 1u)
+                {
+                  auto const index = (position + static_cast<size_type>(countr_zero(matches))) & mask;
+
+                  if (equal(policy::key(slots[index]), key))
+                    return index;
+                }
+              if (current.match_empty())
+                return npos;
+              position = (position + step) & mask;
+            }
+        }
+
+        /// First empty or deleted slot of `hash`'s probe sequence. The table must have one
+        size_type find_free(std::uint64_t hash) const noexcept
+        {
+          auto const mask = slot_count - 1u;
+          auto position = h1(hash) & mask;
+
+          for (size_type step(group_width);; step += group_width)
+            {
+              if (auto const free = group(ctrl + position).match_empty_or_deleted())
+                return (position + static_cast<size_type>(countr_zero(free))) & mask;
+              position = (position + step) & mask;
+            }
+        }
+
+        void deallocate() noexcept
+        {
+          if (!slot_count)
+            return;
+          std::allocator<value_type>().deallocate(slots, slot_count);
+          delete[] ctrl;
+          ctrl = const_cast<ctrl_t *>(empty_group);
+          slots = nullptr;
+          slot_count = 0u;
+        }
+
+        void destroy_values() noexcept
+        {
+          if constexpr (!std::is_trivially_destructible_v<value_type>)
+            for (size_type i(0u); i != slot_count; ++i)
+              if (ctrl[i] >= 0)
+                slots[i].~value_type();
+        }
+
+        ///
+        /// \brief Moves every value to `capacity` new slots, which also drops deleted slots.
+        ///
+        /// Strong guarantee as long as moving values doesn't throw.
+        ///
+        void rehash_to(size_type capacity)
+        {
+          auto const new_ctrl = new ctrl_t[capacity + group_width];
+          value_type *new_slots;
+
+          try
+            {
+              new_slots = std::allocator<value_type>().allocate(capacity);
+            }
+          catch (...)
+            {
+              delete[] new_ctrl;
+              throw;
+            }
+          std::memset(new_ctrl, ctrl_empty, capacity + group_width);
+
+          auto const old_ctrl = ctrl;
+          auto const old_slots = slots;
+          auto const old_count = slot_count;
+
+          ctrl = new_ctrl;
+          slots = new_slots;
+          slot_count = capacity;
+          for (size_type i(0u); i != old_count; ++i)
+            if (old_ctrl[i] >= 0)
+              {
+                auto const hash = hash_of(policy::key(old_slots[i]));
+                auto const index = find_free(hash);
+
+                new (slots + index) value_type(std::move(old_slots[i]));
+                old_slots[i].~value_type();
+                set_ctrl(index, h2(hash));
+              }
+          growth_left = max_load(capacity) - count;
+          if (old_count)
+            {
+              std::allocator<value_type>().deallocate(old_slots, old_count);
+              delete[] old_ctrl;
+            }
+        }
+
+        /// Makes sure a value can be inserted without exceeding the maximum load factor
+        void prepare_insert()
+        {
+          if (growth_left)
+            return;
+          // Mostly deleted slots: cleaning them up is enough
+          if (slot_count && count <= max_load(slot_count) / 2u)
+            rehash_to(slot_count);
+          else
+            rehash_to(slot_count ? slot_count * 2u : group_width);
+        }
+
+        /// Constructs a value in a free slot of `hash`'s probe sequence, returns its index
+        template<class... args_type>
+        size_type insert_new(std::uint64_t hash, args_type &&... args)
+        {
+          prepare_insert();
+
+          auto const index = find_free(hash);
+
+          new (slots + index) value_type(std::forward<args_type>(args)...);
+          growth_left -= ctrl[index] == ctrl_empty;
+          set_ctrl(index, h2(hash));
+          ++count;
+          return index;
+        }
+
+        void erase_index(size_type index) noexcept
+        {
+          auto const mask = slot_count - 1u;
+          auto const empty_before = group(ctrl + ((index - group_width) & mask)).match_empty();
+          auto const empty_after = group(ctrl + index).match_empty();
+
+          slots[index].~value_type();
+          --count;
+          // If no group containing the slot was ever full, no probe went past it: it can become empty again
+          if (empty_before && empty_after
+              && static_cast<size_type>(countr_zero(empty_after) + countl_zero(empty_before << 16u)) < group_width)
+            {
+              set_ctrl(index, ctrl_empty);
+              ++growth_left;
+            }
+          else
+            set_ctrl(index, ctrl_deleted);
+        }
+
+        template<class K>
+        static constexpr bool is_lookup_key = std::is_same_v<K, key_type> || (is_transparent<hash_type>::value && is_transparent<key_equal>::value);
+
+      protected:
+        iterator iterator_at(size_type index) noexcept
+        {
+          return {ctrl + index, slots + index, ctrl + slot_count};
+        }
+
+        const_iterator iterator_at(size_type index) const noexcept
+        {
+          return {ctrl + index, slots + index, ctrl + slot_count};
+        }
+
+        ///
+        /// \brief Returns the index of `key`, constructing a value from `args` if it isn't in the table, and whether it did.
+        ///
+        template<class K, class... args_type>
+        std::pair<size_type, bool> find_or_insert(K const &key, args_type &&... args)
+        {
+          auto const hash = hash_of(key);
+          auto const found = find_index(key, hash);
+
+          if (found != npos)
+            return {found, false};
+          return {insert_new(hash, std::forward<args_type>(args)...), true};
+        }
+
+        value_type &slot_at(size_type index) noexcept
+        {
+          return slots[index];
+        }
+
+      public:
+        table() = default;
+
+        /// \brief Empty table with room for `size` values
+        explicit table(size_type size, hash_type const &hash = {}, key_equal const &equal = {})
+          : hash_type(hash)
+          , key_equal(equal)
+        {
+          reserve(size);
+        }
+
+        table(table const &other)
+          : table(other.count, other.hash_function(), other.key_eq())
+        {
+          for (auto const &value : other)
+            insert_new(hash_of(policy::key(value)), value);
+        }
+
+        table(table &&other) noexcept
+          : hash_type(std::move(other))
+          , key_equal(std::move(other))
+          , ctrl(std::exchange(other.ctrl, const_cast<ctrl_t *>(empty_group)))
+          , slots(std::exchange(other.slots, nullptr))
+          , slot_count(std::exchange(other.slot_count, 0u))
+          , count(std::exchange(other.count, 0u))
+          , growth_left(std::exchange(other.growth_left, 0u))
+        {}
+
+        table &operator=(table other) noexcept
+        {
+          swap(*this, other);
+          return *this;
+        }
+
+        ~table()
+        {
+          destroy_values();
+          deallocate();
+        }
+
+        friend void swap(table &lh, table &rh) noexcept
+        {
+          using std::swap;
+
+          swap(static_cast<hash_type &>(lh), static_cast<hash_type &>(rh));
+          swap(static_cast<key_equal &>(lh), static_cast<key_equal &>(rh));
+          swap(lh.ctrl, rh.ctrl);
+          swap(lh.slots, rh.slots);
+          swap(lh.slot_count, rh.slot_count);
+          swap(lh.count, rh.count);
+          swap(lh.growth_left, rh.growth_left);
+        }
+
+        /// \name iteration, in no particular order
+        /// @{
+        iterator begin() noexcept
+        {
+          auto result = iterator_at(0u);
+
+          result.skip_empty();
+          return result;
+        }
+
+        iterator end() noexcept
+        {
+          return iterator_at(slot_count);
+        }
+
+        const_iterator begin() const noexcept
+        {
+          auto result = iterator_at(0u);
+
+          result.skip_empty();
+          return result;
+        }
+
+        const_iterator end() const noexcept
+        {
+          return iterator_at(slot_count);
+        }
+        /// @}
+
+        size_type size() const noexcept
+        {
+          return count;
+        }
+
+        bool empty() const noexcept
+        {
+          return !count;
+        }
+
+        /// \brief Number of slots, a power of two
+        size_type capacity() const noexcept
+        {
+          return slot_count;
+        }
+
+        ///
+        /// \brief Makes room for `size` values without rehashing.
+        ///
+        void reserve(size_type size)
+        {
+          size_type capacity(group_width);
+
+          while (max_load(capacity) < size)
+            capacity *= 2u;
+          if (capacity > slot_count)
+            rehash_to(capacity);
+        }
+
+        ///
+        /// \brief Destroys every value, keeping the capacity.
+        ///
+        void clear() noexcept
+        {
+          destroy_values();
+          count = 0u;
+          if (slot_count)
+            {
+              std::memset(ctrl, ctrl_empty, slot_count + group_width);
+              growth_left = max_load(slot_count);
+            }
+        }
+
+        ///
+        /// \name lookup, by `key_type` or, if both the hash and the equality are transparent, by any type they accept
+        /// @{
+        template<class K, class = std::enable_if_t<is_lookup_key<K>>>
+        iterator find(K const &key) noexcept
+        {
+          auto const index = find_index(key, hash_of(key));
+
+          return index == npos ? end() : iterator_at(index);
+        }
+
+        template<class K, class = std::enable_if_t<is_lookup_key<K>>>
+        const_iterator find(K const &key) const noexcept
+        {
+          auto const index = find_index(key, hash_of(key));
+
+          return index == npos ? end() : iterator_at(index);
+        }
+
+        iterator find(key_type const &key) noexcept
+        {
+          return find<key_type>(key);
+        }
+
+        const_iterator find(key_type const &key) const noexcept
+        {
+          return find<key_type>(key);
+        }
+
+        template<class K, class = std::enable_if_t<is_lookup_key<K>>>
+        bool contains(K const &key) const noexcept
+        {
+          return find_index(key, hash_of(key)) != npos;
+        }
+
+        bool contains(key_type const &key) const noexcept
+        {
+          return contains<key_type>(key);
+        }
+        /// @}
+
+        ///
+        /// \brief Erases the value at `position`. Other iterators stay valid, so `erase(it++)` is fine.
+        ///
+        void erase(const_iterator position) noexcept
+        {
+          erase_index(static_cast<size_type>(position.ctrl - ctrl));
+        }
+
+        void erase(iterator position) noexcept
+        {
+          erase(const_iterator(position));
+        }
+
+        ///
+        /// \brief Erases `key`, returns how many values were erased (0 or 1).
+        ///
+        template<class K, class = std::enable_if_t<is_lookup_key<K>>>
+        size_type erase(K const &key) noexcept
+        {
+          auto const index = find_index(key, hash_of(key));
+
+          if (index == npos)
+            return 0u;
+          erase_index(index);
+          return 1u;
+        }
+
+        size_type erase(key_type const &key) noexcept
+        {
+          return erase<key_type>(key);
+        }
+
+        ///
+        /// \brief Erases every value for which `predicate(value)` is true, returns how many were erased.
+        ///
+        template<class predicate_type>
+        size_type erase_if(predicate_type &&predicate)
+        {
+          size_type erased(0u);
+
+          for (size_type i(0u); i != slot_count; ++i)
+            if (ctrl[i] >= 0 && predicate(static_cast<value_type const &>(slots[i])))
+              {
+                erase_index(i);
+                ++erased;
+              }
+          return erased;
+        }
+
+        hasher hash_function() const
+        {
+          return *this;
+        }
+
+        key_equal key_eq() const
+        {
+          return *this;
+        }
+      };
+    }
+  }
+}
+
+#undef CLAWS_SWISS_TABLE_SSE2
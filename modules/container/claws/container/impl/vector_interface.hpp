@@ -0,0 +1,332 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/algorithm/constexpr_algorithm.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    ///
+    /// \brief The `std::vector` interface of `claws::static_vector` and `claws::small_vector`, on top of contiguous storage managed by `derived`.
+    ///
+    /// `derived` provides `data()`, `size()` and `capacity()`, and befriends this class for:
+    /// - `set_size(size)`,
+    /// - `reserve_for(size)`, making room for `size` values or throwing `std::bad_alloc`,
+    /// - `emplace_back_full(args...)`, called when there is no room left, which must support `args` referring to values of the vector.
+    ///
+    /// \tparam assignable_slots whether unused slots hold values which can be assigned to, so building values stays usable in constant expressions
+    ///
+    template<class derived, class T, bool assignable_slots>
+    class vector_interface
+    {
+    public:
+      using value_type = T;
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using reference = T &;
+      using const_reference = T const &;
+      using pointer = T *;
+      using const_pointer = T const *;
+      using iterator = T *;
+      using const_iterator = T const *;
+      using reverse_iterator = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+      constexpr derived &self() noexcept
+      {
+        return static_cast<derived &>(*this);
+      }
+
+      constexpr derived const &self() const noexcept
+      {
+        return static_cast<derived const &>(*this);
+      }
+
+      /// Appends copies of `value` up to `size`, which fits the storage
+      constexpr void append_copies(size_type size, T const &value)
+      {
+        auto const values = self().data();
+
+        for (size_type i(self().size()); i != size; ++i)
+          {
+            construct(values + i, value);
+            self().set_size(i + 1u);
+          }
+      }
+
+    protected:
+      template<class... args_type>
+      static constexpr void construct(T *target, args_type &&... args)
+      {
+        if constexpr (assignable_slots)
+          *target = T(std::forward<args_type>(args)...);
+        else
+          new (target) T(std::forward<args_type>(args)...);
+      }
+
+      static constexpr void destroy(T *begin, T *end) noexcept
+      {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+          for (; begin != end; ++begin)
+            begin->~T();
+      }
+
+    public:
+      constexpr iterator begin() noexcept
+      {
+        return self().data();
+      }
+
+      constexpr const_iterator begin() const noexcept
+      {
+        return self().data();
+      }
+
+      constexpr const_iterator cbegin() const noexcept
+      {
+        return begin();
+      }
+
+      constexpr iterator end() noexcept
+      {
+        return self().data() + self().size();
+      }
+
+      constexpr const_iterator end() const noexcept
+      {
+        return self().data() + self().size();
+      }
+
+      constexpr const_iterator cend() const noexcept
+      {
+        return end();
+      }
+
+      constexpr reverse_iterator rbegin() noexcept
+      {
+        return reverse_iterator(end());
+      }
+
+      constexpr const_reverse_iterator rbegin() const noexcept
+      {
+        return const_reverse_iterator(end());
+      }
+
+      constexpr reverse_iterator rend() noexcept
+      {
+        return reverse_iterator(begin());
+      }
+
+      constexpr const_reverse_iterator rend() const noexcept
+      {
+        return const_reverse_iterator(begin());
+      }
+
+      constexpr bool empty() const noexcept
+      {
+        return !self().size();
+      }
+
+      constexpr reference operator[](size_type index) noexcept
+      {
+        return self().data()[index];
+      }
+
+      constexpr const_reference operator[](size_type index) const noexcept
+      {
+        return self().data()[index];
+      }
+
+      constexpr reference front() noexcept
+      {
+        return *begin();
+      }
+
+      constexpr const_reference front() const noexcept
+      {
+        return *begin();
+      }
+
+      constexpr reference back() noexcept
+      {
+        return end()[-1];
+      }
+
+      constexpr const_reference back() const noexcept
+      {
+        return end()[-1];
+      }
+
+      template<class... args_type>
+      constexpr reference emplace_back(args_type &&... args)
+      {
+        auto const count = self().size();
+
+        if (count == self().capacity())
+          return self().emplace_back_full(std::forward<args_type>(args)...);
+
+        auto const target = self().data() + count;
+
+        construct(target, std::forward<args_type>(args)...);
+        self().set_size(count + 1u);
+        return *target;
+      }
+
+      constexpr void push_back(T const &value)
+      {
+        emplace_back(value);
+      }
+
+      constexpr void push_back(T &&value)
+      {
+        emplace_back(std::move(value));
+      }
+
+      constexpr void pop_back() noexcept
+      {
+        auto const count = self().size() - 1u;
+
+        destroy(self().data() + count, self().data() + count + 1u);
+        self().set_size(count);
+      }
+
+      ///
+      /// \brief Constructs a value before `position`, moving the following ones up.
+      ///
+      template<class... args_type>
+      constexpr iterator emplace(const_iterator position, args_type &&... args)
+      {
+        auto const index = static_cast<size_type>(position - begin());
+
+        if (index == self().size())
+          {
+            emplace_back(std::forward<args_type>(args)...);
+            return begin() + index;
+          }
+
+        // `args` may refer to values about to move
+        T value(std::forward<args_type>(args)...);
+
+        emplace_back(std::move(back()));
+
+        auto const values = self().data();
+
+        for (size_type i(self().size() - 2u); i > index; --i)
+          values[i] = std::move(values[i - 1u]);
+        values[index] = std::move(value);
+        return values + index;
+      }
+
+      constexpr iterator insert(const_iterator position, T const &value)
+      {
+        return emplace(position, value);
+      }
+
+      constexpr iterator insert(const_iterator position, T &&value)
+      {
+        return emplace(position, std::move(value));
+      }
+
+      constexpr iterator erase(const_iterator first, const_iterator last)
+      {
+        auto const index = static_cast<size_type>(first - begin());
+        auto const count = static_cast<size_type>(last - first);
+
+        if (count)
+          {
+            auto const values = self().data();
+            auto const size = self().size();
+
+            claws::move(values + index + count, values + size, values + index);
+            destroy(values + size - count, values + size);
+            self().set_size(size - count);
+          }
+        return begin() + index;
+      }
+
+      constexpr iterator erase(const_iterator position)
+      {
+        return erase(position, position + 1);
+      }
+
+      constexpr void clear() noexcept
+      {
+        destroy(begin(), end());
+        self().set_size(0u);
+      }
+
+      ///
+      /// \brief Removes values past `size`, or appends copies of `value` up to `size`.
+      ///
+      constexpr void resize(size_type size, T const &value)
+      {
+        auto const count = self().size();
+
+        if (size <= count)
+          {
+            erase(begin() + size, end());
+            return;
+          }
+        if (size > self().capacity())
+          {
+            // `value` may be one of the values about to be relocated
+            T const copy(value);
+
+            self().reserve_for(size);
+            append_copies(size, copy);
+          }
+        else
+          append_copies(size, value);
+      }
+
+      ///
+      /// \brief Removes values past `size`, or appends value-initialised values up to `size`.
+      ///
+      constexpr void resize(size_type size)
+      {
+        auto const count = self().size();
+
+        if (size <= count)
+          {
+            erase(begin() + size, end());
+            return;
+          }
+        self().reserve_for(size);
+
+        auto const values = self().data();
+
+        for (size_type i(count); i != size; ++i)
+          {
+            construct(values + i);
+            self().set_size(i + 1u);
+          }
+      }
+
+      template<class other_type>
+      constexpr bool operator==(other_type const &other) const
+      {
+        if (self().size() != other.size())
+          return false;
+
+        auto it = other.begin();
+
+        for (auto const &value : *this)
+          if (!(value == *it++))
+            return false;
+        return true;
+      }
+
+      template<class other_type>
+      constexpr bool operator!=(other_type const &other) const
+      {
+        return !(*this == other);
+      }
+    };
+  }
+}
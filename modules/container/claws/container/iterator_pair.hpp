@@ -25,4 +25,10 @@ namespace claws
       return end() - begin();
     }
   };
+
+  ///
+  /// \brief Contiguous range of `T`s, as the bytes of a `claws::mapped_file` or the elements of a `claws::view_binary` buffer.
+  ///
+  template<class T>
+  using span = iterator_pair<T *, T *>;
 }
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+#endif
+
+namespace claws
+{
+  ///
+  /// \brief Where `claws::monotonic_arena` gets its blocks from.
+  ///
+  enum class arena_backing : unsigned char
+  {
+    /// `operator new`
+    heap,
+    /// Anonymous mappings aligned on 2 MiB and advised to use transparent huge pages, where supported, saving TLB misses on large arenas.
+    /// Falls back to `heap` elsewhere
+    huge_pages
+  };
+
+  ///
+  /// \brief Bump allocator: allocations advance a pointer in the current block, deallocations do nothing, `reset` frees everything at once.
+  ///
+  /// For values sharing a lifetime, like everything built while handling one request or one frame:
+  /// allocating is a few instructions, and nothing is freed one by one.
+  ///
+  /// Blocks are chained. `reset` rewinds to the first block in O(1), keeping every block for the next round,
+  /// so an arena reset in a loop stops allocating once it reached its peak size. `release` gives the blocks back.
+  ///
+  /// A `std::pmr::memory_resource`, usable by every `std::pmr` container, and `claws::arena_allocator` is a standard allocator using it without virtual calls.
+  /// Throws `std::bad_alloc` when out of memory. Not thread safe.
+  ///
+  class monotonic_arena : public std::pmr::memory_resource
+  {
+  public:
+    static constexpr std::size_t default_block_size = 64u << 10u;
+    static constexpr std::size_t huge_page_size = 2u << 20u;
+
+  private:
+    struct block
+    {
+      block *next;
+      /// Size of the block, header included
+      std::size_t size;
+    };
+
+    static constexpr std::size_t header_size = (sizeof(block) + alignof(std::max_align_t) - 1u) & ~(alignof(std::max_align_t) - 1u);
+
+    block *first{nullptr};
+    block *current{nullptr};
+    std::byte *position{nullptr};
+    std::byte *end{nullptr};
+    std::size_t block_size;
+    arena_backing backing;
+
+    static std::byte *begin_of(block *target) noexcept
+    {
+      return reinterpret_cast<std::byte *>(target) + header_size;
+    }
+
+    block *allocate_block(std::size_t size)
+    {
+#if defined(__unix__) && defined(MADV_HUGEPAGE)
+      if (backing == arena_backing::huge_pages)
+        {
+          size = (size + huge_page_size - 1u) & ~(huge_page_size - 1u);
+
+          // Over-map by a huge page, and trim the ends so the block is aligned on one
+          auto const mapped = ::mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+          if (mapped == MAP_FAILED)
+            throw std::bad_alloc();
+
+          auto const address = reinterpret_cast<std::uintptr_t>(mapped);
+          auto const aligned = (address + huge_page_size - 1u) & ~(huge_page_size - 1u);
+
+          if (aligned != address)
+            ::munmap(mapped, aligned - address);
+          ::munmap(reinterpret_cast<void *>(aligned + size), huge_page_size - (aligned - address));
+          ::madvise(reinterpret_cast<void *>(aligned), size, MADV_HUGEPAGE);
+          return new (reinterpret_cast<void *>(aligned)) block{nullptr, size};
+        }
+#endif
+      return new (::operator new(size)) block{nullptr, size};
+    }
+
+    void free_block(block *target) noexcept
+    {
+#if defined(__unix__) && defined(MADV_HUGEPAGE)
+      if (backing == arena_backing::huge_pages)
+        {
+          ::munmap(target, target->size);
+          return;
+        }
+#endif
+      ::operator delete(target);
+    }
+
+    void use_block(block *target) noexcept
+    {
+      current = target;
+      position = begin_of(target);
+      end = reinterpret_cast<std::byte *>(target) + target->size;
+    }
+
+    /// Moves to the next block with room for `size` bytes aligned on `alignment`, allocating one if needed
+    void *allocate_slow(std::size_t size, std::size_t alignment)
+    {
+      auto const needed = size + alignment + header_size;
+
+      while (current && current->next)
+        {
+          use_block(current->next);
+          if (auto const result = try_allocate(size, alignment))
+            return result;
+        }
+
+      auto const added = allocate_block(needed > block_size ? needed : block_size);
+
+      if (current)
+        current->next = added;
+      else
+        first = added;
+      use_block(added);
+      return try_allocate(size, alignment);
+    }
+
+    void *try_allocate(std::size_t size, std::size_t alignment) noexcept
+    {
+      auto const aligned = reinterpret_cast<std::byte *>((reinterpret_cast<std::uintptr_t>(position) + alignment - 1u) & ~(alignment - 1u));
+
+      if (aligned > end || static_cast<std::size_t>(end - aligned) < size)
+        return nullptr;
+      position = aligned + size;
+      return aligned;
+    }
+
+  protected:
+    void *do_allocate(std::size_t size, std::size_t alignment) override
+    {
+      return allocate(size, alignment);
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override
+    {}
+
+    bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+  public:
+    ///
+    /// \param block_size size of the blocks, header included. Larger allocations get a block of their own
+    /// \param backing where blocks come from
+    ///
+    explicit monotonic_arena(std::size_t block_size = default_block_size, arena_backing backing = arena_backing::heap) noexcept
+      : block_size(block_size)
+      , backing(backing)
+    {}
+
+    monotonic_arena(monotonic_arena const &) = delete;
+    monotonic_arena &operator=(monotonic_arena const &) = delete;
+
+    ~monotonic_arena() override
+    {
+      release();
+    }
+
+    ///
+    /// \brief Returns `size` bytes aligned on `alignment`, a power of two. Never returns `nullptr`.
+    ///
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+      if (auto const result = try_allocate(size, alignment))
+        return result;
+      return allocate_slow(size, alignment);
+    }
+
+    ///
+    /// \brief Uninitialised storage for `count` `T`s.
+    ///
+    template<class T>
+    T *allocate_array(std::size_t count)
+    {
+      if (count > ~std::size_t(0u) / sizeof(T))
+        throw std::bad_alloc();
+      return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    ///
+    /// \brief Constructs a `T` in the arena. Its destructor is never called, unless the caller does.
+    ///
+    template<class T, class... args_type>
+    T *construct(args_type &&... args)
+    {
+      return new (allocate(sizeof(T), alignof(T))) T(std::forward<args_type>(args)...);
+    }
+
+    ///
+    /// \brief Makes every allocation available again in O(1), keeping the blocks. Nothing allocated before may be used afterwards.
+    ///
+    void reset() noexcept
+    {
+      if (first)
+        use_block(first);
+    }
+
+    ///
+    /// \brief Frees every block.
+    ///
+    void release() noexcept
+    {
+      while (first)
+        free_block(std::exchange(first, first->next));
+      current = nullptr;
+      position = nullptr;
+      end = nullptr;
+    }
+
+    /// \brief Bytes held in blocks, headers included
+    std::size_t get_capacity() const noexcept
+    {
+      std::size_t result(0u);
+
+      for (auto target = first; target; target = target->next)
+        result += target->size;
+      return result;
+    }
+
+    arena_backing get_backing() const noexcept
+    {
+      return backing;
+    }
+  };
+
+  ///
+  /// \brief Standard allocator allocating from a `claws::monotonic_arena`. `deallocate` does nothing.
+  ///
+  /// Unlike `std::pmr::polymorphic_allocator`, allocations are inlined rather than going through a virtual call.
+  ///
+  template<class T>
+  class arena_allocator
+  {
+    monotonic_arena *arena;
+
+    template<class U>
+    friend class arena_allocator;
+
+  public:
+    using value_type = T;
+
+    explicit arena_allocator(monotonic_arena &arena) noexcept
+      : arena(&arena)
+    {}
+
+    template<class U>
+    arena_allocator(arena_allocator<U> const &other) noexcept
+      : arena(other.arena)
+    {}
+
+    T *allocate(std::size_t count)
+    {
+      return arena->allocate_array<T>(count);
+    }
+
+    void deallocate(T *, std::size_t) noexcept
+    {}
+
+    monotonic_arena &get_arena() const noexcept
+    {
+      return *arena;
+    }
+
+    template<class U>
+    bool operator==(arena_allocator<U> const &other) const noexcept
+    {
+      return arena == other.arena;
+    }
+
+    template<class U>
+    bool operator!=(arena_allocator<U> const &other) const noexcept
+    {
+      return arena != other.arena;
+    }
+  };
+}
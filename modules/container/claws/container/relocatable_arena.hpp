@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/utils/offset_ptr.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Allocator carving a block of memory which can be moved, written to a file or mapped at any address as a whole.
+  ///
+  /// The arena lives at the start of its block, and everything it hands out is addressed relative to it.
+  /// Structures allocated from it and linked with `claws::offset_ptr`s (`claws::relocatable_vector`, `claws::relocatable_slot_map`,
+  /// `claws::relocatable_hash_map`) can thus be used straight after `mmap`, without being rebuilt.
+  ///
+  /// Allocations are rounded up to a power of two no smaller than their alignment, and freed blocks are kept in one free list per size,
+  /// so a block that is mapped again can keep on being modified.
+  /// Allocations return `nullptr` once the block is full: grow it (e.g. with `claws::mapped_file::grow`) and `attach` it again.
+  ///
+  /// Not thread safe: concurrent readers are fine, a writer needs exclusive access.
+  /// Readers attach through `attach(void const *, std::size_t)`, which never writes to the block, so it may be mapped read-only.
+  ///
+  class relocatable_arena
+  {
+  public:
+    /// Alignment of the block, and the highest alignment allocations can get
+    static constexpr std::size_t max_alignment = 64;
+
+  private:
+    static constexpr char magic_value[8] = {'C', 'L', 'A', 'R', 'E', 'N', 'A', '1'};
+    static constexpr std::size_t min_block_size = 16;
+    static constexpr unsigned size_classes = 64;
+
+    char magic[8];
+    /// Size of the whole block, arena included
+    std::uint64_t capacity;
+    /// Bytes before the first never allocated byte, arena included
+    std::uint64_t used;
+    /// Offset from the arena of the first free block of each size, 0 when empty
+    std::uint64_t free_lists[size_classes];
+    offset_ptr<void> root;
+
+    relocatable_arena(std::size_t capacity) noexcept
+      : capacity(capacity)
+      , used(sizeof(relocatable_arena))
+      , free_lists{}
+      , root(nullptr)
+    {
+      std::memcpy(magic, magic_value, sizeof(magic));
+    }
+
+    /// Blocks are at least `alignment` bytes, and blocks of a size are aligned on it up to `max_alignment`, so they suit the alignment
+    static constexpr unsigned size_class(std::size_t size, std::size_t alignment) noexcept
+    {
+      unsigned result(0u);
+
+      if (size < alignment)
+        size = alignment;
+      if (size < min_block_size)
+        size = min_block_size;
+
+      while ((std::size_t(1u) << result) < size)
+        ++result;
+      return result;
+    }
+
+    std::byte *base() noexcept
+    {
+      return reinterpret_cast<std::byte *>(this);
+    }
+
+    /// Returns the arena in `block` if there is one which fits in `size` bytes, without writing to it
+    static relocatable_arena const *find(void const *block, std::size_t size) noexcept
+    {
+      if (reinterpret_cast<std::uintptr_t>(block) % max_alignment || size < sizeof(relocatable_arena))
+        return nullptr;
+
+      auto const arena = std::launder(static_cast<relocatable_arena const *>(block));
+
+      if (std::memcmp(arena->magic, magic_value, sizeof(magic_value)) || arena->capacity > size)
+        return nullptr;
+      return arena;
+    }
+
+  public:
+    relocatable_arena(relocatable_arena const &) = delete;
+    relocatable_arena &operator=(relocatable_arena const &) = delete;
+
+    ///
+    /// \brief Creates an arena in `[block, block + size)`, discarding what it held.
+    ///
+    /// Returns `nullptr` if `block` isn't aligned on `max_alignment` or is too small.
+    ///
+    static relocatable_arena *create(void *block, std::size_t size) noexcept
+    {
+      if (reinterpret_cast<std::uintptr_t>(block) % max_alignment || size < sizeof(relocatable_arena))
+        return nullptr;
+      return new (block) relocatable_arena(size);
+    }
+
+    ///
+    /// \brief Returns the arena created in `block`, which may have been moved or mapped since.
+    ///
+    /// `size` may be larger than when the arena was created, the arena then uses the extra space.
+    /// The block is only written to in that case, so attaching a block the arena already spans doesn't race with its readers.
+    /// Returns `nullptr` if `block` doesn't hold an arena, or is smaller than the arena's block.
+    ///
+    static relocatable_arena *attach(void *block, std::size_t size) noexcept
+    {
+      if (!find(block, size))
+        return nullptr;
+
+      auto const arena = std::launder(static_cast<relocatable_arena *>(block));
+
+      if (size > arena->capacity)
+        arena->capacity = size;
+      return arena;
+    }
+
+    ///
+    /// \brief Returns the arena created in `block` for reading only, never writing to the block, which may be mapped read-only.
+    ///
+    /// The arena keeps the size it was last attached with for writing. Returns `nullptr` as the other `attach` does.
+    ///
+    static relocatable_arena const *attach(void const *block, std::size_t size) noexcept
+    {
+      return find(block, size);
+    }
+
+    ///
+    /// \brief Allocates `size` bytes aligned on `alignment`, returns `nullptr` if the arena is full or `alignment` exceeds `max_alignment`.
+    ///
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+      if (alignment > max_alignment || size > capacity)
+        return nullptr;
+
+      auto const index = size_class(size, alignment);
+      auto const block_size = std::size_t(1u) << index;
+
+      if (auto const head = free_lists[index])
+        {
+          std::memcpy(&free_lists[index], base() + head, sizeof(std::uint64_t));
+          return base() + head;
+        }
+
+      // Every block of a size has the same alignment, so freed blocks of this size suit `alignment` too
+      auto const block_alignment = block_size < max_alignment ? block_size : max_alignment;
+      auto const offset = (used + block_alignment - 1u) / block_alignment * block_alignment;
+
+      if (offset > capacity || capacity - offset < block_size)
+        return nullptr;
+      used = offset + block_size;
+      return base() + offset;
+    }
+
+    ///
+    /// \brief Gives back a block from `allocate(size, alignment)`.
+    ///
+    void deallocate(void *block, std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+      if (!block)
+        return;
+
+      auto const index = size_class(size, alignment);
+      std::uint64_t const offset = static_cast<std::uint64_t>(static_cast<std::byte *>(block) - base());
+
+      std::memcpy(block, &free_lists[index], sizeof(std::uint64_t));
+      free_lists[index] = offset;
+    }
+
+    ///
+    /// \brief Allocates and constructs a `T`, returns `nullptr` if the arena is full.
+    ///
+    template<class T, class... args_type>
+    T *construct(args_type &&... args)
+    {
+      auto const block = allocate(sizeof(T), alignof(T));
+
+      if (!block)
+        return nullptr;
+      try
+        {
+          return new (block) T(std::forward<args_type>(args)...);
+        }
+      catch (...)
+        {
+          deallocate(block, sizeof(T), alignof(T));
+          throw;
+        }
+    }
+
+    template<class T>
+    void destroy(T *value) noexcept
+    {
+      if (!value)
+        return;
+      value->~T();
+      deallocate(value, sizeof(T), alignof(T));
+    }
+
+    /// \name root object, to find the structures of a block after mapping it
+    /// @{
+    template<class T>
+    T *get_root() noexcept
+    {
+      return static_cast<T *>(root.get());
+    }
+
+    /// Read-only, as the block of an arena attached with `attach(void const *, std::size_t)` may be mapped read-only
+    template<class T>
+    T const *get_root() const noexcept
+    {
+      return static_cast<T const *>(root.get());
+    }
+
+    void set_root(void *value) noexcept
+    {
+      root = value;
+    }
+    /// @}
+
+    std::size_t get_capacity() const noexcept
+    {
+      return capacity;
+    }
+
+    /// \brief Bytes ever allocated, arena included. Freed blocks still count.
+    std::size_t get_used() const noexcept
+    {
+      return used;
+    }
+  };
+}
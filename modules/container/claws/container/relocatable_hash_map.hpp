@@ -0,0 +1,269 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/container/relocatable_arena.hpp>
+#include <claws/utils/offset_ptr.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Open addressing hash map allocated from a `claws::relocatable_arena`, usable wherever the arena's block is mapped.
+  ///
+  /// \tparam key_type, mapped_type relocatable types: no raw pointers, only values and `claws::offset_ptr`s into the same block
+  /// \tparam hash must give the same hashes in every process mapping the block, as `std::hash` does for integers with a given standard library
+  ///
+  /// Linear probing with backward shift erasure, so lookups never go through tombstones.
+  /// Hashes are spread with a multiplicative (fibonacci) step before picking a bucket, so weak hashes like the identity are fine.
+  ///
+  /// The map itself must live in the arena's block. Throws `std::bad_alloc` when the arena is full, leaving the map untouched.
+  /// References to values are invalidated by insertions and erasures.
+  ///
+  template<class key_type, class mapped_type, class hash = std::hash<key_type>, class key_equal = std::equal_to<key_type>>
+  class relocatable_hash_map
+  {
+  public:
+    using size_type = std::size_t;
+
+    struct entry
+    {
+      key_type key;
+      mapped_type value;
+    };
+
+  private:
+    offset_ptr<relocatable_arena> arena;
+    /// 1 for buckets holding an entry
+    offset_ptr<unsigned char> used;
+    offset_ptr<entry> entries;
+    std::uint64_t bucket_count{0u};
+    std::uint64_t count{0u};
+    /// `64 - log2(bucket_count)`
+    std::uint32_t shift{64u};
+
+    size_type bucket_of(key_type const &key) const noexcept
+    {
+      return static_cast<size_type>((static_cast<std::uint64_t>(hash{}(key)) * 0x9E3779B97F4A7C15u) >> shift);
+    }
+
+    size_type next(size_type bucket) const noexcept
+    {
+      return (bucket + 1u) & (bucket_count - 1u);
+    }
+
+    /// Bucket of `key`, or the empty bucket where it would go
+    size_type probe(key_type const &key) const noexcept
+    {
+      auto bucket = bucket_of(key);
+
+      while (used[bucket] && !key_equal{}(entries[bucket].key, key))
+        bucket = next(bucket);
+      return bucket;
+    }
+
+    void free_buckets(unsigned char *buckets_used, entry *buckets, size_type size) noexcept
+    {
+      for (size_type i(0u); i != size; ++i)
+        if (buckets_used[i])
+          buckets[i].~entry();
+      arena->deallocate(buckets_used, size, 1u);
+      arena->deallocate(buckets, size * sizeof(entry), alignof(entry));
+    }
+
+    /// Moves every entry to `size` new buckets, `size` being a power of two larger than `count`
+    void rehash(size_type size)
+    {
+      auto const new_used = static_cast<unsigned char *>(arena->allocate(size, 1u));
+      auto const new_entries = new_used ? static_cast<entry *>(arena->allocate(size * sizeof(entry), alignof(entry))) : nullptr;
+
+      if (!new_entries)
+        {
+          arena->deallocate(new_used, size, 1u);
+          throw std::bad_alloc();
+        }
+      for (size_type i(0u); i != size; ++i)
+        new_used[i] = 0u;
+
+      auto const old_used = used.get();
+      auto const old_entries = entries.get();
+      auto const old_count = bucket_count;
+
+      used = new_used;
+      entries = new_entries;
+      bucket_count = size;
+      shift = 64u;
+      for (; size > 1u; size >>= 1u)
+        --shift;
+      for (size_type i(0u); i != old_count; ++i)
+        if (old_used[i])
+          {
+            auto const bucket = probe(old_entries[i].key);
+
+            new (&entries[bucket]) entry(std::move(old_entries[i]));
+            used[bucket] = 1u;
+          }
+      if (old_count)
+        free_buckets(old_used, old_entries, old_count);
+    }
+
+  public:
+    explicit relocatable_hash_map(relocatable_arena &arena) noexcept
+      : arena(&arena)
+    {}
+
+    relocatable_hash_map(relocatable_hash_map const &) = delete;
+    relocatable_hash_map &operator=(relocatable_hash_map const &) = delete;
+
+    ~relocatable_hash_map()
+    {
+      if (bucket_count)
+        free_buckets(used, entries, bucket_count);
+    }
+
+    ///
+    /// \brief Makes room for `size` entries without rehashing, keeping the load factor under 3/4.
+    ///
+    void reserve(size_type size)
+    {
+      size_type buckets(bucket_count ? bucket_count : 8u);
+
+      while (size > buckets / 4u * 3u)
+        buckets *= 2u;
+      if (buckets != bucket_count)
+        rehash(buckets);
+    }
+
+    ///
+    /// \brief Inserts `key` with a value constructed from `args` if it isn't in the map yet.
+    ///
+    /// Returns the value of `key`, and whether it was inserted.
+    ///
+    template<class... args_type>
+    std::pair<mapped_type *, bool> try_emplace(key_type const &key, args_type &&... args)
+    {
+      if (bucket_count)
+        {
+          auto const bucket = probe(key);
+
+          if (used[bucket])
+            return {&entries[bucket].value, false};
+        }
+      reserve(count + 1u);
+
+      auto const bucket = probe(key);
+
+      new (&entries[bucket]) entry{key, mapped_type(std::forward<args_type>(args)...)};
+      used[bucket] = 1u;
+      ++count;
+      return {&entries[bucket].value, true};
+    }
+
+    std::pair<mapped_type *, bool> insert(key_type const &key, mapped_type const &value)
+    {
+      return try_emplace(key, value);
+    }
+
+    /// \brief Returns the value of `key`, or `nullptr`.
+    mapped_type *find(key_type const &key) noexcept
+    {
+      return const_cast<mapped_type *>(static_cast<relocatable_hash_map const &>(*this).find(key));
+    }
+
+    mapped_type const *find(key_type const &key) const noexcept
+    {
+      if (!count)
+        return nullptr;
+
+      auto const bucket = probe(key);
+
+      return used[bucket] ? &entries[bucket].value : nullptr;
+    }
+
+    bool contains(key_type const &key) const noexcept
+    {
+      return find(key) != nullptr;
+    }
+
+    ///
+    /// \brief Erases `key`. Returns `false` if it wasn't in the map.
+    ///
+    /// The following entries of the probe sequence are shifted back, so no tombstone is left.
+    ///
+    bool erase(key_type const &key) noexcept(std::is_nothrow_move_constructible_v<entry>)
+    {
+      if (!count)
+        return false;
+
+      auto hole = probe(key);
+
+      if (!used[hole])
+        return false;
+      entries[hole].~entry();
+      used[hole] = 0u;
+      --count;
+      for (auto bucket = next(hole); used[bucket]; bucket = next(bucket))
+        {
+          auto const home = bucket_of(entries[bucket].key);
+
+          // Entries whose home bucket is cyclically in (hole, bucket] stay, others move to the hole
+          if (((bucket - home) & (bucket_count - 1u)) < ((bucket - hole) & (bucket_count - 1u)))
+            continue;
+          new (&entries[hole]) entry(std::move(entries[bucket]));
+          used[hole] = 1u;
+          entries[bucket].~entry();
+          used[bucket] = 0u;
+          hole = bucket;
+        }
+      return true;
+    }
+
+    void clear() noexcept
+    {
+      for (size_type i(0u); i != bucket_count; ++i)
+        if (used[i])
+          {
+            entries[i].~entry();
+            used[i] = 0u;
+          }
+      count = 0u;
+    }
+
+    ///
+    /// \brief Calls `function(key, value)` for every entry, in no particular order.
+    ///
+    template<class function_type>
+    void for_each(function_type &&function)
+    {
+      for (size_type i(0u); i != bucket_count; ++i)
+        if (used[i])
+          function(static_cast<key_type const &>(entries[i].key), entries[i].value);
+    }
+
+    template<class function_type>
+    void for_each(function_type &&function) const
+    {
+      for (size_type i(0u); i != bucket_count; ++i)
+        if (used[i])
+          function(static_cast<key_type const &>(entries[i].key), static_cast<mapped_type const &>(entries[i].value));
+    }
+
+    size_type size() const noexcept
+    {
+      return count;
+    }
+
+    bool empty() const noexcept
+    {
+      return !count;
+    }
+
+    size_type get_bucket_count() const noexcept
+    {
+      return bucket_count;
+    }
+  };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <claws/container/relocatable_vector.hpp>
+#include <claws/container/slot_map.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief `claws::slot_map` stored in `claws::relocatable_vector`s, usable wherever its arena's block is mapped.
+  ///
+  /// Construct it with the arena, in the arena's block: `arena->construct<relocatable_slot_map<T, tag>>(*arena)`.
+  /// Keys are plain integers, so they can be stored in the block or elsewhere and stay valid across mappings.
+  ///
+  template<class T,
+           class tag,
+           class key_data = std::uint32_t,
+           unsigned index_bits = impl::default_slot_index_bits<key_data>,
+           slot_generation_policy generation_policy = slot_generation_policy::wrap>
+  using relocatable_slot_map = slot_map<T, tag, key_data, index_bits, relocatable_vector, generation_policy>;
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/container/relocatable_arena.hpp>
+#include <claws/utils/offset_ptr.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Dynamic array allocated from a `claws::relocatable_arena`, usable wherever the arena's block is mapped.
+  ///
+  /// Has the interface of `std::vector` for what `claws::slot_map` needs, and throws `std::bad_alloc` when the arena is full.
+  /// The vector itself must live in the arena's block, and `T` must be relocatable too:
+  /// no raw pointers, only values and `claws::offset_ptr`s into the same block.
+  ///
+  template<class T>
+  class relocatable_vector
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = T *;
+    using const_iterator = T const *;
+
+  private:
+    offset_ptr<relocatable_arena> arena;
+    offset_ptr<T> values;
+    std::uint64_t count{0u};
+    std::uint64_t storage_capacity{0u};
+
+    void release() noexcept
+    {
+      clear();
+      arena->deallocate(values.get(), storage_capacity * sizeof(T), alignof(T));
+      values = nullptr;
+      storage_capacity = 0u;
+    }
+
+    /// Allocates room for `size` values, throws `std::bad_alloc` if the arena is full
+    T *allocate_storage(size_type size)
+    {
+      if (size > (~std::size_t(0u)) / sizeof(T))
+        throw std::bad_alloc();
+
+      auto const storage = static_cast<T *>(arena->allocate(size * sizeof(T), alignof(T)));
+
+      if (!storage)
+        throw std::bad_alloc();
+      return storage;
+    }
+
+    /// Moves the values to `storage`, of room for `size` values, and frees the previous storage
+    void adopt_storage(T *storage, size_type size)
+    {
+      for (size_type i(0u); i != count; ++i)
+        {
+          new (storage + i) T(std::move_if_noexcept(values[i]));
+          values[i].~T();
+        }
+      arena->deallocate(values.get(), storage_capacity * sizeof(T), alignof(T));
+      values = storage;
+      storage_capacity = size;
+    }
+
+    template<class... args_type>
+    reference emplace_back_full(args_type &&... args)
+    {
+      auto const new_capacity = storage_capacity ? storage_capacity * 2u : 4u;
+      auto const storage = allocate_storage(new_capacity);
+
+      // The new value first, as `args` may refer to the values about to be moved
+      try
+        {
+          new (storage + count) T(std::forward<args_type>(args)...);
+        }
+      catch (...)
+        {
+          arena->deallocate(storage, new_capacity * sizeof(T), alignof(T));
+          throw;
+        }
+      adopt_storage(storage, new_capacity);
+      return values[count++];
+    }
+
+  public:
+    explicit relocatable_vector(relocatable_arena &arena) noexcept
+      : arena(&arena)
+    {}
+
+    relocatable_vector(relocatable_vector const &other)
+      : arena(other.arena)
+    {
+      reserve(other.size());
+      for (auto const &value : other)
+        push_back(value);
+    }
+
+    relocatable_vector(relocatable_vector &&other) noexcept
+      : arena(other.arena)
+      , values(other.values)
+      , count(std::exchange(other.count, 0u))
+      , storage_capacity(std::exchange(other.storage_capacity, 0u))
+    {
+      other.values = nullptr;
+    }
+
+    relocatable_vector &operator=(relocatable_vector const &other)
+    {
+      if (this != &other)
+        {
+          relocatable_vector copy(other);
+
+          *this = std::move(copy);
+        }
+      return *this;
+    }
+
+    relocatable_vector &operator=(relocatable_vector &&other) noexcept
+    {
+      if (this != &other)
+        {
+          release();
+          arena = other.arena;
+          values = other.values;
+          count = std::exchange(other.count, 0u);
+          storage_capacity = std::exchange(other.storage_capacity, 0u);
+          other.values = nullptr;
+        }
+      return *this;
+    }
+
+    ~relocatable_vector()
+    {
+      release();
+    }
+
+    ///
+    /// \brief Makes room for `size` values. Throws `std::bad_alloc` if the arena is full, leaving the vector untouched.
+    ///
+    void reserve(size_type size)
+    {
+      if (size <= storage_capacity)
+        return;
+      adopt_storage(allocate_storage(size), size);
+    }
+
+    template<class... args_type>
+    reference emplace_back(args_type &&... args)
+    {
+      if (count == storage_capacity)
+        return emplace_back_full(std::forward<args_type>(args)...);
+      new (values.get() + count) T(std::forward<args_type>(args)...);
+      return values[count++];
+    }
+
+    void push_back(T const &value)
+    {
+      emplace_back(value);
+    }
+
+    void push_back(T &&value)
+    {
+      emplace_back(std::move(value));
+    }
+
+    void pop_back() noexcept
+    {
+      values[--count].~T();
+    }
+
+    void resize(size_type size)
+    {
+      reserve(size);
+      while (count < size)
+        emplace_back();
+      while (count > size)
+        pop_back();
+    }
+
+    void clear() noexcept
+    {
+      while (count)
+        pop_back();
+    }
+
+    reference operator[](size_type index) noexcept
+    {
+      return values[index];
+    }
+
+    const_reference operator[](size_type index) const noexcept
+    {
+      return values[index];
+    }
+
+    reference back() noexcept
+    {
+      return values[count - 1u];
+    }
+
+    const_reference back() const noexcept
+    {
+      return values[count - 1u];
+    }
+
+    size_type size() const noexcept
+    {
+      return count;
+    }
+
+    size_type capacity() const noexcept
+    {
+      return storage_capacity;
+    }
+
+    bool empty() const noexcept
+    {
+      return !count;
+    }
+
+    T *data() noexcept
+    {
+      return values.get();
+    }
+
+    T const *data() const noexcept
+    {
+      return values.get();
+    }
+
+    iterator begin() noexcept
+    {
+      return values.get();
+    }
+
+    iterator end() noexcept
+    {
+      return values.get() + count;
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return values.get();
+    }
+
+    const_iterator end() const noexcept
+    {
+      return values.get() + count;
+    }
+
+    relocatable_arena &get_arena() const noexcept
+    {
+      return *arena;
+    }
+  };
+}
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    /// 32 bits keys get 24 bits of index (16M values), wider keys split evenly
+    template<class key_data>
+    inline constexpr unsigned default_slot_index_bits = sizeof(key_data) == 4 ? 24u : sizeof(key_data) * 4u;
+  }
+
+  ///
+  /// \brief What a `claws::slot_map` does with a slot whose generation is exhausted.
+  ///
+  enum class slot_generation_policy : unsigned char
+  {
+    /// The generation wraps around to 1 and the slot is reused: a key whose slot was reused that many times may match again
+    wrap,
+    /// The slot is retired and never reused: stale keys never match, but churning maps keep adding slots
+    retire
+  };
+
+  ///
+  /// \brief Associative container handing out stable, validated keys with O(1) insertion, erasure and lookup.
+  ///
+  /// \tparam T the stored value's type
+  /// \tparam tag the tag of the returned `claws::tagged_data` keys, so keys of different maps can't be mixed up
+  /// \tparam key_data unsigned integer a key packs its slot index and generation in
+  /// \tparam index_bits how many of `key_data`'s bits store the slot index, the others store the generation
+  /// \tparam vector_template the vector storing values and slots, `claws::relocatable_vector` for `claws::relocatable_slot_map`
+  /// \tparam generation_policy whether slots are reused or retired once their generation is exhausted
+  ///
+  /// Values are stored contiguously, in no particular order, so iterating over them is as fast as iterating over a `std::vector`.
+  /// Keys go through an indirection table of slots, each holding the value's position and a generation.
+  /// Erasing a value moves the last value in its place and bumps its slot's generation,
+  /// so keys to erased values are detected as stale by `find` and `contains`.
+  ///
+  /// Generations start at 1 and skip 0 when they wrap around, so the null key `key_type{}` never refers to a value.
+  /// With the default 32 bits keys (24 bits of index, 8 of generation), a stale key may thus be mistaken for a live one
+  /// once its slot was reused 255 times; wider keys make that unlikely, 64 bits keys get 32 bits of generation.
+  /// `slot_generation_policy::retire` retires exhausted slots instead, so stale keys never match,
+  /// at the cost of a slot table growing with churn until `emplace` runs out of indices.
+  ///
+  /// Inserting once every slot index is taken, live or retired, throws `std::length_error`.
+  ///
+  /// Pointers and references to values are invalidated by insertions and erasures, keys only by erasing their value.
+  ///
+  template<class T,
+           class tag,
+           class key_data = std::uint32_t,
+           unsigned index_bits = impl::default_slot_index_bits<key_data>,
+           template<class...> class vector_template = std::vector,
+           slot_generation_policy generation_policy = slot_generation_policy::wrap>
+  class slot_map
+  {
+    static_assert(std::is_unsigned_v<key_data>, "slot_map keys must be unsigned integers");
+    static_assert(index_bits > 0 && index_bits < sizeof(key_data) * 8, "slot_map keys need both index and generation bits");
+
+  public:
+    using value_type = T;
+    using key_type = tagged_data<key_data, key_data, tag>;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = typename vector_template<T>::iterator;
+    using const_iterator = typename vector_template<T>::const_iterator;
+
+    static constexpr unsigned generation_bits = sizeof(key_data) * 8 - index_bits;
+
+  private:
+    static constexpr key_data index_mask = static_cast<key_data>((key_data(1) << index_bits) - 1);
+    static constexpr key_data generation_mask = static_cast<key_data>(key_data(~key_data(0)) >> index_bits);
+    /// Ends the free list, and marks retired slots
+    static constexpr key_data null_index = index_mask;
+
+    struct slot
+    {
+      /// Position of the value in `values` if the slot is used, next free slot otherwise
+      key_data position;
+      key_data generation;
+    };
+
+    vector_template<T> values;
+    /// Slot of each value, to fix up the slot of the value moved by `erase`
+    vector_template<key_data> value_slots;
+    vector_template<slot> slots;
+    key_data free_head{null_index};
+
+    static constexpr key_type make_key(key_data index, key_data generation) noexcept
+    {
+      return key_type{static_cast<key_data>(index | (generation << index_bits))};
+    }
+
+    /// Returns the slot `key` refers to, or `nullptr` if `key` is stale or null
+    slot const *get_slot(key_type key) const noexcept
+    {
+      auto const index = index_of(key);
+      auto const generation = generation_of(key);
+
+      // Retired slots have generation 0, which only the null key has
+      if (index >= slots.size() || slots[index].generation != generation || !generation)
+        return nullptr;
+      return &slots[index];
+    }
+
+    /// Makes sure the free list isn't empty, throws `std::length_error` if every slot index is taken
+    void reserve_free_slot()
+    {
+      if (free_head != null_index)
+        return;
+      if (slots.size() >= null_index)
+        throw std::length_error("slot_map: too many slots for the key type");
+      slots.push_back({null_index, 1u});
+      free_head = static_cast<key_data>(slots.size() - 1);
+    }
+
+    void release_slot(key_data index) noexcept
+    {
+      auto &released = slots[index];
+
+      if (released.generation != generation_mask)
+        ++released.generation;
+      else if constexpr (generation_policy == slot_generation_policy::wrap)
+        // 0 is the null key's
+        released.generation = 1u;
+      else
+        {
+          // Retired: no generation is left that old keys can't match
+          released.generation = 0;
+          released.position = null_index;
+          return;
+        }
+      released.position = free_head;
+      free_head = index;
+    }
+
+  public:
+    slot_map() = default;
+
+    ///
+    /// \brief Constructs every underlying vector from `context`, such as the arena of `claws::relocatable_vector`s.
+    ///
+    template<class context_type, class = std::enable_if_t<!std::is_same_v<std::decay_t<context_type>, slot_map>>>
+    explicit slot_map(context_type &context)
+      : values(context)
+      , value_slots(context)
+      , slots(context)
+    {}
+
+    slot_map(slot_map const &) = default;
+
+    /// Leaves `other` empty and usable: its free list went with its slots
+    slot_map(slot_map &&other) noexcept
+      : values(std::move(other.values))
+      , value_slots(std::move(other.value_slots))
+      , slots(std::move(other.slots))
+      , free_head(std::exchange(other.free_head, null_index))
+    {}
+
+    slot_map &operator=(slot_map const &) = default;
+
+    slot_map &operator=(slot_map &&other) noexcept
+    {
+      if (this != &other)
+        {
+          values = std::move(other.values);
+          value_slots = std::move(other.value_slots);
+          slots = std::move(other.slots);
+          free_head = std::exchange(other.free_head, null_index);
+        }
+      return *this;
+    }
+
+    ~slot_map() = default;
+
+    /// \brief Slot index packed in `key`
+    static constexpr key_data index_of(key_type key) noexcept
+    {
+      return key.data & index_mask;
+    }
+
+    /// \brief Generation packed in `key`
+    static constexpr key_data generation_of(key_type key) noexcept
+    {
+      return static_cast<key_data>(key.data >> index_bits);
+    }
+
+    /// \brief Maximum number of slots, live or retired
+    static constexpr size_type max_size() noexcept
+    {
+      return null_index;
+    }
+
+    ///
+    /// \brief Constructs a value in place and returns its key.
+    ///
+    /// Throws `std::length_error` and leaves the map untouched if every slot index is taken.
+    ///
+    template<class... args_type>
+    key_type emplace(args_type &&... args)
+    {
+      // Everything that may throw happens before the map is modified
+      reserve_free_slot();
+      if (value_slots.size() == value_slots.capacity())
+        value_slots.reserve(value_slots.empty() ? 8 : value_slots.size() * 2);
+      values.emplace_back(std::forward<args_type>(args)...);
+
+      auto const index = free_head;
+      auto &used = slots[index];
+
+      free_head = used.position;
+      used.position = static_cast<key_data>(values.size() - 1);
+      value_slots.push_back(index);
+      return make_key(index, used.generation);
+    }
+
+    key_type insert(T const &value)
+    {
+      return emplace(value);
+    }
+
+    key_type insert(T &&value)
+    {
+      return emplace(std::move(value));
+    }
+
+    ///
+    /// \brief Erases the value `key` refers to. Returns `false` if `key` is stale.
+    ///
+    /// The last value is moved into the erased value's place.
+    ///
+    bool erase(key_type key) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+      auto const found = get_slot(key);
+
+      if (!found)
+        return false;
+
+      auto const position = found->position;
+      auto const last = static_cast<key_data>(values.size() - 1);
+
+      if (position != last)
+        {
+          values[position] = std::move(values[last]);
+          value_slots[position] = value_slots[last];
+          slots[value_slots[position]].position = position;
+        }
+      values.pop_back();
+      value_slots.pop_back();
+      release_slot(index_of(key));
+      return true;
+    }
+
+    /// \brief Returns a pointer to the value `key` refers to, or `nullptr` if `key` is stale.
+    T *find(key_type key) noexcept
+    {
+      auto const found = get_slot(key);
+
+      return found ? &values[found->position] : nullptr;
+    }
+
+    T const *find(key_type key) const noexcept
+    {
+      auto const found = get_slot(key);
+
+      return found ? &values[found->position] : nullptr;
+    }
+
+    bool contains(key_type key) const noexcept
+    {
+      return get_slot(key) != nullptr;
+    }
+
+    /// \brief Unchecked access, `key` must not be stale.
+    T &operator[](key_type key) noexcept
+    {
+      return values[slots[index_of(key)].position];
+    }
+
+    T const &operator[](key_type key) const noexcept
+    {
+      return values[slots[index_of(key)].position];
+    }
+
+    /// \brief Returns the key of the value at `position` in iteration order.
+    key_type key_at(size_type position) const noexcept
+    {
+      auto const index = value_slots[position];
+
+      return make_key(index, slots[index].generation);
+    }
+
+    ///
+    /// \brief Erases every value. Every key becomes stale.
+    ///
+    void clear() noexcept
+    {
+      for (auto index : value_slots)
+        release_slot(index);
+      values.clear();
+      value_slots.clear();
+    }
+
+    void reserve(size_type size)
+    {
+      values.reserve(size);
+      value_slots.reserve(size);
+      slots.reserve(size);
+    }
+
+    size_type size() const noexcept
+    {
+      return values.size();
+    }
+
+    bool empty() const noexcept
+    {
+      return values.empty();
+    }
+
+    /// \name dense iteration over values, in no particular order
+    /// @{
+    T *data() noexcept
+    {
+      return values.data();
+    }
+
+    T const *data() const noexcept
+    {
+      return values.data();
+    }
+
+    iterator begin() noexcept
+    {
+      return values.begin();
+    }
+
+    iterator end() noexcept
+    {
+      return values.end();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return values.begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+      return values.end();
+    }
+    /// @}
+  };
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/container/impl/vector_interface.hpp>
+#include <claws/utils/trivially_relocatable.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Vector storing up to `inline_capacity` values inside itself, and spilling to the heap past that.
+  ///
+  /// For lists which are usually short but unbounded, like the edges of a graph node:
+  /// short lists cost no allocation, and are next to the rest of their owner in memory.
+  ///
+  /// Growing doubles the capacity, moving values with `claws::relocate`: a `memcpy` for trivially relocatable types.
+  /// Moving a vector steals its heap storage, or relocates its inline values. Iterators are invalidated by growth and by moves.
+  ///
+  /// \tparam allocator_type allocates the heap storage once values spill out
+  ///
+  template<class T, std::size_t inline_capacity, class _allocator_type = std::allocator<T>>
+  class small_vector
+    : private _allocator_type
+    , public impl::vector_interface<small_vector<T, inline_capacity, _allocator_type>, T, false>
+  {
+    static_assert(inline_capacity > 0u, "use std::vector for vectors without inline storage");
+
+    using interface = impl::vector_interface<small_vector<T, inline_capacity, _allocator_type>, T, false>;
+    using allocator_traits = std::allocator_traits<_allocator_type>;
+
+    friend interface;
+
+  public:
+    using typename interface::size_type;
+    using typename interface::value_type;
+    using allocator_type = _allocator_type;
+    using interface::operator==;
+    using interface::operator!=;
+
+  private:
+    T *values;
+    size_type count{0u};
+    size_type storage_capacity{inline_capacity};
+    alignas(T) unsigned char inline_storage[inline_capacity * sizeof(T)];
+
+    T *get_inline() noexcept
+    {
+      return reinterpret_cast<T *>(inline_storage);
+    }
+
+    allocator_type &get_allocator_ref() noexcept
+    {
+      return *this;
+    }
+
+    allocator_type const &get_allocator_ref() const noexcept
+    {
+      return *this;
+    }
+
+    size_type grown_capacity(size_type size) const noexcept
+    {
+      return size > 2u * storage_capacity ? size : 2u * storage_capacity;
+    }
+
+    /// Frees the heap storage, if any, once the values are gone
+    void release_storage() noexcept
+    {
+      if (!is_inline())
+        allocator_traits::deallocate(get_allocator_ref(), values, storage_capacity);
+      values = get_inline();
+      storage_capacity = inline_capacity;
+    }
+
+    void set_size(size_type size) noexcept
+    {
+      count = size;
+    }
+
+    void reserve_for(size_type size)
+    {
+      if (size <= storage_capacity)
+        return;
+      if (size > max_size())
+        throw std::bad_alloc();
+
+      auto const new_capacity = grown_capacity(size);
+      auto const storage = allocator_traits::allocate(get_allocator_ref(), new_capacity);
+
+      try
+        {
+          relocate(values, count, storage);
+        }
+      catch (...)
+        {
+          allocator_traits::deallocate(get_allocator_ref(), storage, new_capacity);
+          throw;
+        }
+      release_storage();
+      values = storage;
+      storage_capacity = new_capacity;
+    }
+
+    template<class... args_type>
+    T &emplace_back_full(args_type &&... args)
+    {
+      auto const new_capacity = grown_capacity(count + 1u);
+      auto const storage = allocator_traits::allocate(get_allocator_ref(), new_capacity);
+
+      // The new value first, as `args` may refer to the values about to be relocated
+      try
+        {
+          new (storage + count) T(std::forward<args_type>(args)...);
+        }
+      catch (...)
+        {
+          allocator_traits::deallocate(get_allocator_ref(), storage, new_capacity);
+          throw;
+        }
+      try
+        {
+          relocate(values, count, storage);
+        }
+      catch (...)
+        {
+          storage[count].~T();
+          allocator_traits::deallocate(get_allocator_ref(), storage, new_capacity);
+          throw;
+        }
+      release_storage();
+      values = storage;
+      storage_capacity = new_capacity;
+      return values[count++];
+    }
+
+    /// Takes `other`'s values, stealing its heap storage if the allocators allow it
+    void take(small_vector &other)
+    {
+      if (!other.is_inline() && get_allocator_ref() == other.get_allocator_ref())
+        {
+          values = std::exchange(other.values, other.get_inline());
+          storage_capacity = std::exchange(other.storage_capacity, inline_capacity);
+          count = std::exchange(other.count, 0u);
+          return;
+        }
+      reserve_for(other.count);
+      relocate(other.values, other.count, values);
+      count = std::exchange(other.count, 0u);
+      other.release_storage();
+    }
+
+  public:
+    small_vector() noexcept(std::is_nothrow_default_constructible_v<allocator_type>)
+      : values(get_inline())
+    {}
+
+    explicit small_vector(allocator_type const &allocator) noexcept
+      : allocator_type(allocator)
+      , values(get_inline())
+    {}
+
+    small_vector(std::initializer_list<T> init, allocator_type const &allocator = allocator_type())
+      : small_vector(allocator)
+    {
+      reserve_for(init.size());
+      for (auto const &value : init)
+        this->emplace_back(value);
+    }
+
+    explicit small_vector(size_type size, T const &value = T(), allocator_type const &allocator = allocator_type())
+      : small_vector(allocator)
+    {
+      this->resize(size, value);
+    }
+
+    small_vector(small_vector const &other)
+      : small_vector(allocator_traits::select_on_container_copy_construction(other.get_allocator_ref()))
+    {
+      reserve_for(other.count);
+      for (auto const &value : other)
+        this->emplace_back(value);
+    }
+
+    small_vector(small_vector &&other) noexcept(allocator_traits::is_always_equal::value
+                                                && (is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>))
+      : allocator_type(std::move(other.get_allocator_ref()))
+      , values(get_inline())
+    {
+      take(other);
+    }
+
+    small_vector &operator=(small_vector const &other)
+    {
+      if (this != &other)
+        {
+          this->clear();
+          reserve_for(other.count);
+          for (auto const &value : other)
+            this->emplace_back(value);
+        }
+      return *this;
+    }
+
+    small_vector &operator=(small_vector &&other)
+    {
+      if (this != &other)
+        {
+          this->clear();
+          release_storage();
+          if constexpr (allocator_traits::propagate_on_container_move_assignment::value)
+            get_allocator_ref() = std::move(other.get_allocator_ref());
+          take(other);
+        }
+      return *this;
+    }
+
+    ~small_vector()
+    {
+      this->clear();
+      release_storage();
+    }
+
+    T *data() noexcept
+    {
+      return values;
+    }
+
+    T const *data() const noexcept
+    {
+      return values;
+    }
+
+    size_type size() const noexcept
+    {
+      return count;
+    }
+
+    size_type capacity() const noexcept
+    {
+      return storage_capacity;
+    }
+
+    size_type max_size() const noexcept
+    {
+      return allocator_traits::max_size(*this);
+    }
+
+    ///
+    /// \brief Whether the values are stored inside the vector, rather than on the heap.
+    ///
+    bool is_inline() const noexcept
+    {
+      return values == reinterpret_cast<T const *>(inline_storage);
+    }
+
+    void reserve(size_type size)
+    {
+      reserve_for(size);
+    }
+
+    ///
+    /// \brief Moves the values back inside the vector if they fit, or to a heap storage of the right size otherwise.
+    ///
+    void shrink_to_fit()
+    {
+      if (is_inline() || count == storage_capacity)
+        return;
+      if (count <= inline_capacity)
+        {
+          auto const storage = values;
+          auto const old_capacity = storage_capacity;
+
+          relocate(storage, count, get_inline());
+          values = get_inline();
+          storage_capacity = inline_capacity;
+          allocator_traits::deallocate(get_allocator_ref(), storage, old_capacity);
+          return;
+        }
+
+      auto const storage = allocator_traits::allocate(get_allocator_ref(), count);
+
+      try
+        {
+          relocate(values, count, storage);
+        }
+      catch (...)
+        {
+          allocator_traits::deallocate(get_allocator_ref(), storage, count);
+          throw;
+        }
+      release_storage();
+      values = storage;
+      storage_capacity = count;
+    }
+
+    allocator_type get_allocator() const
+    {
+      return *this;
+    }
+  };
+}
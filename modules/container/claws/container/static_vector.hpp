@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/container/impl/vector_interface.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    /// Trivial values are kept in a plain array, usable in constant expressions
+    template<class T>
+    inline constexpr bool is_constexpr_slot = std::is_trivial_v<T> && std::is_copy_assignable_v<T> && std::is_move_assignable_v<T>;
+
+    template<class T, std::size_t capacity, bool = is_constexpr_slot<T>>
+    struct static_vector_storage
+    {
+      T values[capacity]{};
+      std::size_t count{0u};
+    };
+
+    template<class T, std::size_t capacity>
+    struct static_vector_storage<T, capacity, false>
+    {
+      union
+      {
+        T values[capacity];
+      };
+      std::size_t count{0u};
+
+      static_vector_storage() noexcept
+      {}
+
+      static_vector_storage(static_vector_storage const &other)
+      {
+        for (; count != other.count; ++count)
+          new (values + count) T(other.values[count]);
+      }
+
+      static_vector_storage(static_vector_storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      {
+        for (; count != other.count; ++count)
+          new (values + count) T(std::move(other.values[count]));
+      }
+
+      static_vector_storage &operator=(static_vector_storage const &other)
+      {
+        if (this != &other)
+          {
+            destroy_all();
+            for (; count != other.count; ++count)
+              new (values + count) T(other.values[count]);
+          }
+        return *this;
+      }
+
+      static_vector_storage &operator=(static_vector_storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      {
+        if (this != &other)
+          {
+            destroy_all();
+            for (; count != other.count; ++count)
+              new (values + count) T(std::move(other.values[count]));
+          }
+        return *this;
+      }
+
+      ~static_vector_storage()
+      {
+        destroy_all();
+      }
+
+      void destroy_all() noexcept
+      {
+        for (; count; --count)
+          values[count - 1u].~T();
+      }
+    };
+  }
+
+  ///
+  /// \brief Vector of up to `capacity` values stored inline: never allocates.
+  ///
+  /// For lists with a known bound, like the children of a node in a fixed-arity tree, or scratch buffers on the stack.
+  /// Going past `capacity` throws `std::bad_alloc`.
+  ///
+  /// With trivial `T`s, the values are a plain array, value-initialised on construction,
+  /// and the whole interface is `constexpr`: a `static_vector` can be built in constant expressions, and is trivially copyable.
+  ///
+  template<class T, std::size_t _capacity>
+  class static_vector
+    : private impl::static_vector_storage<T, _capacity>
+    , public impl::vector_interface<static_vector<T, _capacity>, T, impl::is_constexpr_slot<T>>
+  {
+    static_assert(_capacity > 0u, "static_vector needs room for at least one value");
+
+    using storage = impl::static_vector_storage<T, _capacity>;
+    using interface = impl::vector_interface<static_vector<T, _capacity>, T, impl::is_constexpr_slot<T>>;
+
+    friend interface;
+
+    constexpr void set_size(std::size_t size) noexcept
+    {
+      this->count = size;
+    }
+
+    constexpr void reserve_for(std::size_t size) const
+    {
+      if (size > _capacity)
+        throw std::bad_alloc();
+    }
+
+    template<class... args_type>
+    [[noreturn]] T &emplace_back_full(args_type &&...)
+    {
+      throw std::bad_alloc();
+    }
+
+  public:
+    using typename interface::size_type;
+    using typename interface::value_type;
+
+    constexpr static_vector() noexcept = default;
+
+    constexpr static_vector(std::initializer_list<T> values)
+    {
+      reserve_for(values.size());
+      for (auto const &value : values)
+        this->emplace_back(value);
+    }
+
+    constexpr explicit static_vector(size_type count, T const &value = T())
+    {
+      this->resize(count, value);
+    }
+
+    constexpr T *data() noexcept
+    {
+      return this->values;
+    }
+
+    constexpr T const *data() const noexcept
+    {
+      return this->values;
+    }
+
+    constexpr size_type size() const noexcept
+    {
+      return this->count;
+    }
+
+    static constexpr size_type capacity() noexcept
+    {
+      return _capacity;
+    }
+
+    static constexpr size_type max_size() noexcept
+    {
+      return _capacity;
+    }
+
+    constexpr bool full() const noexcept
+    {
+      return this->count == _capacity;
+    }
+
+    ///
+    /// \brief `emplace_back` if there is room left. Returns the new value, or `nullptr` if the vector is full.
+    ///
+    template<class... args_type>
+    constexpr T *try_emplace_back(args_type &&... args)
+    {
+      if (full())
+        return nullptr;
+      return &this->emplace_back(std::forward<args_type>(args)...);
+    }
+  };
+}
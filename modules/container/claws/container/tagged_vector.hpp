@@ -0,0 +1,322 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/iterator/self_iterator.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Index into a `claws::tagged_vector` or `claws::tagged_span` tagged with `tag`.
+  ///
+  /// Offsets are signed, as for `tagged_data<std::uint32_t, std::int32_t, tag>`.
+  ///
+  template<class tag, class index_data = std::uint32_t>
+  using tagged_index = tagged_data<index_data, std::make_signed_t<index_data>, tag>;
+
+  ///
+  /// \brief Non-owning view of contiguous values, indexed by `claws::tagged_index<tag, index_data>`.
+  ///
+  /// Only stores a pointer and an `index_data` count.
+  ///
+  template<class tag, class T, class index_data = std::uint32_t>
+  class tagged_span
+  {
+    static_assert(std::is_unsigned_v<index_data>, "tagged indices must be unsigned integers");
+
+  public:
+    using value_type = std::remove_cv_t<T>;
+    using index_type = tagged_index<tag, index_data>;
+    using reference = T &;
+    using pointer = T *;
+    using iterator = T *;
+
+  private:
+    T *first{nullptr};
+    index_data count{0u};
+
+  public:
+    constexpr tagged_span() noexcept = default;
+
+    constexpr tagged_span(T *data, index_type size) noexcept
+      : first(data)
+      , count(size.data)
+    {}
+
+    /// \brief A span of `T const` can be made from a span of `T`
+    template<class U, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr tagged_span(tagged_span<tag, U, index_data> const &other) noexcept
+      : first(other.data())
+      , count(other.size().data)
+    {}
+
+    constexpr reference operator[](index_type index) const noexcept
+    {
+      return first[index.data];
+    }
+
+    constexpr index_type size() const noexcept
+    {
+      return index_type{count};
+    }
+
+    constexpr bool empty() const noexcept
+    {
+      return !count;
+    }
+
+    constexpr T *data() const noexcept
+    {
+      return first;
+    }
+
+    constexpr iterator begin() const noexcept
+    {
+      return first;
+    }
+
+    constexpr iterator end() const noexcept
+    {
+      return first + count;
+    }
+
+    /// \brief Every index of the span, in order
+    constexpr range<index_type> indices() const noexcept
+    {
+      return {index_type{0u}, index_type{count}};
+    }
+
+    /// \brief The `size` values from `offset`, which must be within the span
+    constexpr tagged_span subspan(index_type offset, index_type size) const noexcept
+    {
+      return {first + offset.data, size};
+    }
+
+    /// \brief Index of `value`, which must be in the span
+    constexpr index_type index_of(T const &value) const noexcept
+    {
+      return index_type{static_cast<index_data>(&value - first)};
+    }
+  };
+
+  ///
+  /// \brief `std::vector` indexed by `claws::tagged_index<tag, index_data>`, 32 bits wide by default.
+  ///
+  /// \tparam tag tag of the indices, so indices into different vectors can't be mixed up
+  /// \tparam T the stored value's type
+  /// \tparam index_data unsigned integer type of the indices, which bounds the size
+  ///
+  /// Storing 32 bits typed indices instead of pointers or `std::size_t`s halves the size of references between values
+  /// (adjacency lists, parent links), and unlike pointers, indices stay valid when the vector grows.
+  ///
+  /// Growing past `max_size()` values throws `std::length_error`, as their indices wouldn't fit in `index_data`.
+  ///
+  template<class tag, class T, class index_data = std::uint32_t>
+  class tagged_vector
+  {
+    static_assert(std::is_unsigned_v<index_data>, "tagged indices must be unsigned integers");
+
+  public:
+    using value_type = T;
+    using index_type = tagged_index<tag, index_data>;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using span_type = tagged_span<tag, T, index_data>;
+    using const_span_type = tagged_span<tag, T const, index_data>;
+
+  private:
+    std::vector<T> values;
+
+    static void check_size(std::size_t size)
+    {
+      if (size > max_size().data)
+        throw std::length_error("tagged_vector: too many values for the index type");
+    }
+
+  public:
+    tagged_vector() = default;
+
+    explicit tagged_vector(index_type size)
+      : values(size.data)
+    {}
+
+    tagged_vector(index_type size, T const &value)
+      : values(size.data, value)
+    {}
+
+    tagged_vector(std::initializer_list<T> values)
+      : values((check_size(values.size()), values))
+    {}
+
+    reference operator[](index_type index) noexcept
+    {
+      return values[index.data];
+    }
+
+    const_reference operator[](index_type index) const noexcept
+    {
+      return values[index.data];
+    }
+
+    reference front() noexcept
+    {
+      return values.front();
+    }
+
+    const_reference front() const noexcept
+    {
+      return values.front();
+    }
+
+    reference back() noexcept
+    {
+      return values.back();
+    }
+
+    const_reference back() const noexcept
+    {
+      return values.back();
+    }
+
+    index_type size() const noexcept
+    {
+      return index_type{static_cast<index_data>(values.size())};
+    }
+
+    static constexpr index_type max_size() noexcept
+    {
+      return index_type{std::numeric_limits<index_data>::max()};
+    }
+
+    bool empty() const noexcept
+    {
+      return values.empty();
+    }
+
+    ///
+    /// \brief Constructs a value at the end, and returns its index.
+    ///
+    template<class... args_type>
+    index_type emplace_back(args_type &&... args)
+    {
+      check_size(values.size() + 1u);
+      values.emplace_back(std::forward<args_type>(args)...);
+      return index_type{static_cast<index_data>(values.size() - 1u)};
+    }
+
+    index_type push_back(T const &value)
+    {
+      return emplace_back(value);
+    }
+
+    index_type push_back(T &&value)
+    {
+      return emplace_back(std::move(value));
+    }
+
+    void pop_back() noexcept
+    {
+      values.pop_back();
+    }
+
+    void resize(index_type size)
+    {
+      values.resize(size.data);
+    }
+
+    void resize(index_type size, T const &value)
+    {
+      values.resize(size.data, value);
+    }
+
+    void reserve(index_type size)
+    {
+      values.reserve(size.data);
+    }
+
+    void clear() noexcept
+    {
+      values.clear();
+    }
+
+    T *data() noexcept
+    {
+      return values.data();
+    }
+
+    T const *data() const noexcept
+    {
+      return values.data();
+    }
+
+    iterator begin() noexcept
+    {
+      return values.begin();
+    }
+
+    iterator end() noexcept
+    {
+      return values.end();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return values.begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+      return values.end();
+    }
+
+    /// \brief Every index of the vector, in order
+    range<index_type> indices() const noexcept
+    {
+      return {index_type{0u}, size()};
+    }
+
+    /// \brief Index of `value`, which must be in the vector
+    index_type index_of(T const &value) const noexcept
+    {
+      return index_type{static_cast<index_data>(&value - values.data())};
+    }
+
+    /// \name views sharing the vector's indices
+    /// @{
+    span_type span() noexcept
+    {
+      return {values.data(), size()};
+    }
+
+    const_span_type span() const noexcept
+    {
+      return {values.data(), size()};
+    }
+
+    operator span_type() noexcept
+    {
+      return span();
+    }
+
+    operator const_span_type() const noexcept
+    {
+      return span();
+    }
+    /// @}
+
+    /// \brief The underlying vector, for APIs taking one
+    std::vector<T> const &get_vector() const noexcept
+    {
+      return values;
+    }
+  };
+}
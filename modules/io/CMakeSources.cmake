@@ -0,0 +1,18 @@
+set(MODULE_PATH
+        ${CMAKE_CURRENT_SOURCE_DIR}/claws/io)
+
+set(MODULE_PUBLIC_HEADERS
+        "${MODULE_PATH}/binary_format.hpp"
+        "${MODULE_PATH}/mapped_file.hpp"
+        "${MODULE_PATH}/record_splitter.hpp"
+        "${MODULE_PATH}/text_codec.hpp"
+        )
+
+set(MODULE_PRIVATE_HEADERS
+        "${MODULE_PATH}/impl/splitter_kernels.hpp"
+        )
+
+set(MODULE_SOURCES
+        ${MODULE_PUBLIC_HEADERS}
+        ${MODULE_PRIVATE_HEADERS}
+        )
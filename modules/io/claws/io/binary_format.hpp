@@ -0,0 +1,426 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <claws/container/iterator_pair.hpp>
+#include <claws/container/vect.hpp>
+#include <claws/utils/bit_ops.hpp>
+#include <claws/utils/tagged_data.hpp>
+#include <claws/utils/type.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Describes the fields of a record type written with `claws::write_binary`, by specializing it with a member `type`.
+  ///
+  /// `type` is a type list: any variadic template instance (`std::tuple<float, std::uint32_t>`, or your own list type),
+  /// converted with `claws::copy_param_pack`. Fields are assumed laid out in order with their natural alignment,
+  /// which is checked against `sizeof(T)` at compile time.
+  ///
+  /// \code
+  /// struct particle { claws::vect<float, 3> position; std::uint32_t id; };
+  ///
+  /// template<>
+  /// struct claws::binary_fields<particle> { using type = std::tuple<claws::vect<float, 3>, std::uint32_t>; };
+  /// \endcode
+  ///
+  template<class T>
+  struct binary_fields
+  {};
+
+  ///
+  /// \brief Header preceding the payload of a binary array, in the writer's byte order.
+  ///
+  struct binary_header
+  {
+    /// "CLB1"
+    char magic[4];
+    /// `0x0102` as written by the host, `0x0201` when read on a host of opposite endianness
+    std::uint16_t endianness;
+    /// `alignof` of the elements, the payload being aligned on it
+    std::uint16_t alignment;
+    /// Hash of the elements' layout, see `claws::binary_signature`
+    std::uint64_t signature;
+    std::uint32_t element_size;
+    /// Offset of the payload from the start of the header
+    std::uint32_t payload_offset;
+    std::uint64_t count;
+  };
+
+  static_assert(sizeof(binary_header) == 32, "binary_header must not have padding");
+
+  namespace impl
+  {
+    namespace binary
+    {
+      inline constexpr char magic[4] = {'C', 'L', 'B', '1'};
+      inline constexpr std::uint16_t native_endianness = 0x0102;
+      inline constexpr std::uint16_t foreign_endianness = 0x0201;
+
+      /// FNV-1a over the bytes of `value`
+      constexpr std::uint64_t mix(std::uint64_t hash, std::uint64_t value) noexcept
+      {
+        for (unsigned i(0u); i != 8u; ++i)
+          {
+            hash ^= (value >> (i * 8u)) & 0xFFu;
+            hash *= 0x100000001B3u;
+          }
+        return hash;
+      }
+
+      constexpr std::size_t align_up(std::size_t offset, std::size_t alignment) noexcept
+      {
+        return (offset + alignment - 1u) / alignment * alignment;
+      }
+
+      inline void swap_in_place(std::byte *ptr, std::size_t size) noexcept
+      {
+        for (std::size_t i(0u); i != size / 2u; ++i)
+          std::swap(ptr[i], ptr[size - 1u - i]);
+      }
+
+      template<class T, class = void>
+      struct has_fields : std::false_type
+      {};
+
+      template<class T>
+      struct has_fields<T, std::void_t<typename binary_fields<T>::type>> : std::true_type
+      {};
+
+      ///
+      /// Per type layout description:
+      /// - `describe(hash)` mixes the layout into `hash`
+      /// - `swap(ptr)` reverses the byte order of the value at `ptr`
+      /// - `scalar_size` is the size of every scalar in the value if they all have the same and there is no padding, else 0
+      ///
+      template<class T, class = void>
+      struct traits
+      {
+        static_assert(has_fields<T>::value, "specialize claws::binary_fields to describe record types");
+      };
+
+      template<class T>
+      struct traits<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+      {
+        static constexpr std::size_t scalar_size = sizeof(T);
+
+        static constexpr std::uint64_t describe(std::uint64_t hash) noexcept
+        {
+          std::uint64_t const kind = std::is_floating_point_v<T> ? 'f' : std::is_same_v<T, bool> ? 'b' : std::is_signed_v<T> ? 'i' : 'u';
+
+          return mix(mix(hash, kind), sizeof(T));
+        }
+
+        static void swap(std::byte *ptr) noexcept
+        {
+          swap_in_place(ptr, sizeof(T));
+        }
+      };
+
+      template<class T>
+      struct traits<T, std::enable_if_t<std::is_enum_v<T>>> : traits<std::underlying_type_t<T>>
+      {};
+
+      /// `count` consecutive `element`s
+      template<class element, std::size_t count, char kind>
+      struct repeated_traits
+      {
+        static constexpr std::size_t scalar_size = traits<element>::scalar_size;
+
+        static constexpr std::uint64_t describe(std::uint64_t hash) noexcept
+        {
+          return traits<element>::describe(mix(mix(hash, kind), count));
+        }
+
+        static void swap(std::byte *ptr) noexcept
+        {
+          for (std::size_t i(0u); i != count; ++i)
+            traits<element>::swap(ptr + i * sizeof(element));
+        }
+      };
+
+      template<class T, std::size_t Size>
+      struct traits<vect<T, Size>> : repeated_traits<T, Size, 'v'>
+      {
+        static_assert(sizeof(vect<T, Size>) == Size * sizeof(T), "vect must not have padding");
+      };
+
+      template<class T, std::size_t Size>
+      struct traits<std::array<T, Size>> : repeated_traits<T, Size, 'a'>
+      {
+        static_assert(sizeof(std::array<T, Size>) == Size * sizeof(T), "std::array must not have padding");
+      };
+
+      /// The tag doesn't change the layout, so isn't part of the signature
+      template<class data_type, class offset_type, class tag>
+      struct traits<tagged_data<data_type, offset_type, tag>> : repeated_traits<data_type, 1u, 't'>
+      {};
+
+      template<class record, class fields = copy_param_pack_t<std::tuple, typename binary_fields<record>::type>>
+      struct record_traits;
+
+      template<class record, class... fields>
+      struct record_traits<record, std::tuple<fields...>>
+      {
+        static constexpr std::array<std::size_t, sizeof...(fields)> offsets = []() {
+          std::array<std::size_t, sizeof...(fields)> result{};
+          std::size_t const sizes[] = {sizeof(fields)...};
+          std::size_t const alignments[] = {alignof(fields)...};
+          std::size_t offset(0u);
+
+          for (std::size_t i(0u); i != sizeof...(fields); ++i)
+            {
+              result[i] = align_up(offset, alignments[i]);
+              offset = result[i] + sizes[i];
+            }
+          return result;
+        }();
+
+        static constexpr std::size_t unpadded_size = (sizeof(fields) + ... + 0u);
+
+        static_assert(sizeof...(fields) != 0, "binary records need at least one field");
+        static_assert(align_up(offsets.back() + sizeof(std::tuple_element_t<sizeof...(fields) - 1u, std::tuple<fields...>>), alignof(record)) == sizeof(record),
+                      "binary_fields doesn't match the record's layout");
+
+        static constexpr std::size_t scalar_size = []() {
+          std::size_t const sizes[] = {traits<fields>::scalar_size...};
+
+          for (auto size : sizes)
+            if (size != sizes[0])
+              return std::size_t(0u);
+          return unpadded_size == sizeof(record) ? sizes[0] : 0u;
+        }();
+
+        static constexpr std::uint64_t describe(std::uint64_t hash) noexcept
+        {
+          hash = mix(mix(hash, 'r'), sizeof...(fields));
+          ((hash = traits<fields>::describe(hash)), ...);
+          return hash;
+        }
+
+        static void swap(std::byte *ptr) noexcept
+        {
+          swap_fields(ptr, std::index_sequence_for<fields...>{});
+        }
+
+        template<std::size_t... indexes>
+        static void swap_fields(std::byte *ptr, std::index_sequence<indexes...>) noexcept
+        {
+          (traits<fields>::swap(ptr + offsets[indexes]), ...);
+        }
+      };
+
+      template<class T>
+      struct traits<T, std::enable_if_t<has_fields<T>::value>> : record_traits<T>
+      {};
+
+      /// Swaps `size` bytes as words of `sizeof(word)` bytes, a loop compilers vectorize
+      template<class word>
+      void swap_words(std::byte *ptr, std::size_t size) noexcept
+      {
+        for (std::size_t i(0u); i != size; i += sizeof(word))
+          {
+            word value;
+
+            std::memcpy(&value, ptr + i, sizeof(word));
+            value = byteswap(value);
+            std::memcpy(ptr + i, &value, sizeof(word));
+          }
+      }
+
+      template<class T>
+      void swap_elements(std::byte *ptr, std::size_t count) noexcept
+      {
+        switch (traits<T>::scalar_size)
+          {
+          case 1:
+            break;
+          case 2:
+            swap_words<std::uint16_t>(ptr, count * sizeof(T));
+            break;
+          case 4:
+            swap_words<std::uint32_t>(ptr, count * sizeof(T));
+            break;
+          case 8:
+            swap_words<std::uint64_t>(ptr, count * sizeof(T));
+            break;
+          default:
+            for (std::size_t i(0u); i != count; ++i)
+              traits<T>::swap(ptr + i * sizeof(T));
+          }
+      }
+
+      inline void swap_header(binary_header &header) noexcept
+      {
+        header.endianness = byteswap(header.endianness);
+        header.alignment = byteswap(header.alignment);
+        header.signature = byteswap(header.signature);
+        header.element_size = byteswap(header.element_size);
+        header.payload_offset = byteswap(header.payload_offset);
+        header.count = byteswap(header.count);
+      }
+
+      inline void fail(std::error_code *error, std::errc code) noexcept
+      {
+        if (error)
+          *error = std::make_error_code(code);
+      }
+    }
+  }
+
+  ///
+  /// \brief Hash of the layout of `T`: scalar kinds and sizes, `vect`, `std::array` and `tagged_data` nesting, and record fields.
+  ///
+  template<class T>
+  constexpr std::uint64_t binary_signature() noexcept
+  {
+    return impl::binary::traits<T>::describe(0xCBF29CE484222325u);
+  }
+
+  ///
+  /// \brief Bytes taken by `count` elements of type `T` written with `claws::write_binary`, header included.
+  ///
+  template<class T>
+  constexpr std::size_t binary_size(std::size_t count) noexcept
+  {
+    return impl::binary::align_up(sizeof(binary_header), alignof(T)) + count * sizeof(T);
+  }
+
+  namespace impl
+  {
+    namespace binary
+    {
+      ///
+      /// \brief Reads the header of `[data, data + size)` in native byte order, checking it describes a payload of `T`s within the buffer.
+      ///
+      template<class T>
+      bool read_header(std::byte const *data, std::size_t size, binary_header &header, bool &foreign, std::error_code *error) noexcept
+      {
+        if (size < sizeof(header))
+          {
+            fail(error, std::errc::bad_message);
+            return false;
+          }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) || (header.endianness != native_endianness && header.endianness != foreign_endianness))
+          {
+            fail(error, std::errc::bad_message);
+            return false;
+          }
+        foreign = header.endianness == foreign_endianness;
+        if (foreign)
+          swap_header(header);
+        if (header.signature != binary_signature<T>() || header.element_size != sizeof(T) || header.alignment != alignof(T))
+          {
+            fail(error, std::errc::invalid_argument);
+            return false;
+          }
+        if (header.payload_offset > size || header.count > (size - header.payload_offset) / sizeof(T))
+          {
+            fail(error, std::errc::bad_message);
+            return false;
+          }
+        if (reinterpret_cast<std::uintptr_t>(data + header.payload_offset) % alignof(T))
+          {
+            fail(error, std::errc::bad_address);
+            return false;
+          }
+        return true;
+      }
+    }
+  }
+
+  ///
+  /// \brief Writes a header and `count` elements to `out`, returning the bytes written: `claws::binary_size<T>(count)`, or 0 if `capacity` is too small.
+  ///
+  /// `T` is an arithmetic or enum type, a `vect`, `std::array` or `tagged_data` of those, or a record described by `claws::binary_fields`.
+  /// The payload is a plain copy of the values, in the host's byte order.
+  ///
+  template<class T>
+  std::size_t write_binary(std::byte *out, std::size_t capacity, T const *values, std::size_t count) noexcept
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be written as binary");
+
+    auto const payload_offset = binary_size<T>(0u);
+    binary_header header{{}, impl::binary::native_endianness, alignof(T), binary_signature<T>(), sizeof(T), static_cast<std::uint32_t>(payload_offset), count};
+
+    if (capacity < binary_size<T>(count))
+      return 0u;
+    std::memcpy(header.magic, impl::binary::magic, sizeof(header.magic));
+    std::memcpy(out, &header, sizeof(header));
+    std::memset(out + sizeof(header), 0, payload_offset - sizeof(header));
+    if (count)
+      std::memcpy(out + payload_offset, values, count * sizeof(T));
+    return binary_size<T>(count);
+  }
+
+  ///
+  /// \brief Returns the elements of a buffer written by `claws::write_binary`, in place, without decoding them.
+  ///
+  /// Fails, returning an empty span, if the buffer:
+  ///  - isn't a binary array, or is truncated: `std::errc::bad_message`
+  ///  - holds another type than `T`: `std::errc::invalid_argument`
+  ///  - has its payload misaligned for `T`: `std::errc::bad_address`
+  ///  - was written by a host of opposite endianness: `std::errc::not_supported`, use `claws::load_binary` on a writable buffer
+  ///
+  template<class T>
+  span<T const> view_binary(std::byte const *data, std::size_t size, std::error_code *error = nullptr) noexcept
+  {
+    binary_header header;
+    bool foreign;
+
+    if (!impl::binary::read_header<T>(data, size, header, foreign, error))
+      return {nullptr, nullptr};
+    if (foreign)
+      {
+        impl::binary::fail(error, std::errc::not_supported);
+        return {nullptr, nullptr};
+      }
+
+    auto const begin = reinterpret_cast<T const *>(data + header.payload_offset);
+
+    return {begin, begin + header.count};
+  }
+
+  ///
+  /// \brief Like `claws::view_binary`, but converts a payload written by a host of opposite endianness in place first.
+  ///
+  /// The header is rewritten in native byte order, so loading the same buffer again costs nothing.
+  ///
+  template<class T>
+  span<T> load_binary(std::byte *data, std::size_t size, std::error_code *error = nullptr) noexcept
+  {
+    binary_header header;
+    bool foreign;
+
+    if (!impl::binary::read_header<T>(data, size, header, foreign, error))
+      return {nullptr, nullptr};
+    if (foreign)
+      {
+        impl::binary::swap_elements<T>(data + header.payload_offset, header.count);
+        header.endianness = impl::binary::native_endianness;
+        std::memcpy(data, &header, sizeof(header));
+      }
+
+    auto const begin = reinterpret_cast<T *>(data + header.payload_offset);
+
+    return {begin, begin + header.count};
+  }
+
+  template<class T>
+  span<T const> view_binary(span<std::byte const> buffer, std::error_code *error = nullptr) noexcept
+  {
+    return view_binary<T>(buffer.begin(), static_cast<std::size_t>(buffer.end() - buffer.begin()), error);
+  }
+
+  template<class T>
+  span<T> load_binary(span<std::byte> buffer, std::error_code *error = nullptr) noexcept
+  {
+    return load_binary<T>(buffer.begin(), static_cast<std::size_t>(buffer.end() - buffer.begin()), error);
+  }
+}
@@ -0,0 +1,23 @@
+// Deliberately no include guard: this file is included once per SIMD tier by `claws/io/record_splitter.hpp`,
+// with `CLAWS_SIMD_TIER` naming both the kernels' namespace and the `claws::simd` wrapper,
+// and `CLAWS_SIMD_TARGET` the matching target attribute.
+
+namespace CLAWS_SIMD_TIER
+{
+  /// Bit `i` is set if `block[i] == value`, for the `block_size` bytes of `block`
+  CLAWS_SIMD_TARGET inline std::uint64_t match_mask(char const *block, char value) noexcept
+  {
+    using ops = simd::CLAWS_SIMD_TIER<char>;
+    auto const needle = ops::broadcast(value);
+    std::uint64_t result(0u);
+
+    for (std::size_t i(0u); i != block_size; i += ops::lanes)
+      result |= static_cast<std::uint64_t>(ops::eq(ops::load(block + i), needle)) << i;
+    return result;
+  }
+
+  CLAWS_SIMD_TARGET inline block_masks scan_block(char const *block, record_format const &format) noexcept
+  {
+    return {match_mask(block, format.delimiter), format.quoted ? match_mask(block, format.quote) : 0u};
+  }
+}
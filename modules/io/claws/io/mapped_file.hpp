@@ -0,0 +1,472 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <claws/container/container_view.hpp>
+#include <claws/container/iterator_pair.hpp>
+#include <claws/utils/handle_types.hpp>
+
+/// File descriptors and mappings are POSIX: elsewhere this header declares nothing, the rest of `claws::io` stays portable
+#if defined(__unix__) || defined(__APPLE__)
+#define CLAWS_HAS_MAPPED_FILE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace claws
+{
+  ///
+  /// \brief A POSIX file descriptor, -1 when empty.
+  ///
+  struct file_descriptor
+  {
+    int value{-1};
+
+    constexpr bool operator==(file_descriptor const &other) const noexcept
+    {
+      return value == other.value;
+    }
+
+    constexpr bool operator!=(file_descriptor const &other) const noexcept
+    {
+      return value != other.value;
+    }
+  };
+
+  ///
+  /// \ingroup handles
+  /// \brief `deleter` closing a `claws::file_descriptor`.
+  ///
+  struct fd_closer
+  {
+    void operator()(file_descriptor fd) const noexcept
+    {
+      if (fd.value != -1)
+        ::close(fd.value);
+    }
+  };
+
+  using fd_handle = handle<file_descriptor, fd_closer>;
+
+  ///
+  /// \brief Address and length of a memory mapping, empty when `address` is `nullptr`.
+  ///
+  struct mapping
+  {
+    void *address{nullptr};
+    std::size_t size{0u};
+
+    constexpr bool operator==(mapping const &other) const noexcept
+    {
+      return address == other.address && size == other.size;
+    }
+
+    constexpr bool operator!=(mapping const &other) const noexcept
+    {
+      return !(*this == other);
+    }
+  };
+
+  ///
+  /// \ingroup handles
+  /// \brief `deleter` unmapping a `claws::mapping`.
+  ///
+  /// Provides `bytes_of`, so `claws::deferred_delete<claws::unmapper>` accounts for the address space waiting to be released.
+  ///
+  struct unmapper
+  {
+    void operator()(mapping value) const noexcept
+    {
+      if (value.address)
+        ::munmap(value.address, value.size);
+    }
+
+    std::size_t bytes_of(mapping const &value) const noexcept
+    {
+      return value.size;
+    }
+  };
+
+  using mapping_handle = handle<mapping, unmapper>;
+
+  ///
+  /// \brief Whether a mapping or a file can be written to.
+  ///
+  enum class map_access : unsigned char
+  {
+    read_only,
+    read_write
+  };
+
+  ///
+  /// \brief Access pattern hints forwarded to `madvise`.
+  ///
+  enum class map_advice : unsigned char
+  {
+    normal,
+    sequential,
+    random,
+    willneed,
+    dontneed,
+    /// Transparent huge pages, where supported
+    hugepage
+  };
+
+  namespace impl
+  {
+    struct identity
+    {
+      template<class T>
+      constexpr T &operator()(T &value) const noexcept
+      {
+        return value;
+      }
+    };
+
+    inline void set_error(std::error_code *error, int code) noexcept
+    {
+      if (error)
+        *error = std::error_code(code, std::system_category());
+    }
+
+    inline int advice_flag(map_advice advice) noexcept
+    {
+      switch (advice)
+        {
+        case map_advice::sequential:
+          return MADV_SEQUENTIAL;
+        case map_advice::random:
+          return MADV_RANDOM;
+        case map_advice::willneed:
+          return MADV_WILLNEED;
+        case map_advice::dontneed:
+          return MADV_DONTNEED;
+        case map_advice::hugepage:
+#if defined(MADV_HUGEPAGE)
+          return MADV_HUGEPAGE;
+#else
+          return -1;
+#endif
+        default:
+          return MADV_NORMAL;
+        }
+    }
+  }
+
+  ///
+  /// \brief Owning memory mapping of (part of) a file, exposing its bytes without copying them.
+  ///
+  /// Errors are reported through an optional `std::error_code`, the returned region being empty.
+  ///
+  class mapped_region
+  {
+    mapping_handle region;
+    map_access access{map_access::read_only};
+
+    mapping get() const noexcept
+    {
+      return static_cast<mapping const &>(region);
+    }
+
+    mapped_region(mapping value, map_access access) noexcept
+      : region(unmapper{}, std::move(value))
+      , access(access)
+    {}
+
+  public:
+    mapped_region() = default;
+
+    ///
+    /// \brief Maps `size` bytes of `fd` from `offset`, which must be a multiple of the page size.
+    ///
+    /// Mapping 0 bytes succeeds and returns an empty region.
+    ///
+    static mapped_region map(file_descriptor fd, std::size_t offset, std::size_t size, map_access access, std::error_code *error = nullptr) noexcept
+    {
+      if (!size)
+        return mapped_region({}, access);
+
+      auto const protection = access == map_access::read_write ? PROT_READ | PROT_WRITE : PROT_READ;
+      auto const address = ::mmap(nullptr, size, protection, MAP_SHARED, fd.value, static_cast<off_t>(offset));
+
+      if (address == MAP_FAILED)
+        {
+          impl::set_error(error, errno);
+          return {};
+        }
+      return mapped_region({address, size}, access);
+    }
+
+    bool empty() const noexcept
+    {
+      return !get().address;
+    }
+
+    std::size_t size() const noexcept
+    {
+      return get().size;
+    }
+
+    map_access get_access() const noexcept
+    {
+      return access;
+    }
+
+    /// \name zero-copy access to the mapped bytes
+    /// Writing through the non-const accessors of a read-only region is undefined behaviour.
+    /// @{
+    std::byte *data() noexcept
+    {
+      return static_cast<std::byte *>(get().address);
+    }
+
+    std::byte const *data() const noexcept
+    {
+      return static_cast<std::byte const *>(get().address);
+    }
+
+    span<std::byte> bytes() noexcept
+    {
+      return {data(), data() + size()};
+    }
+
+    span<std::byte const> bytes() const noexcept
+    {
+      return {data(), data() + size()};
+    }
+
+    std::string_view chars() const noexcept
+    {
+      return {reinterpret_cast<char const *>(data()), size()};
+    }
+
+    ///
+    /// \brief The mapped bytes as `size() / sizeof(T)` values of type `T`, ignoring trailing bytes.
+    ///
+    /// The region's offset in the file must be aligned for `T`.
+    ///
+    template<class T>
+    auto as() const noexcept
+    {
+      static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be read from a mapping");
+
+      auto const begin = reinterpret_cast<T const *>(data());
+
+      return container_view(span<T const>{begin, begin + size() / sizeof(T)}, impl::identity{});
+    }
+    /// @}
+
+    ///
+    /// \brief Hints the kernel about how the region will be accessed. Returns `false` if the hint was refused or isn't supported.
+    ///
+    bool advise(map_advice advice, std::error_code *error = nullptr) noexcept
+    {
+      auto const flag = impl::advice_flag(advice);
+
+      if (empty())
+        return true;
+      if (flag == -1)
+        {
+          impl::set_error(error, ENOTSUP);
+          return false;
+        }
+      if (::madvise(get().address, size(), flag))
+        {
+          impl::set_error(error, errno);
+          return false;
+        }
+      return true;
+    }
+
+    ///
+    /// \brief Writes modified pages back to the file, waiting for completion.
+    ///
+    bool sync(std::error_code *error = nullptr) noexcept
+    {
+      if (empty() || !::msync(get().address, size(), MS_SYNC))
+        return true;
+      impl::set_error(error, errno);
+      return false;
+    }
+
+    ///
+    /// \brief Resizes the mapping of `fd`, which must be the file the region maps from offset 0.
+    ///
+    /// Uses `mremap` where available, so the kernel moves page tables instead of the data. Pointers into the region are invalidated.
+    /// On failure, the region is left untouched.
+    ///
+    bool remap(file_descriptor fd, std::size_t new_size, std::error_code *error = nullptr) noexcept
+    {
+      if (empty() || !new_size)
+        {
+          auto remapped = map(fd, 0u, new_size, access, error);
+
+          if (new_size && remapped.empty())
+            return false;
+          *this = std::move(remapped);
+          return true;
+        }
+#if defined(__linux__)
+      (void)fd;
+
+      auto const address = ::mremap(get().address, size(), new_size, MREMAP_MAYMOVE);
+
+      if (address == MAP_FAILED)
+        {
+          impl::set_error(error, errno);
+          return false;
+        }
+      // The old mapping is gone, make sure the handle doesn't unmap it again
+      claws::handle<mapping, claws::forget>(std::move(region));
+      region = mapping_handle(unmapper{}, mapping{address, new_size});
+      return true;
+#else
+      auto remapped = map(fd, 0u, new_size, access, error);
+
+      if (remapped.empty())
+        return false;
+      *this = std::move(remapped);
+      return true;
+#endif
+    }
+  };
+
+  ///
+  /// \brief An open file and a mapping of its whole content.
+  ///
+  /// Replaces stream-based loading: the file's bytes are read straight from the page cache, without being copied into a buffer.
+  /// Writers can `grow` the file, which extends it and remaps it.
+  ///
+  class mapped_file
+  {
+    fd_handle fd;
+    mapped_region region;
+
+    mapped_file(fd_handle &&fd, mapped_region &&region) noexcept
+      : fd(std::move(fd))
+      , region(std::move(region))
+    {}
+
+  public:
+    mapped_file() = default;
+
+    ///
+    /// \brief Opens and maps `path`. With `map_access::read_write`, the file is created if it doesn't exist.
+    ///
+    /// Returns an empty `mapped_file` on failure, see `is_open()`.
+    ///
+    static mapped_file open(char const *path, map_access access = map_access::read_only, std::error_code *error = nullptr) noexcept
+    {
+      auto const flags = access == map_access::read_write ? O_RDWR | O_CREAT : O_RDONLY;
+      fd_handle file(fd_closer{}, file_descriptor{::open(path, flags | O_CLOEXEC, 0644)});
+      struct stat status;
+
+      if (static_cast<file_descriptor const &>(file).value == -1 || ::fstat(static_cast<file_descriptor const &>(file).value, &status))
+        {
+          impl::set_error(error, errno);
+          return {};
+        }
+
+      auto region = mapped_region::map(file, 0u, static_cast<std::size_t>(status.st_size), access, error);
+
+      if (status.st_size && region.empty())
+        return {};
+      return mapped_file(std::move(file), std::move(region));
+    }
+
+    bool is_open() const noexcept
+    {
+      return static_cast<file_descriptor const &>(fd).value != -1;
+    }
+
+    file_descriptor get_fd() const noexcept
+    {
+      return fd;
+    }
+
+    mapped_region &get_region() noexcept
+    {
+      return region;
+    }
+
+    mapped_region const &get_region() const noexcept
+    {
+      return region;
+    }
+
+    std::size_t size() const noexcept
+    {
+      return region.size();
+    }
+
+    std::byte *data() noexcept
+    {
+      return region.data();
+    }
+
+    std::byte const *data() const noexcept
+    {
+      return region.data();
+    }
+
+    span<std::byte> bytes() noexcept
+    {
+      return region.bytes();
+    }
+
+    span<std::byte const> bytes() const noexcept
+    {
+      return region.bytes();
+    }
+
+    std::string_view chars() const noexcept
+    {
+      return region.chars();
+    }
+
+    template<class T>
+    auto as() const noexcept
+    {
+      return region.as<T>();
+    }
+
+    bool advise(map_advice advice, std::error_code *error = nullptr) noexcept
+    {
+      return region.advise(advice, error);
+    }
+
+    bool sync(std::error_code *error = nullptr) noexcept
+    {
+      return region.sync(error);
+    }
+
+    ///
+    /// \brief Extends the file to `new_size` bytes, zero-filled, and remaps it. Files opened read-only can't grow.
+    ///
+    /// Pointers into the mapping are invalidated. On failure the mapping is left untouched.
+    ///
+    bool grow(std::size_t new_size, std::error_code *error = nullptr) noexcept
+    {
+      if (region.get_access() != map_access::read_write)
+        {
+          impl::set_error(error, EBADF);
+          return false;
+        }
+      if (new_size <= size())
+        return true;
+      if (::ftruncate(static_cast<file_descriptor const &>(fd).value, static_cast<off_t>(new_size)))
+        {
+          impl::set_error(error, errno);
+          return false;
+        }
+      return region.remap(fd, new_size, error);
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <claws/algorithm/search.hpp>
+#include <claws/container/iterator_pair.hpp>
+#include <claws/utils/bit_ops.hpp>
+#include <claws/utils/cpu_features.hpp>
+#include <claws/utils/simd.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief How records are delimited in a buffer.
+  ///
+  /// When `quoted` is set, delimiters between `quote` characters don't end a record, as in CSV files.
+  /// Doubled quotes inside a quoted field (`""`) keep it quoted, since they toggle the state twice.
+  ///
+  struct record_format
+  {
+    char delimiter{'\n'};
+    bool quoted{false};
+    char quote{'"'};
+  };
+
+  /// \brief Newline separated records, where newlines in double-quoted fields don't end a record.
+  inline constexpr record_format csv_records{'\n', true, '"'};
+
+  namespace impl
+  {
+    namespace splitter
+    {
+      /// Bytes scanned at once: masks of a block fit in 64 bits
+      inline constexpr std::size_t block_size = 64;
+
+      struct block_masks
+      {
+        std::uint64_t delimiters;
+        std::uint64_t quotes;
+      };
+
+      ///
+      /// \brief Bit `i` is set if an odd number of bits are set at or below `i`.
+      ///
+      /// Turns a mask of quotes into a mask of bytes between an opening quote (included) and a closing quote (excluded).
+      ///
+      constexpr std::uint64_t prefix_xor(std::uint64_t bits) noexcept
+      {
+        for (unsigned shift(1u); shift != 64u; shift <<= 1u)
+          bits ^= bits << shift;
+        return bits;
+      }
+
+      inline std::uint64_t scalar_match_mask(char const *block, char value) noexcept
+      {
+        std::uint64_t result(0u);
+
+        for (std::size_t i(0u); i != block_size; ++i)
+          result |= std::uint64_t(block[i] == value) << i;
+        return result;
+      }
+
+      inline block_masks scan_block_scalar(char const *block, record_format const &format) noexcept
+      {
+        return {scalar_match_mask(block, format.delimiter), format.quoted ? scalar_match_mask(block, format.quote) : 0u};
+      }
+
+#if defined(CLAWS_SIMD_X86)
+#define CLAWS_SIMD_TIER sse2
+#define CLAWS_SIMD_TARGET CLAWS_TARGET_SSE2
+#include <claws/io/impl/splitter_kernels.hpp>
+#undef CLAWS_SIMD_TARGET
+#undef CLAWS_SIMD_TIER
+
+#define CLAWS_SIMD_TIER avx2
+#define CLAWS_SIMD_TARGET CLAWS_TARGET_AVX2
+#include <claws/io/impl/splitter_kernels.hpp>
+#undef CLAWS_SIMD_TARGET
+#undef CLAWS_SIMD_TIER
+
+#define CLAWS_SIMD_TIER avx512
+#define CLAWS_SIMD_TARGET CLAWS_TARGET_AVX512
+#include <claws/io/impl/splitter_kernels.hpp>
+#undef CLAWS_SIMD_TARGET
+#undef CLAWS_SIMD_TIER
+#endif
+
+      inline block_masks scan_block(simd_tier tier, char const *block, record_format const &format) noexcept
+      {
+#if defined(CLAWS_SIMD_X86)
+        switch (tier)
+          {
+          case simd_tier::avx512:
+            return avx512::scan_block(block, format);
+          case simd_tier::avx2:
+            return avx2::scan_block(block, format);
+          case simd_tier::sse2:
+            return sse2::scan_block(block, format);
+          default:
+            break;
+          }
+#else
+        (void)tier;
+#endif
+        return scan_block_scalar(block, format);
+      }
+
+      ///
+      /// \brief Finds the delimiters of a buffer outside quotes, in order, a block of 64 bytes at a time.
+      ///
+      /// Each block is scanned once into a bitmask, which successive calls to `next` then consume bit by bit.
+      ///
+      class scanner
+      {
+        char const *block{nullptr};
+        char const *end{nullptr};
+        /// Delimiters of the current block not returned yet
+        std::uint64_t pending{0u};
+        /// All ones if the byte before the next block is inside quotes
+        std::uint64_t in_quotes{0u};
+        record_format format;
+        simd_tier tier{simd_tier::scalar};
+
+        void scan_next_block() noexcept
+        {
+          auto const size = static_cast<std::size_t>(end - block);
+          block_masks masks;
+
+          if (size >= block_size)
+            masks = scan_block(tier, block, format);
+          else
+            {
+              char tail[block_size] = {};
+
+              std::memcpy(tail, block, size);
+              masks = scan_block(tier, tail, format);
+
+              auto const valid = (std::uint64_t(1u) << size) - 1u;
+
+              masks.delimiters &= valid;
+              masks.quotes &= valid;
+            }
+          if (format.quoted)
+            {
+              auto const inside = prefix_xor(masks.quotes) ^ in_quotes;
+
+              masks.delimiters &= ~inside;
+              in_quotes = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+            }
+          pending = masks.delimiters;
+        }
+
+      public:
+        scanner() = default;
+
+        /// `inside_quotes` is the quoting state at `begin`, only relevant for quoted formats
+        scanner(char const *begin, char const *end, record_format format, bool inside_quotes = false) noexcept
+          : block(begin)
+          , end(end)
+          , in_quotes(inside_quotes ? ~std::uint64_t(0u) : 0u)
+          , format(format)
+          , tier(get_simd_tier())
+        {
+          if (block != end)
+            scan_next_block();
+        }
+
+        /// Returns the next delimiter outside quotes, `end` once there are none left
+        char const *next() noexcept
+        {
+          while (!pending)
+            {
+              if (static_cast<std::size_t>(end - block) <= block_size)
+                return end;
+              block += block_size;
+              scan_next_block();
+            }
+
+          auto const found = block + countr_zero(pending);
+
+          pending &= pending - 1u;
+          return found;
+        }
+      };
+    }
+  }
+
+  ///
+  /// \brief Forward iterator over the records of a buffer, as `std::string_view`s excluding their delimiter.
+  ///
+  /// Consecutive delimiters yield empty records, a delimiter ending the buffer doesn't.
+  /// Quotes are kept in the records: only the splitting honours them.
+  ///
+  class record_iterator
+  {
+    impl::splitter::scanner scanner;
+    char const *cursor{nullptr};
+    char const *end{nullptr};
+    std::string_view record;
+    bool done{true};
+
+    void advance() noexcept
+    {
+      if (cursor == end)
+        {
+          done = true;
+          return;
+        }
+
+      auto const delimiter = scanner.next();
+
+      record = std::string_view(cursor, static_cast<std::size_t>(delimiter - cursor));
+      cursor = delimiter == end ? end : delimiter + 1;
+    }
+
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::string_view;
+    using reference = std::string_view const &;
+    using pointer = std::string_view const *;
+    using iterator_category = std::forward_iterator_tag;
+
+    ///
+    /// \brief The end iterator.
+    ///
+    record_iterator() = default;
+
+    record_iterator(std::string_view buffer, record_format format, bool inside_quotes = false) noexcept
+      : scanner(buffer.data(), buffer.data() + buffer.size(), format, inside_quotes)
+      , cursor(buffer.data())
+      , end(buffer.data() + buffer.size())
+      , done(false)
+    {
+      advance();
+    }
+
+    reference operator*() const noexcept
+    {
+      return record;
+    }
+
+    pointer operator->() const noexcept
+    {
+      return &record;
+    }
+
+    record_iterator &operator++() noexcept
+    {
+      advance();
+      return *this;
+    }
+
+    record_iterator operator++(int) noexcept
+    {
+      auto tmp(*this);
+
+      advance();
+      return tmp;
+    }
+
+    bool operator==(record_iterator const &other) const noexcept
+    {
+      return done == other.done && (done || record.data() == other.record.data());
+    }
+
+    bool operator!=(record_iterator const &other) const noexcept
+    {
+      return !(*this == other);
+    }
+  };
+
+  using record_range = iterator_pair<record_iterator, record_iterator>;
+
+  ///
+  /// \brief Returns the records of `buffer`, see `claws::record_iterator`.
+  ///
+  /// Delimiters are found 64 bytes at a time with the active SIMD tier, see `claws::get_simd_tier()`.
+  ///
+  inline record_range split_records(std::string_view buffer, record_format format = {}) noexcept
+  {
+    return {record_iterator(buffer, format), record_iterator()};
+  }
+
+  namespace impl
+  {
+    namespace splitter
+    {
+      /// Parity of the number of quotes in `chunk`
+      inline bool odd_quotes(std::string_view chunk, char quote) noexcept
+      {
+        return claws::count(chunk.data(), chunk.data() + chunk.size(), quote) & 1;
+      }
+
+      /// Start of the first record starting at or after `position`, given the quoting state at `position`
+      inline std::size_t record_start_after(std::string_view buffer, std::size_t position, record_format format, bool inside_quotes) noexcept
+      {
+        if (!position || position >= buffer.size())
+          return position < buffer.size() ? position : buffer.size();
+        // The previous byte may be the delimiter ending the previous record
+        if (buffer[position - 1] == format.delimiter && !inside_quotes)
+          return position;
+
+        auto const end = buffer.data() + buffer.size();
+        auto const delimiter = scanner(buffer.data() + position, end, format, inside_quotes).next();
+
+        return delimiter == end ? buffer.size() : static_cast<std::size_t>(delimiter - buffer.data()) + 1u;
+      }
+
+      /// Splits `buffer` at record boundaries, given the quoting state at each nominal chunk start
+      inline std::vector<std::string_view> make_chunks(std::string_view buffer, record_format format, std::vector<bool> const &inside_quotes)
+      {
+        auto const count = inside_quotes.size();
+        std::vector<std::string_view> chunks;
+        std::size_t start(0u);
+
+        chunks.reserve(count);
+        for (std::size_t i(1u); i <= count; ++i)
+          {
+            auto const stop = i == count ? buffer.size() : record_start_after(buffer, buffer.size() * i / count, format, inside_quotes[i]);
+
+            chunks.push_back(buffer.substr(start, stop > start ? stop - start : 0u));
+            start = stop > start ? stop : start;
+          }
+        return chunks;
+      }
+    }
+  }
+
+  ///
+  /// \brief Cuts `buffer` in `chunk_count` chunks of whole records, of roughly equal sizes. Some chunks may be empty.
+  ///
+  /// Every chunk starts outside quotes, so can be split with `split_records` independently of the others.
+  ///
+  inline std::vector<std::string_view> split_chunks(std::string_view buffer, record_format format, std::size_t chunk_count)
+  {
+    chunk_count = chunk_count ? chunk_count : 1u;
+
+    std::vector<bool> inside_quotes(chunk_count, false);
+
+    if (format.quoted)
+      for (std::size_t i(1u); i != chunk_count; ++i)
+        {
+          auto const from = buffer.size() * (i - 1) / chunk_count;
+          auto const to = buffer.size() * i / chunk_count;
+
+          inside_quotes[i] = inside_quotes[i - 1] != impl::splitter::odd_quotes(buffer.substr(from, to - from), format.quote);
+        }
+    return impl::splitter::make_chunks(buffer, format, inside_quotes);
+  }
+
+  ///
+  /// \brief Calls `function(record)` for every record of `buffer`, from `thread_count` threads working on separate chunks.
+  ///
+  /// `function` is called concurrently, and in no particular order across chunks.
+  /// For quoted formats, the quoting state at each chunk's start is found by counting quotes in parallel first.
+  ///
+  template<class function_type>
+  void for_each_record_parallel(std::string_view buffer, record_format format, unsigned thread_count, function_type const &function)
+  {
+    thread_count = thread_count ? thread_count : 1u;
+
+    std::vector<bool> inside_quotes(thread_count, false);
+    std::vector<std::thread> threads;
+
+    if (format.quoted && thread_count > 1)
+      {
+        std::vector<unsigned char> odd(thread_count, 0u);
+
+        for (unsigned i(0u); i != thread_count; ++i)
+          threads.emplace_back([&, i]() {
+            auto const from = buffer.size() * i / thread_count;
+            auto const to = buffer.size() * (i + 1) / thread_count;
+
+            odd[i] = impl::splitter::odd_quotes(buffer.substr(from, to - from), format.quote);
+          });
+        for (auto &thread : threads)
+          thread.join();
+        threads.clear();
+        for (unsigned i(1u); i != thread_count; ++i)
+          inside_quotes[i] = inside_quotes[i - 1] != static_cast<bool>(odd[i - 1]);
+      }
+
+    auto const chunks = impl::splitter::make_chunks(buffer, format, inside_quotes);
+
+    for (auto const &chunk : chunks)
+      threads.emplace_back([&chunk, &format, &function]() {
+        for (auto record : split_records(chunk, format))
+          function(record);
+      });
+    for (auto &thread : threads)
+      thread.join();
+  }
+}
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <claws/container/vect.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Separators written between values by `claws::write_text`.
+  ///
+  /// Every element of an array is a record: scalars are written one per record, `vect` components are separated by `value_separator`.
+  /// Parsing accepts either separator, as well as any whitespace, between values.
+  ///
+  struct text_layout
+  {
+    char value_separator{' '};
+    char record_separator{'\n'};
+  };
+
+  ///
+  /// \brief Where `claws::parse_text` stopped, and how many elements it filled.
+  ///
+  /// `ec` is `std::errc{}` when the input ended or `count` elements were parsed, in which case `ptr` is past the last value.
+  /// Otherwise `ptr` points to the value that could not be parsed, and `count` elements before it were filled.
+  ///
+  struct parse_result
+  {
+    char const *ptr;
+    std::size_t count;
+    std::errc ec;
+  };
+
+  namespace impl
+  {
+    namespace text
+    {
+      template<class T>
+      struct element_traits
+      {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "only arithmetic values and vects of them can be written as text");
+
+        using component_type = T;
+
+        static constexpr std::size_t components = 1;
+
+        static constexpr T *begin(T &value) noexcept
+        {
+          return &value;
+        }
+
+        static constexpr T const *begin(T const &value) noexcept
+        {
+          return &value;
+        }
+      };
+
+      template<class T, std::size_t Size>
+      struct element_traits<vect<T, Size>>
+      {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "only arithmetic values and vects of them can be written as text");
+
+        using component_type = T;
+
+        static constexpr std::size_t components = Size;
+
+        static constexpr T *begin(vect<T, Size> &value) noexcept
+        {
+          return value.begin();
+        }
+
+        static constexpr T const *begin(vect<T, Size> const &value) noexcept
+        {
+          return value.cbegin();
+        }
+      };
+
+      /// Longest text `to_chars` writes for a `T`: the sign, digits, and for floating points the dot and up to 4 exponent digits
+      template<class T>
+      constexpr std::size_t max_chars() noexcept
+      {
+        if constexpr (std::is_integral_v<T>)
+          return std::numeric_limits<T>::digits10 + 2u;
+        else
+          return std::numeric_limits<T>::max_digits10 + 8u;
+      }
+
+      constexpr bool is_digit(char c) noexcept
+      {
+        return static_cast<unsigned char>(c - '0') < 10u;
+      }
+
+      constexpr bool is_separator(char c, text_layout layout) noexcept
+      {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == layout.value_separator || c == layout.record_separator;
+      }
+
+      /// Digits are converted 8 at a time in a 64 bit word, which needs little endian loads
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      inline constexpr bool has_swar = true;
+#else
+      inline constexpr bool has_swar = false;
+#endif
+
+      inline std::uint64_t load_eight(char const *ptr) noexcept
+      {
+        std::uint64_t word;
+
+        std::memcpy(&word, ptr, sizeof(word));
+        return word;
+      }
+
+      /// Every byte is in '0'..'9': its high nibble is 3, and adding 6 doesn't carry out of its low nibble
+      constexpr bool all_digits(std::uint64_t word) noexcept
+      {
+        return !(((word & 0xF0F0F0F0F0F0F0F0u) | (((word + 0x0606060606060606u) & 0xF0F0F0F0F0F0F0F0u) >> 4u)) ^ 0x3333333333333333u);
+      }
+
+      /// Value of 8 digits, the first one being the lowest byte of `word`
+      constexpr std::uint32_t parse_eight(std::uint64_t word) noexcept
+      {
+        word -= 0x3030303030303030u;
+        // Pairs of digits, then groups of 4, then 8
+        word = (word * 10u) + (word >> 8u);
+        word = (((word & 0x000000FF000000FFu) * (100u + (1000000ull << 32u))) + (((word >> 16u) & 0x000000FF000000FFu) * (1u + (10000ull << 32u)))) >> 32u;
+        return static_cast<std::uint32_t>(word);
+      }
+
+      ///
+      /// \brief `std::from_chars` for integers, converting runs of 8 digits at once.
+      ///
+      /// Numbers with more digits than always fit in `T` are handed to `std::from_chars`, which checks for overflow.
+      ///
+      template<class T>
+      std::from_chars_result parse_integer(char const *first, char const *last, T &value) noexcept
+      {
+        using unsigned_type = std::make_unsigned_t<T>;
+        constexpr std::ptrdiff_t safe_digits = std::numeric_limits<unsigned_type>::digits10;
+
+        auto ptr = first;
+        bool negative = false;
+
+        if constexpr (std::is_signed_v<T>)
+          if (ptr != last && *ptr == '-')
+            {
+              negative = true;
+              ++ptr;
+            }
+
+        auto const digits = ptr;
+        std::uint64_t result(0u);
+
+        if constexpr (has_swar && safe_digits >= 8)
+          for (; last - ptr >= 8 && ptr - digits + 8 <= safe_digits; ptr += 8)
+            {
+              auto const word = load_eight(ptr);
+
+              if (!all_digits(word))
+                break;
+              result = result * 100000000u + parse_eight(word);
+            }
+        for (; ptr != last && is_digit(*ptr) && ptr - digits < safe_digits; ++ptr)
+          result = result * 10u + static_cast<unsigned>(*ptr - '0');
+        if (ptr == digits)
+          return {first, std::errc::invalid_argument};
+        if (ptr != last && is_digit(*ptr))
+          return std::from_chars(first, last, value);
+
+        constexpr std::uint64_t max = static_cast<unsigned_type>(std::numeric_limits<T>::max());
+
+        if (result > max + negative)
+          return {ptr, std::errc::result_out_of_range};
+        value = negative ? static_cast<T>(static_cast<unsigned_type>(0u - result)) : static_cast<T>(result);
+        return {ptr, std::errc{}};
+      }
+
+      /// A floating point type whose normal range covers `T`'s subnormals, or `T` if there is none
+      template<class T>
+      using wider_floating_t = std::conditional_t<std::is_same_v<T, float>, double, long double>;
+
+      template<class T>
+      inline constexpr bool has_wider_floating =
+        std::numeric_limits<wider_floating_t<T>>::min_exponent < std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits;
+
+      ///
+      /// \brief `std::from_chars` for floating points, accepting subnormal values.
+      ///
+      /// Some standard libraries, like recent libstdc++, report subnormal results as out of range without storing them, as `strtod` does.
+      /// Such tokens are parsed again in a wider type, and accepted if they round to a subnormal `T`:
+      /// rounding twice only differs from a direct conversion for values within a hair of halfway between two subnormals.
+      ///
+      template<class T>
+      std::from_chars_result parse_floating(char const *first, char const *last, T &value) noexcept
+      {
+        auto result = std::from_chars(first, last, value);
+
+        if constexpr (has_wider_floating<T>)
+          if (result.ec == std::errc::result_out_of_range)
+            {
+              wider_floating_t<T> wide;
+              auto const wide_result = std::from_chars(first, last, wide);
+              auto const narrow = static_cast<T>(wide);
+
+              if (wide_result.ec == std::errc{} && wide_result.ptr == result.ptr && narrow != T(0)
+                  && (narrow < T(0) ? -narrow : narrow) <= std::numeric_limits<T>::min())
+                {
+                  value = narrow;
+                  result.ec = std::errc{};
+                }
+            }
+        return result;
+      }
+
+      template<class T>
+      std::from_chars_result parse_value(char const *first, char const *last, T &value) noexcept
+      {
+        if constexpr (std::is_integral_v<T>)
+          return parse_integer(first, last, value);
+        else
+          return parse_floating(first, last, value);
+      }
+    }
+  }
+
+  ///
+  /// \brief Upper bound of the text `claws::write_text` writes for `count` elements of type `T`, an arithmetic type or a `vect` of one.
+  ///
+  template<class T>
+  constexpr std::size_t text_capacity(std::size_t count) noexcept
+  {
+    using traits = impl::text::element_traits<T>;
+
+    return count * traits::components * (impl::text::max_chars<typename traits::component_type>() + 1u);
+  }
+
+  ///
+  /// \brief Writes `count` elements as text in `[first, last)`, in the shortest form that parses back to the same values.
+  ///
+  /// Uses `std::to_chars`: no allocation and no locale. Each element is followed by `layout.record_separator`.
+  /// Returns the end of the written text, or `last` and `std::errc::value_too_large` if the buffer is too small,
+  /// which never happens with a buffer of `claws::text_capacity<T>(count)` bytes.
+  ///
+  template<class T>
+  std::to_chars_result write_text(char *first, char *last, T const *values, std::size_t count, text_layout layout = {}) noexcept
+  {
+    using traits = impl::text::element_traits<T>;
+
+    for (std::size_t i(0u); i != count; ++i)
+      {
+        auto const components = traits::begin(values[i]);
+
+        for (std::size_t j(0u); j != traits::components; ++j)
+          {
+            auto const result = std::to_chars(first, last, components[j]);
+
+            if (result.ec != std::errc{} || result.ptr == last)
+              return {last, std::errc::value_too_large};
+            first = result.ptr;
+            *first++ = j + 1 == traits::components ? layout.record_separator : layout.value_separator;
+          }
+      }
+    return {first, std::errc{}};
+  }
+
+  ///
+  /// \brief Appends `count` elements as text to `out`, growing it once.
+  ///
+  template<class T>
+  void append_text(std::string &out, T const *values, std::size_t count, text_layout layout = {})
+  {
+    auto const size = out.size();
+
+    out.resize(size + text_capacity<T>(count));
+
+    auto const result = write_text(out.data() + size, out.data() + out.size(), values, count, layout);
+
+    out.resize(static_cast<std::size_t>(result.ptr - out.data()));
+  }
+
+  ///
+  /// \brief Parses up to `count` elements from `[first, last)` into `values`, skipping separators and whitespace between values.
+  ///
+  /// Integers are converted 8 digits at a time in a 64 bit word, with plain scalar arithmetic (SWAR) rather than vector instructions.
+  /// Floating points use `std::from_chars`, subnormal values included. See `claws::parse_result`.
+  ///
+  template<class T>
+  parse_result parse_text(char const *first, char const *last, T *values, std::size_t count, text_layout layout = {}) noexcept
+  {
+    using traits = impl::text::element_traits<T>;
+
+    for (std::size_t i(0u); i != count; ++i)
+      {
+        auto const components = traits::begin(values[i]);
+
+        for (std::size_t j(0u); j != traits::components; ++j)
+          {
+            for (; first != last && impl::text::is_separator(*first, layout); ++first)
+              ;
+            if (first == last && !j)
+              return {first, i, std::errc{}};
+
+            auto const result = impl::text::parse_value(first, last, components[j]);
+
+            if (result.ec != std::errc{})
+              return {first, i, first == last ? std::errc::invalid_argument : result.ec};
+            first = result.ptr;
+          }
+      }
+    return {first, count, std::errc{}};
+  }
+}
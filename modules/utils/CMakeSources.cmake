@@ -3,20 +3,32 @@ set(MODULE_PATH
 
 set(MODULE_PUBLIC_HEADERS
         "${MODULE_PATH}/array_ops.hpp"
+        "${MODULE_PATH}/bit_ops.hpp"
         "${MODULE_PATH}/box.hpp"
         "${MODULE_PATH}/circular_iterator.hpp"
         "${MODULE_PATH}/constexpr_algorithm.hpp"
         "${MODULE_PATH}/contextful_container.hpp"
+        "${MODULE_PATH}/cpu_features.hpp"
+        "${MODULE_PATH}/function_ref.hpp"
+        "${MODULE_PATH}/handle_array.hpp"
         "${MODULE_PATH}/handle_types.hpp"
+        "${MODULE_PATH}/inplace_function.hpp"
+        "${MODULE_PATH}/is_constant_evaluated.hpp"
         "${MODULE_PATH}/iterator_util.hpp"
         "${MODULE_PATH}/lambda_ops.hpp"
         "${MODULE_PATH}/lambda_utils.hpp"
+        "${MODULE_PATH}/offset_ptr.hpp"
         "${MODULE_PATH}/on_scope_exit.hpp"
+        "${MODULE_PATH}/padded.hpp"
         "${MODULE_PATH}/self_iterator.hpp"
+        "${MODULE_PATH}/shared_handle.hpp"
+        "${MODULE_PATH}/simd.hpp"
         "${MODULE_PATH}/tagged_data.hpp"
+        "${MODULE_PATH}/trivially_relocatable.hpp"
         "${MODULE_PATH}/tuple_helper.hpp"
         "${MODULE_PATH}/type.hpp"
         "${MODULE_PATH}/vect.hpp"
+        "${MODULE_PATH}/visit.hpp"
         )
 
 set(MODULE_PRIVATE_HEADERS
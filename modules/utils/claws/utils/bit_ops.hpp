@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace claws
+{
+  ///
+  /// \brief Number of trailing zero bits of `value`, which must not be 0.
+  ///
+  /// Compiles to a single instruction with GCC, Clang and MSVC, to a loop elsewhere.
+  ///
+  template<class T>
+  inline int countr_zero(T value) noexcept
+  {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8u, "countr_zero takes unsigned integers of up to 64 bits");
+
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (sizeof(T) <= sizeof(unsigned))
+      return __builtin_ctz(static_cast<unsigned>(value));
+    else
+      return __builtin_ctzll(static_cast<unsigned long long>(value));
+#elif defined(_MSC_VER)
+    unsigned long index;
+
+    if constexpr (sizeof(T) <= 4u)
+      _BitScanForward(&index, static_cast<unsigned long>(value));
+    else
+      {
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanForward64(&index, static_cast<unsigned __int64>(value));
+#else
+        if (!_BitScanForward(&index, static_cast<unsigned long>(value)))
+          {
+            _BitScanForward(&index, static_cast<unsigned long>(value >> 32u));
+            index += 32u;
+          }
+#endif
+      }
+    return static_cast<int>(index);
+#else
+    int count(0);
+
+    for (; !(value & 1u); value >>= 1u)
+      ++count;
+    return count;
+#endif
+  }
+
+  ///
+  /// \brief Number of leading zero bits of `value`, counted over the width of `T`, which must not be 0.
+  ///
+  template<class T>
+  inline int countl_zero(T value) noexcept
+  {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8u, "countl_zero takes unsigned integers of up to 64 bits");
+
+    constexpr int bits = static_cast<int>(sizeof(T) * 8u);
+
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (sizeof(T) <= sizeof(unsigned))
+      return __builtin_clz(static_cast<unsigned>(value)) - (static_cast<int>(sizeof(unsigned) * 8u) - bits);
+    else
+      return __builtin_clzll(static_cast<unsigned long long>(value)) - (static_cast<int>(sizeof(unsigned long long) * 8u) - bits);
+#elif defined(_MSC_VER)
+    unsigned long index;
+
+    if constexpr (sizeof(T) <= 4u)
+      _BitScanReverse(&index, static_cast<unsigned long>(value));
+    else
+      {
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanReverse64(&index, static_cast<unsigned __int64>(value));
+#else
+        if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32u)))
+          index += 32u;
+        else
+          _BitScanReverse(&index, static_cast<unsigned long>(value));
+#endif
+      }
+    return bits - 1 - static_cast<int>(index);
+#else
+    int count(0);
+
+    for (T const top = T(1) << (bits - 1); !(value & top); value <<= 1u)
+      ++count;
+    return count;
+#endif
+  }
+
+  ///
+  /// \brief `value` with its bytes in reverse order.
+  ///
+  template<class T>
+  inline T byteswap(T value) noexcept
+  {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8u, "byteswap takes unsigned integers of up to 64 bits");
+
+    if constexpr (sizeof(T) == 1u)
+      return value;
+#if defined(__GNUC__) || defined(__clang__)
+    else if constexpr (sizeof(T) == 2u)
+      return static_cast<T>(__builtin_bswap16(static_cast<std::uint16_t>(value)));
+    else if constexpr (sizeof(T) == 4u)
+      return static_cast<T>(__builtin_bswap32(static_cast<std::uint32_t>(value)));
+    else
+      return static_cast<T>(__builtin_bswap64(static_cast<std::uint64_t>(value)));
+#elif defined(_MSC_VER)
+    else if constexpr (sizeof(T) == 2u)
+      return static_cast<T>(_byteswap_ushort(static_cast<unsigned short>(value)));
+    else if constexpr (sizeof(T) == 4u)
+      return static_cast<T>(_byteswap_ulong(static_cast<unsigned long>(value)));
+    else
+      return static_cast<T>(_byteswap_uint64(static_cast<unsigned __int64>(value)));
+#else
+    else
+      {
+        // Compilers recognize the pattern and emit a single instruction where there is one
+        T result(0u);
+
+        for (std::size_t i(0u); i != sizeof(T); ++i, value >>= 8u)
+          result = static_cast<T>((result << 8u) | (value & 0xFFu));
+        return result;
+      }
+#endif
+  }
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+/// Defined when SIMD kernels can be compiled for x86 targets regardless of the build's baseline architecture
+#define CLAWS_SIMD_X86 1
+#define CLAWS_TARGET_SSE2 __attribute__((target("sse2")))
+#define CLAWS_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#define CLAWS_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx2,bmi,bmi2,popcnt")))
+#endif
+
+namespace claws
+{
+  ///
+  /// \brief Instruction set extensions supported by the running CPU (and enabled by the OS).
+  ///
+  struct cpu_features
+  {
+    bool sse2{false};
+    bool sse4_2{false};
+    bool popcnt{false};
+    bool avx2{false};
+    bool bmi2{false};
+    bool avx512f{false};
+    bool avx512bw{false};
+    bool avx512vl{false};
+    bool avx512dq{false};
+  };
+
+  ///
+  /// \brief Instruction sets claws' SIMD kernels are compiled for, from least to most capable.
+  ///
+  /// `scalar` disables every kernel, falling back to plain loops.
+  ///
+  enum class simd_tier : unsigned char
+  {
+    scalar,
+    sse2,
+    avx2,
+    avx512
+  };
+
+  namespace impl
+  {
+    inline cpu_features detect_cpu_features() noexcept
+    {
+      cpu_features features;
+
+#if defined(CLAWS_SIMD_X86)
+      // May run before libgcc's own constructor if called during static initialisation
+      __builtin_cpu_init();
+      features.sse2 = __builtin_cpu_supports("sse2");
+      features.sse4_2 = __builtin_cpu_supports("sse4.2");
+      features.popcnt = __builtin_cpu_supports("popcnt");
+      features.avx2 = __builtin_cpu_supports("avx2");
+      features.bmi2 = __builtin_cpu_supports("bmi2");
+      features.avx512f = __builtin_cpu_supports("avx512f");
+      features.avx512bw = __builtin_cpu_supports("avx512bw");
+      features.avx512vl = __builtin_cpu_supports("avx512vl");
+      features.avx512dq = __builtin_cpu_supports("avx512dq");
+#endif
+      return features;
+    }
+  }
+
+  ///
+  /// \brief Returns the features of the running CPU. Detection happens once, on first call.
+  ///
+  inline cpu_features const &get_cpu_features() noexcept
+  {
+    static cpu_features const features = impl::detect_cpu_features();
+
+    return features;
+  }
+
+  namespace impl
+  {
+    inline simd_tier best_simd_tier(cpu_features const &features) noexcept
+    {
+#if defined(CLAWS_SIMD_X86)
+      if (features.avx512f && features.avx512bw && features.avx512vl && features.avx512dq && features.avx2 && features.bmi2 && features.popcnt)
+        return simd_tier::avx512;
+      if (features.avx2 && features.bmi2 && features.popcnt)
+        return simd_tier::avx2;
+      if (features.sse2)
+        return simd_tier::sse2;
+#else
+      (void)features;
+#endif
+      return simd_tier::scalar;
+    }
+
+    /// Returns `false` and leaves `tier` untouched if `name` isn't one of "scalar", "sse2", "avx2" or "avx512"
+    inline bool parse_simd_tier(char const *name, simd_tier &tier) noexcept
+    {
+      constexpr char const *names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+      for (unsigned i(0u); i != sizeof(names) / sizeof(*names); ++i)
+        if (!std::strcmp(name, names[i]))
+          {
+            tier = static_cast<simd_tier>(i);
+            return true;
+          }
+      return false;
+    }
+
+    /// The best supported tier, lowered by the `CLAWS_SIMD_TIER` environment variable if it is set
+    inline simd_tier initial_simd_tier() noexcept
+    {
+      auto const best = best_simd_tier(get_cpu_features());
+      auto requested = best;
+
+      if (auto const name = std::getenv("CLAWS_SIMD_TIER"))
+        parse_simd_tier(name, requested);
+      return requested < best ? requested : best;
+    }
+
+    inline std::atomic<simd_tier> &active_simd_tier() noexcept
+    {
+      static std::atomic<simd_tier> tier{initial_simd_tier()};
+
+      return tier;
+    }
+  }
+
+  ///
+  /// \brief Returns the most capable tier the running CPU supports.
+  ///
+  inline simd_tier get_max_simd_tier() noexcept
+  {
+    return impl::best_simd_tier(get_cpu_features());
+  }
+
+  ///
+  /// \brief Returns the tier SIMD kernels are currently dispatched to.
+  ///
+  /// Defaults to `get_max_simd_tier()`, or to the `CLAWS_SIMD_TIER` environment variable
+  /// ("scalar", "sse2", "avx2" or "avx512") when it names a lower tier.
+  ///
+  inline simd_tier get_simd_tier() noexcept
+  {
+    return impl::active_simd_tier().load(std::memory_order_relaxed);
+  }
+
+  ///
+  /// \brief Dispatches SIMD kernels to `tier`, or to `get_max_simd_tier()` if the CPU doesn't support `tier`.
+  ///
+  /// Returns the tier actually selected. Meant for tests, benchmarks and working around a misbehaving tier.
+  ///
+  inline simd_tier set_simd_tier(simd_tier tier) noexcept
+  {
+    auto const best = get_max_simd_tier();
+    auto const selected = tier < best ? tier : best;
+
+    impl::active_simd_tier().store(selected, std::memory_order_relaxed);
+    return selected;
+  }
+}
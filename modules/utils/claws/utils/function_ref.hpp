@@ -0,0 +1,95 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace claws
+{
+  namespace impl
+  {
+    /// How type-erased callables receive arguments: scalars by value, so they stay in registers, anything else by reference
+    template<class T>
+    using erased_param_t = std::conditional_t<std::is_scalar_v<T>, T, T &&>;
+
+    /// `std::invoke`, converting the result to `result_type`, or discarding it if `result_type` is `void`
+    template<class result_type, class callable_type, class... param_types>
+    constexpr result_type invoke_r(callable_type &&callable, param_types &&... params)
+    {
+      if constexpr (std::is_void_v<result_type>)
+        std::invoke(std::forward<callable_type>(callable), std::forward<param_types>(params)...);
+      else
+        return std::invoke(std::forward<callable_type>(callable), std::forward<param_types>(params)...);
+    }
+  }
+
+  template<class signature>
+  class function_ref;
+
+  ///
+  /// \brief Non-owning reference to a callable: a pointer to it, and a pointer to a function calling it.
+  ///
+  /// For callbacks which are only called during the call they are passed to, like visitors or comparators:
+  /// unlike a template parameter, the callee isn't instantiated for each callable, and unlike `std::function`, nothing is copied nor allocated.
+  ///
+  /// The callable must outlive the `function_ref`, which is a problem when binding a temporary lambda to a `function_ref` variable.
+  /// Trivially copyable, two pointers in size. Calling costs one indirect call.
+  ///
+  template<class result_type, class... param_types>
+  class function_ref<result_type(param_types...)>
+  {
+    union target
+    {
+      void *object;
+      result_type (*function)(param_types...);
+    };
+
+    target callable;
+    result_type (*invoke)(target, impl::erased_param_t<param_types>...);
+
+    template<class callable_type>
+    static result_type invoke_object(target callable, impl::erased_param_t<param_types>... params)
+    {
+      return impl::invoke_r<result_type>(*static_cast<callable_type *>(callable.object), std::forward<param_types>(params)...);
+    }
+
+    template<class function_type>
+    static result_type invoke_function(target callable, impl::erased_param_t<param_types>... params)
+    {
+      return impl::invoke_r<result_type>(reinterpret_cast<function_type *>(callable.function), std::forward<param_types>(params)...);
+    }
+
+  public:
+    ///
+    /// \brief References `callable`, which must outlive the `function_ref`.
+    ///
+    template<class callable_type,
+             std::enable_if_t<!std::is_same_v<std::decay_t<callable_type>, function_ref> && !std::is_function_v<std::remove_reference_t<callable_type>>
+                                && std::is_invocable_r_v<result_type, callable_type &, param_types...>> * = nullptr>
+    function_ref(callable_type &&callable) noexcept
+      : invoke(&invoke_object<std::remove_reference_t<callable_type>>)
+    {
+      this->callable.object = const_cast<void *>(static_cast<void const volatile *>(std::addressof(callable)));
+    }
+
+    ///
+    /// \brief References a function, which doesn't need to outlive the `function_ref`.
+    ///
+    template<class function_type,
+             std::enable_if_t<std::is_function_v<function_type> && std::is_invocable_r_v<result_type, function_type &, param_types...>> * = nullptr>
+    function_ref(function_type *function) noexcept
+      : invoke(&invoke_function<function_type>)
+    {
+      callable.function = reinterpret_cast<result_type (*)(param_types...)>(function);
+    }
+
+    function_ref(function_ref const &) noexcept = default;
+    function_ref &operator=(function_ref const &) noexcept = default;
+
+    result_type operator()(param_types... params) const
+    {
+      return invoke(callable, std::forward<param_types>(params)...);
+    }
+  };
+}
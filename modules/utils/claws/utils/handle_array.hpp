@@ -0,0 +1,273 @@
+///
+/// *Defined in "handle_array.hpp"*
+///
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <claws/utils/handle_types.hpp>
+
+namespace claws
+{
+  ///
+  /// \ingroup handles
+  /// \brief Owns a contiguous array of values of type `type`, released in batches by a single deleter call per run of values.
+  ///
+  /// @tparam _type The stored values' type. Empty slots hold `type{}`, which is never passed to the deleter.
+  /// @tparam _batch_deleter_type Called as `deleter(type *values, std::size_t count)` to release `count` contiguous values. Inherited protectedly.
+  ///
+  /// Values are released:
+  ///  - by `release(first, last)`, with one deleter call per run of values in the range,
+  ///  - by `retire(index)`, which queues a single value and releases every queued value in one call on `flush()`,
+  ///  - on destruction, with one deleter call per run of values left, a single call if there are no empty slots.
+  ///
+  /// Tearing down many resources that the deleter can release at once (file descriptors with `close_range`, buffers from the same pool)
+  /// thus costs a handful of calls instead of one per resource.
+  ///
+  template<class _type, class _batch_deleter_type>
+  class handle_array : protected _batch_deleter_type
+  {
+  public:
+    using type = _type;
+    using deleter_type = _batch_deleter_type;
+    using size_type = std::size_t;
+    using const_iterator = type const *;
+
+  private:
+    std::vector<type> values;
+    std::vector<type> retired;
+
+    static bool is_empty(type const &value) noexcept
+    {
+      return value == type{};
+    }
+
+    void delete_batch(type *batch, size_type count) noexcept
+    {
+      if (count)
+        static_cast<deleter_type &>(*this)(batch, count);
+    }
+
+    /// One deleter call per run of values in `[first, last)`, then empties them
+    void delete_runs(size_type first, size_type last) noexcept
+    {
+      while (first != last)
+        {
+          for (; first != last && is_empty(values[first]); ++first)
+            ;
+
+          auto run_end = first;
+
+          for (; run_end != last && !is_empty(values[run_end]); ++run_end)
+            ;
+          delete_batch(values.data() + first, run_end - first);
+          for (; first != run_end; ++first)
+            values[first] = type{};
+        }
+    }
+
+  public:
+    handle_array() = default;
+
+    explicit handle_array(deleter_type &&deleter)
+      : deleter_type(std::move(deleter))
+    {}
+
+    handle_array(handle_array const &) = delete;
+    handle_array &operator=(handle_array const &) = delete;
+
+    handle_array(handle_array &&other) noexcept(std::is_nothrow_move_constructible_v<deleter_type>)
+      : deleter_type(std::move(static_cast<deleter_type &>(other)))
+      , values(std::move(other.values))
+      , retired(std::move(other.retired))
+    {
+      other.values.clear();
+      other.retired.clear();
+    }
+
+    handle_array &operator=(handle_array &&other) noexcept(std::is_nothrow_move_assignable_v<deleter_type>)
+    {
+      if (this != &other)
+        {
+          clear();
+          static_cast<deleter_type &>(*this) = std::move(static_cast<deleter_type &>(other));
+          values = std::move(other.values);
+          retired = std::move(other.retired);
+          other.values.clear();
+          other.retired.clear();
+        }
+      return *this;
+    }
+
+    ~handle_array()
+    {
+      clear();
+    }
+
+    ///
+    /// \brief Appends up to `count` values made by a single `create(type *values, std::size_t count)` call, returning how many it made.
+    ///
+    /// Slots past the returned count are dropped, others `create` leaves to `type{}` stay empty.
+    ///
+    template<class creator_type>
+    size_type create(size_type count, creator_type &&create)
+    {
+      auto const first = values.size();
+
+      values.resize(first + count);
+
+      size_type const created = std::forward<creator_type>(create)(values.data() + first, count);
+
+      values.resize(first + (created < count ? created : count));
+      return values.size() - first;
+    }
+
+    ///
+    /// \brief Takes ownership of `value`.
+    ///
+    /// If storing it throws, `value` is passed to the deleter before the exception propagates, so it never leaks.
+    ///
+    void push_back(type value)
+    {
+      try
+        {
+          values.push_back(std::move(value));
+        }
+      catch (...)
+        {
+          // `push_back` has no effect when it throws, `value` is still ours
+          if (!is_empty(value))
+            delete_batch(&value, 1u);
+          throw;
+        }
+    }
+
+    ///
+    /// \brief Releases the values in `[first, last)`, with one deleter call per run of values. Their slots become empty.
+    ///
+    void release(size_type first, size_type last) noexcept
+    {
+      delete_runs(first, last);
+    }
+
+    ///
+    /// \brief Queues the value at `index` for the next `flush()`. Its slot becomes empty right away.
+    ///
+    void retire(size_type index)
+    {
+      if (is_empty(values[index]))
+        return;
+      // The slot is only emptied once queued, so the value stays owned if `push_back` throws
+      retired.push_back(values[index]);
+      values[index] = type{};
+    }
+
+    ///
+    /// \brief Releases every retired value in a single deleter call. Returns how many were released.
+    ///
+    size_type flush() noexcept
+    {
+      auto const count = retired.size();
+
+      delete_batch(retired.data(), count);
+      retired.clear();
+      return count;
+    }
+
+    ///
+    /// \brief Flushes retired values then releases every value, with one deleter call per run.
+    ///
+    void clear() noexcept
+    {
+      flush();
+      delete_runs(0u, values.size());
+      values.clear();
+    }
+
+    ///
+    /// \brief Removes empty slots, keeping the values' order, and returns the new size.
+    ///
+    /// Calls `moved(from, to)` for every value that changes index.
+    ///
+    template<class callback_type>
+    size_type compact(callback_type &&moved)
+    {
+      size_type kept(0u);
+
+      for (size_type index(0u); index != values.size(); ++index)
+        if (!is_empty(values[index]))
+          {
+            if (index != kept)
+              {
+                values[kept] = std::exchange(values[index], type{});
+                moved(index, kept);
+              }
+            ++kept;
+          }
+      values.resize(kept);
+      return kept;
+    }
+
+    size_type compact()
+    {
+      return compact([](size_type, size_type) noexcept {});
+    }
+
+    ///
+    /// \brief returns a non-owning handle
+    ///
+    auto operator[](size_type index) const
+    {
+      return handle<type, no_delete>(values[index]);
+    }
+
+    ///
+    /// \brief Number of slots, empty or not.
+    ///
+    size_type size() const noexcept
+    {
+      return values.size();
+    }
+
+    bool empty() const noexcept
+    {
+      return values.empty();
+    }
+
+    ///
+    /// \brief Number of values retired and not flushed yet.
+    ///
+    size_type retired_count() const noexcept
+    {
+      return retired.size();
+    }
+
+    void reserve(size_type size)
+    {
+      values.reserve(size);
+    }
+
+    type const *data() const noexcept
+    {
+      return values.data();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return values.data();
+    }
+
+    const_iterator end() const noexcept
+    {
+      return values.data() + values.size();
+    }
+
+    auto const &get_deleter() const noexcept
+    {
+      return static_cast<deleter_type const &>(*this);
+    }
+  };
+}
@@ -342,6 +342,8 @@ namespace claws
   ///
   /// \brief provides a groupe handle, where `auto operator[](std::size_t)` returns a non-owning handle
   ///
+  /// See `claws::handle_array` for a group owning each of its values, released in batches.
+  ///
   template<class type, class group_type, class group_deleter>
   struct group_handle : public handle<group_type, group_deleter>
   {
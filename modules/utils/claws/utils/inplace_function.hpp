@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <claws/utils/function_ref.hpp>
+
+namespace claws
+{
+  namespace impl
+  {
+    /// Shared by every capacity, so `inplace_function`s of different capacities can take each other's callables
+    enum class erased_operation
+    {
+      move,
+      destroy
+    };
+
+    using erased_manage_type = void (*)(erased_operation, void *storage, void *destination) noexcept;
+
+    template<class result_type, class... param_types>
+    [[noreturn]] result_type invoke_empty(void *, erased_param_t<param_types>...)
+    {
+      throw std::bad_function_call();
+    }
+  }
+
+  template<class signature, std::size_t capacity = 4u * sizeof(void *), std::size_t alignment = alignof(std::max_align_t)>
+  class inplace_function;
+
+  ///
+  /// \brief Owning, move-only, type-erased callable, stored in a buffer of `capacity` bytes inside the `inplace_function`.
+  ///
+  /// A replacement for `std::function` that never allocates: callables which don't fit `capacity` and `alignment` don't compile,
+  /// instead of silently going to the heap. Callables only need to be movable, so lambdas can capture `std::unique_ptr`s or handles.
+  ///
+  /// Calling costs one indirect call. Moving trivially copyable callables copies the buffer,
+  /// other callables are moved and destroyed through a second function pointer.
+  /// Calling an empty `inplace_function` throws `std::bad_function_call`, without testing for emptiness on calls.
+  ///
+  /// Like `std::function`, `operator()` is `const` but calls the callable as non-`const`.
+  ///
+  template<class result_type, class... param_types, std::size_t capacity, std::size_t alignment>
+  class inplace_function<result_type(param_types...), capacity, alignment>
+  {
+    using invoke_type = result_type (*)(void *storage, impl::erased_param_t<param_types>...);
+
+    static constexpr invoke_type invoke_empty = &impl::invoke_empty<result_type, param_types...>;
+
+    invoke_type invoke{invoke_empty};
+    /// `nullptr` for trivially copyable callables
+    impl::erased_manage_type manage{nullptr};
+    alignas(alignment) mutable unsigned char storage[capacity];
+
+    template<class, std::size_t, std::size_t>
+    friend class inplace_function;
+
+    template<class callable_type>
+    static result_type invoke_stored(void *storage, impl::erased_param_t<param_types>... params)
+    {
+      return impl::invoke_r<result_type>(*std::launder(static_cast<callable_type *>(storage)), std::forward<param_types>(params)...);
+    }
+
+    template<class callable_type>
+    static void manage_stored(impl::erased_operation op, void *storage, void *destination) noexcept
+    {
+      auto &stored = *std::launder(static_cast<callable_type *>(storage));
+
+      if (op == impl::erased_operation::move)
+        new (destination) callable_type(std::move(stored));
+      stored.~callable_type();
+    }
+
+    /// Moves `other`'s callable in, leaving `other` empty. `*this` must be empty.
+    template<std::size_t other_capacity, std::size_t other_alignment>
+    void take(inplace_function<result_type(param_types...), other_capacity, other_alignment> &other) noexcept
+    {
+      if (other.manage)
+        other.manage(impl::erased_operation::move, other.storage, storage);
+      else
+        std::memcpy(storage, other.storage, other_capacity < capacity ? other_capacity : capacity);
+      invoke = std::exchange(other.invoke, invoke_empty);
+      manage = std::exchange(other.manage, nullptr);
+    }
+
+  public:
+    inplace_function() noexcept = default;
+
+    inplace_function(std::nullptr_t) noexcept
+    {}
+
+    ///
+    /// \brief Stores a copy of `callable`, or moves it in.
+    ///
+    template<class callable_type,
+             class stored_type = std::decay_t<callable_type>,
+             std::enable_if_t<!std::is_same_v<stored_type, inplace_function> && std::is_invocable_r_v<result_type, stored_type &, param_types...>> * = nullptr>
+    inplace_function(callable_type &&callable) noexcept(std::is_nothrow_constructible_v<stored_type, callable_type &&>)
+    {
+      static_assert(sizeof(stored_type) <= capacity, "callable too large for the inplace_function's capacity");
+      static_assert(alignof(stored_type) <= alignment, "callable too aligned for the inplace_function");
+      static_assert(std::is_nothrow_move_constructible_v<stored_type>, "inplace_function moves callables without throwing");
+
+      new (storage) stored_type(std::forward<callable_type>(callable));
+      invoke = &invoke_stored<stored_type>;
+      if constexpr (!std::is_trivially_copyable_v<stored_type>)
+        manage = &manage_stored<stored_type>;
+    }
+
+    inplace_function(inplace_function const &) = delete;
+    inplace_function &operator=(inplace_function const &) = delete;
+
+    inplace_function(inplace_function &&other) noexcept
+    {
+      take(other);
+    }
+
+    ///
+    /// \brief Takes the callable of an `inplace_function` with a smaller buffer.
+    ///
+    template<std::size_t other_capacity,
+             std::size_t other_alignment,
+             std::enable_if_t<(other_capacity < capacity && other_alignment <= alignment)> * = nullptr>
+    inplace_function(inplace_function<result_type(param_types...), other_capacity, other_alignment> &&other) noexcept
+    {
+      take(other);
+    }
+
+    inplace_function &operator=(inplace_function &&other) noexcept
+    {
+      if (this != &other)
+        {
+          reset();
+          take(other);
+        }
+      return *this;
+    }
+
+    inplace_function &operator=(std::nullptr_t) noexcept
+    {
+      reset();
+      return *this;
+    }
+
+    ~inplace_function()
+    {
+      reset();
+    }
+
+    void reset() noexcept
+    {
+      if (manage)
+        manage(impl::erased_operation::destroy, storage, nullptr);
+      invoke = invoke_empty;
+      manage = nullptr;
+    }
+
+    explicit operator bool() const noexcept
+    {
+      return invoke != invoke_empty;
+    }
+
+    result_type operator()(param_types... params) const
+    {
+      return invoke(storage, std::forward<param_types>(params)...);
+    }
+
+    friend void swap(inplace_function &lh, inplace_function &rh) noexcept
+    {
+      inplace_function tmp(std::move(lh));
+
+      lh = std::move(rh);
+      rh = std::move(tmp);
+    }
+  };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <type_traits>
+
+#if defined(__cpp_lib_is_constant_evaluated)
+#define CLAWS_HAS_IS_CONSTANT_EVALUATED 1
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define CLAWS_HAS_BUILTIN_IS_CONSTANT_EVALUATED 1
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#define CLAWS_HAS_BUILTIN_IS_CONSTANT_EVALUATED 1
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+#define CLAWS_HAS_BUILTIN_IS_CONSTANT_EVALUATED 1
+#endif
+
+namespace claws
+{
+  ///
+  /// \brief Returns `true` when called during constant evaluation.
+  ///
+  /// Used to select a `constexpr`-friendly path in functions which otherwise lower to runtime-only code (`memmove`, intrinsics...).
+  /// If the compiler provides no way to tell, this conservatively returns `true`, so only the `constexpr` path is ever taken.
+  ///
+  constexpr bool is_constant_evaluated() noexcept
+  {
+#if defined(CLAWS_HAS_IS_CONSTANT_EVALUATED)
+    return std::is_constant_evaluated();
+#elif defined(CLAWS_HAS_BUILTIN_IS_CONSTANT_EVALUATED)
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+  }
+}
@@ -0,0 +1,133 @@
+///
+/// *Defined in "offset_ptr.hpp"*
+///
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <claws/utils/tagged_data.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Pointer storing the distance from itself to its target, so it stays valid when the memory holding both is moved.
+  ///
+  /// @tparam T The pointed-to type.
+  /// @tparam tag Tag of the stored `claws::tagged_data` offset, so offsets into different structures can't be mixed up.
+  ///
+  /// Structures made of `offset_ptr`s instead of pointers can be written to a file or shared memory,
+  /// then used in place once mapped at any address, see `claws::relocatable_arena`.
+  /// The pointer and its target must live in the same block of memory, moved as a whole.
+  ///
+  /// Copying an `offset_ptr` recomputes the offset from the copy's address: the copy points to the same target.
+  /// Sizes and counts stored next to them should use fixed width types, so the layout doesn't depend on the host.
+  ///
+  template<class T, class tag = void>
+  class offset_ptr
+  {
+  public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using pointer = T *;
+    using reference = std::add_lvalue_reference_t<T>;
+    /// Distance in bytes from the pointer to its target
+    using offset_type = tagged_data<std::ptrdiff_t, std::ptrdiff_t, tag>;
+
+  private:
+    /// 1 is never a valid distance to a `T` not overlapping the pointer, so it encodes `nullptr`
+    static constexpr std::ptrdiff_t null_offset = 1;
+
+    offset_type offset{null_offset};
+
+    std::ptrdiff_t offset_to(T const volatile *target) const noexcept
+    {
+      if (!target)
+        return null_offset;
+      return reinterpret_cast<std::intptr_t>(target) - reinterpret_cast<std::intptr_t>(this);
+    }
+
+  public:
+    offset_ptr() noexcept = default;
+
+    offset_ptr(std::nullptr_t) noexcept
+    {}
+
+    offset_ptr(T *target) noexcept
+      : offset(offset_to(target))
+    {}
+
+    offset_ptr(offset_ptr const &other) noexcept
+      : offset(offset_to(other.get()))
+    {}
+
+    template<class U, class = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    offset_ptr(offset_ptr<U, tag> const &other) noexcept
+      : offset(offset_to(static_cast<T *>(other.get())))
+    {}
+
+    offset_ptr &operator=(offset_ptr const &other) noexcept
+    {
+      offset = offset_type(offset_to(other.get()));
+      return *this;
+    }
+
+    offset_ptr &operator=(T *target) noexcept
+    {
+      offset = offset_type(offset_to(target));
+      return *this;
+    }
+
+    ~offset_ptr() = default;
+
+    T *get() const noexcept
+    {
+      if (offset.data == null_offset)
+        return nullptr;
+      return reinterpret_cast<T *>(reinterpret_cast<std::intptr_t>(this) + offset.data);
+    }
+
+    /// \brief The stored distance, `1` when null.
+    offset_type get_offset() const noexcept
+    {
+      return offset;
+    }
+
+    reference operator*() const noexcept
+    {
+      return *get();
+    }
+
+    T *operator->() const noexcept
+    {
+      return get();
+    }
+
+    /// Comparisons, arithmetic and subscripts go through the raw pointer, which is only valid at its current address
+    operator T *() const noexcept
+    {
+      return get();
+    }
+
+    offset_ptr &operator+=(std::ptrdiff_t distance) noexcept
+    {
+      return *this = get() + distance;
+    }
+
+    offset_ptr &operator-=(std::ptrdiff_t distance) noexcept
+    {
+      return *this = get() - distance;
+    }
+
+    offset_ptr &operator++() noexcept
+    {
+      return *this += 1;
+    }
+
+    offset_ptr &operator--() noexcept
+    {
+      return *this -= 1;
+    }
+  };
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <claws/utils/box.hpp>
+
+namespace claws
+{
+  ///
+  /// \brief Size of a cache line on the targeted CPUs.
+  ///
+  /// `std::hardware_destructive_interference_size` would depend on compiler flags, breaking ABI between translation units.
+  ///
+  inline constexpr std::size_t cache_line_size = 64u;
+
+  ///
+  /// \brief A value alone on its cache line(s): aligned to, and its size rounded up to, `alignment`.
+  ///
+  /// \tparam T any type, typically an atomic written by one thread and read by others
+  /// \tparam alignment `claws::cache_line_size` by default
+  ///
+  /// Values written by different threads that share a cache line make every write invalidate the other threads' copies (false sharing),
+  /// an array of `padded` keeps each element on its own line.
+  ///
+  /// An aggregate, so `padded<std::atomic<int>> counters[8]{}` works.
+  ///
+  template<class T, std::size_t alignment = cache_line_size>
+  struct alignas(alignment) padded
+  {
+    T value;
+
+    constexpr T &get() noexcept
+    {
+      return value;
+    }
+
+    constexpr T const &get() const noexcept
+    {
+      return value;
+    }
+
+    constexpr T &operator*() noexcept
+    {
+      return value;
+    }
+
+    constexpr T const &operator*() const noexcept
+    {
+      return value;
+    }
+
+    constexpr T *operator->() noexcept
+    {
+      return &value;
+    }
+
+    constexpr T const *operator->() const noexcept
+    {
+      return &value;
+    }
+  };
+
+  ///
+  /// \brief `claws::box` alone on its cache line(s): a primitive that looks like a class and never shares its line.
+  ///
+  template<class _type, std::size_t alignment = cache_line_size>
+  class alignas(alignment) cache_aligned_box : public box<_type>
+  {
+  public:
+    using box<_type>::box;
+  };
+}
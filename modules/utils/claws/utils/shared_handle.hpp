@@ -0,0 +1,394 @@
+///
+/// *Defined in "shared_handle.hpp"*
+///
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <claws/utils/handle_types.hpp>
+
+namespace claws
+{
+  ///
+  /// \ingroup handles
+  /// \brief Count policy of `claws::shared_handle`s shared between threads.
+  ///
+  struct atomic_count
+  {
+    using counter_type = std::atomic<std::size_t>;
+
+    static void acquire(counter_type &counter) noexcept
+    {
+      counter.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    /// Returns `true` if the last owner let go
+    static bool release(counter_type &counter) noexcept
+    {
+      return counter.fetch_sub(1u, std::memory_order_acq_rel) == 1u;
+    }
+
+    static std::size_t count(counter_type const &counter) noexcept
+    {
+      return counter.load(std::memory_order_relaxed);
+    }
+  };
+
+  ///
+  /// \ingroup handles
+  /// \brief Count policy of `claws::shared_handle`s confined to one thread: plain increments and decrements.
+  ///
+  struct local_count
+  {
+    using counter_type = std::size_t;
+
+    static constexpr void acquire(counter_type &counter) noexcept
+    {
+      ++counter;
+    }
+
+    static constexpr bool release(counter_type &counter) noexcept
+    {
+      return !--counter;
+    }
+
+    static constexpr std::size_t count(counter_type const &counter) noexcept
+    {
+      return counter;
+    }
+  };
+
+  ///
+  /// \ingroup handles
+  /// \brief Base of objects counting their own `claws::shared_handle` owners.
+  ///
+  /// A `shared_handle<T *, deleter, count_policy>` to a `T` inheriting this base stores nothing but the pointer,
+  /// and can be rebuilt from a raw `T *` at any time.
+  /// Copying the object doesn't copy its count.
+  ///
+  template<class count_policy = atomic_count>
+  class shared_count_base
+  {
+  public:
+    /// Owner count, only meant for `claws::shared_handle`
+    mutable typename count_policy::counter_type shared_count{0u};
+
+    constexpr shared_count_base() noexcept = default;
+
+    constexpr shared_count_base(shared_count_base const &) noexcept
+    {}
+
+    constexpr shared_count_base &operator=(shared_count_base const &) noexcept
+    {
+      return *this;
+    }
+
+    ~shared_count_base() = default;
+  };
+
+  namespace impl
+  {
+    template<class type, class count_policy>
+    struct is_intrusively_counted : std::false_type
+    {};
+
+    template<class T, class count_policy>
+    struct is_intrusively_counted<T *, count_policy> : std::is_base_of<shared_count_base<count_policy>, T>
+    {};
+
+    ///
+    /// \brief The count lives in a block allocated with the value.
+    ///
+    template<class type, class count_policy, bool intrusive = is_intrusively_counted<type, count_policy>::value>
+    class shared_storage
+    {
+      struct block
+      {
+        typename count_policy::counter_type count;
+        type value;
+      };
+
+      block *shared{nullptr};
+
+    public:
+      static constexpr bool is_intrusive = false;
+
+      constexpr shared_storage() noexcept = default;
+
+      /// `value` is left untouched if the allocation throws
+      explicit shared_storage(type &&value)
+        : shared(new block{{1u}, std::move(value)})
+      {}
+
+      constexpr void swap_storage(shared_storage &other) noexcept
+      {
+        std::swap(shared, other.shared);
+      }
+
+      constexpr bool has_value() const noexcept
+      {
+        return shared != nullptr;
+      }
+
+      constexpr typename count_policy::counter_type &counter() const noexcept
+      {
+        return shared->count;
+      }
+
+      constexpr type &value() const noexcept
+      {
+        return shared->value;
+      }
+
+      /// Called after the deleter ran on the value
+      void delete_storage() noexcept
+      {
+        delete shared;
+      }
+
+      constexpr void detach() noexcept
+      {
+        shared = nullptr;
+      }
+    };
+
+    ///
+    /// \brief The count lives in the pointed-to object.
+    ///
+    template<class type, class count_policy>
+    class shared_storage<type, count_policy, true>
+    {
+      mutable type shared{nullptr};
+
+    public:
+      static constexpr bool is_intrusive = true;
+
+      constexpr shared_storage() noexcept = default;
+
+      explicit shared_storage(type &&value) noexcept
+        : shared(value)
+      {
+        if (shared)
+          count_policy::acquire(shared->shared_count);
+      }
+
+      constexpr void swap_storage(shared_storage &other) noexcept
+      {
+        std::swap(shared, other.shared);
+      }
+
+      constexpr bool has_value() const noexcept
+      {
+        return shared != nullptr;
+      }
+
+      constexpr typename count_policy::counter_type &counter() const noexcept
+      {
+        return shared->shared_count;
+      }
+
+      constexpr type &value() const noexcept
+      {
+        return shared;
+      }
+
+      constexpr void delete_storage() noexcept
+      {}
+
+      constexpr void detach() noexcept
+      {
+        shared = nullptr;
+      }
+    };
+  }
+
+  ///
+  /// \ingroup handles
+  /// \brief A RAII wrapper sharing ownership of a value of type `type`: the deleter runs when the last owner is destroyed.
+  ///
+  /// @tparam _type The stored value's type.
+  /// @tparam _deleter_type The deleter's type, inherited protectedly like `claws::handle`'s, and copied along with the handle.
+  /// @tparam _count_policy `claws::atomic_count` (default) or `claws::local_count` for handles that never leave their thread.
+  ///
+  /// The count is stored inline, in one allocation with the value, unless `type` is a pointer to a `claws::shared_count_base`,
+  /// in which case the count is intrusive and the handle is as small as the pointer.
+  ///
+  /// Unlike `std::shared_ptr` there is no separate control block and no atomic operation with `claws::local_count`.
+  ///
+  template<class _type, class _deleter_type, class _count_policy = atomic_count>
+  class shared_handle : protected _deleter_type, private impl::shared_storage<_type, _count_policy>
+  {
+    using storage = impl::shared_storage<_type, _count_policy>;
+
+  public:
+    using type = _type;
+    using deleter_type = _deleter_type;
+    using count_policy = _count_policy;
+
+  private:
+    void release() noexcept
+    {
+      if (this->has_value() && count_policy::release(this->counter()))
+        {
+          static_cast<deleter_type &>(*this)(std::move(this->value()));
+          this->delete_storage();
+        }
+    }
+
+    /// Takes ownership of `value`, deleting it if the count can't be allocated
+    static storage make_storage(deleter_type &deleter, type &&value)
+    {
+      if constexpr (storage::is_intrusive)
+        return storage(std::move(value));
+      else
+        {
+          try
+            {
+              return storage(std::move(value));
+            }
+          catch (...)
+            {
+              deleter(std::move(value));
+              throw;
+            }
+        }
+    }
+
+  public:
+    ///
+    /// \brief Default construction. Handle is empty.
+    ///
+    constexpr shared_handle() = default;
+
+    ///
+    /// \brief Moves the deleter and the value into the handle, which becomes its only owner.
+    ///
+    /// If the count can't be allocated, the value is deleted and `std::bad_alloc` is thrown.
+    ///
+    shared_handle(deleter_type &&deleter, type value)
+      : deleter_type(std::move(deleter))
+      , storage(make_storage(*this, std::move(value)))
+    {}
+
+    ///
+    /// \brief Default-constructs the deleter and moves the value into the handle.
+    ///
+    explicit shared_handle(type value)
+      : shared_handle(deleter_type{}, std::move(value))
+    {}
+
+    shared_handle(shared_handle const &other) noexcept(std::is_nothrow_copy_constructible_v<deleter_type>)
+      : deleter_type(static_cast<deleter_type const &>(other))
+      , storage()
+    {
+      if (other.has_value())
+        {
+          count_policy::acquire(other.counter());
+          static_cast<storage &>(*this) = static_cast<storage const &>(other);
+        }
+    }
+
+    shared_handle(shared_handle &&other) noexcept(std::is_nothrow_copy_constructible_v<deleter_type>)
+      : deleter_type(static_cast<deleter_type const &>(other))
+      , storage()
+    {
+      this->swap_storage(other);
+    }
+
+    shared_handle &operator=(shared_handle other) noexcept(std::is_nothrow_swappable_v<deleter_type>)
+    {
+      swap(*this, other);
+      return *this;
+    }
+
+    ~shared_handle()
+    {
+      release();
+    }
+
+    friend void swap(shared_handle &lh, shared_handle &rh) noexcept(std::is_nothrow_swappable_v<deleter_type>)
+    {
+      using std::swap;
+
+      swap(static_cast<deleter_type &>(lh), static_cast<deleter_type &>(rh));
+      lh.swap_storage(rh);
+    }
+
+    ///
+    /// \brief Lets go of the value, running the deleter if this was the last owner. Handle becomes empty.
+    ///
+    void reset() noexcept
+    {
+      release();
+      this->detach();
+    }
+
+    ///
+    /// \brief Returns the value. The handle must not be empty.
+    ///
+    constexpr type const &get() const noexcept
+    {
+      return this->value();
+    }
+
+    constexpr decltype(auto) operator*() const noexcept
+    {
+      if constexpr (std::is_pointer_v<type>)
+        return *this->value();
+      else
+        return static_cast<type const &>(this->value());
+    }
+
+    constexpr auto operator->() const noexcept
+    {
+      if constexpr (std::is_pointer_v<type>)
+        return this->value();
+      else
+        return &static_cast<type const &>(this->value());
+    }
+
+    ///
+    /// \brief Returns the number of owners, 0 if empty.
+    ///
+    std::size_t use_count() const noexcept
+    {
+      return this->has_value() ? count_policy::count(this->counter()) : 0u;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+      return this->has_value();
+    }
+
+    ///
+    /// \brief Returns a non-owning handle to the value, which must not outlive the owners. The handle must not be empty.
+    ///
+    constexpr handle<type, no_delete> borrow() const
+    {
+      return handle<type, no_delete>(get());
+    }
+
+    constexpr operator handle<type, no_delete>() const
+    {
+      return borrow();
+    }
+
+    constexpr deleter_type const &get_deleter() const noexcept
+    {
+      return static_cast<deleter_type const &>(*this);
+    }
+  };
+
+  ///
+  /// \ingroup handles
+  /// \brief Constructs a `T` in the same allocation as its count, as `std::make_shared` does.
+  ///
+  template<class T, class count_policy = atomic_count, class... args_type>
+  shared_handle<T, forget, count_policy> make_shared_handle(args_type &&... args)
+  {
+    return shared_handle<T, forget, count_policy>(forget{}, T(std::forward<args_type>(args)...));
+  }
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <claws/utils/cpu_features.hpp>
+
+#if defined(CLAWS_SIMD_X86)
+#include <immintrin.h>
+
+namespace claws
+{
+  ///
+  /// \brief Thin per instruction set wrappers over x86 intrinsics, generic over the lane type.
+  ///
+  /// Each wrapper provides:
+  /// - `vector`, the register type, and `mask`, the comparison result type
+  /// - `width` in bytes, `lanes`, the number of `lane`s in a vector, and `bits_per_lane`, how many mask bits a lane sets
+  /// - `full_mask`, the mask with every lane set
+  /// - `load`, `store`, `broadcast` and `eq`
+  /// - `min` and `max` when `has_minmax` is true
+  ///
+  /// Every member is compiled for its instruction set only, so must only be called from functions compiled for it,
+  /// after checking `claws::get_simd_tier()`.
+  ///
+  namespace simd
+  {
+    template<class lane>
+    struct sse2
+    {
+      static_assert(std::is_arithmetic_v<lane>, "simd lanes must be arithmetic types");
+
+      using vector = __m128i;
+      using mask = std::uint32_t;
+
+      static constexpr std::size_t width = 16;
+      static constexpr std::size_t lanes = width / sizeof(lane);
+      static constexpr unsigned bits_per_lane = sizeof(lane);
+      static constexpr mask full_mask = 0xFFFFu;
+      static constexpr bool has_minmax = std::is_integral_v<lane> && sizeof(lane) < 8;
+
+      CLAWS_TARGET_SSE2 static vector load(lane const *ptr) noexcept
+      {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr));
+      }
+
+      CLAWS_TARGET_SSE2 static void store(lane *ptr, vector value) noexcept
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr), value);
+      }
+
+      CLAWS_TARGET_SSE2 static vector broadcast(lane value) noexcept
+      {
+        lane values[lanes];
+
+        for (auto &elem : values)
+          elem = value;
+        return load(values);
+      }
+
+      CLAWS_TARGET_SSE2 static mask eq(vector lh, vector rh) noexcept
+      {
+        __m128i result;
+
+        if constexpr (std::is_same_v<lane, float>)
+          result = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(lh), _mm_castsi128_ps(rh)));
+        else if constexpr (std::is_same_v<lane, double>)
+          result = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(lh), _mm_castsi128_pd(rh)));
+        else if constexpr (sizeof(lane) == 1)
+          result = _mm_cmpeq_epi8(lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          result = _mm_cmpeq_epi16(lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          result = _mm_cmpeq_epi32(lh, rh);
+        else
+          {
+            // No 64 bits comparison in SSE2: both 32 bits halves must be equal
+            result = _mm_cmpeq_epi32(lh, rh);
+            result = _mm_and_si128(result, _mm_shuffle_epi32(result, _MM_SHUFFLE(2, 3, 0, 1)));
+          }
+        return static_cast<mask>(_mm_movemask_epi8(result));
+      }
+
+      CLAWS_TARGET_SSE2 static vector min(vector lh, vector rh) noexcept
+      {
+        return select(greater(lh, rh), rh, lh);
+      }
+
+      CLAWS_TARGET_SSE2 static vector max(vector lh, vector rh) noexcept
+      {
+        return select(greater(lh, rh), lh, rh);
+      }
+
+    private:
+      CLAWS_TARGET_SSE2 static vector select(vector condition, vector if_true, vector if_false) noexcept
+      {
+        return _mm_or_si128(_mm_and_si128(condition, if_true), _mm_andnot_si128(condition, if_false));
+      }
+
+      CLAWS_TARGET_SSE2 static vector greater(vector lh, vector rh) noexcept
+      {
+        static_assert(has_minmax, "no SSE2 comparison for this lane type");
+        if constexpr (std::is_unsigned_v<lane>)
+          {
+            // Flipping the sign bit maps unsigned order onto signed order
+            using signed_lane = std::make_signed_t<lane>;
+            vector const sign = broadcast(static_cast<lane>(lane(1) << (sizeof(lane) * 8 - 1)));
+
+            return sse2<signed_lane>::greater_signed(_mm_xor_si128(lh, sign), _mm_xor_si128(rh, sign));
+          }
+        else
+          return greater_signed(lh, rh);
+      }
+
+      CLAWS_TARGET_SSE2 static vector greater_signed(vector lh, vector rh) noexcept
+      {
+        if constexpr (sizeof(lane) == 1)
+          return _mm_cmpgt_epi8(lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          return _mm_cmpgt_epi16(lh, rh);
+        else
+          return _mm_cmpgt_epi32(lh, rh);
+      }
+
+      template<class other_lane>
+      friend struct sse2;
+    };
+
+    template<class lane>
+    struct avx2
+    {
+      static_assert(std::is_arithmetic_v<lane>, "simd lanes must be arithmetic types");
+
+      using vector = __m256i;
+      using mask = std::uint32_t;
+
+      static constexpr std::size_t width = 32;
+      static constexpr std::size_t lanes = width / sizeof(lane);
+      static constexpr unsigned bits_per_lane = sizeof(lane);
+      static constexpr mask full_mask = 0xFFFFFFFFu;
+      static constexpr bool has_minmax = std::is_integral_v<lane>;
+
+      CLAWS_TARGET_AVX2 static vector load(lane const *ptr) noexcept
+      {
+        return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(ptr));
+      }
+
+      CLAWS_TARGET_AVX2 static void store(lane *ptr, vector value) noexcept
+      {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr), value);
+      }
+
+      CLAWS_TARGET_AVX2 static vector broadcast(lane value) noexcept
+      {
+        lane values[lanes];
+
+        for (auto &elem : values)
+          elem = value;
+        return load(values);
+      }
+
+      CLAWS_TARGET_AVX2 static mask eq(vector lh, vector rh) noexcept
+      {
+        __m256i result;
+
+        if constexpr (std::is_same_v<lane, float>)
+          result = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(lh), _mm256_castsi256_ps(rh), _CMP_EQ_OQ));
+        else if constexpr (std::is_same_v<lane, double>)
+          result = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(lh), _mm256_castsi256_pd(rh), _CMP_EQ_OQ));
+        else if constexpr (sizeof(lane) == 1)
+          result = _mm256_cmpeq_epi8(lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          result = _mm256_cmpeq_epi16(lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          result = _mm256_cmpeq_epi32(lh, rh);
+        else
+          result = _mm256_cmpeq_epi64(lh, rh);
+        return static_cast<mask>(_mm256_movemask_epi8(result));
+      }
+
+      CLAWS_TARGET_AVX2 static vector min(vector lh, vector rh) noexcept
+      {
+        static_assert(has_minmax, "no AVX2 min for this lane type");
+        constexpr bool is_signed = std::is_signed_v<lane>;
+
+        if constexpr (sizeof(lane) == 1)
+          return is_signed ? _mm256_min_epi8(lh, rh) : _mm256_min_epu8(lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          return is_signed ? _mm256_min_epi16(lh, rh) : _mm256_min_epu16(lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          return is_signed ? _mm256_min_epi32(lh, rh) : _mm256_min_epu32(lh, rh);
+        else
+          return _mm256_blendv_epi8(lh, rh, greater64(lh, rh));
+      }
+
+      CLAWS_TARGET_AVX2 static vector max(vector lh, vector rh) noexcept
+      {
+        static_assert(has_minmax, "no AVX2 max for this lane type");
+        constexpr bool is_signed = std::is_signed_v<lane>;
+
+        if constexpr (sizeof(lane) == 1)
+          return is_signed ? _mm256_max_epi8(lh, rh) : _mm256_max_epu8(lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          return is_signed ? _mm256_max_epi16(lh, rh) : _mm256_max_epu16(lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          return is_signed ? _mm256_max_epi32(lh, rh) : _mm256_max_epu32(lh, rh);
+        else
+          return _mm256_blendv_epi8(rh, lh, greater64(lh, rh));
+      }
+
+    private:
+      CLAWS_TARGET_AVX2 static vector greater64(vector lh, vector rh) noexcept
+      {
+        if constexpr (std::is_unsigned_v<lane>)
+          {
+            vector const sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(lh, sign), _mm256_xor_si256(rh, sign));
+          }
+        else
+          return _mm256_cmpgt_epi64(lh, rh);
+      }
+    };
+
+    /// Comparisons produce a mask register, so every lane sets a single mask bit
+    template<class lane>
+    struct avx512
+    {
+      static_assert(std::is_arithmetic_v<lane>, "simd lanes must be arithmetic types");
+
+      using vector = __m512i;
+      using mask = std::uint64_t;
+
+      static constexpr std::size_t width = 64;
+      static constexpr std::size_t lanes = width / sizeof(lane);
+      static constexpr unsigned bits_per_lane = 1;
+      static constexpr mask full_mask = lanes == 64 ? ~mask(0) : (mask(1) << lanes) - 1;
+      static constexpr bool has_minmax = std::is_integral_v<lane>;
+
+      CLAWS_TARGET_AVX512 static vector load(lane const *ptr) noexcept
+      {
+        return _mm512_loadu_si512(ptr);
+      }
+
+      CLAWS_TARGET_AVX512 static void store(lane *ptr, vector value) noexcept
+      {
+        _mm512_storeu_si512(ptr, value);
+      }
+
+      CLAWS_TARGET_AVX512 static vector broadcast(lane value) noexcept
+      {
+        lane values[lanes];
+
+        for (auto &elem : values)
+          elem = value;
+        return load(values);
+      }
+
+      CLAWS_TARGET_AVX512 static mask eq(vector lh, vector rh) noexcept
+      {
+        if constexpr (std::is_same_v<lane, float>)
+          return _mm512_cmp_ps_mask(_mm512_castsi512_ps(lh), _mm512_castsi512_ps(rh), _CMP_EQ_OQ);
+        else if constexpr (std::is_same_v<lane, double>)
+          return _mm512_cmp_pd_mask(_mm512_castsi512_pd(lh), _mm512_castsi512_pd(rh), _CMP_EQ_OQ);
+        else if constexpr (sizeof(lane) == 1)
+          return _mm512_cmpeq_epi8_mask(lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          return _mm512_cmpeq_epi16_mask(lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          return _mm512_cmpeq_epi32_mask(lh, rh);
+        else
+          return _mm512_cmpeq_epi64_mask(lh, rh);
+      }
+
+      CLAWS_TARGET_AVX512 static vector min(vector lh, vector rh) noexcept
+      {
+        static_assert(has_minmax, "no AVX-512 min for this lane type");
+        constexpr bool is_signed = std::is_signed_v<lane>;
+
+        if constexpr (sizeof(lane) == 1)
+          return is_signed ? _mm512_maskz_min_epi8(all_lanes(), lh, rh) : _mm512_maskz_min_epu8(all_lanes(), lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          return is_signed ? _mm512_maskz_min_epi16(all_lanes(), lh, rh) : _mm512_maskz_min_epu16(all_lanes(), lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          return is_signed ? _mm512_maskz_min_epi32(all_lanes(), lh, rh) : _mm512_maskz_min_epu32(all_lanes(), lh, rh);
+        else
+          return is_signed ? _mm512_maskz_min_epi64(all_lanes(), lh, rh) : _mm512_maskz_min_epu64(all_lanes(), lh, rh);
+      }
+
+      CLAWS_TARGET_AVX512 static vector max(vector lh, vector rh) noexcept
+      {
+        static_assert(has_minmax, "no AVX-512 max for this lane type");
+        constexpr bool is_signed = std::is_signed_v<lane>;
+
+        if constexpr (sizeof(lane) == 1)
+          return is_signed ? _mm512_maskz_max_epi8(all_lanes(), lh, rh) : _mm512_maskz_max_epu8(all_lanes(), lh, rh);
+        else if constexpr (sizeof(lane) == 2)
+          return is_signed ? _mm512_maskz_max_epi16(all_lanes(), lh, rh) : _mm512_maskz_max_epu16(all_lanes(), lh, rh);
+        else if constexpr (sizeof(lane) == 4)
+          return is_signed ? _mm512_maskz_max_epi32(all_lanes(), lh, rh) : _mm512_maskz_max_epu32(all_lanes(), lh, rh);
+        else
+          return is_signed ? _mm512_maskz_max_epi64(all_lanes(), lh, rh) : _mm512_maskz_max_epu64(all_lanes(), lh, rh);
+      }
+
+    private:
+      // Zero-masking forms with every lane selected: the unmasked ones trip GCC's -Wmaybe-uninitialized on `_mm512_undefined_*`
+      static constexpr auto all_lanes() noexcept
+      {
+        if constexpr (lanes == 64)
+          return static_cast<__mmask64>(full_mask);
+        else if constexpr (lanes == 32)
+          return static_cast<__mmask32>(full_mask);
+        else if constexpr (lanes == 16)
+          return static_cast<__mmask16>(full_mask);
+        else
+          return static_cast<__mmask8>(full_mask);
+      }
+    };
+  }
+}
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace claws
+{
+  ///
+  /// \brief Whether moving a `T` to a new address and destroying the original amounts to copying its bytes.
+  ///
+  /// True for trivially copyable types, and `std::unique_ptr`s with such deleters.
+  /// Specialise it for types which hold no pointer to themselves, nor are pointed to by anything they own,
+  /// so containers growing or moving their storage `memcpy` them instead of moving and destroying them one by one.
+  ///
+  /// Many standard types aren't: libstdc++'s `std::string` points into itself for short strings.
+  ///
+  template<class T>
+  struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+  {};
+
+  template<class T, class deleter_type>
+  struct is_trivially_relocatable<std::unique_ptr<T, deleter_type>> : is_trivially_relocatable<deleter_type>
+  {};
+
+  template<class T>
+  inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+  ///
+  /// \brief Moves `count` values from `source` to the uninitialised `destination`, and destroys the sources. The ranges must not overlap.
+  ///
+  /// Copies bytes if `T` is trivially relocatable.
+  /// Otherwise, if a move (or copy, for types whose move may throw) throws, the values already constructed at `destination` are destroyed,
+  /// and `source` is left untouched.
+  ///
+  template<class T>
+  void relocate(T *source, std::size_t count, T *destination) noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+  {
+    if constexpr (is_trivially_relocatable_v<T>)
+      {
+        if (count)
+          std::memcpy(static_cast<void *>(destination), static_cast<void const *>(source), count * sizeof(T));
+      }
+    else if constexpr (std::is_nothrow_move_constructible_v<T>)
+      {
+        for (std::size_t i(0u); i != count; ++i)
+          {
+            new (destination + i) T(std::move(source[i]));
+            source[i].~T();
+          }
+      }
+    else
+      {
+        std::size_t i(0u);
+
+        try
+          {
+            for (; i != count; ++i)
+              new (destination + i) T(std::move_if_noexcept(source[i]));
+          }
+        catch (...)
+          {
+            while (i--)
+              destination[i].~T();
+            throw;
+          }
+        for (i = 0u; i != count; ++i)
+          source[i].~T();
+      }
+  }
+}
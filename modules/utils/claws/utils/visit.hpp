@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace claws
+{
+  namespace impl
+  {
+    template<class variant_type>
+    inline constexpr std::size_t variant_size_of = std::variant_size_v<std::remove_cv_t<std::remove_reference_t<variant_type>>>;
+
+    /// `std::get`, telling the compiler the index was already checked, so it doesn't check it again
+    template<std::size_t alternative, class variant_type>
+    constexpr decltype(auto) get_checked(variant_type &&variant) noexcept
+    {
+#if defined(__GNUC__)
+      if (variant.index() != alternative)
+        __builtin_unreachable();
+#elif defined(_MSC_VER)
+      __assume(variant.index() == alternative);
+#endif
+      return std::get<alternative>(std::forward<variant_type>(variant));
+    }
+
+    ///
+    /// \brief Dispatches a visitor over the combination of the variants' alternatives.
+    ///
+    /// Combinations are numbered in mixed radix, the first variant's index being the most significant digit:
+    /// one switch or one table lookup finds the combination, however many variants there are.
+    ///
+    template<class visitor_type, class... variant_types>
+    struct visit_dispatch
+    {
+      static constexpr std::size_t variant_count = sizeof...(variant_types);
+      static constexpr std::array<std::size_t, variant_count> sizes{variant_size_of<variant_types>...};
+      static constexpr std::size_t combination_count = (variant_size_of<variant_types> * ... * 1u);
+
+      using result_type = decltype(std::declval<visitor_type>()(std::get<0>(std::declval<variant_types>())...));
+      using function_type = result_type (*)(visitor_type &&, variant_types &&...);
+
+      /// Index of the alternative of variant `variant` in combination `combination`
+      static constexpr std::size_t alternative(std::size_t combination, std::size_t variant) noexcept
+      {
+        for (auto i(variant + 1u); i != variant_count; ++i)
+          combination /= sizes[i];
+        return combination % sizes[variant];
+      }
+
+      template<std::size_t combination, std::size_t... variant_indices>
+      static constexpr result_type invoke(std::index_sequence<variant_indices...>, visitor_type &&visitor, variant_types &&... variants)
+      {
+        // Called directly rather than through `std::invoke`, which isn't `constexpr` before C++20
+        using invoked_type = decltype(std::forward<visitor_type>(visitor)(get_checked<alternative(combination, variant_indices)>(std::forward<variant_types>(variants))...));
+
+        static_assert(std::is_same_v<invoked_type, result_type>, "the visitor must return the same type for every alternative");
+        return std::forward<visitor_type>(visitor)(get_checked<alternative(combination, variant_indices)>(std::forward<variant_types>(variants))...);
+      }
+
+      template<std::size_t combination>
+      static constexpr result_type invoke_combination(visitor_type &&visitor, variant_types &&... variants)
+      {
+        return invoke<combination>(std::index_sequence_for<variant_types...>{}, std::forward<visitor_type>(visitor), std::forward<variant_types>(variants)...);
+      }
+
+      template<std::size_t... combinations>
+      static constexpr std::array<function_type, combination_count> make_table(std::index_sequence<combinations...>) noexcept
+      {
+        return {{&invoke_combination<combinations>...}};
+      }
+
+      static constexpr std::array<function_type, combination_count> table = make_table(std::make_index_sequence<combination_count>{});
+    };
+
+    /// Calls `visitor` with the values of `grouped[offsets[alternative]]` to `grouped[offsets[alternative + 1]]`, which hold `alternative`
+    template<std::size_t alternative, class visitor_type, class variant_type, std::size_t offset_count>
+    void visit_group(visitor_type &visitor, variant_type *const *grouped, std::array<std::size_t, offset_count> const &offsets)
+    {
+      for (auto i(offsets[alternative]); i != offsets[alternative + 1u]; ++i)
+        visitor(get_checked<alternative>(*grouped[i]));
+    }
+
+    template<class visitor_type, class variant_type, std::size_t offset_count, std::size_t... alternatives>
+    void visit_groups(visitor_type &visitor,
+                      variant_type *const *grouped,
+                      std::array<std::size_t, offset_count> const &offsets,
+                      std::index_sequence<alternatives...>)
+    {
+      (visit_group<alternatives>(visitor, grouped, offsets), ...);
+    }
+
+    /// Visitors over fewer combinations get a switch, which compilers turn into a jump table with the call inlined in each case
+    inline constexpr std::size_t visit_switch_size = 16u;
+  }
+
+  ///
+  /// \brief Calls `visitor` with the values held by `variants`, like `std::visit`.
+  ///
+  /// \param visitor typically a `claws::lambda_ops` overload set, like `handle_ping + handle_data + handle_close`
+  ///
+  /// Up to 16 combinations of alternatives, dispatches with a `switch`, letting the compiler inline the visitor in each case.
+  /// Past that, calls through a flat table of function pointers, indexed by all the variants' indices at once,
+  /// where `std::visit` implementations may go through one table per variant.
+  ///
+  /// The visitor must return the same type for every combination.
+  /// Throws `std::bad_variant_access` if a variant is valueless.
+  ///
+  template<class visitor_type, class... variant_types>
+  constexpr decltype(auto) visit(visitor_type &&visitor, variant_types &&... variants)
+  {
+    using dispatch = impl::visit_dispatch<visitor_type, variant_types...>;
+
+    if ((variants.valueless_by_exception() || ...))
+      throw std::bad_variant_access();
+
+    std::size_t combination(0u);
+
+    ((combination = combination * impl::variant_size_of<variant_types> + variants.index()), ...);
+    if constexpr (dispatch::combination_count <= impl::visit_switch_size)
+      {
+#define CLAWS_VISIT_CASE(COMBINATION)                                                                                                            \
+  case COMBINATION:                                                                                                                              \
+    if constexpr (COMBINATION < dispatch::combination_count)                                                                                     \
+      return dispatch::template invoke_combination<COMBINATION>(std::forward<visitor_type>(visitor), std::forward<variant_types>(variants)...); \
+    else                                                                                                                                         \
+      break;
+
+        switch (combination)
+          {
+            CLAWS_VISIT_CASE(0)
+            CLAWS_VISIT_CASE(1)
+            CLAWS_VISIT_CASE(2)
+            CLAWS_VISIT_CASE(3)
+            CLAWS_VISIT_CASE(4)
+            CLAWS_VISIT_CASE(5)
+            CLAWS_VISIT_CASE(6)
+            CLAWS_VISIT_CASE(7)
+            CLAWS_VISIT_CASE(8)
+            CLAWS_VISIT_CASE(9)
+            CLAWS_VISIT_CASE(10)
+            CLAWS_VISIT_CASE(11)
+            CLAWS_VISIT_CASE(12)
+            CLAWS_VISIT_CASE(13)
+            CLAWS_VISIT_CASE(14)
+            CLAWS_VISIT_CASE(15)
+          }
+#undef CLAWS_VISIT_CASE
+        // Every valid combination returned above
+#if defined(__GNUC__)
+        __builtin_unreachable();
+#elif defined(_MSC_VER)
+        __assume(false);
+#endif
+      }
+    else
+      return dispatch::table[combination](std::forward<visitor_type>(visitor), std::forward<variant_types>(variants)...);
+  }
+
+  ///
+  /// \brief Calls `visitor` with the value of each variant in [`begin`, `end`), grouped by alternative rather than in order.
+  ///
+  /// Variants are first bucketed by index, then each alternative's values are visited in a loop calling the visitor directly:
+  /// instead of one unpredictable indirect branch per variant, branches are only mispredicted when moving to the next alternative.
+  /// Within an alternative, values are visited in order. Uses a temporary buffer of one pointer per variant.
+  ///
+  /// Throws `std::bad_variant_access` before visiting anything if a variant is valueless.
+  ///
+  template<class visitor_type, class iterator_type>
+  void visit_grouped(visitor_type &&visitor, iterator_type begin, iterator_type end)
+  {
+    using variant_type = std::remove_reference_t<decltype(*begin)>;
+    constexpr std::size_t alternative_count = impl::variant_size_of<variant_type>;
+
+    std::array<std::size_t, alternative_count + 1u> offsets{};
+
+    for (auto it = begin; it != end; ++it)
+      {
+        if (it->valueless_by_exception())
+          throw std::bad_variant_access();
+        ++offsets[it->index() + 1u];
+      }
+    for (std::size_t i(1u); i != offsets.size(); ++i)
+      offsets[i] += offsets[i - 1u];
+
+    std::vector<variant_type *> grouped(offsets.back());
+    auto positions = offsets;
+
+    for (auto it = begin; it != end; ++it)
+      grouped[positions[it->index()]++] = std::addressof(*it);
+
+    impl::visit_groups(visitor, grouped.data(), offsets, std::make_index_sequence<alternative_count>{});
+  }
+}
@@ -0,0 +1,126 @@
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <claws/algorithm/constexpr_algorithm.hpp>
+
+namespace
+{
+  constexpr int constexpr_copy_sum()
+  {
+    int src[4] = {1, 2, 3, 4};
+    int dst[4] = {};
+
+    claws::copy(src, src + 4, dst);
+    claws::copy_n(src, 2, dst + 2);
+    return dst[0] + dst[1] + dst[2] + dst[3];
+  }
+
+  constexpr int constexpr_fill_sum()
+  {
+    int dst[5] = {};
+
+    claws::fill(dst, dst + 5, 3);
+    claws::fill_n(dst, 2, 1);
+    return dst[0] + dst[1] + dst[2] + dst[3] + dst[4];
+  }
+
+  struct pair16
+  {
+    std::uint64_t first;
+    std::uint64_t second;
+  };
+}
+
+TEST(constexpr_algorithm, constexpr_correctness)
+{
+  static_assert(constexpr_copy_sum() == 1 + 2 + 1 + 2);
+  static_assert(constexpr_fill_sum() == 1 + 1 + 3 + 3 + 3);
+}
+
+TEST(constexpr_algorithm, bitwise_dispatch_traits)
+{
+  static_assert(claws::impl::is_bitwise_copyable<int const *, int *, false>());
+  static_assert(!claws::impl::is_bitwise_copyable<int const *, long *, false>());
+  static_assert(!claws::impl::is_bitwise_copyable<std::string *, std::string *, false>());
+  static_assert(claws::impl::is_bitwise_copyable<std::vector<int>::const_iterator, int *, false>());
+  static_assert(!claws::impl::is_bitwise_copyable<std::list<int>::iterator, int *, false>());
+  static_assert(!claws::impl::is_bitwise_copyable<std::vector<bool>::iterator, bool *, false>());
+  static_assert(claws::impl::is_bitwise_fillable<double *, int>());
+  static_assert(!claws::impl::is_bitwise_fillable<int const *, int>());
+}
+
+TEST(constexpr_algorithm, copy_overlapping)
+{
+  std::vector<int> data{0, 1, 2, 3, 4, 5, 6, 7};
+
+  auto end = claws::copy(data.data() + 2, data.data() + 8, data.data());
+  ASSERT_EQ(end, data.data() + 6);
+  ASSERT_EQ(data, (std::vector<int>{2, 3, 4, 5, 6, 7, 6, 7}));
+}
+
+TEST(constexpr_algorithm, copy_large)
+{
+  std::vector<std::uint32_t> src((claws::impl::non_temporal_threshold / sizeof(std::uint32_t)) + 37);
+  std::vector<std::uint32_t> dst(src.size() + 1);
+
+  for (std::size_t i(0u); i != src.size(); ++i)
+    src[i] = static_cast<std::uint32_t>(i * 2654435761u);
+
+  // offset destination to exercise the unaligned head
+  auto end = claws::copy(src.data(), src.data() + src.size(), dst.data() + 1);
+  ASSERT_EQ(end, dst.data() + dst.size());
+  ASSERT_TRUE(std::equal(src.begin(), src.end(), dst.begin() + 1));
+
+  std::vector<std::uint32_t> moved(src.size());
+  claws::move(src.data(), src.data() + src.size(), moved.data());
+  ASSERT_EQ(moved, src);
+}
+
+TEST(constexpr_algorithm, copy_non_trivial)
+{
+  std::vector<std::string> src{"a", "bb", "ccc"};
+  std::vector<std::string> dst(3);
+
+  claws::copy_n(src.begin(), 3, dst.begin());
+  ASSERT_EQ(dst, src);
+  claws::move(src.begin(), src.end(), dst.begin());
+  ASSERT_EQ(dst, (std::vector<std::string>{"a", "bb", "ccc"}));
+}
+
+TEST(constexpr_algorithm, copy_output_iterators)
+{
+  std::vector<int> const src{1, 2, 3};
+  std::vector<int> dst;
+  std::ostringstream out;
+
+  static_assert(!claws::is_contiguous_iterator_v<std::back_insert_iterator<std::vector<int>>>);
+  static_assert(!claws::is_contiguous_iterator_v<std::ostream_iterator<int>>);
+  claws::copy(src.begin(), src.end(), std::back_inserter(dst));
+  ASSERT_EQ(dst, src);
+  claws::copy(src.begin(), src.end(), std::ostream_iterator<int>(out, " "));
+  ASSERT_EQ(out.str(), "1 2 3 ");
+}
+
+TEST(constexpr_algorithm, fill)
+{
+  std::vector<std::uint16_t> small(33);
+
+  claws::fill(small.data(), small.data() + small.size(), std::uint16_t(0x1234));
+  for (auto value : small)
+    ASSERT_EQ(value, 0x1234);
+  claws::fill_n(small.data(), small.size(), 0);
+  for (auto value : small)
+    ASSERT_EQ(value, 0);
+
+  std::vector<pair16> large(claws::impl::non_temporal_threshold / sizeof(pair16) + 3);
+  pair16 const pattern{1u, 2u};
+
+  ASSERT_EQ(claws::fill_n(large.data() + 1, large.size() - 1, pattern), large.data() + large.size());
+  ASSERT_EQ(large[0].first, 0u);
+  for (std::size_t i(1u); i != large.size(); ++i)
+    ASSERT_TRUE(large[i].first == 1u && large[i].second == 2u);
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/algorithm/search.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace
+{
+  constexpr bool constexpr_search_works()
+  {
+    int data[6] = {4, 1, 3, 1, 9, 0};
+
+    return claws::find(data, data + 6, 3) == data + 2 && claws::count(data, data + 6, 1) == 2
+      && claws::find_if_eq_any(data, data + 6, {9, 0}) == data + 4 && claws::minmax_element(data, data + 6).first == data + 5
+      && claws::mismatch(data, data + 6, data).first == data + 6;
+  }
+
+  template<class T>
+  std::vector<T> make_values(std::size_t size, unsigned seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::vector<T> result(size);
+
+    for (auto &value : result)
+      value = static_cast<T>(engine() % 23u) - static_cast<T>(std::is_signed_v<T> ? 11 : 0);
+    return result;
+  }
+
+  template<class T>
+  void check_against_std()
+  {
+    for (std::size_t size : {0u, 1u, 7u, 16u, 31u, 32u, 33u, 64u, 100u, 1000u})
+      {
+        auto const values = make_values<T>(size, static_cast<unsigned>(size));
+
+        for (int needle = -12; needle < 24; needle += 5)
+          {
+            auto const value = static_cast<T>(needle);
+
+            ASSERT_EQ(claws::find(values.begin(), values.end(), value), std::find(values.begin(), values.end(), value));
+            ASSERT_EQ(claws::count(values.begin(), values.end(), value), std::count(values.begin(), values.end(), value));
+
+            T const needles[] = {value, static_cast<T>(value + 3), static_cast<T>(value + 7)};
+
+            ASSERT_EQ(claws::find_if_eq_any(values.begin(), values.end(), std::begin(needles), std::end(needles)),
+                      std::find_first_of(values.begin(), values.end(), std::begin(needles), std::end(needles)));
+          }
+        ASSERT_EQ(claws::minmax_element(values.begin(), values.end()), std::minmax_element(values.begin(), values.end()));
+
+        auto other = values;
+
+        for (std::size_t i(0u); i < size; i += 13)
+          {
+            other[i] = static_cast<T>(other[i] + 1);
+            ASSERT_EQ(claws::mismatch(values.begin(), values.end(), other.begin()), std::mismatch(values.begin(), values.end(), other.begin()));
+            other[i] = values[i];
+          }
+        ASSERT_EQ(claws::mismatch(values.begin(), values.end(), other.begin()).first, values.end());
+      }
+  }
+
+  void check_every_type_against_std()
+  {
+    check_against_std<std::int8_t>();
+    check_against_std<std::uint8_t>();
+    check_against_std<std::int16_t>();
+    check_against_std<std::uint16_t>();
+    check_against_std<std::int32_t>();
+    check_against_std<std::uint32_t>();
+    check_against_std<std::int64_t>();
+    check_against_std<std::uint64_t>();
+    check_against_std<float>();
+    check_against_std<double>();
+  }
+
+  struct id_tag;
+  using id = claws::tagged_data<std::uint32_t, std::int32_t, id_tag>;
+}
+
+TEST(search, constexpr_correctness)
+{
+  static_assert(constexpr_search_works());
+}
+
+TEST(search, matches_std)
+{
+  check_every_type_against_std();
+}
+
+TEST(search, forced_tiers)
+{
+  auto const initial = claws::get_simd_tier();
+
+  for (auto tier : {claws::simd_tier::scalar, claws::simd_tier::sse2, claws::simd_tier::avx2, claws::simd_tier::avx512})
+    {
+      if (tier > claws::get_max_simd_tier())
+        break;
+      ASSERT_EQ(claws::set_simd_tier(tier), tier);
+      check_every_type_against_std();
+    }
+  claws::set_simd_tier(initial);
+}
+
+TEST(search, mixed_needle_types)
+{
+  std::vector<std::uint8_t> bytes{1, 2, 255, 4};
+
+  ASSERT_EQ(claws::find(bytes.begin(), bytes.end(), 255), bytes.begin() + 2);
+  ASSERT_EQ(claws::find(bytes.begin(), bytes.end(), 255 + 256), bytes.end());
+  ASSERT_EQ(claws::find(bytes.begin(), bytes.end(), -1), bytes.end());
+
+  std::vector<std::int32_t> ints(40, -1);
+
+  ASSERT_EQ(claws::count(ints.begin(), ints.end(), std::int64_t(-1)), 40);
+  ASSERT_EQ(claws::count(ints.begin(), ints.end(), std::int64_t(0xFFFFFFFFu)), 0);
+}
+
+TEST(search, extreme_values)
+{
+  std::vector<std::int64_t> values(100, 0);
+
+  values[17] = std::numeric_limits<std::int64_t>::min();
+  values[80] = std::numeric_limits<std::int64_t>::max();
+  values[90] = std::numeric_limits<std::int64_t>::max();
+  ASSERT_EQ(claws::minmax_element(values.begin(), values.end()), std::make_pair(values.begin() + 17, values.begin() + 90));
+
+  std::vector<std::uint32_t> unsigned_values(50, 1u << 31);
+
+  unsigned_values[3] = 0xFFFFFFFFu;
+  unsigned_values[4] = 0u;
+  ASSERT_EQ(claws::minmax_element(unsigned_values.begin(), unsigned_values.end()), std::make_pair(unsigned_values.begin() + 4, unsigned_values.begin() + 3));
+}
+
+TEST(search, tagged_data)
+{
+  std::vector<id> ids;
+
+  for (std::uint32_t i = 0; i < 100; ++i)
+    ids.emplace_back(i % 10u);
+  ASSERT_EQ(claws::find(ids.begin(), ids.end(), id(7u)), ids.begin() + 7);
+  ASSERT_EQ(claws::count(ids.begin(), ids.end(), id(3u)), 10);
+  ASSERT_EQ(claws::find_if_eq_any(ids.begin(), ids.end(), {id(42u), id(5u)}), ids.begin() + 5);
+
+  auto const [min, max] = claws::minmax_element(ids.begin(), ids.end());
+  ASSERT_EQ(min, ids.begin());
+  ASSERT_EQ(max, ids.begin() + 99);
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/algorithm/sort.hpp>
+#include <claws/algorithm/radix_sort.hpp>
+#include <claws/utils/tagged_data.hpp>
+
+namespace
+{
+  constexpr bool constexpr_sort_works()
+  {
+    int data[40] = {};
+
+    for (int i = 0; i < 40; ++i)
+      data[i] = (i * 17) % 40;
+    claws::sort(data, data + 40);
+    for (int i = 0; i < 40; ++i)
+      if (data[i] != i)
+        return false;
+    claws::sort(data, data + 40, std::greater<>{});
+    return claws::is_sorted(data, data + 40, std::greater<>{});
+  }
+
+  std::vector<std::uint64_t> make_inputs(std::size_t size, int pattern)
+  {
+    std::mt19937_64 engine(42);
+    std::vector<std::uint64_t> result(size);
+
+    for (std::size_t i(0u); i != size; ++i)
+      switch (pattern)
+        {
+        case 0:
+          result[i] = engine();
+          break;
+        case 1:
+          result[i] = i;
+          break;
+        case 2:
+          result[i] = size - i;
+          break;
+        case 3:
+          result[i] = engine() % 4u;
+          break;
+        default:
+          result[i] = (i % 2) ? i : size - i; // organ pipe-ish
+        }
+    return result;
+  }
+
+  struct index_tag;
+  using node_index = claws::tagged_data<std::uint32_t, std::int32_t, index_tag>;
+}
+
+TEST(sort, constexpr_correctness)
+{
+  static_assert(constexpr_sort_works());
+}
+
+TEST(sort, patterns)
+{
+  for (std::size_t size : {0u, 1u, 2u, 23u, 24u, 129u, 1000u, 100000u})
+    for (int pattern = 0; pattern < 5; ++pattern)
+      {
+        auto data = make_inputs(size, pattern);
+        auto expected = data;
+
+        std::sort(expected.begin(), expected.end());
+        claws::sort(data.begin(), data.end());
+        ASSERT_EQ(data, expected) << "size " << size << " pattern " << pattern;
+      }
+}
+
+TEST(sort, non_trivial_values)
+{
+  std::vector<std::string> data;
+
+  for (int i = 0; i < 500; ++i)
+    data.push_back(std::to_string((i * 7919) % 503));
+
+  auto expected = data;
+
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+  claws::sort(data.begin(), data.end(), std::greater<>{});
+  ASSERT_EQ(data, expected);
+}
+
+TEST(sort, heap_sort)
+{
+  auto data = make_inputs(1000, 0);
+  auto expected = data;
+
+  std::sort(expected.begin(), expected.end());
+  claws::heap_sort(data.begin(), data.end());
+  ASSERT_EQ(data, expected);
+}
+
+TEST(radix_sort, integers)
+{
+  std::mt19937 engine(7);
+  std::vector<std::int32_t> data(5000);
+
+  for (auto &value : data)
+    value = static_cast<std::int32_t>(engine());
+  data[0] = std::numeric_limits<std::int32_t>::min();
+  data[1] = std::numeric_limits<std::int32_t>::max();
+
+  auto expected = data;
+
+  std::sort(expected.begin(), expected.end());
+  claws::radix_sort(data.begin(), data.end());
+  ASSERT_EQ(data, expected);
+
+  auto wide = make_inputs(3000, 0);
+  auto wide_expected = wide;
+
+  std::sort(wide_expected.begin(), wide_expected.end());
+  claws::radix_sort(wide.data(), wide.data() + wide.size());
+  ASSERT_EQ(wide, wide_expected);
+}
+
+TEST(radix_sort, floating_point)
+{
+  std::vector<float> data{3.5f, -1.f, 0.f, -0.f, -std::numeric_limits<float>::infinity(), 1e-30f, -2.5e10f, std::numeric_limits<float>::infinity()};
+
+  for (int i = 0; i < 200; ++i)
+    data.push_back(static_cast<float>((i * 37) % 101) - 50.25f);
+
+  auto expected = data;
+
+  std::stable_sort(expected.begin(), expected.end());
+  claws::radix_sort(data.begin(), data.end());
+  ASSERT_EQ(data, expected);
+}
+
+TEST(radix_sort, tagged_data_with_payload)
+{
+  std::vector<node_index> keys;
+  std::vector<std::string> payload;
+
+  for (std::uint32_t i = 0; i < 1000; ++i)
+    {
+      keys.emplace_back((i * 7u) % 100u);
+      payload.push_back(std::to_string(i));
+    }
+  claws::radix_sort(keys.begin(), keys.end(), payload.begin());
+  for (std::size_t i(1u); i < keys.size(); ++i)
+    {
+      ASSERT_LE(keys[i - 1].data, keys[i].data);
+      ASSERT_EQ((std::stoul(payload[i]) * 7u) % 100u, keys[i].data);
+      // stability: payloads of equal keys keep their relative order
+      if (keys[i - 1] == keys[i])
+        {
+          ASSERT_LT(std::stoul(payload[i - 1]), std::stoul(payload[i]));
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/concurrent_hash_map.hpp>
+
+TEST(concurrent_hash_map, basic)
+{
+  claws::concurrent_hash_map<std::string, int> map(5u);
+
+  ASSERT_EQ(map.get_shard_count(), 8u);
+  ASSERT_TRUE(map.insert("one", 1));
+  ASSERT_FALSE(map.try_emplace(std::string_view("one"), 10));
+  ASSERT_TRUE(map.insert_or_assign("two", 2));
+  ASSERT_FALSE(map.insert_or_assign("two", 20));
+  ASSERT_EQ(map.find("one"), 1);
+  ASSERT_EQ(map.find(std::string_view("two")), 20);
+  ASSERT_EQ(map.find("three"), std::nullopt);
+  ASSERT_TRUE(map.visit("one", [](int &value) { value += 5; }));
+  ASSERT_TRUE(std::as_const(map).visit("one", [](int const &value) { ASSERT_EQ(value, 6); }));
+  ASSERT_FALSE(map.visit("three", [](int &) { FAIL(); }));
+  ASSERT_EQ(map.size(), 2u);
+  ASSERT_TRUE(map.erase("one"));
+  ASSERT_FALSE(map.erase("one"));
+  ASSERT_FALSE(map.contains("one"));
+  map.clear();
+  ASSERT_TRUE(map.empty());
+}
+
+TEST(concurrent_hash_map, bulk)
+{
+  claws::concurrent_hash_map<std::uint64_t, std::uint64_t> map;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> entries;
+  std::vector<std::uint64_t> keys;
+
+  for (std::uint64_t i(0u); i != 1000u; ++i)
+    {
+      entries.emplace_back(i * 3u, i);
+      keys.push_back(i * 2u);
+    }
+  ASSERT_EQ(map.insert_many(entries), 1000u);
+  ASSERT_EQ(map.insert_many(entries), 0u);
+
+  std::vector<std::uint64_t> values(keys.size(), ~std::uint64_t(0u));
+
+  // Multiples of 6 are found
+  ASSERT_EQ(map.find_many(keys, [&](std::size_t index, std::uint64_t value) { values[index] = value; }), 334u);
+  for (std::size_t i(0u); i != keys.size(); ++i)
+    ASSERT_EQ(values[i], keys[i] % 3u ? ~std::uint64_t(0u) : keys[i] / 3u);
+
+  std::uint64_t sum(0u);
+
+  map.for_each([&](std::uint64_t key, std::uint64_t value) { sum += key - value * 3u; });
+  ASSERT_EQ(sum, 0u);
+}
+
+TEST(concurrent_hash_map, threads)
+{
+  constexpr std::uint64_t per_thread = 20000u;
+  claws::concurrent_hash_map<std::uint64_t, std::uint64_t, claws::mix_hash, std::equal_to<>, std::mutex> map(16u);
+  std::vector<std::thread> threads;
+
+  // Each thread inserts its own keys, bumps a shared counter, and erases every other key it inserted
+  map.insert(~std::uint64_t(0u), 0u);
+  for (std::uint64_t t(0u); t != 4u; ++t)
+    threads.emplace_back([&map, t] {
+      for (std::uint64_t i(0u); i != per_thread; ++i)
+        {
+          map.try_emplace(t * per_thread + i, i);
+          map.visit(~std::uint64_t(0u), [](std::uint64_t &count) { ++count; });
+          if (i % 2u)
+            map.erase(t * per_thread + i - 1u);
+        }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(map.find(~std::uint64_t(0u)), 4u * per_thread);
+  ASSERT_EQ(map.size(), 4u * per_thread / 2u + 1u);
+  for (std::uint64_t key(1u); key < 4u * per_thread; key += 2u)
+    ASSERT_EQ(map.find(key), key % per_thread);
+}
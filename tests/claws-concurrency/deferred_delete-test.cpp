@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/deferred_delete.hpp>
+#include <claws/utils/handle_types.hpp>
+
+namespace
+{
+  std::atomic<int> deleted_ints{0};
+
+  struct int_deleter
+  {
+    void operator()(int *value) const noexcept
+    {
+      delete value;
+      ++deleted_ints;
+    }
+  };
+
+  claws::deletion_queue &get_test_queue() noexcept
+  {
+    static claws::deletion_queue queue(4u);
+
+    return queue;
+  }
+
+  struct sized_buffer
+  {
+    char *data;
+    std::size_t size;
+
+    bool operator==(sized_buffer const &other) const noexcept
+    {
+      return data == other.data && size == other.size;
+    }
+  };
+
+  struct buffer_deleter
+  {
+    std::atomic<std::size_t> *released;
+
+    void operator()(sized_buffer buffer) const noexcept
+    {
+      delete[] buffer.data;
+      *released += buffer.size;
+    }
+
+    std::size_t bytes_of(sized_buffer const &buffer) const noexcept
+    {
+      return buffer.size;
+    }
+  };
+}
+
+TEST(deferred_delete, flush_and_drain)
+{
+  claws::deletion_queue queue;
+  std::vector<int> deleted;
+  auto const deleter = [&deleted](int value) noexcept { deleted.push_back(value); };
+
+  for (int i(0); i != 10; ++i)
+    queue.push(deleter, i, 2u);
+  ASSERT_TRUE(deleted.empty());
+  ASSERT_EQ(queue.pending_items(), 10u);
+  ASSERT_EQ(queue.pending_bytes(), 20u);
+
+  // Unpublished batches aren't seen by reclaim_published
+  ASSERT_EQ(queue.reclaim_published(), 0u);
+  queue.flush();
+  ASSERT_EQ(queue.pending_items(), 10u);
+  ASSERT_EQ(queue.reclaim_published(), 10u);
+  ASSERT_EQ(deleted.size(), 10u);
+  ASSERT_EQ(queue.pending_items(), 0u);
+  ASSERT_EQ(queue.pending_bytes(), 0u);
+
+  queue.push(deleter, 10);
+  ASSERT_EQ(queue.drain(), 1u);
+  ASSERT_EQ(deleted.back(), 10);
+  ASSERT_EQ(queue.drain(), 0u);
+}
+
+TEST(deferred_delete, batch_thresholds)
+{
+  claws::deletion_queue queue(3u, 100u);
+  int deleted = 0;
+  auto const deleter = [&deleted](int) noexcept { ++deleted; };
+
+  queue.push(deleter, 0);
+  queue.push(deleter, 1);
+  ASSERT_EQ(queue.reclaim_published(), 0u);
+  queue.push(deleter, 2);
+  ASSERT_EQ(queue.reclaim_published(), 3u);
+
+  // A single large deletion fills a batch by itself
+  queue.push(deleter, 3, 100u);
+  ASSERT_EQ(queue.pending_bytes(), 100u);
+  ASSERT_EQ(queue.reclaim_published(), 1u);
+  ASSERT_EQ(deleted, 4);
+  ASSERT_EQ(queue.pending_bytes(), 0u);
+}
+
+TEST(deferred_delete, boxed_payloads)
+{
+  claws::deletion_queue queue;
+  std::vector<std::string> deleted;
+  std::array<char, 64> padding;
+
+  padding.fill('x');
+  // Too large to be stored inline
+  auto const deleter = [&deleted, padding](std::string value) noexcept { deleted.push_back(value + padding[0]); };
+
+  queue.push(deleter, std::string("first value, long enough to be allocated"));
+  queue.push(deleter, std::string("second"));
+  ASSERT_EQ(queue.drain(), 2u);
+  ASSERT_EQ(deleted.size(), 2u);
+  ASSERT_NE(std::find(deleted.begin(), deleted.end(), "secondx"), deleted.end());
+}
+
+TEST(deferred_delete, handle)
+{
+  using deferred_deleter = claws::deferred_delete<int_deleter, get_test_queue>;
+  using deferred_int = claws::handle<int *, deferred_deleter>;
+  auto &queue = get_test_queue();
+  auto const before = deleted_ints.load();
+
+  {
+    deferred_int a(deferred_deleter{}, new int(1));
+    deferred_int b(deferred_deleter{}, new int(2));
+    deferred_int moved_from(deferred_deleter{}, new int(3));
+    deferred_int moved_to(std::move(moved_from));
+    deferred_int empty;
+  }
+  // The moved-from and empty handles didn't queue anything
+  ASSERT_EQ(queue.pending_items(), 3u);
+  ASSERT_EQ(deleted_ints.load(), before);
+  ASSERT_EQ(queue.drain(), 3u);
+  ASSERT_EQ(deleted_ints.load(), before + 3);
+}
+
+TEST(deferred_delete, pending_bytes_from_deleter)
+{
+  claws::deletion_queue queue;
+  std::atomic<std::size_t> released{0u};
+  buffer_deleter const plain{&released};
+
+  for (std::size_t size : {16u, 32u, 64u})
+    queue.push(plain, sized_buffer{new char[size], size}, plain.bytes_of(sized_buffer{nullptr, size}));
+  ASSERT_EQ(queue.pending_bytes(), 112u);
+  queue.drain();
+  ASSERT_EQ(released.load(), 112u);
+
+  auto &default_queue = claws::get_default_deletion_queue();
+  claws::deferred_delete<buffer_deleter> deleter(plain);
+
+  deleter(sized_buffer{new char[8], 8u});
+  deleter(sized_buffer{});
+  ASSERT_EQ(default_queue.pending_bytes(), 8u);
+  ASSERT_EQ(default_queue.drain(), 1u);
+  ASSERT_EQ(released.load(), 120u);
+}
+
+TEST(deferred_delete, thread_exit_publishes)
+{
+  claws::deletion_queue queue(1000u);
+  std::atomic<int> deleted{0};
+  auto const deleter = [&deleted](int) noexcept { ++deleted; };
+  std::vector<std::thread> threads;
+
+  for (int t(0); t != 4; ++t)
+    threads.emplace_back([&]() {
+      for (int i(0); i != 100; ++i)
+        queue.push(deleter, i);
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(queue.pending_items(), 400u);
+  ASSERT_EQ(queue.reclaim_published(), 400u);
+  ASSERT_EQ(deleted.load(), 400);
+}
+
+TEST(deferred_delete, queues_outlived_by_thread)
+{
+  claws::deletion_queue long_lived(1000u);
+  std::atomic<int> deleted{0};
+  auto const deleter = [&deleted](int) noexcept { ++deleted; };
+
+  std::thread([&]() {
+    long_lived.push(deleter, 0);
+    for (int i(0); i != 100; ++i)
+      {
+        // Likely at the same address each time: the thread must not mix them up
+        claws::deletion_queue short_lived(1000u);
+
+        short_lived.push(deleter, i);
+        short_lived.push(deleter, i);
+        ASSERT_EQ(short_lived.pending_items(), 2u);
+      }
+    ASSERT_EQ(deleted.load(), 200);
+    long_lived.push(deleter, 1);
+    ASSERT_EQ(long_lived.pending_items(), 2u);
+  }).join();
+  ASSERT_EQ(long_lived.reclaim_published(), 2u);
+  ASSERT_EQ(deleted.load(), 202);
+}
+
+TEST(deferred_delete, background_reclaimer)
+{
+  claws::deletion_queue queue(16u);
+  std::atomic<int> deleted{0};
+  auto const deleter = [&deleted](int) noexcept { ++deleted; };
+
+  {
+    claws::background_reclaimer reclaimer(queue, std::chrono::milliseconds(1));
+    std::vector<std::thread> threads;
+
+    for (int t(0); t != 4; ++t)
+      threads.emplace_back([&]() {
+        for (int i(0); i != 1000; ++i)
+          queue.push(deleter, i);
+        queue.flush();
+      });
+    for (auto &thread : threads)
+      thread.join();
+    for (int wait(0); wait != 1000 && deleted.load() != 4000; ++wait)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(deleted.load(), 4000);
+  }
+  ASSERT_EQ(queue.pending_items(), 0u);
+}
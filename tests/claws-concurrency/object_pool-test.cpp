@@ -0,0 +1,163 @@
+#include <atomic>
+#include <list>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/object_pool.hpp>
+
+namespace
+{
+  struct counted
+  {
+    static inline std::atomic<int> alive{0};
+
+    std::string name;
+
+    explicit counted(std::string name)
+      : name(std::move(name))
+    {
+      ++alive;
+    }
+
+    ~counted()
+    {
+      --alive;
+    }
+  };
+}
+
+TEST(object_pool, basic)
+{
+  claws::object_pool<counted> pool(64u);
+  std::vector<counted *> values;
+
+  for (int i(0); i != 200; ++i)
+    values.push_back(pool.create(std::to_string(i)));
+  ASSERT_EQ(counted::alive, 200);
+  ASSERT_EQ(values[123]->name, "123");
+  ASSERT_EQ(std::set<counted *>(values.begin(), values.end()).size(), 200u);
+
+  auto const capacity = pool.get_capacity();
+
+  for (auto value : values)
+    pool.destroy(value);
+  ASSERT_EQ(counted::alive, 0);
+  // Freed slots are reused
+  for (auto &value : values)
+    value = pool.create("again");
+  ASSERT_EQ(pool.get_capacity(), capacity);
+  for (auto value : values)
+    pool.destroy(value);
+}
+
+TEST(object_pool, handle)
+{
+  claws::object_pool<counted> pool;
+
+  {
+    auto first = pool.make_handle("first");
+    auto moved_from = pool.make_handle("second");
+    auto moved_to(std::move(moved_from));
+    claws::pool_handle<counted> empty;
+
+    ASSERT_EQ(counted::alive, 2);
+    claws::handle<counted *, claws::no_delete> borrowed(first);
+    counted *value = borrowed;
+
+    ASSERT_EQ(value->name, "first");
+  }
+  ASSERT_EQ(counted::alive, 0);
+}
+
+TEST(object_pool, pmr_and_allocator)
+{
+  claws::fixed_pool pool(64u, alignof(std::max_align_t));
+
+  {
+    std::list<int, claws::pool_allocator<int>> list{claws::pool_allocator<int>(pool)};
+
+    for (int i(0); i != 1000; ++i)
+      list.push_back(i);
+    ASSERT_EQ(list.back(), 999);
+  }
+
+  // Too large for a slot: allocated with operator new
+  std::pmr::vector<char> large(1000u, 'x', &pool);
+  std::pmr::set<int> set(&pool);
+
+  for (int i(0); i != 100; ++i)
+    set.insert(i);
+  ASSERT_EQ(set.size(), 100u);
+  ASSERT_EQ(large[999], 'x');
+}
+
+TEST(object_pool, threads)
+{
+  claws::object_pool<counted> pool;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<counted *>> created(4u);
+
+  // Each thread frees what the previous one allocated, so slots move between threads
+  for (int t(0); t != 4; ++t)
+    threads.emplace_back([&pool, &created, t] {
+      for (int i(0); i != 10000; ++i)
+        {
+          auto const value = pool.create(std::to_string(t));
+
+          ASSERT_EQ(value->name, std::to_string(t));
+          if (i % 2)
+            pool.destroy(value);
+          else
+            created[t].push_back(value);
+        }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  threads.clear();
+  for (int t(0); t != 4; ++t)
+    threads.emplace_back([&pool, &created, t] {
+      for (auto value : created[(t + 1) % 4])
+        pool.destroy(value);
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(counted::alive, 0);
+}
+
+TEST(object_pool, short_lived_pools)
+{
+  claws::object_pool<counted> outer;
+  auto const kept = outer.create("kept");
+
+  // Each pool leaves a cache in this thread's list when destroyed, dropped when the next pool is first used
+  for (int i(0); i != 1000; ++i)
+    {
+      claws::object_pool<counted> pool;
+
+      pool.destroy(pool.create(std::to_string(i)));
+      outer.destroy(outer.create("outer"));
+    }
+  ASSERT_EQ(kept->name, "kept");
+  outer.destroy(kept);
+  ASSERT_EQ(counted::alive, 0);
+}
+
+TEST(object_pool, free_from_thread_without_cache)
+{
+  claws::object_pool<counted> pool;
+  auto const value = pool.create("freed elsewhere");
+  void *reused;
+
+  // The freeing thread never allocated: the slot goes to the shared list, where its first allocation finds it
+  std::thread([&pool, value, &reused] {
+    pool.destroy(value);
+    reused = pool.allocate_slot();
+    pool.deallocate_slot(reused);
+  }).join();
+  ASSERT_EQ(reused, static_cast<void *>(value));
+  ASSERT_EQ(pool.get_capacity(), claws::object_pool<counted>::default_chunk_slots);
+  ASSERT_EQ(counted::alive, 0);
+}
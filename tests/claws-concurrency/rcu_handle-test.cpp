@@ -0,0 +1,185 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/rcu_handle.hpp>
+
+namespace
+{
+  std::atomic<int> live_configs{0};
+
+  struct config
+  {
+    int version;
+    int checksum;
+
+    config(int version)
+      : version(version)
+      , checksum(-version)
+    {
+      ++live_configs;
+    }
+
+    config(config const &other)
+      : version(other.version)
+      , checksum(other.checksum)
+    {
+      ++live_configs;
+    }
+
+    ~config()
+    {
+      --live_configs;
+    }
+  };
+}
+
+TEST(rcu_handle, read_and_update)
+{
+  claws::rcu_domain domain;
+
+  {
+    claws::rcu_handle<config> handle(new config(1), domain);
+
+    ASSERT_EQ(handle.read()->version, 1);
+    handle.update(new config(2));
+    ASSERT_EQ(handle.read()->version, 2);
+    ASSERT_EQ(domain.retired_count(), 1u);
+    ASSERT_EQ(domain.reclaim(), 1u);
+    ASSERT_EQ(live_configs.load(), 1);
+
+    handle.copy_update([](config &value) { value.version = 3; });
+    ASSERT_EQ(handle.read()->version, 3);
+    ASSERT_EQ(handle.read()->checksum, -2);
+    ASSERT_EQ(handle.synchronize(), 1u);
+    ASSERT_EQ(live_configs.load(), 1);
+
+    claws::rcu_handle<config> empty(domain);
+
+    ASSERT_FALSE(empty.read());
+  }
+  // The destructor retires the last value
+  ASSERT_EQ(domain.retired_count(), 1u);
+  ASSERT_EQ(domain.reclaim(), 1u);
+  ASSERT_EQ(live_configs.load(), 0);
+}
+
+TEST(rcu_handle, readers_keep_values_alive)
+{
+  claws::rcu_domain domain;
+  claws::rcu_handle<config> handle(new config(1), domain);
+
+  {
+    auto const reader = handle.read();
+
+    handle.update(new config(2));
+    ASSERT_EQ(domain.reclaim(), 0u);
+    ASSERT_EQ(reader->version, 1);
+    ASSERT_EQ(live_configs.load(), 2);
+
+    // Nested read sections don't move the reader to a newer epoch
+    {
+      claws::rcu_read_lock lock(domain);
+
+      ASSERT_EQ(handle.get(lock)->version, 2);
+    }
+    ASSERT_EQ(domain.reclaim(), 0u);
+  }
+  ASSERT_EQ(domain.reclaim(), 1u);
+  ASSERT_EQ(live_configs.load(), 1);
+}
+
+TEST(rcu_handle, synchronize_waits_for_readers)
+{
+  claws::rcu_domain domain;
+  claws::rcu_handle<config> handle(new config(1), domain);
+  std::atomic<bool> reading{false};
+  std::atomic<bool> done{false};
+  std::thread reader([&]() {
+    auto const value = handle.read();
+
+    reading = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    done = value->version == 1 && value->checksum == -1;
+  });
+
+  while (!reading)
+    std::this_thread::yield();
+  handle.update(new config(2));
+  ASSERT_EQ(handle.synchronize(), 1u);
+  ASSERT_TRUE(done.load());
+  reader.join();
+}
+
+TEST(rcu_handle, custom_deleter)
+{
+  claws::rcu_domain domain;
+  std::vector<int> deleted;
+  auto deleter = [&deleted](int *value) noexcept {
+    deleted.push_back(*value);
+    delete value;
+  };
+
+  {
+    claws::rcu_handle<int, decltype(deleter)> handle(std::move(deleter), new int(1), domain);
+
+    handle.update(new int(2));
+    delete handle.exchange(new int(3));
+  }
+  domain.reclaim();
+  ASSERT_EQ(deleted, (std::vector<int>{1, 3}));
+}
+
+TEST(rcu_handle, concurrent_readers)
+{
+  claws::rcu_domain domain(8u);
+  claws::rcu_handle<config> handle(new config(0), domain);
+  std::atomic<bool> stop{false};
+  std::atomic<int> torn{0};
+  std::vector<std::thread> readers;
+
+  for (int t(0); t != 4; ++t)
+    readers.emplace_back([&]() {
+      int last = 0;
+
+      while (!stop)
+        {
+          auto const value = handle.read();
+
+          // Versions never go back, and a value is never deleted while read
+          torn += value->checksum != -value->version || value->version < last;
+          last = value->version;
+        }
+    });
+  for (int version(1); version != 5000; ++version)
+    handle.update(new config(version));
+  stop = true;
+  for (auto &reader : readers)
+    reader.join();
+  ASSERT_EQ(torn.load(), 0);
+  domain.synchronize();
+  ASSERT_EQ(live_configs.load(), 1);
+}
+
+TEST(rcu_handle, short_lived_domains)
+{
+  claws::rcu_domain outer;
+  claws::rcu_handle<config> kept(new config(-1), outer);
+
+  // Each domain leaves a record in this thread's list when destroyed, dropped when the next domain is first read through
+  for (int i(0); i != 1000; ++i)
+    {
+      claws::rcu_domain domain;
+      claws::rcu_handle<config> handle(new config(i), domain);
+
+      ASSERT_EQ(handle.read()->version, i);
+      ASSERT_EQ(kept.read()->version, -1);
+    }
+  {
+    claws::rcu_read_lock lock(outer);
+
+    ASSERT_EQ(kept.get(lock)->checksum, 1);
+  }
+  ASSERT_EQ(live_configs.load(), 1);
+}
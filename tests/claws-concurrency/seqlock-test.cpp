@@ -0,0 +1,73 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/seqlock.hpp>
+#include <claws/container/vect.hpp>
+#include <claws/utils/box.hpp>
+
+namespace
+{
+  using pose = claws::vect<double, 4u>;
+
+  /// One writer stores poses whose components are all equal, readers check they never see a mix of two poses
+  template<class cell_type>
+  void check_consistency()
+  {
+    constexpr double last = 200000.0;
+    cell_type cell(pose{{0.0, 0.0, 0.0, 0.0}});
+    std::atomic<bool> inconsistent{false};
+    std::vector<std::thread> readers;
+
+    for (int t(0); t != 3; ++t)
+      readers.emplace_back([&] {
+        double previous(0.0);
+
+        while (previous != last)
+          {
+            auto const value = cell.load();
+
+            if (value[1] != value[0] || value[2] != value[0] || value[3] != value[0] || value[0] < previous)
+              inconsistent = true;
+            previous = value[0];
+          }
+      });
+    for (double i(1.0); i <= last; i += 1.0)
+      cell.store(pose{{i, i, i, i}});
+    for (auto &reader : readers)
+      reader.join();
+    ASSERT_FALSE(inconsistent);
+    ASSERT_EQ(cell.get_version(), static_cast<std::uint64_t>(last));
+  }
+}
+
+TEST(seqlock, basic)
+{
+  claws::seqlock<claws::box<int>> cell;
+
+  ASSERT_EQ(cell.load(), 0);
+  ASSERT_EQ(cell.get_version(), 0u);
+  cell.store(3);
+
+  claws::box<int> value;
+
+  ASSERT_TRUE(cell.try_load(value));
+  ASSERT_EQ(value, 3);
+  ASSERT_EQ(cell.get_version(), 1u);
+
+  claws::multi_seqlock<std::uint16_t, 3u> slots(7u);
+
+  ASSERT_EQ(slots.load(), 7u);
+  for (std::uint16_t i(0u); i != 10u; ++i)
+    {
+      slots.store(i);
+      ASSERT_EQ(slots.load(), i);
+    }
+}
+
+TEST(seqlock, threads)
+{
+  check_consistency<claws::seqlock<pose>>();
+  check_consistency<claws::multi_seqlock<pose>>();
+}
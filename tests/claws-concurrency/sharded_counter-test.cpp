@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/sharded_counter.hpp>
+
+TEST(sharded_counter, basic)
+{
+  claws::sharded_counter<std::int64_t> counter(3u);
+
+  ASSERT_EQ(counter.get_slot_count(), 4u);
+  ASSERT_EQ(counter.load(), 0);
+  ++counter;
+  counter += 5;
+  counter.add(-2);
+  ASSERT_EQ(counter, 4);
+  ASSERT_EQ(counter.exchange_zero(), 4);
+  ASSERT_EQ(counter.load(), 0);
+}
+
+TEST(sharded_counter, threads)
+{
+  // More threads than slots, so some share a slot
+  claws::sharded_counter<> counter(4u);
+  std::vector<std::thread> threads;
+
+  for (int t(0); t != 8; ++t)
+    threads.emplace_back([&counter] {
+      for (int i(0); i != 100000; ++i)
+        counter.increment();
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(counter.load(), 800000u);
+}
+
+TEST(sharded_counter, thread_slots_are_reused)
+{
+  auto const main_slot = claws::impl::get_thread_slot();
+
+  // Exited threads give their number back, so numbers don't grow with the threads ever created
+  for (int t(0); t != 16; ++t)
+    {
+      std::size_t slot;
+
+      std::thread([&slot] { slot = claws::impl::get_thread_slot(); }).join();
+      ASSERT_NE(slot, main_slot);
+      ASSERT_LT(slot, 2u);
+    }
+
+  std::atomic<int> numbered{0};
+  std::size_t slots[2];
+  auto const run = [&numbered, &slots](int index) {
+    slots[index] = claws::impl::get_thread_slot();
+    ++numbered;
+    while (numbered != 2)
+      std::this_thread::yield();
+  };
+  std::thread first(run, 0);
+  std::thread second(run, 1);
+
+  first.join();
+  second.join();
+  // Three live threads, the main one included
+  ASSERT_NE(slots[0], slots[1]);
+  ASSERT_LT(slots[0], 3u);
+  ASSERT_LT(slots[1], 3u);
+}
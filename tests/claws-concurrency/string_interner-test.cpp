@@ -0,0 +1,80 @@
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/concurrency/string_interner.hpp>
+
+TEST(string_interner, basic)
+{
+  claws::string_interner interner;
+  auto const a = interner.intern("alpha");
+  auto const b = interner.intern(std::string("beta"));
+
+  ASSERT_EQ(a, claws::interned_id{0u});
+  ASSERT_EQ(b, claws::interned_id{1u});
+  ASSERT_EQ(interner.intern(std::string_view("alpha")), a);
+  ASSERT_EQ(interner.find("beta"), b);
+  ASSERT_EQ(interner.find("gamma"), std::nullopt);
+  ASSERT_EQ(interner.view(a), "alpha");
+  ASSERT_EQ(std::strcmp(interner.c_str(b), "beta"), 0);
+  ASSERT_EQ(interner.intern(""), claws::interned_id{2u});
+  ASSERT_EQ(interner.view(claws::interned_id{2u}), "");
+  ASSERT_EQ(interner.size(), 3u);
+
+  // Views stay valid while the interner grows
+  auto const view = interner.view(a);
+
+  for (int i(0); i != 100000; ++i)
+    interner.intern("metric." + std::to_string(i));
+  ASSERT_EQ(view.data(), interner.view(a).data());
+  ASSERT_EQ(interner.size(), 100003u);
+  for (int i(0); i < 100000; i += 997)
+    ASSERT_EQ(interner.view(*interner.find("metric." + std::to_string(i))), "metric." + std::to_string(i));
+}
+
+TEST(string_interner, bulk)
+{
+  claws::string_interner interner;
+  std::vector<std::string> names{"a", "b", "a", "c"};
+  std::vector<claws::interned_id> ids;
+
+  interner.intern("b");
+  ASSERT_EQ(interner.intern_many(names, std::back_inserter(ids)), 2u);
+  ASSERT_EQ(ids.size(), 4u);
+  ASSERT_EQ(ids[0], ids[2]);
+  ASSERT_EQ(ids[1], claws::interned_id{0u});
+  for (std::size_t i(0u); i != names.size(); ++i)
+    ASSERT_EQ(interner.view(ids[i]), names[i]);
+}
+
+TEST(string_interner, threads)
+{
+  constexpr int string_count = 20000;
+  claws::string_interner interner;
+  std::vector<std::vector<claws::interned_id>> ids(4u);
+  std::vector<std::thread> threads;
+  static constexpr int multipliers[4] = {1, 3, 7, 9};
+
+  // Every thread interns the same strings in a different order, while the others grow the index
+  for (int t(0); t != 4; ++t)
+    threads.emplace_back([&interner, &ids, t] {
+      ids[t].resize(string_count);
+      for (int i(0); i != string_count; ++i)
+        {
+          auto const value = (i * multipliers[t]) % string_count;
+
+          ids[t][value] = interner.intern("symbol" + std::to_string(value));
+        }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(interner.size(), static_cast<std::size_t>(string_count));
+  for (int i(0); i != string_count; ++i)
+    {
+      ASSERT_EQ(interner.view(ids[0][i]), "symbol" + std::to_string(i));
+      for (int t(1); t != 4; ++t)
+        ASSERT_EQ(ids[t][i], ids[0][i]);
+    }
+}
@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <gtest/gtest.h>
+#include <claws/container/flat_hash_map.hpp>
+#include <claws/container/flat_hash_set.hpp>
+
+namespace
+{
+  struct id_tag;
+
+  using id = claws::tagged_data<std::uint32_t, std::int32_t, id_tag>;
+  using position = claws::vect<int, 2u>;
+
+  position position_of(std::uint32_t i)
+  {
+    return position{{static_cast<int>(i % 32u) - 16, static_cast<int>(i / 32u)}};
+  }
+}
+
+TEST(flat_hash_map, random)
+{
+  claws::flat_hash_map<std::uint64_t, std::uint32_t> map;
+  std::unordered_map<std::uint64_t, std::uint32_t> reference;
+  std::mt19937_64 generator(7u);
+
+  // Small key range, so insertions and erasures hit existing keys and leave deleted slots
+  for (std::uint32_t i(0u); i != 100000u; ++i)
+    {
+      auto const key = generator() % 4096u;
+
+      switch (generator() % 3u)
+        {
+        case 0u:
+          ASSERT_EQ(map.try_emplace(key, i).second, reference.try_emplace(key, i).second);
+          break;
+        case 1u:
+          ASSERT_EQ(map.erase(key), reference.erase(key));
+          break;
+        default:
+          {
+            auto const found = map.find(key);
+            auto const expected = reference.find(key);
+
+            ASSERT_EQ(found == map.end(), expected == reference.end());
+            ASSERT_TRUE(expected == reference.end() || found->second == expected->second);
+          }
+        }
+      ASSERT_EQ(map.size(), reference.size());
+    }
+
+  std::size_t visited(0u);
+
+  for (auto const &[key, value] : map)
+    {
+      ASSERT_EQ(reference.at(key), value);
+      ++visited;
+    }
+  ASSERT_EQ(visited, reference.size());
+  auto const erased = map.erase_if([](auto const &value) { return value.first % 2u; });
+
+  ASSERT_EQ(erased, visited - map.size());
+  for (auto it = reference.begin(); it != reference.end();)
+    it = it->first % 2u ? reference.erase(it) : std::next(it);
+  ASSERT_EQ(map.size(), reference.size());
+
+  auto copy(map);
+
+  map.clear();
+  ASSERT_TRUE(map.empty());
+  ASSERT_FALSE(map.contains(std::uint64_t(0u)));
+  for (auto const &[key, value] : reference)
+    ASSERT_EQ(copy[key], value);
+}
+
+TEST(flat_hash_map, heterogeneous)
+{
+  claws::flat_hash_map<std::string, int> map;
+
+  ASSERT_FALSE(map.contains(std::string_view("missing")));
+  map["one"] = 1;
+  map.insert_or_assign(std::string_view("two"), 2);
+  ASSERT_TRUE(map.try_emplace(std::string("three"), 3).second);
+  ASSERT_FALSE(map.try_emplace("one", 10).second);
+  map.insert_or_assign("two", 20);
+
+  ASSERT_EQ(map.size(), 3u);
+  ASSERT_EQ(map.find(std::string_view("one"))->second, 1);
+  ASSERT_EQ(map.find("two")->second, 20);
+  ASSERT_TRUE(map.contains(std::string("three")));
+  ASSERT_EQ(map.erase(std::string_view("one")), 1u);
+  ASSERT_EQ(map.find("one"), map.end());
+}
+
+TEST(flat_hash_map, compound_keys)
+{
+  claws::flat_hash_map<id, int> by_id;
+  claws::flat_hash_map<position, int> by_position;
+
+  for (std::uint32_t i(0u); i != 1000u; ++i)
+    {
+      by_id[id{i}] = static_cast<int>(i);
+      by_position[position_of(i)] = static_cast<int>(i);
+    }
+  for (std::uint32_t i(0u); i != 1000u; ++i)
+    {
+      ASSERT_EQ(by_id.find(id{i})->second, static_cast<int>(i));
+      ASSERT_EQ(by_position.find(position_of(i))->second, static_cast<int>(i));
+    }
+  ASSERT_FALSE(by_id.contains(id{1000u}));
+  ASSERT_FALSE(by_position.contains(position{{16, 0}}));
+}
+
+TEST(flat_hash_set, basic)
+{
+  claws::flat_hash_set<std::string> set;
+
+  ASSERT_TRUE(set.insert("a").second);
+  ASSERT_TRUE(set.insert(std::string("b")).second);
+  ASSERT_FALSE(set.insert(std::string_view("a")).second);
+  ASSERT_EQ(set.size(), 2u);
+  ASSERT_TRUE(set.contains("b"));
+  set.erase(set.find("a"));
+  ASSERT_FALSE(set.contains(std::string_view("a")));
+
+  claws::flat_hash_set<int> numbers(100u);
+  auto const capacity = numbers.capacity();
+
+  for (int i(0); i != 40; ++i)
+    numbers.insert(i);
+  // Erasing and inserting new keys cleans up deleted slots instead of growing
+  for (int i(40); i != 10000; ++i)
+    {
+      numbers.erase(i - 40);
+      numbers.insert(i);
+    }
+  ASSERT_EQ(numbers.size(), 40u);
+  ASSERT_EQ(numbers.capacity(), capacity);
+}
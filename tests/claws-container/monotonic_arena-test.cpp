@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/container/monotonic_arena.hpp>
+
+TEST(monotonic_arena, alignment)
+{
+  claws::monotonic_arena arena(4096u);
+
+  for (std::size_t alignment : {1u, 2u, 8u, 16u, 64u, 256u})
+    for (int i(0); i != 10; ++i)
+      {
+        auto const pointer = arena.allocate(3u, alignment);
+
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(pointer) % alignment, 0u);
+      }
+
+  // Larger than a block: gets a block of its own
+  auto const large = static_cast<char *>(arena.allocate(10000u, 64u));
+
+  large[0] = 1;
+  large[9999] = 2;
+  ASSERT_GE(arena.get_capacity(), 4096u + 10000u);
+}
+
+TEST(monotonic_arena, reset)
+{
+  claws::monotonic_arena arena(1024u);
+  std::vector<int *> values;
+
+  for (int i(0); i != 1000; ++i)
+    values.push_back(arena.construct<int>(i));
+  for (int i(0); i != 1000; ++i)
+    ASSERT_EQ(*values[i], i);
+
+  auto const capacity = arena.get_capacity();
+
+  // Same allocations after a reset reuse the same blocks
+  for (int round(0); round != 3; ++round)
+    {
+      arena.reset();
+      ASSERT_EQ(arena.construct<int>(0), values[0]);
+      for (int i(1); i != 1000; ++i)
+        arena.construct<int>(i);
+      ASSERT_EQ(arena.get_capacity(), capacity);
+    }
+  arena.release();
+  ASSERT_EQ(arena.get_capacity(), 0u);
+  ASSERT_EQ(*arena.construct<int>(7), 7);
+}
+
+TEST(monotonic_arena, pmr_and_allocator)
+{
+  claws::monotonic_arena arena;
+
+  {
+    std::pmr::vector<std::pmr::string> strings(&arena);
+
+    for (int i(0); i != 100; ++i)
+      strings.emplace_back("a string long enough to be allocated " + std::to_string(i));
+    ASSERT_EQ(strings[42], "a string long enough to be allocated 42");
+  }
+
+  using allocator = claws::arena_allocator<std::pair<int const, int>>;
+  std::map<int, int, std::less<>, allocator> map{allocator(arena)};
+
+  for (int i(0); i != 100; ++i)
+    map[i] = i * i;
+  ASSERT_EQ(map.at(9), 81);
+  ASSERT_TRUE(allocator(arena) == claws::arena_allocator<int>(arena));
+}
+
+TEST(monotonic_arena, huge_pages)
+{
+  claws::monotonic_arena arena(claws::monotonic_arena::default_block_size, claws::arena_backing::huge_pages);
+  std::pmr::vector<std::uint64_t> values(&arena);
+
+  for (std::uint64_t i(0u); i != 100000u; ++i)
+    values.push_back(i);
+  ASSERT_EQ(values[99999], 99999u);
+  arena.reset();
+  ASSERT_EQ(*arena.construct<std::uint64_t>(3u), 3u);
+}
@@ -0,0 +1,193 @@
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <gtest/gtest.h>
+#include <claws/container/relocatable_hash_map.hpp>
+#include <claws/container/relocatable_slot_map.hpp>
+
+namespace
+{
+  struct block_deleter
+  {
+    void operator()(void *block) const noexcept
+    {
+      std::free(block);
+    }
+  };
+
+  using block = std::unique_ptr<std::byte, block_deleter>;
+
+  block make_block(std::size_t size)
+  {
+    return block(static_cast<std::byte *>(std::aligned_alloc(claws::relocatable_arena::max_alignment, size)));
+  }
+
+  struct item_tag;
+
+  struct root
+  {
+    claws::relocatable_vector<std::uint32_t> numbers;
+    claws::relocatable_slot_map<double, item_tag> items;
+    claws::relocatable_hash_map<std::uint64_t, std::uint32_t> index;
+
+    explicit root(claws::relocatable_arena &arena)
+      : numbers(arena)
+      , items(arena)
+      , index(arena)
+    {}
+  };
+}
+
+TEST(relocatable, arena)
+{
+  constexpr std::size_t size = 1u << 12u;
+  auto memory = make_block(size);
+  auto arena = claws::relocatable_arena::create(memory.get(), size);
+
+  ASSERT_NE(arena, nullptr);
+  ASSERT_EQ(claws::relocatable_arena::create(memory.get() + 1, size - 1u), nullptr);
+
+  auto const a = arena->allocate(24u, 8u);
+  auto const b = arena->allocate(100u, 64u);
+
+  ASSERT_NE(a, nullptr);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(b) % 64u, 0u);
+  // Freed blocks are reused for the same size
+  arena->deallocate(a, 24u);
+  ASSERT_EQ(arena->allocate(32u, 16u), a);
+  ASSERT_EQ(arena->allocate(size, 8u), nullptr);
+  ASSERT_EQ(arena->allocate(8u, 128u), nullptr);
+
+  // Small blocks get the alignment they ask for, freed or not
+  auto const aligned = arena->allocate(8u, 64u);
+
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64u, 0u);
+  arena->deallocate(aligned, 8u, 64u);
+  ASSERT_EQ(arena->allocate(8u, 64u), aligned);
+
+  // Attaching checks the magic and the size
+  auto other = make_block(size);
+
+  std::memset(other.get(), 0, size);
+  ASSERT_EQ(claws::relocatable_arena::attach(other.get(), size), nullptr);
+  ASSERT_EQ(claws::relocatable_arena::attach(memory.get(), size / 2u), nullptr);
+  ASSERT_EQ(claws::relocatable_arena::attach(memory.get(), size), arena);
+
+  // Attaching for reading only checks the same things, and doesn't grow the arena
+  void const *block = memory.get();
+
+  ASSERT_EQ(claws::relocatable_arena::attach(block, size / 2u), nullptr);
+  ASSERT_EQ(claws::relocatable_arena::attach(block, size * 2u), arena);
+  ASSERT_EQ(arena->get_capacity(), size);
+}
+
+TEST(relocatable, moved_block)
+{
+  constexpr std::size_t size = 1u << 20u;
+  auto memory = make_block(size);
+  auto arena = claws::relocatable_arena::create(memory.get(), size);
+  auto const data = arena->construct<root>(*arena);
+  std::vector<claws::relocatable_slot_map<double, item_tag>::key_type> keys;
+
+  arena->set_root(data);
+  for (std::uint32_t i(0u); i != 1000u; ++i)
+    {
+      data->numbers.push_back(i * 3u);
+      keys.push_back(data->items.insert(i * 0.5));
+      data->index.insert(std::uint64_t(i) << 20u, i);
+    }
+  data->items.erase(keys[10]);
+  data->index.erase(std::uint64_t(10u) << 20u);
+
+  // As if written to a file and mapped elsewhere
+  auto moved = make_block(size);
+
+  std::memcpy(moved.get(), memory.get(), size);
+  memory.reset();
+
+  auto const moved_arena = claws::relocatable_arena::attach(moved.get(), size);
+
+  ASSERT_NE(moved_arena, nullptr);
+
+  auto const moved_data = moved_arena->get_root<root>();
+
+  ASSERT_EQ(moved_data->numbers.size(), 1000u);
+  ASSERT_EQ(moved_data->numbers[999], 2997u);
+  ASSERT_EQ(moved_data->items.size(), 999u);
+  ASSERT_EQ(moved_data->items.find(keys[10]), nullptr);
+  ASSERT_EQ(*moved_data->items.find(keys[500]), 250.0);
+  ASSERT_EQ(moved_data->index.size(), 999u);
+  ASSERT_EQ(moved_data->index.find(std::uint64_t(10u) << 20u), nullptr);
+  for (std::uint32_t i(11u); i != 1000u; ++i)
+    ASSERT_EQ(*moved_data->index.find(std::uint64_t(i) << 20u), i);
+
+  // And can keep on growing there
+  for (std::uint32_t i(1000u); i != 5000u; ++i)
+    {
+      moved_data->numbers.push_back(i * 3u);
+      moved_data->index.insert(std::uint64_t(i) << 20u, i);
+    }
+  ASSERT_EQ(moved_data->numbers[4999], 14997u);
+  ASSERT_EQ(*moved_data->index.find(std::uint64_t(4999u) << 20u), 4999u);
+  moved_arena->destroy(moved_data);
+}
+
+TEST(relocatable, push_back_own_value)
+{
+  constexpr std::size_t size = 1u << 16u;
+  auto memory = make_block(size);
+  auto arena = claws::relocatable_arena::create(memory.get(), size);
+  claws::relocatable_vector<std::array<std::uint64_t, 4>> values(*arena);
+
+  for (std::uint64_t i(0u); i != 4u; ++i)
+    values.push_back({i + 1u, i + 2u, i + 3u, i + 4u});
+  ASSERT_EQ(values.size(), values.capacity());
+  // Growing frees the block the value is copied from
+  values.push_back(values[0]);
+  ASSERT_EQ(values[4], (std::array<std::uint64_t, 4>{1u, 2u, 3u, 4u}));
+  ASSERT_EQ(values[0], values[4]);
+
+  claws::relocatable_slot_map<double, item_tag> items(*arena);
+  auto const first = items.insert(1.5);
+
+  for (int i(0); i != 3; ++i)
+    items.insert(i);
+  ASSERT_EQ(*items.find(items.insert(items[first])), 1.5);
+}
+
+TEST(relocatable, hash_map)
+{
+  constexpr std::size_t size = 1u << 22u;
+  auto memory = make_block(size);
+  auto arena = claws::relocatable_arena::create(memory.get(), size);
+  claws::relocatable_hash_map<std::uint32_t, std::uint32_t> &map = *arena->construct<claws::relocatable_hash_map<std::uint32_t, std::uint32_t>>(*arena);
+  std::unordered_map<std::uint32_t, std::uint32_t> reference;
+  std::uint32_t state = 1u;
+
+  for (int i(0); i != 20000; ++i)
+    {
+      state = state * 1664525u + 1013904223u;
+
+      auto const key = (state >> 8u) % 4096u;
+
+      if (state & 1u)
+        ASSERT_EQ(map.erase(key), reference.erase(key) == 1u);
+      else
+        ASSERT_EQ(map.insert(key, state).second, reference.emplace(key, state).second);
+    }
+  ASSERT_EQ(map.size(), reference.size());
+  for (auto const &[key, value] : reference)
+    ASSERT_EQ(*map.find(key), value);
+
+  std::size_t visited(0u);
+
+  map.for_each([&](std::uint32_t key, std::uint32_t value) {
+    ++visited;
+    ASSERT_EQ(reference[key], value);
+  });
+  ASSERT_EQ(visited, reference.size());
+  arena->destroy(&map);
+}
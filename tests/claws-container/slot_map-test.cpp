@@ -0,0 +1,222 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/container/slot_map.hpp>
+
+namespace
+{
+  struct entity_tag;
+  using entity_map = claws::slot_map<int, entity_tag>;
+  using entity = entity_map::key_type;
+}
+
+TEST(slot_map, type_traits)
+{
+  static_assert(std::is_same_v<entity, claws::tagged_data<std::uint32_t, std::uint32_t, entity_tag>>);
+  static_assert(sizeof(entity) == 4);
+  static_assert(entity_map::generation_bits == 8);
+  static_assert(entity_map::max_size() == (1u << 24) - 1);
+  static_assert(sizeof(claws::slot_map<int, entity_tag, std::uint64_t>::key_type) == 8);
+  static_assert(claws::slot_map<int, entity_tag, std::uint64_t>::generation_bits == 32);
+  static_assert(entity_map::index_of(entity{0x0A000005u}) == 5);
+  static_assert(entity_map::generation_of(entity{0x0A000005u}) == 10);
+}
+
+TEST(slot_map, insert_find_erase)
+{
+  entity_map map;
+  auto const a = map.insert(1);
+  auto const b = map.insert(2);
+  auto const c = map.emplace(3);
+
+  ASSERT_EQ(map.size(), 3u);
+  ASSERT_EQ(*map.find(a), 1);
+  ASSERT_EQ(map[b], 2);
+  ASSERT_EQ(*map.find(c), 3);
+  ASSERT_FALSE(map.contains(entity{}));
+
+  // Erasing `a` moves `c` in its place, `c`'s key must still work
+  ASSERT_TRUE(map.erase(a));
+  ASSERT_FALSE(map.erase(a));
+  ASSERT_EQ(map.find(a), nullptr);
+  ASSERT_EQ(*map.find(c), 3);
+  ASSERT_EQ(*map.find(b), 2);
+  ASSERT_EQ(map.size(), 2u);
+
+  // `a`'s slot is reused with a new generation
+  auto const d = map.insert(4);
+  ASSERT_EQ(entity_map::index_of(d), entity_map::index_of(a));
+  ASSERT_NE(d, a);
+  ASSERT_FALSE(map.contains(a));
+  ASSERT_EQ(*map.find(d), 4);
+}
+
+TEST(slot_map, dense_iteration)
+{
+  entity_map map;
+  std::vector<entity> keys;
+
+  for (int i = 0; i < 10; ++i)
+    keys.push_back(map.insert(i));
+  for (int i = 0; i < 10; i += 3)
+    map.erase(keys[static_cast<std::size_t>(i)]);
+
+  int sum = 0;
+
+  for (auto value : map)
+    sum += value;
+  ASSERT_EQ(sum, 1 + 2 + 4 + 5 + 7 + 8);
+  for (std::size_t i(0u); i != map.size(); ++i)
+    ASSERT_EQ(map[map.key_at(i)], map.data()[i]);
+}
+
+TEST(slot_map, clear)
+{
+  entity_map map;
+  auto const a = map.insert(1);
+  auto const b = map.insert(2);
+
+  map.clear();
+  ASSERT_TRUE(map.empty());
+  ASSERT_FALSE(map.contains(a));
+  ASSERT_FALSE(map.contains(b));
+
+  auto const c = map.insert(3);
+  ASSERT_EQ(*map.find(c), 3);
+  ASSERT_FALSE(map.contains(a));
+}
+
+TEST(slot_map, generation_wrap)
+{
+  // 2 bits of generation: generations go 1, 2, 3, then back to 1, never 0
+  struct small_tag;
+  using small_map = claws::slot_map<int, small_tag, std::uint8_t, 6>;
+  small_map map;
+
+  // However long the churn, the same slot is reused
+  for (int i = 0; i < 1000; ++i)
+    {
+      auto const key = map.insert(i);
+
+      ASSERT_EQ(small_map::index_of(key), 0u);
+      ASSERT_EQ(small_map::generation_of(key), 1u + i % 3u);
+      ASSERT_EQ(map[key], i);
+      map.erase(key);
+      ASSERT_FALSE(map.contains(key));
+    }
+  ASSERT_FALSE(map.contains(small_map::key_type{}));
+}
+
+TEST(slot_map, generation_exhaustion)
+{
+  // 2 bits of generation: each slot can be used by 3 generations before it is retired
+  struct small_tag;
+  using small_map = claws::slot_map<int, small_tag, std::uint8_t, 6, std::vector, claws::slot_generation_policy::retire>;
+  small_map map;
+  std::vector<small_map::key_type> keys;
+
+  for (int i = 0; i < 3; ++i)
+    {
+      keys.push_back(map.insert(i));
+      ASSERT_EQ(small_map::index_of(keys.back()), 0u);
+      map.erase(keys.back());
+    }
+
+  auto const next = map.insert(3);
+  ASSERT_EQ(small_map::index_of(next), 1u);
+  for (auto key : keys)
+    ASSERT_FALSE(map.contains(key));
+  // Slot 0 is retired with generation 0, the null key still must not match it
+  ASSERT_FALSE(map.contains(small_map::key_type{}));
+}
+
+TEST(slot_map, index_exhaustion)
+{
+  struct tiny_tag;
+  using tiny_map = claws::slot_map<int, tiny_tag, std::uint8_t, 2>;
+  tiny_map map;
+
+  ASSERT_EQ(tiny_map::max_size(), 3u);
+  for (int i = 0; i < 3; ++i)
+    ASSERT_NE(map.insert(i), tiny_map::key_type{});
+  ASSERT_THROW(map.insert(3), std::length_error);
+  ASSERT_EQ(map.size(), 3u);
+}
+
+TEST(slot_map, move_only_values)
+{
+  struct pointer_tag;
+  claws::slot_map<std::unique_ptr<int>, pointer_tag> map;
+  auto const a = map.emplace(std::make_unique<int>(1));
+  auto const b = map.emplace(std::make_unique<int>(2));
+
+  map.erase(a);
+  ASSERT_EQ(**map.find(b), 2);
+}
+
+TEST(slot_map, reuse_after_move)
+{
+  entity_map map;
+  auto const a = map.insert(1);
+  auto const b = map.insert(2);
+
+  map.erase(a);
+
+  entity_map moved(std::move(map));
+
+  ASSERT_EQ(moved[b], 2);
+  // The moved-from map starts over, without the free list of the slots it lost
+  ASSERT_EQ(*map.find(map.insert(3)), 3);
+  ASSERT_EQ(map.size(), 1u);
+
+  map.erase(map.insert(4));
+  moved = std::move(map);
+  ASSERT_EQ(moved.size(), 1u);
+  ASSERT_EQ(*map.find(map.insert(5)), 5);
+}
+
+TEST(slot_map, matches_unordered_map)
+{
+  entity_map map;
+  std::unordered_map<std::uint32_t, int> reference;
+  std::vector<entity> keys;
+  std::mt19937 engine(42);
+
+  for (int i = 0; i < 100000; ++i)
+    {
+      if (keys.empty() || engine() % 3)
+        {
+          auto const key = map.insert(i);
+
+          ASSERT_TRUE(reference.emplace(key.data, i).second);
+          keys.push_back(key);
+        }
+      else
+        {
+          auto const position = engine() % keys.size();
+          auto const key = keys[position];
+
+          ASSERT_EQ(map.erase(key), reference.erase(key.data) == 1);
+          // Keep some stale keys around
+          if (engine() % 2)
+            {
+              keys[position] = keys.back();
+              keys.pop_back();
+            }
+        }
+    }
+  ASSERT_EQ(map.size(), reference.size());
+  for (auto key : keys)
+    {
+      auto const found = reference.find(key.data);
+
+      if (found == reference.end())
+        ASSERT_EQ(map.find(key), nullptr);
+      else
+        ASSERT_EQ(*map.find(key), found->second);
+    }
+}
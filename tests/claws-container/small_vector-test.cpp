@@ -0,0 +1,198 @@
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/container/small_vector.hpp>
+#include <claws/container/static_vector.hpp>
+
+namespace
+{
+  constexpr claws::static_vector<int, 8> build_static()
+  {
+    claws::static_vector<int, 8> values{1, 2, 4};
+
+    values.insert(values.begin() + 2, 3);
+    values.push_back(5);
+    values.erase(values.begin());
+    values.pop_back();
+    return values;
+  }
+
+  // Counts allocations, and may refuse to share storage between vectors
+  template<class T>
+  struct counting_allocator
+  {
+    using value_type = T;
+
+    int *allocations;
+    int id{0};
+
+    explicit counting_allocator(int *allocations, int id = 0) noexcept
+      : allocations(allocations)
+      , id(id)
+    {}
+
+    template<class U>
+    counting_allocator(counting_allocator<U> const &other) noexcept
+      : allocations(other.allocations)
+      , id(other.id)
+    {}
+
+    T *allocate(std::size_t count)
+    {
+      ++*allocations;
+      return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *pointer, std::size_t count) noexcept
+    {
+      std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template<class U>
+    bool operator==(counting_allocator<U> const &other) const noexcept
+    {
+      return id == other.id;
+    }
+
+    template<class U>
+    bool operator!=(counting_allocator<U> const &other) const noexcept
+    {
+      return id != other.id;
+    }
+  };
+}
+
+TEST(static_vector, constexpr_correctness)
+{
+  constexpr auto values = build_static();
+
+  static_assert(values.size() == 3u);
+  static_assert(values[0] == 2 && values[1] == 3 && values[2] == 4);
+  static_assert(std::is_trivially_copyable_v<claws::static_vector<int, 8>>);
+  ASSERT_EQ(values, (std::vector<int>{2, 3, 4}));
+}
+
+TEST(static_vector, non_trivial)
+{
+  claws::static_vector<std::string, 4> values;
+
+  values.push_back("a string long enough to be allocated");
+  values.emplace_back(3u, 'b');
+  values.insert(values.begin(), "first");
+  ASSERT_NE(values.try_emplace_back("last"), nullptr);
+  ASSERT_TRUE(values.full());
+  ASSERT_EQ(values.try_emplace_back("no room"), nullptr);
+  ASSERT_THROW(values.push_back("no room"), std::bad_alloc);
+  ASSERT_EQ(values.size(), 4u);
+
+  auto copy = values;
+  auto moved = std::move(copy);
+
+  moved.erase(moved.begin() + 1, moved.begin() + 3);
+  ASSERT_EQ(moved, (std::vector<std::string>{"first", "last"}));
+  moved.resize(3u, "c");
+  ASSERT_EQ(moved.back(), "c");
+  values.clear();
+  ASSERT_TRUE(values.empty());
+}
+
+TEST(small_vector, spill)
+{
+  int allocations = 0;
+  claws::small_vector<int, 4, counting_allocator<int>> values{counting_allocator<int>(&allocations)};
+
+  for (int i(0); i != 4; ++i)
+    values.push_back(i);
+  ASSERT_TRUE(values.is_inline());
+  ASSERT_EQ(allocations, 0);
+  // Pushing a value of the vector while it grows
+  values.push_back(values[0]);
+  ASSERT_FALSE(values.is_inline());
+  ASSERT_EQ(allocations, 1);
+  ASSERT_EQ(values.capacity(), 8u);
+  for (int i(0); i != 100; ++i)
+    values.insert(values.begin() + 2, values.back());
+  ASSERT_EQ(values.size(), 105u);
+  ASSERT_EQ(values[1], 1);
+  ASSERT_EQ(values[2], 0);
+  ASSERT_EQ(values[104], 0);
+  values.erase(values.begin() + 2, values.begin() + 102);
+  ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 0}));
+  values.pop_back();
+  values.shrink_to_fit();
+  ASSERT_TRUE(values.is_inline());
+  ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(small_vector, resize_with_own_value)
+{
+  std::string const long_string(40u, 'x');
+  claws::small_vector<std::string, 2> values{long_string, "b"};
+
+  // Growing relocates the value being copied
+  values.resize(8u, values[0]);
+  ASSERT_EQ(values.size(), 8u);
+  for (std::size_t i(2u); i != 8u; ++i)
+    ASSERT_EQ(values[i], long_string);
+  values.resize(10u, values[1]);
+  ASSERT_EQ(values[9], "b");
+}
+
+TEST(small_vector, moves)
+{
+  using vector = claws::small_vector<std::unique_ptr<int>, 2>;
+
+  static_assert(claws::is_trivially_relocatable_v<std::unique_ptr<int>>);
+  static_assert(claws::is_trivially_relocatable_v<std::unique_ptr<int, void (*)(int *)>>);
+  static_assert(!claws::is_trivially_relocatable_v<std::string>);
+
+  vector inline_values;
+  vector heap_values;
+
+  inline_values.push_back(std::make_unique<int>(1));
+  for (int i(0); i != 10; ++i)
+    heap_values.push_back(std::make_unique<int>(i));
+
+  auto const heap_data = heap_values.data();
+  vector stolen(std::move(heap_values));
+
+  ASSERT_EQ(stolen.data(), heap_data);
+  ASSERT_TRUE(heap_values.empty());
+  ASSERT_TRUE(heap_values.is_inline());
+
+  vector relocated(std::move(inline_values));
+
+  ASSERT_TRUE(relocated.is_inline());
+  ASSERT_EQ(*relocated[0], 1);
+  relocated = std::move(stolen);
+  ASSERT_EQ(*relocated[9], 9);
+  relocated.resize(1u);
+  ASSERT_EQ(*relocated.front(), 0);
+}
+
+TEST(small_vector, copies_and_allocators)
+{
+  int allocations = 0;
+  using allocator = counting_allocator<std::string>;
+  using vector = claws::small_vector<std::string, 2, allocator>;
+
+  vector values({"a", "b", "c"}, allocator(&allocations));
+  vector copy(values);
+
+  ASSERT_EQ(copy, values);
+  ASSERT_EQ(allocations, 2);
+
+  // Unequal allocators: values move one by one into the target's storage
+  vector other(allocator(&allocations, 1));
+
+  other = std::move(copy);
+  ASSERT_EQ(other, (std::vector<std::string>{"a", "b", "c"}));
+  ASSERT_EQ(allocations, 3);
+  ASSERT_TRUE(copy.empty());
+
+  vector sized(3u, "x", allocator(&allocations));
+
+  ASSERT_EQ(sized[2], "x");
+}
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/container/tagged_vector.hpp>
+
+namespace
+{
+  struct node_tag;
+  struct edge_tag;
+
+  using node_index = claws::tagged_index<node_tag>;
+  using edge_index = claws::tagged_index<edge_tag>;
+
+  struct edge
+  {
+    node_index from;
+    node_index to;
+  };
+
+  int sum(claws::tagged_span<node_tag, int const> values)
+  {
+    int result = 0;
+
+    for (auto index : values.indices())
+      result += values[index];
+    return result;
+  }
+}
+
+TEST(tagged_vector, indices)
+{
+  static_assert(std::is_same_v<node_index, claws::tagged_data<std::uint32_t, std::int32_t, node_tag>>);
+  static_assert(!std::is_convertible_v<edge_index, node_index>);
+  // Two 32 bits indices instead of two pointers
+  static_assert(sizeof(edge) == 8u);
+
+  claws::tagged_vector<node_tag, int> nodes{10, 20};
+  claws::tagged_vector<edge_tag, edge> edges;
+
+  auto const third = nodes.push_back(30);
+
+  ASSERT_EQ(third, node_index(2u));
+  ASSERT_EQ(nodes.size(), node_index(3u));
+  ASSERT_EQ(nodes[third], 30);
+
+  auto const link = edges.emplace_back(edge{node_index(0u), third});
+
+  ASSERT_EQ(nodes[edges[link].to], 30);
+  ASSERT_EQ(nodes.index_of(nodes.back()), third);
+
+  std::vector<node_index> visited;
+
+  for (auto index : nodes.indices())
+    visited.push_back(index);
+  ASSERT_EQ(visited, (std::vector<node_index>{node_index(0u), node_index(1u), node_index(2u)}));
+
+  nodes.resize(node_index(5u), 1);
+  ASSERT_EQ(nodes[node_index(4u)], 1);
+  nodes.pop_back();
+  ASSERT_EQ(nodes.size(), node_index(4u));
+  ASSERT_EQ(nodes.max_size().data, ~std::uint32_t(0u));
+}
+
+TEST(tagged_vector, size_limit)
+{
+  claws::tagged_vector<node_tag, int, std::uint8_t> small(claws::tagged_index<node_tag, std::uint8_t>(254u));
+
+  // Index 254 is the last one that fits in 8 bits, then indices would wrap around
+  ASSERT_EQ(small.push_back(1).data, 254u);
+  ASSERT_THROW(small.push_back(2), std::length_error);
+  ASSERT_EQ(small.size().data, 255u);
+}
+
+TEST(tagged_vector, span)
+{
+  claws::tagged_vector<node_tag, int> nodes{1, 2, 3, 4};
+  claws::tagged_vector<node_tag, int> const &const_nodes = nodes;
+
+  ASSERT_EQ(sum(nodes), 10);
+  ASSERT_EQ(sum(const_nodes.span()), 10);
+
+  auto const middle = nodes.span().subspan(node_index(1u), node_index(2u));
+
+  ASSERT_EQ(middle.size(), node_index(2u));
+  ASSERT_EQ(middle[node_index(0u)], 2);
+  middle[node_index(1u)] = 5;
+  ASSERT_EQ(nodes[node_index(2u)], 5);
+  ASSERT_EQ(middle.index_of(nodes[node_index(2u)]), node_index(1u));
+  ASSERT_TRUE((claws::tagged_span<node_tag, int>().empty()));
+
+  claws::tagged_vector<node_tag, std::uint8_t, std::uint8_t> small(claws::tagged_index<node_tag, std::uint8_t>(3u));
+
+  ASSERT_EQ(small.size().data, 3u);
+}
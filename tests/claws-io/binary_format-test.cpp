@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/io/binary_format.hpp>
+#include <claws/io/mapped_file.hpp>
+#if defined(CLAWS_HAS_MAPPED_FILE)
+#include <unistd.h>
+#endif
+
+namespace
+{
+  struct particle_tag;
+
+  using particle_id = claws::tagged_data<std::uint32_t, std::uint32_t, particle_tag>;
+
+  struct particle
+  {
+    claws::vect<float, 3> position;
+    particle_id id;
+    std::uint16_t flags;
+    double mass;
+  };
+
+  template<class... T>
+  struct type_list
+  {};
+
+  template<class T>
+  std::vector<std::byte> write(std::vector<T> const &values)
+  {
+    std::vector<std::byte> buffer(claws::binary_size<T>(values.size()));
+
+    EXPECT_EQ(claws::write_binary(buffer.data(), buffer.size(), values.data(), values.size()), buffer.size());
+    return buffer;
+  }
+
+  /// What a host of opposite endianness would have written, given the layout of `T`
+  template<class T>
+  void make_foreign(std::vector<std::byte> &buffer, std::size_t count)
+  {
+    claws::binary_header header;
+
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    claws::impl::binary::swap_elements<T>(buffer.data() + header.payload_offset, count);
+    claws::impl::binary::swap_header(header);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+  }
+}
+
+template<>
+struct claws::binary_fields<particle>
+{
+  // Any type list works
+  using type = type_list<claws::vect<float, 3>, particle_id, std::uint16_t, double>;
+};
+
+TEST(binary_format, signatures)
+{
+  static_assert(claws::binary_signature<float>() != claws::binary_signature<std::int32_t>());
+  static_assert(claws::binary_signature<std::int32_t>() != claws::binary_signature<std::uint32_t>());
+  static_assert(claws::binary_signature<claws::vect<float, 3>>() != claws::binary_signature<std::array<float, 3>>());
+  static_assert(claws::binary_signature<claws::vect<float, 3>>() != claws::binary_signature<claws::vect<float, 4>>());
+  static_assert(claws::binary_signature<particle_id>() != claws::binary_signature<std::uint32_t>());
+  static_assert(claws::binary_signature<particle>() == claws::binary_signature<particle>());
+  static_assert(claws::impl::binary::traits<claws::vect<float, 3>>::scalar_size == 4);
+  static_assert(claws::impl::binary::traits<particle>::scalar_size == 0);
+}
+
+TEST(binary_format, in_place)
+{
+  std::vector<claws::vect<float, 3>> const vects{{1.f, 2.f, 3.f}, {-4.f, 5.5f, 0.f}};
+  auto buffer = write(vects);
+  std::error_code error;
+  auto const view = claws::view_binary<claws::vect<float, 3>>(buffer.data(), buffer.size(), &error);
+
+  ASSERT_FALSE(error);
+  ASSERT_EQ(view.size(), 2);
+  // No copy: the span points into the buffer
+  ASSERT_EQ(reinterpret_cast<std::byte const *>(view.begin()), (buffer.data() + claws::binary_size<claws::vect<float, 3>>(0u)));
+  ASSERT_TRUE(std::equal(view.begin(), view.end(), vects.begin()));
+
+  std::vector<particle> const particles{{{1.f, 2.f, 3.f}, particle_id(7u), 3u, 0.5}, {{0.f, 0.f, 1.f}, particle_id(9u), 0u, 2.0}};
+  auto particle_buffer = write(particles);
+  auto const particle_view = claws::view_binary<particle>(particle_buffer.data(), particle_buffer.size());
+
+  ASSERT_EQ(particle_view.size(), 2);
+  ASSERT_EQ(particle_view.begin()[1].id, particle_id(9u));
+  ASSERT_EQ(particle_view.begin()[1].mass, 2.0);
+
+  using record = std::array<std::int16_t, 4>;
+  auto const empty = write(std::vector<record>{});
+
+  ASSERT_EQ(claws::view_binary<record>(empty.data(), empty.size(), &error).size(), 0);
+  ASSERT_FALSE(error);
+}
+
+TEST(binary_format, foreign_endianness)
+{
+  std::vector<particle> const particles{{{1.f, 2.f, 3.f}, particle_id(7u), 3u, 0.5}, {{0.f, 0.f, 1.f}, particle_id(0x01020304u), 0x0506u, -2.0}};
+  auto buffer = write(particles);
+  std::error_code error;
+
+  make_foreign<particle>(buffer, particles.size());
+  ASSERT_EQ(claws::view_binary<particle>(buffer.data(), buffer.size(), &error).size(), 0);
+  ASSERT_EQ(error, std::errc::not_supported);
+
+  auto const loaded = claws::load_binary<particle>(buffer.data(), buffer.size());
+
+  ASSERT_EQ(loaded.size(), 2);
+  ASSERT_EQ(loaded.begin()[1].id, particle_id(0x01020304u));
+  ASSERT_EQ(loaded.begin()[1].flags, 0x0506u);
+  ASSERT_EQ(loaded.begin()[1].mass, -2.0);
+  ASSERT_TRUE(loaded.begin()[0].position == (claws::vect<float, 3>{1.f, 2.f, 3.f}));
+  // Converted once: the buffer is now native
+  ASSERT_EQ(claws::view_binary<particle>(buffer.data(), buffer.size()).size(), 2);
+
+  // Bulk path, swapping words
+  std::vector<claws::vect<std::uint32_t, 3>> const vects{{1u, 2u, 3u}, {0xAABBCCDDu, 0u, 5u}};
+  auto vect_buffer = write(vects);
+
+  make_foreign<claws::vect<std::uint32_t, 3>>(vect_buffer, vects.size());
+
+  auto const vect_view = claws::load_binary<claws::vect<std::uint32_t, 3>>(vect_buffer.data(), vect_buffer.size());
+
+  ASSERT_TRUE(std::equal(vect_view.begin(), vect_view.end(), vects.begin()));
+}
+
+TEST(binary_format, errors)
+{
+  std::vector<std::uint32_t> const values{1u, 2u, 3u};
+  auto buffer = write(values);
+  std::error_code error;
+
+  ASSERT_EQ(claws::view_binary<float>(buffer.data(), buffer.size(), &error).size(), 0);
+  ASSERT_EQ(error, std::errc::invalid_argument);
+  ASSERT_EQ(claws::view_binary<std::uint32_t>(buffer.data(), buffer.size() - 1u, &error).size(), 0);
+  ASSERT_EQ(error, std::errc::bad_message);
+  ASSERT_EQ(claws::view_binary<std::uint32_t>(buffer.data(), 16u, &error).size(), 0);
+  ASSERT_EQ(error, std::errc::bad_message);
+  ASSERT_EQ(claws::write_binary(buffer.data(), buffer.size() - 1u, values.data(), values.size()), 0u);
+
+  std::vector<std::byte> misaligned(buffer.size() + 1u);
+
+  std::copy(buffer.begin(), buffer.end(), misaligned.begin() + 1);
+  ASSERT_EQ(claws::view_binary<std::uint32_t>(misaligned.data() + 1, buffer.size(), &error).size(), 0);
+  ASSERT_EQ(error, std::errc::bad_address);
+
+  buffer[0] = std::byte{'X'};
+  ASSERT_EQ(claws::view_binary<std::uint32_t>(buffer.data(), buffer.size(), &error).size(), 0);
+  ASSERT_EQ(error, std::errc::bad_message);
+}
+
+#if defined(CLAWS_HAS_MAPPED_FILE)
+TEST(binary_format, mapped_file)
+{
+  auto const path = "/tmp/claws-binary-test-" + std::to_string(::getpid());
+  std::vector<double> values(1000u);
+
+  for (std::size_t i(0u); i != values.size(); ++i)
+    values[i] = static_cast<double>(i) * 0.5;
+  {
+    auto file = claws::mapped_file::open(path.c_str(), claws::map_access::read_write);
+
+    ASSERT_TRUE(file.grow(claws::binary_size<double>(values.size())));
+    ASSERT_EQ(claws::write_binary(file.data(), file.size(), values.data(), values.size()), file.size());
+  }
+
+  auto const file = claws::mapped_file::open(path.c_str());
+  auto const view = claws::view_binary<double>(file.bytes());
+
+  ASSERT_TRUE(std::equal(view.begin(), view.end(), values.begin(), values.end()));
+  std::remove(path.c_str());
+}
+#endif
@@ -0,0 +1,168 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <claws/container/relocatable_arena.hpp>
+#include <claws/io/mapped_file.hpp>
+
+namespace
+{
+  /// Unique path in the temporary directory, removed on destruction
+  struct temporary_path
+  {
+    std::string path;
+
+    explicit temporary_path(char const *name)
+      : path(std::string(::testing::TempDir()) + "claws-" + std::to_string(::getpid()) + "-" + name)
+    {}
+
+    ~temporary_path()
+    {
+      std::remove(path.c_str());
+    }
+  };
+
+  void write_file(std::string const &path, std::string const &content)
+  {
+    std::ofstream(path, std::ios::binary) << content;
+  }
+}
+
+TEST(mapped_file, read_only)
+{
+  temporary_path path("read_only");
+
+  write_file(path.path, "hello, mapped world");
+
+  auto file = claws::mapped_file::open(path.path.c_str());
+
+  ASSERT_TRUE(file.is_open());
+  ASSERT_EQ(file.size(), 19u);
+  ASSERT_EQ(file.chars(), "hello, mapped world");
+  ASSERT_EQ(file.bytes().size(), 19);
+  ASSERT_EQ(static_cast<char>(*file.bytes().begin()), 'h');
+  ASSERT_TRUE(file.advise(claws::map_advice::sequential));
+  ASSERT_TRUE(file.advise(claws::map_advice::willneed));
+
+  std::error_code error;
+
+  ASSERT_FALSE(file.grow(100u, &error));
+  ASSERT_EQ(error, std::errc::bad_file_descriptor);
+}
+
+TEST(mapped_file, missing_file)
+{
+  std::error_code error;
+  auto const file = claws::mapped_file::open("/nonexistent/claws/file", claws::map_access::read_only, &error);
+
+  ASSERT_FALSE(file.is_open());
+  ASSERT_EQ(error, std::errc::no_such_file_or_directory);
+  ASSERT_EQ(file.size(), 0u);
+}
+
+TEST(mapped_file, typed_view)
+{
+  temporary_path path("typed_view");
+  std::vector<std::uint32_t> values{1u, 2u, 3u, 0xDEADBEEFu};
+
+  write_file(path.path, std::string(reinterpret_cast<char const *>(values.data()), values.size() * sizeof(std::uint32_t)) + "xy");
+
+  auto const file = claws::mapped_file::open(path.path.c_str());
+  auto const view = file.as<std::uint32_t>();
+
+  // Trailing bytes are ignored
+  ASSERT_EQ(view.size(), 4);
+  ASSERT_EQ(view[3], 0xDEADBEEFu);
+  ASSERT_EQ(std::vector<std::uint32_t>(view.begin(), view.end()), values);
+}
+
+TEST(mapped_file, grow_and_write)
+{
+  temporary_path path("grow");
+
+  {
+    auto file = claws::mapped_file::open(path.path.c_str(), claws::map_access::read_write);
+
+    ASSERT_TRUE(file.is_open());
+    ASSERT_EQ(file.size(), 0u);
+    ASSERT_EQ(file.data(), nullptr);
+    ASSERT_TRUE(file.grow(4096u));
+    std::memcpy(file.data(), "abc", 3);
+    // Remapping keeps the content
+    ASSERT_TRUE(file.grow(1u << 20u));
+    ASSERT_EQ(file.size(), 1u << 20u);
+    ASSERT_EQ(file.chars().substr(0, 4), std::string_view("abc\0", 4));
+    file.data()[(1u << 20u) - 1u] = std::byte{'z'};
+    ASSERT_TRUE(file.grow(10u));
+    ASSERT_EQ(file.size(), 1u << 20u);
+    ASSERT_TRUE(file.sync());
+  }
+
+  auto const file = claws::mapped_file::open(path.path.c_str());
+
+  ASSERT_EQ(file.size(), 1u << 20u);
+  ASSERT_EQ(file.chars().substr(0, 3), "abc");
+  ASSERT_EQ(file.chars().back(), 'z');
+}
+
+TEST(mapped_file, read_only_arena)
+{
+  temporary_path path("arena");
+
+  {
+    auto file = claws::mapped_file::open(path.path.c_str(), claws::map_access::read_write);
+
+    ASSERT_TRUE(file.grow(4096u));
+
+    auto const arena = claws::relocatable_arena::create(file.data(), file.size());
+
+    arena->set_root(arena->construct<std::uint64_t>(42u));
+    ASSERT_TRUE(file.sync());
+  }
+
+  // Attaching for reading never writes to the block: a write would fault on the read-only mapping
+  auto const file = claws::mapped_file::open(path.path.c_str());
+  void const *block = file.data();
+  auto const arena = claws::relocatable_arena::attach(block, file.size());
+
+  ASSERT_NE(arena, nullptr);
+  static_assert(std::is_same_v<decltype(arena->get_root<std::uint64_t>()), std::uint64_t const *>);
+  ASSERT_EQ(*arena->get_root<std::uint64_t>(), 42u);
+  ASSERT_EQ(arena->get_capacity(), 4096u);
+  ASSERT_EQ(claws::relocatable_arena::attach(block, 2048u), nullptr);
+}
+
+TEST(mapped_file, regions)
+{
+  temporary_path path("regions");
+  auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+  write_file(path.path, std::string(page, 'a') + std::string(page, 'b'));
+
+  auto const file = claws::mapped_file::open(path.path.c_str());
+  auto region = claws::mapped_region::map(file.get_fd(), page, page, claws::map_access::read_only);
+
+  ASSERT_FALSE(region.empty());
+  ASSERT_EQ(region.chars(), std::string(page, 'b'));
+
+  auto const moved = std::move(region);
+
+  ASSERT_TRUE(region.empty());
+  ASSERT_EQ(moved.size(), page);
+
+  std::error_code error;
+
+  // Misaligned offsets are refused by mmap
+  ASSERT_TRUE(claws::mapped_region::map(file.get_fd(), 1u, page, claws::map_access::read_only, &error).empty());
+  ASSERT_EQ(error, std::errc::invalid_argument);
+}
+
+#endif
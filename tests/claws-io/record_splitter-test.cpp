@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/io/record_splitter.hpp>
+
+namespace
+{
+  std::vector<std::string_view> reference_split(std::string_view buffer, claws::record_format format)
+  {
+    std::vector<std::string_view> records;
+    std::size_t start(0u);
+    bool quoted = false;
+
+    for (std::size_t i(0u); i != buffer.size(); ++i)
+      if (format.quoted && buffer[i] == format.quote)
+        quoted = !quoted;
+      else if (buffer[i] == format.delimiter && !quoted)
+        {
+          records.push_back(buffer.substr(start, i - start));
+          start = i + 1;
+        }
+    if (start != buffer.size())
+      records.push_back(buffer.substr(start));
+    return records;
+  }
+
+  std::vector<std::string_view> split(std::string_view buffer, claws::record_format format)
+  {
+    auto const records = claws::split_records(buffer, format);
+
+    return {records.begin(), records.end()};
+  }
+
+  std::string random_buffer(std::size_t size, std::mt19937 &random)
+  {
+    std::string buffer(size, 'a');
+    std::uniform_int_distribution<int> pick(0, 15);
+
+    for (auto &c : buffer)
+      switch (pick(random))
+        {
+        case 0:
+          c = '\n';
+          break;
+        case 1:
+          c = '"';
+          break;
+        case 2:
+          c = ',';
+          break;
+        default:
+          c = static_cast<char>('a' + pick(random));
+        }
+    return buffer;
+  }
+
+  void check_against_reference()
+  {
+    std::mt19937 random(42);
+
+    for (std::size_t size : {0u, 1u, 63u, 64u, 65u, 127u, 128u, 1000u, 4099u})
+      for (auto format : {claws::record_format{}, claws::csv_records, claws::record_format{',', true, '"'}})
+        {
+          auto const buffer = random_buffer(size, random);
+
+          ASSERT_EQ(split(buffer, format), reference_split(buffer, format)) << size;
+        }
+  }
+}
+
+TEST(record_splitter, lines)
+{
+  ASSERT_EQ(split("a\nbc\n\nd", {}), (std::vector<std::string_view>{"a", "bc", "", "d"}));
+  // A trailing delimiter doesn't make an empty record
+  ASSERT_EQ(split("a\n", {}), (std::vector<std::string_view>{"a"}));
+  ASSERT_EQ(split("\n", {}), (std::vector<std::string_view>{""}));
+  ASSERT_TRUE(split("", {}).empty());
+  ASSERT_EQ(split("a|b", {'|'}), (std::vector<std::string_view>{"a", "b"}));
+
+  std::string const long_line(200u, 'x');
+
+  ASSERT_EQ(split(long_line + "\n" + long_line, {}), (std::vector<std::string_view>{long_line, long_line}));
+}
+
+TEST(record_splitter, quoted)
+{
+  std::string_view const csv = "id,text\n1,\"multi\nline\"\n2,\"with \"\"quotes\"\"\n and newline\"\n";
+
+  ASSERT_EQ(split(csv, claws::csv_records),
+            (std::vector<std::string_view>{"id,text", "1,\"multi\nline\"", "2,\"with \"\"quotes\"\"\n and newline\""}));
+  ASSERT_EQ(split("1,\"a,b\",c", {',', true}), (std::vector<std::string_view>{"1", "\"a,b\"", "c"}));
+
+  // Quoting state carries across blocks
+  std::string const long_field = "\"" + std::string(100u, '\n') + "\"";
+
+  ASSERT_EQ(split(long_field + "\nx", claws::csv_records), (std::vector<std::string_view>{long_field, "x"}));
+}
+
+TEST(record_splitter, forced_tiers)
+{
+  auto const initial = claws::get_simd_tier();
+
+  for (auto tier : {claws::simd_tier::scalar, claws::simd_tier::sse2, claws::simd_tier::avx2, claws::simd_tier::avx512})
+    {
+      if (tier > claws::get_max_simd_tier())
+        break;
+      ASSERT_EQ(claws::set_simd_tier(tier), tier);
+      check_against_reference();
+    }
+  claws::set_simd_tier(initial);
+}
+
+TEST(record_splitter, chunks)
+{
+  std::mt19937 random(7);
+
+  for (auto format : {claws::record_format{}, claws::csv_records})
+    for (std::size_t chunk_count : {1u, 2u, 3u, 8u, 100u})
+      {
+        auto const buffer = random_buffer(5000u, random);
+        std::vector<std::string_view> records;
+        std::size_t covered(0u);
+
+        for (auto chunk : claws::split_chunks(buffer, format, chunk_count))
+          {
+            // Chunks are contiguous, and made of whole records
+            ASSERT_EQ(chunk.data(), buffer.data() + covered);
+            covered += chunk.size();
+            for (auto record : claws::split_records(chunk, format))
+              records.push_back(record);
+          }
+        ASSERT_EQ(covered, buffer.size());
+        ASSERT_EQ(records, reference_split(buffer, format));
+      }
+}
+
+TEST(record_splitter, parallel)
+{
+  std::mt19937 random(3);
+
+  for (auto format : {claws::record_format{}, claws::csv_records})
+    for (unsigned threads : {1u, 4u})
+      {
+        auto const buffer = random_buffer(20000u, random);
+        std::mutex mutex;
+        std::vector<std::string_view> records;
+
+        claws::for_each_record_parallel(buffer, format, threads, [&](std::string_view record) {
+          std::lock_guard lock(mutex);
+
+          records.push_back(record);
+        });
+        std::sort(records.begin(), records.end(), [](auto lh, auto rh) { return lh.data() < rh.data(); });
+        ASSERT_EQ(records, reference_split(buffer, format));
+      }
+}
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/io/text_codec.hpp>
+
+namespace
+{
+  template<class T>
+  std::vector<T> round_trip(std::vector<T> const &values, claws::text_layout layout = {})
+  {
+    std::string text;
+    std::vector<T> result(values.size());
+
+    claws::append_text(text, values.data(), values.size(), layout);
+
+    auto const parsed = claws::parse_text(text.data(), text.data() + text.size(), result.data(), result.size(), layout);
+
+    EXPECT_EQ(parsed.ec, std::errc{});
+    EXPECT_EQ(parsed.count, values.size());
+    // Stops right after the last value, before its record separator
+    EXPECT_EQ(parsed.ptr, text.data() + text.size() - 1);
+    return result;
+  }
+}
+
+TEST(text_codec, integers)
+{
+  std::mt19937_64 random(42);
+  std::vector<std::int64_t> values{0, -1, 1, 12345678, 123456789, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()};
+
+  for (int i(0); i != 1000; ++i)
+    values.push_back(static_cast<std::int64_t>(random()) >> (random() % 64u));
+  ASSERT_EQ(round_trip(values), values);
+
+  std::vector<std::uint64_t> const unsigned_values{0u, 99999999u, 100000000u, std::numeric_limits<std::uint64_t>::max()};
+
+  ASSERT_EQ(round_trip(unsigned_values), unsigned_values);
+
+  std::vector<std::int8_t> const small{-128, -1, 0, 127};
+
+  ASSERT_EQ(round_trip(small), small);
+}
+
+TEST(text_codec, floating_points)
+{
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+  std::vector<double> values{0.0, -0.5, 1e-300, std::numeric_limits<double>::max(), std::numeric_limits<double>::denorm_min()};
+  std::vector<float> floats{std::numeric_limits<float>::lowest(), 0.1f, std::numeric_limits<float>::denorm_min(), -1e-40f};
+
+  for (int i(0); i != 1000; ++i)
+    {
+      values.push_back(distribution(random));
+      floats.push_back(static_cast<float>(distribution(random)));
+    }
+  ASSERT_EQ(round_trip(values), values);
+  ASSERT_EQ(round_trip(floats), floats);
+}
+
+TEST(text_codec, vects)
+{
+  std::vector<claws::vect<float, 3>> const values{{1.5f, -2.f, 3.25f}, {0.f, 0.f, 0.f}, {1e-20f, 1e20f, -0.125f}};
+  std::string text;
+
+  claws::append_text(text, values.data(), values.size());
+  ASSERT_EQ(text.substr(0u, 20u), "1.5 -2 3.25\n0 0 0\n1e");
+  ASSERT_TRUE(round_trip(values) == values);
+  ASSERT_TRUE(round_trip(values, {',', ';'}) == values);
+
+  std::vector<claws::vect<int, 2>> const ints{{1, 2}, {-3, 4}};
+
+  ASSERT_TRUE(round_trip(ints) == ints);
+}
+
+TEST(text_codec, errors)
+{
+  std::int32_t values[4] = {};
+  std::string_view text = " 1  2\n\t3 x";
+  auto result = claws::parse_text(text.data(), text.data() + text.size(), values, 4);
+
+  ASSERT_EQ(result.ec, std::errc::invalid_argument);
+  ASSERT_EQ(result.count, 3u);
+  ASSERT_EQ(*result.ptr, 'x');
+  ASSERT_EQ(values[2], 3);
+
+  // Ends early: fewer values, no error
+  text = "7 8\n";
+  result = claws::parse_text(text.data(), text.data() + text.size(), values, 4);
+  ASSERT_EQ(result.ec, std::errc{});
+  ASSERT_EQ(result.count, 2u);
+
+  // Overflow, with and without the 8 digit fast path
+  for (std::string_view overflow : {"2147483648", "-2147483649", "99999999999999999999"})
+    ASSERT_EQ(claws::parse_text(overflow.data(), overflow.data() + overflow.size(), values, 1).ec, std::errc::result_out_of_range) << overflow;
+
+  // A truncated vect is an error
+  claws::vect<double, 3> vect;
+
+  text = "1 2";
+  result = claws::parse_text(text.data(), text.data() + text.size(), &vect, 1);
+  ASSERT_EQ(result.ec, std::errc::invalid_argument);
+  ASSERT_EQ(result.count, 0u);
+
+  // Too small a buffer
+  char buffer[4];
+  std::int32_t const big = 123456;
+
+  ASSERT_EQ(claws::write_text(buffer, buffer + sizeof(buffer), &big, 1).ec, std::errc::value_too_large);
+}
@@ -0,0 +1,31 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <claws/utils/bit_ops.hpp>
+
+TEST(bit_ops, countr_zero)
+{
+  ASSERT_EQ(claws::countr_zero(std::uint8_t(0x80u)), 7);
+  ASSERT_EQ(claws::countr_zero(std::uint16_t(1u)), 0);
+  ASSERT_EQ(claws::countr_zero(std::uint32_t(0x00F00000u)), 20);
+  ASSERT_EQ(claws::countr_zero(std::uint64_t(1u) << 40u), 40);
+  ASSERT_EQ(claws::countr_zero(~std::uint64_t(0u)), 0);
+  ASSERT_EQ(claws::countr_zero(std::uint64_t(1u) << 63u), 63);
+}
+
+TEST(bit_ops, countl_zero)
+{
+  ASSERT_EQ(claws::countl_zero(std::uint8_t(1u)), 7);
+  ASSERT_EQ(claws::countl_zero(std::uint16_t(0x0100u)), 7);
+  ASSERT_EQ(claws::countl_zero(std::uint32_t(0x00F00000u)), 8);
+  ASSERT_EQ(claws::countl_zero(std::uint64_t(1u) << 40u), 23);
+  ASSERT_EQ(claws::countl_zero(std::uint64_t(1u)), 63);
+  ASSERT_EQ(claws::countl_zero(~std::uint64_t(0u)), 0);
+}
+
+TEST(bit_ops, byteswap)
+{
+  ASSERT_EQ(claws::byteswap(std::uint8_t(0x12u)), 0x12u);
+  ASSERT_EQ(claws::byteswap(std::uint16_t(0x1234u)), 0x3412u);
+  ASSERT_EQ(claws::byteswap(std::uint32_t(0x12345678u)), 0x78563412u);
+  ASSERT_EQ(claws::byteswap(std::uint64_t(0x0123456789ABCDEFu)), 0xEFCDAB8967452301u);
+}
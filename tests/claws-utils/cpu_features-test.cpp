@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <claws/utils/cpu_features.hpp>
+
+TEST(cpu_features, tier_parsing)
+{
+  claws::simd_tier tier = claws::simd_tier::avx2;
+
+  ASSERT_TRUE(claws::impl::parse_simd_tier("scalar", tier));
+  ASSERT_EQ(tier, claws::simd_tier::scalar);
+  ASSERT_TRUE(claws::impl::parse_simd_tier("avx512", tier));
+  ASSERT_EQ(tier, claws::simd_tier::avx512);
+  ASSERT_FALSE(claws::impl::parse_simd_tier("avx3", tier));
+  ASSERT_EQ(tier, claws::simd_tier::avx512);
+}
+
+TEST(cpu_features, best_tier)
+{
+  claws::cpu_features features;
+
+  ASSERT_EQ(claws::impl::best_simd_tier(features), claws::simd_tier::scalar);
+#if defined(CLAWS_SIMD_X86)
+  features.sse2 = true;
+  ASSERT_EQ(claws::impl::best_simd_tier(features), claws::simd_tier::sse2);
+  features.avx2 = true;
+  ASSERT_EQ(claws::impl::best_simd_tier(features), claws::simd_tier::sse2);
+  features.bmi2 = true;
+  features.popcnt = true;
+  ASSERT_EQ(claws::impl::best_simd_tier(features), claws::simd_tier::avx2);
+  features.avx512f = true;
+  ASSERT_EQ(claws::impl::best_simd_tier(features), claws::simd_tier::avx2);
+  features.avx512bw = true;
+  features.avx512vl = true;
+  features.avx512dq = true;
+  ASSERT_EQ(claws::impl::best_simd_tier(features), claws::simd_tier::avx512);
+#endif
+}
+
+TEST(cpu_features, forcing_tiers)
+{
+  auto const initial = claws::get_simd_tier();
+  auto const best = claws::get_max_simd_tier();
+
+  ASSERT_LE(initial, best);
+  ASSERT_EQ(claws::set_simd_tier(claws::simd_tier::scalar), claws::simd_tier::scalar);
+  ASSERT_EQ(claws::get_simd_tier(), claws::simd_tier::scalar);
+  // Tiers the CPU doesn't support are clamped
+  ASSERT_EQ(claws::set_simd_tier(claws::simd_tier::avx512), best);
+  ASSERT_EQ(claws::get_simd_tier(), best);
+  claws::set_simd_tier(initial);
+}
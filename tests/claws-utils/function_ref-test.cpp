@@ -0,0 +1,69 @@
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/utils/function_ref.hpp>
+
+namespace
+{
+  int twice(int value)
+  {
+    return value * 2;
+  }
+
+  int sum_transformed(std::vector<int> const &values, claws::function_ref<int(int)> transform)
+  {
+    int result = 0;
+
+    for (auto value : values)
+      result += transform(value);
+    return result;
+  }
+}
+
+TEST(function_ref, callables)
+{
+  static_assert(std::is_trivially_copyable_v<claws::function_ref<int(int)>>);
+  static_assert(sizeof(claws::function_ref<int(int)>) == 2 * sizeof(void *));
+
+  std::vector<int> const values{1, 2, 3};
+  int offset = 10;
+  auto add_offset = [&offset](int value) { return value + offset; };
+
+  ASSERT_EQ(sum_transformed(values, twice), 12);
+  ASSERT_EQ(sum_transformed(values, &twice), 12);
+  ASSERT_EQ(sum_transformed(values, add_offset), 36);
+  // References the lambda: sees its state change
+  claws::function_ref<int(int)> ref = add_offset;
+
+  offset = 0;
+  ASSERT_EQ(ref(1), 1);
+  ref = twice;
+  ASSERT_EQ(ref(1), 2);
+}
+
+TEST(function_ref, forwarding)
+{
+  std::string moved_to;
+  auto steal = [&moved_to](std::string &&value, std::string &appended) {
+    moved_to = std::move(value);
+    appended += "!";
+    return moved_to.size();
+  };
+  claws::function_ref<std::size_t(std::string &&, std::string &)> ref = steal;
+  std::string source = "a string long enough to be allocated";
+  std::string appended;
+
+  ASSERT_EQ(ref(std::move(source), appended), 36u);
+  ASSERT_EQ(moved_to, "a string long enough to be allocated");
+  ASSERT_EQ(appended, "!");
+
+  // Results convert to the signature's
+  auto const make_int = [] { return 'a'; };
+  claws::function_ref<int()> converting = make_int;
+  claws::function_ref<void()> discarding = make_int;
+
+  ASSERT_EQ(converting(), 'a');
+  discarding();
+}
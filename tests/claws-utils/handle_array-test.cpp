@@ -0,0 +1,181 @@
+#include <new>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/utils/handle_array.hpp>
+
+namespace
+{
+  struct batch_log
+  {
+    std::vector<std::vector<int>> calls;
+  };
+
+  struct logging_deleter
+  {
+    batch_log *log;
+
+    void operator()(int *values, std::size_t count) const noexcept
+    {
+      log->calls.emplace_back(values, values + count);
+    }
+  };
+
+  using int_array = claws::handle_array<int, logging_deleter>;
+
+  std::size_t fill(int *values, std::size_t count, int first)
+  {
+    std::iota(values, values + count, first);
+    return count;
+  }
+
+  /// Value whose copies throw while `failing` is set, like a vector failing to grow
+  struct fragile_value
+  {
+    static inline bool failing{false};
+
+    int value{0};
+
+    fragile_value() = default;
+
+    fragile_value(int value) noexcept
+      : value(value)
+    {}
+
+    fragile_value(fragile_value const &other)
+      : value(other.value)
+    {
+      if (failing)
+        throw std::bad_alloc();
+    }
+
+    fragile_value &operator=(fragile_value const &) = default;
+
+    bool operator==(fragile_value const &other) const noexcept
+    {
+      return value == other.value;
+    }
+  };
+
+  struct fragile_deleter
+  {
+    std::vector<int> *deleted;
+
+    void operator()(fragile_value *values, std::size_t count) const noexcept
+    {
+      for (std::size_t i(0u); i != count; ++i)
+        deleted->push_back(values[i].value);
+    }
+  };
+}
+
+TEST(handle_array, single_call_teardown)
+{
+  batch_log log;
+
+  {
+    int_array array(logging_deleter{&log});
+
+    ASSERT_EQ(array.create(1000u, [](int *values, std::size_t count) { return fill(values, count, 1); }), 1000u);
+    ASSERT_EQ(array.size(), 1000u);
+    ASSERT_EQ(array[999], 1000);
+    ASSERT_TRUE(log.calls.empty());
+  }
+  ASSERT_EQ(log.calls.size(), 1u);
+  ASSERT_EQ(log.calls[0].size(), 1000u);
+  ASSERT_EQ(log.calls[0].back(), 1000);
+}
+
+TEST(handle_array, partial_release)
+{
+  batch_log log;
+  int_array array(logging_deleter{&log});
+
+  // Creators may make fewer values than asked for
+  ASSERT_EQ(array.create(10u, [](int *values, std::size_t) { return fill(values, 6u, 1); }), 6u);
+  array.push_back(7);
+  array.push_back(8);
+
+  array.release(1u, 3u);
+  ASSERT_EQ(log.calls.size(), 1u);
+  ASSERT_EQ(log.calls[0], (std::vector<int>{2, 3}));
+  ASSERT_EQ(array[1], 0);
+
+  // Empty slots split the range in runs, and aren't released twice
+  array.release(0u, 5u);
+  ASSERT_EQ(log.calls.size(), 3u);
+  ASSERT_EQ(log.calls[1], (std::vector<int>{1}));
+  ASSERT_EQ(log.calls[2], (std::vector<int>{4, 5}));
+
+  array.retire(7u);
+  array.retire(5u);
+  array.retire(5u);
+  ASSERT_EQ(array.retired_count(), 2u);
+  ASSERT_EQ(log.calls.size(), 3u);
+  ASSERT_EQ(array.flush(), 2u);
+  ASSERT_EQ(log.calls[3], (std::vector<int>{8, 6}));
+  ASSERT_EQ(array.flush(), 0u);
+  ASSERT_EQ(log.calls.size(), 4u);
+}
+
+TEST(handle_array, compaction)
+{
+  batch_log log;
+  int_array array(logging_deleter{&log});
+  std::vector<std::pair<std::size_t, std::size_t>> moves;
+
+  array.create(6u, [](int *values, std::size_t count) { return fill(values, count, 1); });
+  array.retire(0u);
+  array.release(2u, 4u);
+  ASSERT_EQ(array.compact([&moves](std::size_t from, std::size_t to) { moves.emplace_back(from, to); }), 3u);
+  ASSERT_EQ(moves, (std::vector<std::pair<std::size_t, std::size_t>>{{1u, 0u}, {4u, 1u}, {5u, 2u}}));
+  ASSERT_EQ(std::vector<int>(array.begin(), array.end()), (std::vector<int>{2, 5, 6}));
+  ASSERT_EQ(array.compact(), 3u);
+
+  // A compacted array is torn down in one call, retired values included in their own
+  log.calls.clear();
+  array.clear();
+  ASSERT_EQ(log.calls.size(), 2u);
+  ASSERT_EQ(log.calls[0], (std::vector<int>{1}));
+  ASSERT_EQ(log.calls[1], (std::vector<int>{2, 5, 6}));
+  ASSERT_TRUE(array.empty());
+}
+
+TEST(handle_array, move)
+{
+  batch_log log;
+
+  {
+    int_array array(logging_deleter{&log});
+
+    array.push_back(1);
+
+    int_array moved(std::move(array));
+
+    ASSERT_TRUE(array.empty());
+    moved.push_back(2);
+    array = std::move(moved);
+    ASSERT_EQ(array.size(), 2u);
+    ASSERT_TRUE(log.calls.empty());
+  }
+  ASSERT_EQ(log.calls, (std::vector<std::vector<int>>{{1, 2}}));
+}
+
+TEST(handle_array, push_back_failure)
+{
+  std::vector<int> deleted;
+
+  {
+    claws::handle_array<fragile_value, fragile_deleter> array(fragile_deleter{&deleted});
+
+    array.push_back(1);
+    fragile_value::failing = true;
+    // The value couldn't be stored, but was taken ownership of: it is deleted right away
+    ASSERT_THROW(array.push_back(2), std::bad_alloc);
+    fragile_value::failing = false;
+    ASSERT_EQ(deleted, (std::vector<int>{2}));
+    ASSERT_EQ(array.size(), 1u);
+  }
+  ASSERT_EQ(deleted, (std::vector<int>{2, 1}));
+}
@@ -0,0 +1,88 @@
+#include <array>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <gtest/gtest.h>
+#include <claws/utils/inplace_function.hpp>
+
+namespace
+{
+  struct counted
+  {
+    static inline int alive = 0;
+
+    counted() noexcept
+    {
+      ++alive;
+    }
+
+    counted(counted const &) noexcept
+    {
+      ++alive;
+    }
+
+    counted(counted &&) noexcept
+    {
+      ++alive;
+    }
+
+    ~counted()
+    {
+      --alive;
+    }
+  };
+}
+
+TEST(inplace_function, basic)
+{
+  claws::inplace_function<int(int)> empty;
+
+  ASSERT_FALSE(empty);
+  ASSERT_THROW(empty(1), std::bad_function_call);
+
+  std::array<int, 6> captured{1, 2, 3, 4, 5, 6};
+  claws::inplace_function<int(int), 32> sum = [captured](int value) {
+    for (auto element : captured)
+      value += element;
+    return value;
+  };
+
+  ASSERT_TRUE(sum);
+  ASSERT_EQ(sum(1), 22);
+
+  claws::inplace_function<int(int), 64> larger = std::move(sum);
+
+  ASSERT_FALSE(sum);
+  ASSERT_EQ(larger(0), 21);
+  larger = nullptr;
+  ASSERT_FALSE(larger);
+  larger = claws::inplace_function<int(int), 32>();
+  ASSERT_FALSE(larger);
+
+  // Stateful lambdas keep their state between calls, even through a const function
+  claws::inplace_function<int()> const counter = [count = 0]() mutable { return ++count; };
+
+  counter();
+  ASSERT_EQ(counter(), 2);
+}
+
+TEST(inplace_function, move_only)
+{
+  static_assert(!std::is_copy_constructible_v<claws::inplace_function<int()>>);
+  static_assert(std::is_nothrow_move_constructible_v<claws::inplace_function<int()>>);
+
+  {
+    claws::inplace_function<int()> owner = [value = std::make_unique<int>(42), tracker = counted()] { return *value; };
+    claws::inplace_function<int()> moved(std::move(owner));
+
+    ASSERT_EQ(counted::alive, 1);
+    ASSERT_EQ(moved(), 42);
+    owner = std::move(moved);
+    ASSERT_EQ(owner(), 42);
+    swap(owner, moved);
+    ASSERT_EQ(moved(), 42);
+    ASSERT_FALSE(owner);
+    ASSERT_EQ(counted::alive, 1);
+  }
+  ASSERT_EQ(counted::alive, 0);
+}
@@ -0,0 +1,61 @@
+#include <cstring>
+#include <gtest/gtest.h>
+#include <claws/utils/offset_ptr.hpp>
+
+namespace
+{
+  struct node
+  {
+    int value;
+    claws::offset_ptr<node> next;
+  };
+}
+
+TEST(offset_ptr, basic)
+{
+  int values[4] = {1, 2, 3, 4};
+  claws::offset_ptr<int> ptr(values + 1);
+  claws::offset_ptr<int> null;
+
+  ASSERT_EQ(*ptr, 2);
+  ASSERT_EQ(ptr[1], 3);
+  ASSERT_EQ(ptr.get_offset().data, reinterpret_cast<char *>(values + 1) - reinterpret_cast<char *>(&ptr));
+  ASSERT_FALSE(null);
+  ASSERT_EQ(null, nullptr);
+  ASSERT_TRUE(ptr);
+  ++ptr;
+  ASSERT_EQ(ptr, values + 2);
+  ptr -= 2;
+  ASSERT_EQ(*ptr, 1);
+
+  // Copies point to the same target, from their own address
+  claws::offset_ptr<int> copy(ptr);
+  claws::offset_ptr<int const> const_copy(copy);
+
+  ASSERT_EQ(copy, ptr);
+  ASSERT_EQ(const_copy.get(), values);
+  ASSERT_NE(copy.get_offset(), ptr.get_offset());
+  null = copy;
+  ASSERT_EQ(null, values);
+}
+
+TEST(offset_ptr, relocation)
+{
+  node nodes[3] = {{1, nullptr}, {2, nullptr}, {3, nullptr}};
+
+  nodes[0].next = &nodes[1];
+  nodes[1].next = &nodes[2];
+
+  // Moving the bytes of the whole structure keeps it linked
+  alignas(node) unsigned char moved[sizeof(nodes)];
+
+  std::memcpy(moved, nodes, sizeof(nodes));
+
+  auto const first = reinterpret_cast<node *>(moved);
+  int sum = 0;
+
+  for (node *it = first; it; it = it->next)
+    sum += it->value;
+  ASSERT_EQ(sum, 6);
+  ASSERT_EQ(first->next.get(), first + 1);
+}
@@ -0,0 +1,32 @@
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <claws/utils/padded.hpp>
+
+TEST(padded, layout)
+{
+  static_assert(sizeof(claws::padded<char>) == claws::cache_line_size);
+  static_assert(alignof(claws::padded<std::atomic<std::uint64_t>>) == claws::cache_line_size);
+  static_assert(sizeof(claws::padded<char[100]>) == 2u * claws::cache_line_size);
+  static_assert(sizeof(claws::padded<int, 128u>) == 128u);
+  static_assert(sizeof(claws::cache_aligned_box<int>) == claws::cache_line_size);
+
+  claws::padded<std::atomic<int>> counters[4]{};
+
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&counters[1]) - reinterpret_cast<std::uintptr_t>(&counters[0]), claws::cache_line_size);
+  counters[2]->fetch_add(3);
+  ASSERT_EQ(counters[2].get().load(), 3);
+  ASSERT_EQ((*counters[0]).load(), 0);
+}
+
+TEST(padded, box)
+{
+  constexpr claws::cache_aligned_box<int> value{2};
+  static_assert(value == 2);
+
+  claws::cache_aligned_box<double> counts[2];
+
+  counts[1] += 1.5;
+  ASSERT_EQ(counts[0], 0.0);
+  ASSERT_EQ(counts[1], 1.5);
+}
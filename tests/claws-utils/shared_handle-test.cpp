@@ -0,0 +1,149 @@
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/utils/shared_handle.hpp>
+
+namespace
+{
+  struct fd_closer
+  {
+    std::vector<int> *closed;
+
+    void operator()(int fd) const noexcept
+    {
+      closed->push_back(fd);
+    }
+  };
+
+  struct node : claws::shared_count_base<claws::local_count>
+  {
+    int value;
+    bool *deleted;
+
+    node(int value, bool *deleted)
+      : value(value)
+      , deleted(deleted)
+    {}
+
+    ~node()
+    {
+      *deleted = true;
+    }
+  };
+
+  struct node_deleter
+  {
+    void operator()(node *value) const noexcept
+    {
+      delete value;
+    }
+  };
+}
+
+TEST(shared_handle, type_traits)
+{
+  using intrusive = claws::shared_handle<node *, node_deleter, claws::local_count>;
+  using inline_count = claws::shared_handle<int *, node_deleter, claws::local_count>;
+
+  static_assert(sizeof(intrusive) == sizeof(node *));
+  static_assert(sizeof(inline_count) == sizeof(void *));
+  static_assert(!std::is_constructible_v<intrusive, int>);
+  static_assert(std::is_nothrow_move_constructible_v<intrusive>);
+  static_assert(std::is_convertible_v<intrusive, claws::handle<node *, claws::no_delete>>);
+}
+
+TEST(shared_handle, inline_count)
+{
+  std::vector<int> closed;
+
+  {
+    claws::shared_handle<int, fd_closer, claws::local_count> fd(fd_closer{&closed}, 3);
+
+    ASSERT_EQ(fd.use_count(), 1u);
+    ASSERT_EQ(fd.get(), 3);
+    {
+      auto copy = fd;
+      auto moved = std::move(copy);
+
+      ASSERT_FALSE(copy);
+      ASSERT_EQ(fd.use_count(), 2u);
+      ASSERT_EQ(*moved, 3);
+    }
+    ASSERT_EQ(fd.use_count(), 1u);
+    ASSERT_TRUE(closed.empty());
+
+    claws::handle<int, claws::no_delete> borrowed = fd;
+
+    ASSERT_EQ(borrowed, 3);
+  }
+  ASSERT_EQ(closed, std::vector<int>{3});
+
+  claws::shared_handle<int, fd_closer> lh(fd_closer{&closed}, 4);
+  claws::shared_handle<int, fd_closer> rh(fd_closer{&closed}, 5);
+  auto keep = rh;
+
+  rh = lh;
+  ASSERT_EQ(rh.get(), 4);
+  ASSERT_EQ(lh.use_count(), 2u);
+  ASSERT_EQ(keep.use_count(), 1u);
+  keep.reset();
+  ASSERT_FALSE(keep);
+  ASSERT_EQ(keep.use_count(), 0u);
+  ASSERT_EQ(closed, (std::vector<int>{3, 5}));
+}
+
+TEST(shared_handle, intrusive_count)
+{
+  bool deleted = false;
+  auto const raw = new node(7, &deleted);
+
+  {
+    claws::shared_handle<node *, node_deleter, claws::local_count> first(node_deleter{}, raw);
+    // The count is in the object, so a second handle can be made from the raw pointer
+    claws::shared_handle<node *, node_deleter, claws::local_count> second(node_deleter{}, raw);
+
+    ASSERT_EQ(first.use_count(), 2u);
+    ASSERT_EQ(second->value, 7);
+    first.reset();
+    ASSERT_FALSE(deleted);
+
+    // Copying the object doesn't copy its count
+    node copy(*raw);
+
+    ASSERT_EQ(copy.shared_count, 0u);
+    copy.deleted = &deleted;
+    ASSERT_EQ(static_cast<node *>(second.borrow())->value, 7);
+  }
+  ASSERT_TRUE(deleted);
+}
+
+TEST(shared_handle, make_shared_handle)
+{
+  auto const values = claws::make_shared_handle<std::vector<int>, claws::local_count>(3u, 1);
+  auto copy = values;
+
+  ASSERT_EQ(values->size(), 3u);
+  ASSERT_EQ((*copy)[2], 1);
+  ASSERT_EQ(copy.use_count(), 2u);
+}
+
+TEST(shared_handle, atomic_count)
+{
+  auto const value = claws::make_shared_handle<int>(42);
+  std::vector<std::thread> threads;
+
+  for (int t(0); t != 4; ++t)
+    threads.emplace_back([value]() {
+      for (int i(0); i != 10000; ++i)
+        {
+          auto copy = value;
+
+          (void)copy;
+        }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(value.use_count(), 1u);
+}
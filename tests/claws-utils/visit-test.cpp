@@ -0,0 +1,128 @@
+#include <string>
+#include <variant>
+#include <vector>
+#include <gtest/gtest.h>
+#include <claws/utils/lambda_ops.hpp>
+#include <claws/utils/visit.hpp>
+
+namespace
+{
+  struct ping
+  {
+    int sequence;
+  };
+
+  struct data
+  {
+    std::string payload;
+  };
+
+  struct hang_up
+  {};
+
+  using message = std::variant<ping, data, hang_up>;
+
+  // 20 alternatives: past the switch, dispatched through the table
+  template<std::size_t index>
+  struct tag
+  {
+    static constexpr std::size_t value = index;
+  };
+
+  template<std::size_t... indices>
+  std::variant<tag<indices>...> make_large_variant(std::size_t index, std::index_sequence<indices...>)
+  {
+    std::variant<tag<indices>...> result;
+
+    ((index == indices ? (void)result.template emplace<indices>() : (void)0), ...);
+    return result;
+  }
+}
+
+TEST(visit, overload_set)
+{
+  using namespace claws::lambda_ops;
+
+  auto const describe = [](ping const &value) { return "ping " + std::to_string(value.sequence); }
+    + [](data const &value) { return "data " + value.payload; } + [](hang_up) { return std::string("hang up"); };
+
+  ASSERT_EQ(claws::visit(describe, message(ping{3})), "ping 3");
+  ASSERT_EQ(claws::visit(describe, message(data{"abc"})), "data abc");
+  ASSERT_EQ(claws::visit(describe, message(hang_up{})), "hang up");
+
+  // Values are forwarded with the variant's value category
+  message moved(data{"a string long enough to be allocated"});
+  std::string stolen;
+
+  claws::visit([&stolen](auto &&value) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(value)>, data>)
+      stolen = std::forward<decltype(value)>(value).payload;
+  }, std::move(moved));
+  ASSERT_EQ(stolen, "a string long enough to be allocated");
+}
+
+TEST(visit, constexpr_correctness)
+{
+  constexpr auto to_int = [](auto value) { return int(value); };
+
+  static_assert(claws::visit(to_int, std::variant<int, char>('a')) == 'a');
+  static_assert(claws::visit([](auto lh, auto rh) { return int(lh + rh); }, std::variant<int, char>(1), std::variant<long, short>(short(2))) == 3);
+}
+
+TEST(visit, multiple_variants_and_tables)
+{
+  std::variant<int, double> const number = 2.5;
+  std::variant<char, std::string, long> const other = std::string("abc");
+  auto const sizes = [](auto const &lh, auto const &rh) { return sizeof(lh) * 100 + sizeof(rh); };
+
+  ASSERT_EQ(claws::visit(sizes, number, other), sizeof(double) * 100 + sizeof(std::string));
+  ASSERT_EQ(claws::visit(sizes, std::variant<int, double>(1), std::variant<char, std::string, long>('a')), sizeof(int) * 100 + 1);
+
+  for (std::size_t lh(0u); lh != 20u; ++lh)
+    for (std::size_t rh(0u); rh < 20u; rh += 7u)
+      {
+        auto const first = make_large_variant(lh, std::make_index_sequence<20>{});
+        auto const second = make_large_variant(rh, std::make_index_sequence<20>{});
+
+        ASSERT_EQ(claws::visit([](auto a) { return a.value; }, first), lh);
+        ASSERT_EQ(claws::visit([](auto a, auto b) { return a.value * 20u + b.value; }, first, second), lh * 20u + rh);
+      }
+}
+
+TEST(visit, grouped)
+{
+  std::vector<message> messages;
+
+  for (int i(0); i != 30; ++i)
+    switch (i % 3)
+      {
+      case 0:
+        messages.emplace_back(ping{i});
+        break;
+      case 1:
+        messages.emplace_back(data{std::to_string(i)});
+        break;
+      default:
+        messages.emplace_back(hang_up{});
+      }
+
+  std::vector<std::string> visited;
+
+  claws::visit_grouped([&visited](auto const &value) {
+    using type = std::decay_t<decltype(value)>;
+
+    if constexpr (std::is_same_v<type, ping>)
+      visited.push_back("p" + std::to_string(value.sequence));
+    else if constexpr (std::is_same_v<type, data>)
+      visited.push_back("d" + value.payload);
+    else
+      visited.push_back("c");
+  }, messages.begin(), messages.end());
+  ASSERT_EQ(visited.size(), 30u);
+  // Grouped by alternative, in order within each
+  ASSERT_EQ(visited[0], "p0");
+  ASSERT_EQ(visited[9], "p27");
+  ASSERT_EQ(visited[10], "d1");
+  ASSERT_EQ(visited[19], "d28");
+  ASSERT_EQ(visited[29], "c");
+}